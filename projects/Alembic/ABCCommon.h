@@ -4,19 +4,63 @@
 #include "ABCTree.h"
 #include "Alembic/Abc/IObject.h"
 #include "zeno/ListObject.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 namespace zeno {
 
+// what traverseABC can keep of an archive from one frame to the next: the topology,
+// uvs and face sets of the meshes that don't change them, keyed by object path.
+// readABC resets it and tells whether the archive can be read from many threads
+struct ABCReadCache {
+    struct MeshTopology {
+        std::vector<int> loops;
+        std::vector<vec2i> polys;
+        std::vector<vec2f> uvs;
+        std::vector<int> loop_uvs;
+        bool has_faceset = false;
+        std::vector<int> faceset;
+        std::vector<std::string> faceset_names;
+    };
+
+    bool parallel = false;
+
+    void reset(bool parallel_ = false) {
+        std::lock_guard lck(mtx);
+        meshes.clear();
+        parallel = parallel_;
+    }
+
+    std::shared_ptr<MeshTopology const> findMesh(std::string const &path) {
+        std::lock_guard lck(mtx);
+        auto it = meshes.find(path);
+        return it == meshes.end() ? nullptr : it->second;
+    }
+
+    void storeMesh(std::string const &path, std::shared_ptr<MeshTopology const> topo) {
+        std::lock_guard lck(mtx);
+        meshes[path] = std::move(topo);
+    }
+
+private:
+    std::mutex mtx;
+    std::map<std::string, std::shared_ptr<MeshTopology const>> meshes;
+};
+
 extern void traverseABC(
     Alembic::AbcGeom::IObject &obj,
     ABCTree &tree,
     int frameid,
     bool read_done,
     bool read_face_set,
-    std::string path
+    std::string path,
+    ABCReadCache *cache = nullptr
 );
 
-extern Alembic::AbcGeom::IArchive readABC(std::string const &path);
+extern Alembic::AbcGeom::IArchive readABC(std::string const &path, ABCReadCache *cache = nullptr);
 
 extern std::shared_ptr<zeno::ListObject> get_xformed_prims(std::shared_ptr<zeno::ABCTree> abctree);
 
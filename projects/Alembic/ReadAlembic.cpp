@@ -8,16 +8,22 @@
 #include <zeno/types/NumericObject.h>
 #include <zeno/types/UserData.h>
 #include <zeno/extra/GlobalState.h>
+#include <zeno/extra/FramePrefetcher.h>
+#include <zeno/extra/FrameCacheWriter.h>
 #include <Alembic/AbcGeom/All.h>
 #include <Alembic/AbcCoreAbstract/All.h>
 #include <Alembic/AbcCoreOgawa/All.h>
 #include <Alembic/AbcCoreHDF5/All.h>
 #include <Alembic/Abc/ErrorHandler.h>
 #include "ABCTree.h"
+#include "ABCCommon.h"
 #include "zeno/types/DictObject.h"
+#include <algorithm>
 #include <cstring>
 #include <cstdio>
+#include <exception>
 #include <filesystem>
+#include <thread>
 #include <zeno/utils/string.h>
 #include <zeno/utils/scope_exit.h>
 
@@ -350,45 +356,8 @@ static void read_user_data(std::shared_ptr<PrimitiveObject> prim, ICompoundPrope
     }
 }
 
-static std::shared_ptr<PrimitiveObject> foundABCMesh(Alembic::AbcGeom::IPolyMeshSchema &mesh, int frameid, bool read_done, bool read_face_set) {
-    auto prim = std::make_shared<PrimitiveObject>();
-
-    std::shared_ptr<Alembic::AbcCoreAbstract::v12::TimeSampling> time = mesh.getTimeSampling();
-    float time_per_cycle =  time->getTimeSamplingType().getTimePerCycle();
-    double start = time->getStoredTimes().front();
-    int start_frame = std::lround(start / time_per_cycle );
-    set_time_info(prim->userData(), time->getTimeSamplingType(), start, int(mesh.getNumSamples()));
-
-    int sample_index = clamp(frameid - start_frame, 0, (int)mesh.getNumSamples() - 1);
-    ISampleSelector iSS = Alembic::Abc::v12::ISampleSelector((Alembic::AbcCoreAbstract::index_t)sample_index);
-    Alembic::AbcGeom::IPolyMeshSchema::Sample mesamp = mesh.getValue(iSS);
-
-    if (auto marr = mesamp.getPositions()) {
-        if (!read_done) {
-            log_debug("[alembic] totally {} positions", marr->size());
-        }
-        auto &parr = prim->verts;
-        for (size_t i = 0; i < marr->size(); i++) {
-            auto const &val = (*marr)[i];
-            parr.emplace_back(val[0], val[1], val[2]);
-        }
-    }
-
-    read_velocity(prim, mesamp.getVelocities(), read_done);
-    if (auto nrm = mesh.getNormalsParam()) {
-        auto nrmsamp =
-                nrm.getIndexedValue(Alembic::Abc::v12::ISampleSelector((Alembic::AbcCoreAbstract::index_t)sample_index));
-        int value_size = (int)nrmsamp.getVals()->size();
-        if (value_size == prim->verts.size()) {
-            auto &nrms = prim->verts.add_attr<vec3f>("nrm");
-            auto marr = nrmsamp.getVals();
-            for (size_t i = 0; i < marr->size(); i++) {
-                auto const &n = (*marr)[i];
-                nrms[i] = {n[0], n[1], n[2]};
-            }
-        }
-    }
-
+// fills loops, polys and uvs of a mesh from its sample
+static void read_mesh_topology(std::shared_ptr<PrimitiveObject> prim, Alembic::AbcGeom::IPolyMeshSchema &mesh, Alembic::AbcGeom::IPolyMeshSchema::Sample &mesamp, const ISampleSelector &iSS, bool read_done) {
     if (auto marr = mesamp.getFaceIndices()) {
         if (!read_done) {
             log_debug("[alembic] totally {} face indices", marr->size());
@@ -414,8 +383,7 @@ static std::shared_ptr<PrimitiveObject> foundABCMesh(Alembic::AbcGeom::IPolyMesh
         }
     }
     if (auto uv = mesh.getUVsParam()) {
-        auto uvsamp =
-            uv.getIndexedValue(Alembic::Abc::v12::ISampleSelector((Alembic::AbcCoreAbstract::index_t)sample_index));
+        auto uvsamp = uv.getIndexedValue(iSS);
         int value_size = (int)uvsamp.getVals()->size();
         int index_size = (int)uvsamp.getIndices()->size();
         if (!read_done) {
@@ -461,27 +429,150 @@ static std::shared_ptr<PrimitiveObject> foundABCMesh(Alembic::AbcGeom::IPolyMesh
             prim->loops.attr<int>("uvs")[i] = 0;
         }
     }
+}
+
+static void read_mesh_face_sets(std::shared_ptr<PrimitiveObject> prim, Alembic::AbcGeom::IPolyMeshSchema &mesh) {
+    auto &faceset = prim->polys.add_attr<int>("faceset");
+    std::fill(faceset.begin(), faceset.end(), -1);
+    auto &ud = prim->userData();
+    std::vector<std::string> faceSetNames;
+    mesh.getFaceSetNames(faceSetNames);
+    ud.set2("faceset_count", int(faceSetNames.size()));
+    for (auto i = 0; i < faceSetNames.size(); i++) {
+        auto n = faceSetNames[i];
+        ud.set2(zeno::format("faceset_{}", i), n);
+        IFaceSet faceSet = mesh.getFaceSet(n);
+        IFaceSetSchema::Sample faceSetSample = faceSet.getSchema().getValue();
+        size_t s = faceSetSample.getFaces()->size();
+        for (auto j = 0; j < s; j++) {
+            int f = faceSetSample.getFaces()->get()[j];
+            faceset[f] = i;
+        }
+    }
+}
+
+// the topology of a mesh is worth keeping when only its points move: then the uvs and
+// face sets are kept along too, as long as they are not animated either
+static std::shared_ptr<ABCReadCache::MeshTopology const> cache_mesh_topology(std::shared_ptr<PrimitiveObject> prim, Alembic::AbcGeom::IPolyMeshSchema &mesh, bool read_face_set) {
+    if (mesh.getTopologyVariance() == Alembic::AbcGeom::kHeterogenousTopology) {
+        return nullptr;
+    }
+    if (auto uv = mesh.getUVsParam()) {
+        if (!uv.isConstant()) {
+            return nullptr;
+        }
+    }
+    auto topo = std::make_shared<ABCReadCache::MeshTopology>();
+    topo->loops = prim->loops.values;
+    topo->polys = prim->polys.values;
+    topo->uvs = prim->uvs.values;
+    topo->loop_uvs = prim->loops.attr<int>("uvs");
+    if (read_face_set) {
+        std::vector<std::string> faceSetNames;
+        mesh.getFaceSetNames(faceSetNames);
+        topo->has_faceset = true;
+        for (auto const &n: faceSetNames) {
+            if (!mesh.getFaceSet(n).getSchema().isConstant()) {
+                topo->has_faceset = false;
+            }
+        }
+        if (topo->has_faceset) {
+            topo->faceset = prim->polys.attr<int>("faceset");
+            topo->faceset_names = std::move(faceSetNames);
+        }
+    }
+    return topo;
+}
+
+static std::shared_ptr<PrimitiveObject> foundABCMesh(Alembic::AbcGeom::IPolyMeshSchema &mesh, int frameid, bool read_done, bool read_face_set, ABCReadCache *cache, std::string const &path) {
+    auto prim = std::make_shared<PrimitiveObject>();
+
+    std::shared_ptr<Alembic::AbcCoreAbstract::v12::TimeSampling> time = mesh.getTimeSampling();
+    float time_per_cycle =  time->getTimeSamplingType().getTimePerCycle();
+    double start = time->getStoredTimes().front();
+    int start_frame = std::lround(start / time_per_cycle );
+    set_time_info(prim->userData(), time->getTimeSamplingType(), start, int(mesh.getNumSamples()));
+
+    int sample_index = clamp(frameid - start_frame, 0, (int)mesh.getNumSamples() - 1);
+    ISampleSelector iSS = Alembic::Abc::v12::ISampleSelector((Alembic::AbcCoreAbstract::index_t)sample_index);
+
+    std::shared_ptr<ABCReadCache::MeshTopology const> topo;
+    if (cache) {
+        topo = cache->findMesh(path);
+        if (topo && read_face_set && !topo->has_faceset) {
+            topo = nullptr;
+        }
+    }
+    // with the topology at hand, only the animated properties have to be fetched
+    Alembic::AbcGeom::IPolyMeshSchema::Sample mesamp;
+    P3fArraySamplePtr positions;
+    V3fArraySamplePtr velocities;
+    if (topo) {
+        positions = mesh.getPositionsProperty().getValue(iSS);
+        if (auto vel = mesh.getVelocitiesProperty(); vel.valid()) {
+            velocities = vel.getValue(iSS);
+        }
+    } else {
+        mesamp = mesh.getValue(iSS);
+        positions = mesamp.getPositions();
+        velocities = mesamp.getVelocities();
+    }
+
+    if (auto marr = positions) {
+        if (!read_done) {
+            log_debug("[alembic] totally {} positions", marr->size());
+        }
+        auto &parr = prim->verts;
+        for (size_t i = 0; i < marr->size(); i++) {
+            auto const &val = (*marr)[i];
+            parr.emplace_back(val[0], val[1], val[2]);
+        }
+    }
+
+    read_velocity(prim, velocities, read_done);
+    if (auto nrm = mesh.getNormalsParam()) {
+        auto nrmsamp =
+                nrm.getIndexedValue(Alembic::Abc::v12::ISampleSelector((Alembic::AbcCoreAbstract::index_t)sample_index));
+        int value_size = (int)nrmsamp.getVals()->size();
+        if (value_size == prim->verts.size()) {
+            auto &nrms = prim->verts.add_attr<vec3f>("nrm");
+            auto marr = nrmsamp.getVals();
+            for (size_t i = 0; i < marr->size(); i++) {
+                auto const &n = (*marr)[i];
+                nrms[i] = {n[0], n[1], n[2]};
+            }
+        }
+    }
+
+    if (topo) {
+        prim->loops.values = topo->loops;
+        prim->polys.values = topo->polys;
+        prim->uvs.values = topo->uvs;
+        prim->loops.add_attr<int>("uvs") = topo->loop_uvs;
+    } else {
+        read_mesh_topology(prim, mesh, mesamp, iSS, read_done);
+    }
     ICompoundProperty arbattrs = mesh.getArbGeomParams();
     read_attributes(prim, arbattrs, iSS, read_done);
     ICompoundProperty usrData = mesh.getUserProperties();
     read_user_data(prim, usrData, iSS, read_done);
 
-    if (read_face_set) {
-        auto &faceset = prim->polys.add_attr<int>("faceset");
-        std::fill(faceset.begin(), faceset.end(), -1);
-        auto &ud = prim->userData();
-        std::vector<std::string> faceSetNames;
-        mesh.getFaceSetNames(faceSetNames);
-        ud.set2("faceset_count", int(faceSetNames.size()));
-        for (auto i = 0; i < faceSetNames.size(); i++) {
-            auto n = faceSetNames[i];
-            ud.set2(zeno::format("faceset_{}", i), n);
-            IFaceSet faceSet = mesh.getFaceSet(n);
-            IFaceSetSchema::Sample faceSetSample = faceSet.getSchema().getValue();
-            size_t s = faceSetSample.getFaces()->size();
-            for (auto j = 0; j < s; j++) {
-                int f = faceSetSample.getFaces()->get()[j];
-                faceset[f] = i;
+    if (topo) {
+        if (read_face_set) {
+            prim->polys.add_attr<int>("faceset") = topo->faceset;
+            auto &ud = prim->userData();
+            ud.set2("faceset_count", int(topo->faceset_names.size()));
+            for (auto i = 0; i < topo->faceset_names.size(); i++) {
+                ud.set2(zeno::format("faceset_{}", i), topo->faceset_names[i]);
+            }
+        }
+    } else {
+        if (read_face_set) {
+            read_mesh_face_sets(prim, mesh);
+        }
+        if (cache) {
+            if (auto newtopo = cache_mesh_topology(prim, mesh, read_face_set)) {
+                cache->storeMesh(path, std::move(newtopo));
             }
         }
     }
@@ -729,77 +820,27 @@ static std::shared_ptr<PrimitiveObject> foundABCCurves(Alembic::AbcGeom::ICurves
     return prim;
 }
 
-void traverseABC(
+namespace {
+
+struct ABCReadJob {
+    Alembic::AbcGeom::IObject obj;
+    ABCTree *tree;
+    std::string path;
+};
+
+}
+
+// builds the tree from the object headers alone, and lists the objects whose samples are to be read
+static void collectABC(
     Alembic::AbcGeom::IObject &obj,
     ABCTree &tree,
-    int frameid,
     bool read_done,
-    bool read_face_set,
-    std::string path
+    std::string path,
+    std::vector<ABCReadJob> &jobs
 ) {
-    {
-        auto const &md = obj.getMetaData();
-        if (!read_done) {
-            log_debug("[alembic] meta data: [{}]", md.serialize());
-        }
-        tree.name = obj.getName();
-        path = zeno::format("{}/{}", path, tree.name);
-
-        if (Alembic::AbcGeom::IPolyMesh::matches(md)) {
-            if (!read_done) {
-                log_debug("[alembic] found a mesh [{}]", obj.getName());
-            }
-
-            Alembic::AbcGeom::IPolyMesh meshy(obj);
-            auto &mesh = meshy.getSchema();
-            tree.prim = foundABCMesh(mesh, frameid, read_done, read_face_set);
-            tree.prim->userData().set2("_abc_name", obj.getName());
-            tree.prim->userData().set2("_abc_path", path);
-        } else if (Alembic::AbcGeom::IXformSchema::matches(md)) {
-            if (!read_done) {
-                log_debug("[alembic] found a Xform [{}]", obj.getName());
-            }
-            Alembic::AbcGeom::IXform xfm(obj);
-            auto &cam_sch = xfm.getSchema();
-            tree.xform = foundABCXform(cam_sch, frameid);
-        } else if (Alembic::AbcGeom::ICameraSchema::matches(md)) {
-            if (!read_done) {
-                log_debug("[alembic] found a Camera [{}]", obj.getName());
-            }
-            Alembic::AbcGeom::ICamera cam(obj);
-            auto &cam_sch = cam.getSchema();
-            tree.camera_info = foundABCCamera(cam_sch, frameid);
-        } else if(Alembic::AbcGeom::IPointsSchema::matches(md)) {
-            if (!read_done) {
-                log_debug("[alembic] found points [{}]", obj.getName());
-            }
-            Alembic::AbcGeom::IPoints points(obj);
-            auto &points_sch = points.getSchema();
-            tree.prim = foundABCPoints(points_sch, frameid, read_done);
-            tree.prim->userData().set2("_abc_name", obj.getName());
-            tree.prim->userData().set2("_abc_path", path);
-            tree.prim->userData().set2("faceset_count", 0);
-        } else if(Alembic::AbcGeom::ICurvesSchema::matches(md)) {
-            if (!read_done) {
-                log_debug("[alembic] found curves [{}]", obj.getName());
-            }
-            Alembic::AbcGeom::ICurves curves(obj);
-            auto &curves_sch = curves.getSchema();
-            tree.prim = foundABCCurves(curves_sch, frameid, read_done);
-            tree.prim->userData().set2("_abc_name", obj.getName());
-            tree.prim->userData().set2("_abc_path", path);
-            tree.prim->userData().set2("faceset_count", 0);
-        } else if (Alembic::AbcGeom::ISubDSchema::matches(md)) {
-            if (!read_done) {
-                log_debug("[alembic] found SubD [{}]", obj.getName());
-            }
-            Alembic::AbcGeom::ISubD subd(obj);
-            auto &subd_sch = subd.getSchema();
-            tree.prim = foundABCSubd(subd_sch, frameid, read_done, read_face_set);
-            tree.prim->userData().set2("_abc_name", obj.getName());
-            tree.prim->userData().set2("_abc_path", path);
-        }
-    }
+    tree.name = obj.getName();
+    path = zeno::format("{}/{}", path, tree.name);
+    jobs.push_back({obj, &tree, path});
 
     size_t nch = obj.getNumChildren();
     if (!read_done) {
@@ -815,12 +856,114 @@ void traverseABC(
         Alembic::AbcGeom::IObject child(obj, name);
 
         auto childTree = std::make_shared<ABCTree>();
-        traverseABC(child, *childTree, frameid, read_done, read_face_set, path);
+        collectABC(child, *childTree, read_done, path, jobs);
         tree.children.push_back(std::move(childTree));
     }
 }
 
-Alembic::AbcGeom::IArchive readABC(std::string const &path) {
+static void readABCObject(
+    Alembic::AbcGeom::IObject &obj,
+    ABCTree &tree,
+    int frameid,
+    bool read_done,
+    bool read_face_set,
+    std::string const &path,
+    ABCReadCache *cache
+) {
+    auto const &md = obj.getMetaData();
+    if (!read_done) {
+        log_debug("[alembic] meta data: [{}]", md.serialize());
+    }
+
+    if (Alembic::AbcGeom::IPolyMesh::matches(md)) {
+        if (!read_done) {
+            log_debug("[alembic] found a mesh [{}]", obj.getName());
+        }
+
+        Alembic::AbcGeom::IPolyMesh meshy(obj);
+        auto &mesh = meshy.getSchema();
+        tree.prim = foundABCMesh(mesh, frameid, read_done, read_face_set, cache, path);
+        tree.prim->userData().set2("_abc_name", obj.getName());
+        tree.prim->userData().set2("_abc_path", path);
+    } else if (Alembic::AbcGeom::IXformSchema::matches(md)) {
+        if (!read_done) {
+            log_debug("[alembic] found a Xform [{}]", obj.getName());
+        }
+        Alembic::AbcGeom::IXform xfm(obj);
+        auto &cam_sch = xfm.getSchema();
+        tree.xform = foundABCXform(cam_sch, frameid);
+    } else if (Alembic::AbcGeom::ICameraSchema::matches(md)) {
+        if (!read_done) {
+            log_debug("[alembic] found a Camera [{}]", obj.getName());
+        }
+        Alembic::AbcGeom::ICamera cam(obj);
+        auto &cam_sch = cam.getSchema();
+        tree.camera_info = foundABCCamera(cam_sch, frameid);
+    } else if(Alembic::AbcGeom::IPointsSchema::matches(md)) {
+        if (!read_done) {
+            log_debug("[alembic] found points [{}]", obj.getName());
+        }
+        Alembic::AbcGeom::IPoints points(obj);
+        auto &points_sch = points.getSchema();
+        tree.prim = foundABCPoints(points_sch, frameid, read_done);
+        tree.prim->userData().set2("_abc_name", obj.getName());
+        tree.prim->userData().set2("_abc_path", path);
+        tree.prim->userData().set2("faceset_count", 0);
+    } else if(Alembic::AbcGeom::ICurvesSchema::matches(md)) {
+        if (!read_done) {
+            log_debug("[alembic] found curves [{}]", obj.getName());
+        }
+        Alembic::AbcGeom::ICurves curves(obj);
+        auto &curves_sch = curves.getSchema();
+        tree.prim = foundABCCurves(curves_sch, frameid, read_done);
+        tree.prim->userData().set2("_abc_name", obj.getName());
+        tree.prim->userData().set2("_abc_path", path);
+        tree.prim->userData().set2("faceset_count", 0);
+    } else if (Alembic::AbcGeom::ISubDSchema::matches(md)) {
+        if (!read_done) {
+            log_debug("[alembic] found SubD [{}]", obj.getName());
+        }
+        Alembic::AbcGeom::ISubD subd(obj);
+        auto &subd_sch = subd.getSchema();
+        tree.prim = foundABCSubd(subd_sch, frameid, read_done, read_face_set);
+        tree.prim->userData().set2("_abc_name", obj.getName());
+        tree.prim->userData().set2("_abc_path", path);
+    }
+}
+
+// the hierarchy is walked first, then the objects are read in parallel when the archive
+// allows it, each one filling its own tree node, so the result doesn't depend on the order
+void traverseABC(
+    Alembic::AbcGeom::IObject &obj,
+    ABCTree &tree,
+    int frameid,
+    bool read_done,
+    bool read_face_set,
+    std::string path,
+    ABCReadCache *cache
+) {
+    std::vector<ABCReadJob> jobs;
+    collectABC(obj, tree, read_done, path, jobs);
+
+    bool parallel = cache && cache->parallel && jobs.size() > 1;
+    std::exception_ptr error;
+#pragma omp parallel for schedule(dynamic, 1) if (parallel)
+    for (int i = 0; i < (int)jobs.size(); i++) {
+        try {
+            readABCObject(jobs[i].obj, *jobs[i].tree, frameid, read_done, read_face_set, jobs[i].path, cache);
+        } catch (...) {
+#pragma omp critical
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+Alembic::AbcGeom::IArchive readABC(std::string const &path, ABCReadCache *cache) {
     std::string native_path = std::filesystem::u8path(path).string();
     std::string hdr;
     {
@@ -835,9 +978,19 @@ Alembic::AbcGeom::IArchive readABC(std::string const &path) {
     }
     if (hdr == "\x89HDF") {
         log_info("[alembic] opening as HDF5 format");
+        // the HDF5 backend isn't thread safe
+        if (cache) {
+            cache->reset(false);
+        }
         return {Alembic::AbcCoreHDF5::ReadArchive(), native_path};
     } else if (hdr == "Ogaw") {
         log_info("[alembic] opening as Ogawa format");
+        if (cache) {
+            // one stream per thread so that parallel reads don't wait on each other
+            cache->reset(true);
+            size_t nstreams = std::max(1u, std::thread::hardware_concurrency());
+            return {Alembic::AbcCoreOgawa::ReadArchive(nstreams), native_path};
+        }
         return {Alembic::AbcCoreOgawa::ReadArchive(), native_path};
     } else {
         throw Exception("[alembic] unrecognized ABC header: [" + hdr + "]");
@@ -846,8 +999,13 @@ Alembic::AbcGeom::IArchive readABC(std::string const &path) {
 
 struct ReadAlembic : INode {
     Alembic::Abc::v12::IArchive archive;
+    std::shared_ptr<ABCReadCache> cache;
     std::string usedPath;
+    std::optional<FramePrefetcher::FileStamp> usedStamp;
     bool read_done = false;
+    // not canApplyInParallel: HDF5 archives (readABC opens those too) go through
+    // the HDF5 library, which isn't thread safe, and two of these nodes would
+    // read them at once
     virtual void apply() override {
         int frameid;
         if (has_input("frameid")) {
@@ -855,24 +1013,50 @@ struct ReadAlembic : INode {
         } else {
             frameid = getGlobalState()->frameid;
         }
-        auto abctree = std::make_shared<ABCTree>();
+        std::shared_ptr<ABCTree> abctree;
         {
             auto path = get_input<StringObject>("path")->get();
-            if (usedPath != path) {
+            // an archive rewritten in place is opened again too
+            auto stamp = FramePrefetcher::fileStamp(path);
+            if (usedPath != path || !(usedStamp == stamp)) {
                 read_done = false;
             }
             if (read_done == false) {
-                archive = readABC(path);
+                // a fresh cache, reads ahead in the last archive may still be filling the old one
+                cache = std::make_shared<ABCReadCache>();
+                archive = readABC(path, cache.get());
             }
             double start, _end;
             GetArchiveStartAndEndTime(archive, start, _end);
             // fmt::print("GetArchiveStartAndEndTime: {}\n", start);
             // fmt::print("archive.getNumTimeSamplings: {}\n", archive.getNumTimeSamplings());
-            auto obj = archive.getTop();
             bool read_face_set = get_input2<bool>("read_face_set");
-            traverseABC(obj, *abctree, frameid, read_done, read_face_set, "");
+            // the next frames are read in the background when the archive can be read from many threads
+            if (cache->parallel) {
+                auto key = zeno::format("ReadAlembic:{}\n{}", read_face_set, path);
+                auto &prefetcher = FramePrefetcher::instance();
+                abctree = std::static_pointer_cast<ABCTree>(prefetcher.take(key, frameid));
+                prefetcher.prefetch(key, frameid, [archive = archive, cache = cache, read_face_set]
+                                    (int frameid, std::size_t &bytes) mutable -> std::shared_ptr<zeno::IObject> {
+                    auto abctree = std::make_shared<ABCTree>();
+                    auto obj = archive.getTop();
+                    traverseABC(obj, *abctree, frameid, true, read_face_set, "", cache.get());
+                    abctree->visitPrims([&] (auto const &p) {
+                        bytes += FrameCacheWriter::estimateBytes(p.get());
+                    });
+                    return abctree;
+                }, [path] (int) {
+                    return path;
+                });
+            }
+            if (!abctree) {
+                abctree = std::make_shared<ABCTree>();
+                auto obj = archive.getTop();
+                traverseABC(obj, *abctree, frameid, read_done, read_face_set, "", cache.get());
+            }
             read_done = true;
             usedPath = path;
+            usedStamp = stamp;
         }
         {
             auto namelist = std::make_shared<zeno::ListObject>();
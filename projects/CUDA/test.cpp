@@ -693,7 +693,7 @@ struct TestAdaptiveGrid : INode {
 
         openvdb::FloatGrid::Ptr sdf;
         if (has_input("sdf"))
-            sdf = get_input("sdf")->as<VDBFloatGrid>()->m_grid;
+            sdf = get_input("sdf")->as<VDBFloatGrid>()->grid();
         else {
             sdf = zs::load_floatgrid_from_vdb_file("/home/mine/Codes/zeno2/zeno/assets/tozeno.vdb")
                       .as<openvdb::FloatGrid::Ptr>();
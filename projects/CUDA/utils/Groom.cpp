@@ -55,7 +55,7 @@ struct SpawnGuidelines : INode {
             auto collider = get_input2<zeno::VDBFloatGrid>("vdb_collider");
             auto sep_dist = get_input2<float>("sep_dist");
             auto maxIters = get_input2<int>("max_iter");
-            auto grid = collider->m_grid;
+            auto grid = collider->grid();
             grid->tree().voxelizeActiveTiles();
             auto dx = collider->getVoxelSize()[0];
             openvdb::Vec3fGrid::Ptr gridGrad = openvdb::tools::gradient(*grid);
@@ -250,7 +250,7 @@ struct StepGuidelines : INode {
         bool hasCollider = has_input("vdb_collider");
         if (hasCollider) {
             auto collider = get_input2<zeno::VDBFloatGrid>("vdb_collider");
-            grid = collider->m_grid;
+            grid = collider->grid();
             grid->tree().voxelizeActiveTiles();
             gridGrad = openvdb::tools::gradient(*grid);
         }
@@ -721,7 +721,7 @@ struct RepelPoints : zeno::INode {
         auto collider = get_input2<zeno::VDBFloatGrid>("vdb_collider");
         auto sep_dist = get_input2<float>("sep_dist");
         auto maxIters = get_input2<int>("max_iter");
-        auto grid = collider->m_grid;
+        auto grid = collider->grid();
         grid->tree().voxelizeActiveTiles();
         auto dx = collider->getVoxelSize()[0];
         openvdb::Vec3fGrid::Ptr gridGrad = openvdb::tools::gradient(*grid);
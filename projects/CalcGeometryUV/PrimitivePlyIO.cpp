@@ -85,6 +85,10 @@ static void readply(
 }
 
 struct ReadPlyPrimitive : zeno::INode {
+    virtual bool canApplyInParallel() const override {
+        return true;
+    }
+
     virtual void apply() override {
         auto path = get_input<zeno::StringObject>("path")->get();
         auto prim = std::make_shared<zeno::PrimitiveObject>();
@@ -221,10 +221,10 @@ struct ZSVDBToSparseGrid : INode {
 
             if (num_ch == 1) {
                 auto vdb_ = std::dynamic_pointer_cast<VDBFloatGrid>(vdb);
-                zs::assign_floatgrid_to_sparse_grid(vdb_->m_grid, spg, attrTag);
+                zs::assign_floatgrid_to_sparse_grid(vdb_->grid(), spg, attrTag);
             } else {
                 auto vdb_ = std::dynamic_pointer_cast<VDBFloat3Grid>(vdb);
-                zs::assign_float3grid_to_sparse_grid(vdb_->m_grid, spg, attrTag);
+                zs::assign_float3grid_to_sparse_grid(vdb_->grid(), spg, attrTag);
             }
 
             set_output("SparseGrid", zs_grid);
@@ -235,10 +235,10 @@ struct ZSVDBToSparseGrid : INode {
             if (vdbType == "FloatGrid") {
                 auto vdb_ = std::dynamic_pointer_cast<VDBFloatGrid>(vdb);
                 spg =
-                    zs::convert_floatgrid_to_sparse_grid(vdb_->m_grid, zs::MemoryHandle{zs::memsrc_e::device, 0}, attr);
+                    zs::convert_floatgrid_to_sparse_grid(vdb_->grid(), zs::MemoryHandle{zs::memsrc_e::device, 0}, attr);
             } else if (vdbType == "Vec3fGrid") {
                 auto vdb_ = std::dynamic_pointer_cast<VDBFloat3Grid>(vdb);
-                spg = zs::convert_float3grid_to_sparse_grid(vdb_->m_grid, zs::MemoryHandle{zs::memsrc_e::device, 0},
+                spg = zs::convert_float3grid_to_sparse_grid(vdb_->grid(), zs::MemoryHandle{zs::memsrc_e::device, 0},
                                                             attr);
             } else {
                 throw std::runtime_error("Input VDB must be a FloatGrid or Vec3fGrid!");
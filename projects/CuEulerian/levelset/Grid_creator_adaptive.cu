@@ -216,10 +216,10 @@ struct ZSVDBToAdaptiveGrid : INode {
 #if 1
       if (num_ch == 1) {
         auto vdb_ = std::dynamic_pointer_cast<VDBFloatGrid>(vdb);
-        zs::assign_floatgrid_to_adaptive_grid(vdb_->m_grid, ag, attrTag);
+        zs::assign_floatgrid_to_adaptive_grid(vdb_->grid(), ag, attrTag);
       } else {
         auto vdb_ = std::dynamic_pointer_cast<VDBFloat3Grid>(vdb);
-        zs::assign_float3grid_to_adaptive_grid(vdb_->m_grid, ag, attrTag);
+        zs::assign_float3grid_to_adaptive_grid(vdb_->grid(), ag, attrTag);
       }
 
       set_output("AdaptiveGrid", zs_grid);
@@ -234,11 +234,11 @@ struct ZSVDBToAdaptiveGrid : INode {
       if (vdbType == "FloatGrid") {
         auto vdb_ = std::dynamic_pointer_cast<VDBFloatGrid>(vdb);
         ag = zs::convert_floatgrid_to_adaptive_grid(
-            vdb_->m_grid, zs::MemoryHandle{zs::memsrc_e::device, 0}, attr);
+            vdb_->grid(), zs::MemoryHandle{zs::memsrc_e::device, 0}, attr);
       } else if (vdbType == "Vec3fGrid") {
         auto vdb_ = std::dynamic_pointer_cast<VDBFloat3Grid>(vdb);
         ag = zs::convert_float3grid_to_adaptive_grid(
-            vdb_->m_grid, zs::MemoryHandle{zs::memsrc_e::device, 0}, attr);
+            vdb_->grid(), zs::MemoryHandle{zs::memsrc_e::device, 0}, attr);
       } else {
         throw std::runtime_error("Input VDB must be a FloatGrid or Vec3fGrid!");
       }
@@ -21,7 +21,7 @@ struct PoissonDiskSample : INode {
 
         zs::OpenVDBStruct gridPtr{};
         if (has_input<VDBFloatGrid>("VDBGrid"))
-            gridPtr = get_input<VDBFloatGrid>("VDBGrid")->m_grid;
+            gridPtr = get_input<VDBFloatGrid>("VDBGrid")->grid();
         else
             gridPtr = zs::load_floatgrid_from_vdb_file(get_param<std::string>("path"));
 
@@ -1542,13 +1542,13 @@ struct ToZSLevelSet : INode {
 
         if (has_input<VDBFloatGrid>("VDBGrid")) {
             // pass in FloatGrid::Ptr
-            zs::OpenVDBStruct gridPtr = get_input<VDBFloatGrid>("VDBGrid")->m_grid;
+            zs::OpenVDBStruct gridPtr = get_input<VDBFloatGrid>("VDBGrid")->grid();
             ls->getLevelSet() =
                 basic_ls_t{zs::convert_floatgrid_to_sparse_grid(gridPtr, zs::MemoryProperty{zs::memsrc_e::device, 0})};
         } else if (has_input<VDBFloat3Grid>("VDBGrid")) {
             // pass in FloatGrid::Ptr
 #if 0
-            zs::OpenVDBStruct gridPtr = get_input<VDBFloat3Grid>("VDBGrid")->m_grid;
+            zs::OpenVDBStruct gridPtr = get_input<VDBFloat3Grid>("VDBGrid")->grid();
             ls->getLevelSet() =
                 basic_ls_t{zs::convert_vec3fgrid_to_sparse_grid(gridPtr, zs::MemoryProperty{zs::memsrc_e::device, 0})};
 #else
@@ -420,8 +420,8 @@ struct MarkMovingSolidCellsByVDB : zeno::INode {
     auto simParam = get_input("simParam")->as<CompressibleSimStates>();
     auto sdf_vdb = get_input("SDFVDBField")->as<VDBFloatGrid>();
     auto solid_vel_vdb = get_input("SolidVelVDBField")->as<VDBFloat3Grid>();
-    auto sdf_access = sdf_vdb->m_grid->getAccessor();
-    auto solid_vel_access = solid_vel_vdb->m_grid->getAccessor();
+    auto sdf_access = sdf_vdb->grid()->getAccessor();
+    auto solid_vel_access = solid_vel_vdb->grid()->getAccessor();
 
     // counting solid cell num
     int num = 0;
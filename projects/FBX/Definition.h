@@ -30,6 +30,12 @@ std::cout.setstate(std::ios::failbit); std::cout \
 
 #include <limits>
 #include <algorithm>
+#include <memory>
+#include <mutex>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include <zeno/utils/log.h>
 #include <zeno/utils/vec.h>
 #include <zeno/core/IObject.h>
@@ -161,36 +167,39 @@ struct SAnimBone {
     }
 
     void update(float animationTime) {
+        m_LocalTransform = evaluate(animationTime);
+    }
+
+    // the local transform at animationTime, without touching m_LocalTransform
+    aiMatrix4x4 evaluate(float animationTime) const {
         aiMatrix4x4 translation = interpolatePosition(animationTime);
         aiMatrix4x4 rotation = interpolateRotation(animationTime);
         aiMatrix4x4 scale = interpolateScaling(animationTime);
 
-        m_LocalTransform = translation * rotation * scale;
+        return translation * rotation * scale;
     }
 
-    int getPositionIndex(float animationTime) {
-        for (int index = 0; index < m_NumPositions - 1; ++index) {
-            if (animationTime <= m_Positions[index + 1].timeStamp)
-                return index;
-        }
-        return m_NumPositions-1;
+    // the last key whose next key is not before animationTime, the keys are sorted by time
+    template <class Key>
+    static int getKeyIndex(std::vector<Key> const &keys, int numKeys, float animationTime) {
+        if (numKeys <= 1)
+            return numKeys - 1;
+        auto it = std::lower_bound(keys.begin() + 1, keys.begin() + numKeys, animationTime,
+                                   [] (Key const &key, float time) { return key.timeStamp < time; });
+        return it == keys.begin() + numKeys ? numKeys - 1 : int(it - keys.begin()) - 1;
     }
-    int getRotationIndex(float animationTime) {
-        for (int index = 0; index < m_NumRotations - 1; ++index) {
-            if (animationTime <= m_Rotations[index + 1].timeStamp)
-                return index;
-        }
-        return m_NumRotations-1;
+
+    int getPositionIndex(float animationTime) const {
+        return getKeyIndex(m_Positions, m_NumPositions, animationTime);
     }
-    int getScaleIndex(float animationTime) {
-        for (int index = 0; index < m_NumScalings - 1; ++index) {
-            if (animationTime <= m_Scales[index + 1].timeStamp)
-                return index;
-        }
-        return m_NumScalings-1;
+    int getRotationIndex(float animationTime) const {
+        return getKeyIndex(m_Rotations, m_NumRotations, animationTime);
+    }
+    int getScaleIndex(float animationTime) const {
+        return getKeyIndex(m_Scales, m_NumScalings, animationTime);
     }
 
-    aiMatrix4x4 interpolatePosition(float animationTime) {
+    aiMatrix4x4 interpolatePosition(float animationTime) const {
         aiMatrix4x4 result;
 
         if (1 == m_NumPositions) {
@@ -214,7 +223,7 @@ struct SAnimBone {
         return result;
     }
 
-    aiMatrix4x4 interpolateRotation(float animationTime) {
+    aiMatrix4x4 interpolateRotation(float animationTime) const {
         aiMatrix4x4 result;
 
         if (1 == m_NumRotations) {
@@ -239,7 +248,7 @@ struct SAnimBone {
         return result;
     }
 
-    aiMatrix4x4 interpolateScaling(float animationTime) {
+    aiMatrix4x4 interpolateScaling(float animationTime) const {
         aiMatrix4x4 result;
         if (1 == m_NumScalings) {
             aiMatrix4x4::Scaling(m_Scales[0].scale, result);
@@ -262,7 +271,7 @@ struct SAnimBone {
         return result;
     }
 
-    float getScaleFactor(float lastTimeStamp, float nextTimeStamp, float animationTime) {
+    float getScaleFactor(float lastTimeStamp, float nextTimeStamp, float animationTime) const {
         //std::cout << " Stamp Factor " << lastTimeStamp << " " << nextTimeStamp << " " << animationTime << "\n";
         if(animationTime <= lastTimeStamp){
             return 0.0f;
@@ -554,6 +563,35 @@ struct SLight{
     aiVector2D mSize;
 };
 
+// a cache an object builds lazily from its data, clones of the object start without one
+template <class T>
+struct SFBXCacheRef {
+    SFBXCacheRef() = default;
+    SFBXCacheRef(SFBXCacheRef const &) {}
+    SFBXCacheRef &operator=(SFBXCacheRef const &) {
+        std::lock_guard lck(m_mtx);
+        m_ptr = nullptr;
+        return *this;
+    }
+
+    // the cached T while isValid(T) holds, else a new one from make(). the lock
+    // is per cache, so the caches of different objects are built concurrently
+    template <class IsValid, class Make>
+    std::shared_ptr<T> get(IsValid const &isValid, Make const &make) {
+        std::lock_guard lck(m_mtx);
+        if (!m_ptr || !isValid(*m_ptr))
+            m_ptr = make();
+        return m_ptr;
+    }
+
+private:
+    std::mutex m_mtx;
+    std::shared_ptr<T> m_ptr;
+};
+
+struct SFBXAnimCache;
+struct SFBXMeshCache;
+
 struct NodeTree : zeno::IObjectClone<NodeTree>{
     aiMatrix4x4 transformation;
     std::string name;
@@ -563,6 +601,75 @@ struct NodeTree : zeno::IObjectClone<NodeTree>{
 
 struct BoneTree : zeno::IObjectClone<BoneTree>{
     std::unordered_map<std::string, SAnimBone> AnimBoneMap;
+
+    SFBXCacheRef<SFBXAnimCache> animCache;
+};
+
+// a node of the NodeTree, see SFBXAnimCache
+struct SFBXJoint {
+    std::string name;
+    std::string path;               // "/root/.../name", what the lazy transforms are keyed by
+    int parent;                     // -1 for the root
+    aiMatrix4x4 transformation;
+    const SAnimBone *animBone;      // nullptr if the node has no key-anim
+};
+
+// the NodeTree of an archive flattened depth first (parents come before their
+// children) with its curves, and the global transforms of the joints sampled at
+// the times evaluated so far, shared by every mesh and every evaluation of it
+struct SFBXAnimCache {
+    std::weak_ptr<NodeTree> nodeTree;
+    std::vector<SFBXJoint> joints;
+    std::unordered_map<std::string, int> pathIndex;
+    std::unordered_map<std::string, int> nameIndex;     // the last joint of each name
+
+    static constexpr size_t maxSamples = 256;
+    std::mutex mtx;
+    std::map<float, std::shared_ptr<const std::vector<aiMatrix4x4>>> samples;
+
+    static std::shared_ptr<SFBXAnimCache> of(std::shared_ptr<NodeTree> const &nodeTree,
+                                             std::shared_ptr<BoneTree> const &boneTree) {
+        return boneTree->animCache.get([&] (SFBXAnimCache &cache) {
+            return cache.nodeTree.lock() == nodeTree;
+        }, [&] {
+            auto cache = std::make_shared<SFBXAnimCache>();
+            cache->nodeTree = nodeTree;
+            cache->addJoint(*nodeTree, -1, "", *boneTree);
+            return cache;
+        });
+    }
+
+    void addJoint(const NodeTree &node, int parent, std::string const &parentPath, const BoneTree &boneTree) {
+        int index = joints.size();
+        auto it = boneTree.AnimBoneMap.find(node.name);
+        SFBXJoint joint{node.name, parentPath + "/" + node.name, parent, node.transformation,
+                        it == boneTree.AnimBoneMap.end() ? nullptr : &it->second};
+        pathIndex[joint.path] = index;
+        nameIndex[joint.name] = index;
+        joints.push_back(std::move(joint));
+        for (int i = 0; i < node.childrenCount; i++)
+            addJoint(node.children[i], index, joints[index].path, boneTree);
+    }
+
+    // global transforms of the joints at animationTime
+    std::shared_ptr<const std::vector<aiMatrix4x4>> sample(float animationTime) {
+        {
+            std::lock_guard lck(mtx);
+            auto it = samples.find(animationTime);
+            if (it != samples.end())
+                return it->second;
+        }
+        auto globals = std::make_shared<std::vector<aiMatrix4x4>>(joints.size());
+        for (size_t i = 0; i < joints.size(); i++) {
+            auto &joint = joints[i];
+            aiMatrix4x4 nodeTransform = joint.animBone ? joint.animBone->evaluate(animationTime) : joint.transformation;
+            (*globals)[i] = joint.parent < 0 ? nodeTransform : (*globals)[joint.parent] * nodeTransform;
+        }
+        std::lock_guard lck(mtx);
+        if (samples.size() >= maxSamples)
+            samples.clear();
+        return samples.emplace(animationTime, std::move(globals)).first->second;
+    }
 };
 
 struct AnimInfo : zeno::IObjectClone<AnimInfo>{
@@ -646,6 +753,83 @@ struct FBXData : zeno::IObjectClone<FBXData>{
     std::shared_ptr<BoneTree> boneTree;
     std::shared_ptr<NodeTree> nodeTree;
     std::shared_ptr<AnimInfo> animInfo;
+
+    SFBXCacheRef<SFBXMeshCache> meshCache;
+};
+
+// the bones and the bone influences of a mesh resolved against the joints of its archive
+struct SFBXMeshCache {
+    std::weak_ptr<SFBXAnimCache> anim;
+
+    // the bones, by the names in the bone offsets and in SVertex::boneWeights
+    std::vector<std::string> boneNames;
+    std::vector<int> boneJoint;             // -1 if no joint has an offset for the bone
+    std::vector<aiMatrix4x4> boneOffset;
+
+    // influences of vertex i are [influenceStart[i], influenceStart[i+1]), in the order of its boneWeights
+    std::vector<int> influenceStart;
+    std::vector<int> influenceBone;
+    std::vector<int> influenceJoint;        // the joint named as the bone, 0 if none
+    std::vector<float> influenceWeight;
+
+    // the last joint whose path contains the name of each camera
+    std::unordered_map<std::string, int> cameraJoint;
+
+    static std::shared_ptr<SFBXMeshCache> of(std::shared_ptr<SFBXAnimCache> const &anim, FBXData &fbxData) {
+        return fbxData.meshCache.get([&] (SFBXMeshCache &cache) {
+            return cache.anim.lock() == anim;
+        }, [&] {
+            auto cache = std::make_shared<SFBXMeshCache>();
+            cache->build(anim, fbxData);
+            return cache;
+        });
+    }
+
+    void build(std::shared_ptr<SFBXAnimCache> const &animCache, FBXData const &fbxData) {
+        anim = animCache;
+        auto &joints = animCache->joints;
+        std::unordered_map<std::string, int> boneIndex;
+        auto boneOf = [&] (std::string const &name) {
+            auto [it, fresh] = boneIndex.try_emplace(name, (int)boneNames.size());
+            if (fresh) {
+                boneNames.push_back(name);
+                boneJoint.push_back(-1);
+                boneOffset.emplace_back();
+            }
+            return it->second;
+        };
+
+        auto &offsets = fbxData.iBoneOffset.value;
+        for (size_t i = 0; i < joints.size(); i++) {
+            auto it = offsets.find(joints[i].name);
+            if (it != offsets.end()) {
+                int b = boneOf(it->second.name);
+                boneJoint[b] = i;
+                boneOffset[b] = it->second.offset;
+            }
+        }
+
+        auto &vertices = fbxData.iVertices.value;
+        influenceStart.reserve(vertices.size() + 1);
+        influenceStart.push_back(0);
+        for (auto const &v: vertices) {
+            for (auto const &[name, weight]: v.boneWeights) {
+                auto it = animCache->nameIndex.find(name);
+                influenceBone.push_back(boneOf(name));
+                influenceJoint.push_back(it == animCache->nameIndex.end() ? 0 : it->second);
+                influenceWeight.push_back(weight);
+            }
+            influenceStart.push_back(influenceBone.size());
+        }
+
+        for (auto const &[camName, cam]: fbxData.iCamera.value) {
+            int found = -1;
+            for (size_t i = 0; i < joints.size(); i++)
+                if (joints[i].path.find(camName) != std::string::npos)
+                    found = i;
+            cameraJoint[camName] = found;
+        }
+    }
 };
 
 struct IFBXData : zeno::IObjectClone<IFBXData>{
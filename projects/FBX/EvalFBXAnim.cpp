@@ -7,6 +7,7 @@
 #include <zeno/types/DictObject.h>
 #include <zeno/types/CameraObject.h>
 #include <zeno/types/UserData.h>
+#include <zeno/para/parallel_for.h>
 
 #include "assimp/scene.h"
 
@@ -26,43 +27,28 @@ struct EvalAnim{
     float m_DeltaTime;
 
     SFBXEvalOption m_evalOption;
-    NodeTree m_RootNode;
     SFBXData m_FbxData;
     AnimInfo m_animInfo;
-    IMeshName m_meshName;
-    IPathName m_pathName;
-    IPathTrans m_PathTrans;
+    std::shared_ptr<FBXData> m_Data;
 
-    std::unordered_map<std::string, aiMatrix4x4> m_BoneTransforms;
-    std::unordered_map<std::string, aiMatrix4x4> m_LazyTransforms;
-    std::unordered_map<std::string, SBoneOffset> m_BoneOffset;
-    std::unordered_map<std::string, SAnimBone> m_AnimBones;
+    std::shared_ptr<SFBXAnimCache> m_Anim;
+    std::shared_ptr<SFBXMeshCache> m_Mesh;
 
-    std::vector<SVertex> m_Vertices;
-    std::vector<unsigned int> m_IndicesTris;
-    std::vector<unsigned int> m_IndicesLoops;
-    std::vector<zeno::vec2i> m_IndicesPolys;
-
-    std::unordered_map<std::string, int> m_JointCorrespondingIndex;
+    // global transforms of m_Anim->joints at m_CurrentFrame
+    std::shared_ptr<const std::vector<aiMatrix4x4>> m_Globals;
+    // global transform * bone offset, of each of m_Mesh->boneNames
+    std::vector<aiMatrix4x4> m_BoneTransforms;
 
     void initAnim(std::shared_ptr<NodeTree>& nodeTree,
                   std::shared_ptr<BoneTree>& boneTree,
                   std::shared_ptr<FBXData>& fbxData,
                   std::shared_ptr<AnimInfo>& animInfo){
         m_animInfo = *animInfo;
+        m_Data = fbxData;
 
-        m_Vertices = fbxData->iVertices.value;
-        m_IndicesTris = fbxData->iIndices.valueTri;
-        m_IndicesPolys = fbxData->iIndices.valuePolys;
-        m_IndicesLoops = fbxData->iIndices.valueLoops;
-
-        m_meshName = fbxData->iMeshName;
-        m_pathName = fbxData->iPathName;
-        m_PathTrans = fbxData->iPathTrans;
-
-        m_RootNode = *nodeTree;
-        m_AnimBones = boneTree->AnimBoneMap;
-        m_BoneOffset = fbxData->iBoneOffset.value;
+        // flattened once per archive and resolved once per mesh, see Definition.h
+        m_Anim = SFBXAnimCache::of(nodeTree, boneTree);
+        m_Mesh = SFBXMeshCache::of(m_Anim, *fbxData);
 
         m_CurrentFrame = 0.0f;
     }
@@ -80,20 +66,20 @@ struct EvalAnim{
         //ED_COUT << "FBX: FrameID " << fi << " Tick " << m_animInfo.tick << " DeltaTime " << dt << std::endl;
 
         if(m_evalOption.writeData){
-            expandBoneTransform(&m_RootNode, "", aiMatrix4x4());
+            expandBoneTransform();
             calculateMaxBoneInfluence();
 
             for(float s = m_animInfo.minTimeStamp; s<=m_animInfo.maxTimeStamp; s+=1.0f){
                 //std::cout << "FBX: Calculate Anim Transform Time " << s << std::endl;
-                calculateAnimTransform(&m_RootNode, s);
+                calculateAnimTransform(s);
             }
         }
 
         if(m_evalOption.printAnimData) {
-            std::cout << "----- >" << m_pathName.value << "\n";
+            std::cout << "----- >" << m_Data->iPathName.value << "\n";
         }
 //        TIMER_START(UpdateAnim_CalcTrans)
-        calculateBoneTransform(&m_RootNode, aiMatrix4x4(), "");
+        calculateBoneTransform();
 //        TIMER_END(UpdateAnim_CalcTrans)
 
 //        TIMER_START(UpdateAnim_CalcPrim)
@@ -101,7 +87,7 @@ struct EvalAnim{
 //        TIMER_END(UpdateAnim_CalcPrim)
 
         if(m_evalOption.printAnimData) {
-            std::cout << "===== <" << m_pathName.value << "\n";
+            std::cout << "===== <" << m_Data->iPathName.value << "\n";
         }
     }
 
@@ -109,12 +95,13 @@ struct EvalAnim{
                             std::shared_ptr<zeno::DictObject> &r,
                             std::shared_ptr<zeno::DictObject> &s){
 
-        for(auto& m:m_BoneTransforms){
-            //zeno::log_info("A {}", m.first);
+        for(size_t b = 0; b < m_BoneTransforms.size(); b++){
+            auto& boneName = m_Mesh->boneNames[b];
+            //zeno::log_info("A {}", boneName);
             aiVector3t<float> trans;
             aiQuaterniont<float> rotate;
             aiVector3t<float> scale;
-            m.second.Decompose(scale, rotate, trans);
+            m_BoneTransforms[b].Decompose(scale, rotate, trans);
             //zeno::log_info("    T {: f} {: f} {: f}", trans.x, trans.y, trans.z);
             //zeno::log_info("    R {: f} {: f} {: f} {: f}", rotate.x, rotate.y, rotate.z, rotate.w);
             //zeno::log_info("    S {: f} {: f} {: f}", scale.x, scale.y, scale.z);
@@ -128,120 +115,80 @@ struct EvalAnim{
             auto ns = std::make_shared<zeno::NumericObject>();
             ns->value = zeno::vec3f(scale.x, scale.y, scale.z);
 
-            t->lut[m.first] = nt;
-            r->lut[m.first] = nr;
-            s->lut[m.first] = ns;
+            t->lut[boneName] = nt;
+            r->lut[boneName] = nr;
+            s->lut[boneName] = ns;
         }
     }
 
     void calculateMaxBoneInfluence(){
-        for(unsigned int i=0; i<m_Vertices.size(); i++) {
-            int s = m_Vertices[i].boneWeights.size();
+        auto& start = m_Mesh->influenceStart;
+        for(size_t i=0; i+1<start.size(); i++) {
+            int s = start[i+1] - start[i];
             m_FbxData.jointIndices_elementSize = std::max(s, m_FbxData.jointIndices_elementSize);
         }
         //std::cout << "FBX: MaxJointInfluence " << m_FbxData.jointIndices_elementSize << std::endl;
     }
 
-    void calculateAnimTransform(const NodeTree *node, float timeCode){
-        std::string nodeName = node->name;
-        aiVector3t<float> trans{0.0f,0.0f,0.0f};
-        aiQuaterniont<float> rotate;
-        aiVector3t<float> scale{1.0f,1.0f,1.0f};
-
-        if (m_AnimBones.find(nodeName) != m_AnimBones.end()) {
-            auto& bone = m_AnimBones[nodeName];
-            bone.update(timeCode);
-            bone.m_LocalTransform.Decompose(scale, rotate, trans);
-        }
+    void calculateAnimTransform(float timeCode){
+        auto& rotations = m_FbxData.rotations_timeSamples[timeCode];
+        auto& translations = m_FbxData.translations_timeSamples[timeCode];
+        auto& scales = m_FbxData.scales_timeSamples[timeCode];
 
-        m_FbxData.rotations_timeSamples[timeCode].emplace_back(rotate.x,rotate.y,rotate.z,rotate.w);
-        m_FbxData.translations_timeSamples[timeCode].emplace_back(trans.x,trans.y,trans.z);
-        m_FbxData.scales_timeSamples[timeCode].emplace_back(scale.x,scale.y,scale.z);
+        for(auto& joint: m_Anim->joints){
+            aiVector3t<float> trans{0.0f,0.0f,0.0f};
+            aiQuaterniont<float> rotate;
+            aiVector3t<float> scale{1.0f,1.0f,1.0f};
 
-        for (int i = 0; i < node->childrenCount; i++)
-            calculateAnimTransform(&node->children[i], timeCode);
-    }
+            if (joint.animBone) {
+                joint.animBone->evaluate(timeCode).Decompose(scale, rotate, trans);
+            }
 
-    void expandBoneTransform(const NodeTree *node, std::string pPath, aiMatrix4x4 parentTransform) {
-        std::string nodeName = node->name;
-        std::string cName;
-        pPath.empty() ? cName = nodeName : cName = pPath + "/" + nodeName;
-        aiMatrix4x4 nodeTransform = node->transformation;
-
-        m_FbxData.joints.push_back(cName);
-        m_FbxData.jointNames.push_back(nodeName);
-        m_JointCorrespondingIndex[nodeName] = m_FbxData.joints.size()-1;
-        //std::cout << "FBX: Bone name " << nodeName << " " << cName << " " << m_FbxData.joints.size() << std::endl;
-
-        aiMatrix4x4 globalTransformation = parentTransform * nodeTransform;
-        m_FbxData.restTransforms.push_back(globalTransformation);
-        m_FbxData.bindTransforms.push_back(nodeTransform);
-
-        if (m_BoneOffset.find(nodeName) != m_BoneOffset.end()) {  // found
-            std::string boneName = m_BoneOffset[nodeName].name;
-            aiMatrix4x4 boneOffset = m_BoneOffset[nodeName].offset;
-            m_BoneTransforms[boneName] = globalTransformation * boneOffset;
+            rotations.emplace_back(rotate.x,rotate.y,rotate.z,rotate.w);
+            translations.emplace_back(trans.x,trans.y,trans.z);
+            scales.emplace_back(scale.x,scale.y,scale.z);
         }
-
-        for (int i = 0; i < node->childrenCount; i++)
-            expandBoneTransform(&node->children[i], cName, globalTransformation);
     }
 
-    void calculateBoneTransform(const NodeTree *node, aiMatrix4x4 parentTransform, std::string parent_path) {
-        std::string nodeName = node->name;
-        aiMatrix4x4 nodeTransform = node->transformation;
-        auto pathName = parent_path + "/" + nodeName;
-
-        if(m_evalOption.printAnimData) {
-            std::cout << "---------- ---------- ----------\n";
-            std::cout << "FBX: ***** Node Name " << nodeName << std::endl;
-            Helper::printAiMatrix(nodeTransform);
-            std::cout << "++++++++++ ++++++++++ ++++++++++\n";
-            Helper::printAiMatrix(parentTransform);
-            std::cout << "---------- ---------- ----------\n";
+    // the joints in rest pose, in the order of m_Anim->joints
+    void expandBoneTransform() {
+        auto& joints = m_Anim->joints;
+        std::vector<aiMatrix4x4> globals(joints.size());
+        for(size_t i = 0; i < joints.size(); i++){
+            auto& joint = joints[i];
+            globals[i] = joint.parent < 0 ? joint.transformation : globals[joint.parent] * joint.transformation;
+
+            m_FbxData.joints.push_back(joint.path.substr(1));
+            m_FbxData.jointNames.push_back(joint.name);
+            m_FbxData.restTransforms.push_back(globals[i]);
+            m_FbxData.bindTransforms.push_back(joint.transformation);
+            //std::cout << "FBX: Bone name " << joint.name << " " << joint.path << " " << m_FbxData.joints.size() << std::endl;
         }
+    }
 
-        // Any object that just has the key-anim is a bone
-        if (m_AnimBones.find(nodeName) != m_AnimBones.end()) {
-            auto& bone = m_AnimBones[nodeName];
-
-            bone.update(m_CurrentFrame);
-            nodeTransform = bone.m_LocalTransform;
-
-            if(m_evalOption.printAnimData) {
-                std::cout << "FBX: Anim Node Name " << nodeName << std::endl;
-                //Helper::printAiMatrix(nodeTransform);
-            }
-        }
-        aiMatrix4x4 globalTransformation = parentTransform * nodeTransform;
+    void calculateBoneTransform() {
+        // Any object that just has the key-anim is a bone, sampled once per archive and time
+        m_Globals = m_Anim->sample(m_CurrentFrame);
+        auto& globals = *m_Globals;
 
         // XXX Lazy Transform
-        if (m_BoneOffset.find(nodeName) != m_BoneOffset.end()) {  // found
-            std::string boneName = m_BoneOffset[nodeName].name;
-            aiMatrix4x4 boneOffset = m_BoneOffset[nodeName].offset;
-
-            if(m_evalOption.printAnimData) {
-                std::cout << "FBX: Bone Node Name " << nodeName << std::endl;
-                //Helper::printAiMatrix(boneOffset);
-            }
-
-            m_BoneTransforms[boneName] = globalTransformation * boneOffset;
-            if(m_evalOption.printAnimData) {
-                //std::cout << "FBX: Transform " << boneName << "\n";
-                //Helper::printAiMatrix(m_BoneTransforms[boneName]);
-            }
+        m_BoneTransforms.resize(m_Mesh->boneNames.size());
+        for(size_t b = 0; b < m_BoneTransforms.size(); b++){
+            int j = m_Mesh->boneJoint[b];
+            m_BoneTransforms[b] = j < 0 ? aiMatrix4x4() : globals[j] * m_Mesh->boneOffset[b];
         }
 
-            // The child is already applied the parent transformation by the tree struct.
-            m_LazyTransforms[pathName] = globalTransformation;
-
-            if(m_evalOption.printAnimData) {
-                std::cout << std::fixed << "FBX: Lazy Node Name " << nodeName << std::endl;
-                Helper::printAiMatrix(globalTransformation);
+        if(m_evalOption.printAnimData) {
+            for(size_t i = 0; i < m_Anim->joints.size(); i++){
+                auto& joint = m_Anim->joints[i];
+                std::cout << "---------- ---------- ----------\n";
+                std::cout << "FBX: ***** Node Name " << joint.name << std::endl;
+                if(joint.animBone)
+                    std::cout << "FBX: Anim Node Name " << joint.name << std::endl;
+                std::cout << std::fixed << "FBX: Lazy Node Name " << joint.name << std::endl;
+                Helper::printAiMatrix(globals[i]);
             }
-
-        for (int i = 0; i < node->childrenCount; i++)
-            calculateBoneTransform(&node->children[i], globalTransformation, pathName);
+        }
     }
 
     void updateCameraAndLight(std::shared_ptr<FBXData>& fbxData,
@@ -250,35 +197,34 @@ struct EvalAnim{
     {
         float gscale = m_evalOption.globalScale;
         // TODO We didn't consider that the camera might be in the hierarchy
-        for(auto& ltrans: m_LazyTransforms){
-            auto namePath = ltrans.first;
+        for(auto &[camName, camObj]: fbxData->iCamera.value){
+            auto it = m_Mesh->cameraJoint.find(camName);
+            if(it == m_Mesh->cameraJoint.end() || it->second < 0)
+                continue;
 
-            for(auto &[camName, camObj]: fbxData->iCamera.value){
-                if(namePath.find(camName) != std::string::npos){
+            SCamera cam = camObj;
 
-                    SCamera cam = fbxData->iCamera.value.at(camName);
-
-                    aiVector3t<float> trans;
-                    aiQuaterniont<float> rotate;
-                    aiVector3t<float> scale;
+            aiVector3t<float> trans;
+            aiQuaterniont<float> rotate;
+            aiVector3t<float> scale;
 
-                    ltrans.second.Decompose(scale, rotate, trans);
+            (*m_Globals)[it->second].Decompose(scale, rotate, trans);
 
-                    cam.pos = zeno::vec3f(trans.x * gscale, trans.y * gscale, trans.z * gscale);
-                    aiMatrix3x3 r = rotate.GetMatrix().Transpose();
-                    cam.view = zeno::vec3f(r.a1, r.a2, r.a3);
-                    cam.up = zeno::vec3f(r.b1, r.b2, r.b3);
+            cam.pos = zeno::vec3f(trans.x * gscale, trans.y * gscale, trans.z * gscale);
+            aiMatrix3x3 r = rotate.GetMatrix().Transpose();
+            cam.view = zeno::vec3f(r.a1, r.a2, r.a3);
+            cam.up = zeno::vec3f(r.b1, r.b2, r.b3);
 
-                    iCamera->value[camName] = cam;
-                }
-            }
+            iCamera->value[camName] = cam;
         }
     }
 
     void getPathTrans(std::string pathName, glm::mat4& pathTrans, int& tranType){
 
-        if(m_LazyTransforms.find(pathName) != m_LazyTransforms.end()){
-            auto& tr = m_LazyTransforms[pathName];
+        auto lazy = m_Anim->pathIndex.find(pathName);
+        auto path = m_Data->iPathTrans.value.find(pathName);
+        if(lazy != m_Anim->pathIndex.end()){
+            auto& tr = (*m_Globals)[lazy->second];
             pathTrans = glm::mat4(tr.a1,tr.b1,tr.c1,tr.d1,
                                   tr.a2,tr.b2,tr.c2,tr.d2,
                                   tr.a3,tr.b3,tr.c3,tr.d3,
@@ -290,8 +236,8 @@ struct EvalAnim{
             }
             tranType = 0;
 
-        }else if(m_PathTrans.value.find(pathName) != m_PathTrans.value.end()) {
-            auto& tr = m_PathTrans.value[pathName];
+        }else if(path != m_Data->iPathTrans.value.end()) {
+            auto& tr = path->second;
             pathTrans = glm::mat4(tr.a1,tr.b1,tr.c1,tr.d1,
                                   tr.a2,tr.b2,tr.c2,tr.d2,
                                   tr.a3,tr.b3,tr.c3,tr.d3,
@@ -310,6 +256,14 @@ struct EvalAnim{
     }
 
     void calculateFinal(std::shared_ptr<zeno::PrimitiveObject>& prim){
+        auto &vertices = m_Data->iVertices.value;
+        auto &indicesTris = m_Data->iIndices.valueTri;
+        auto &indicesLoops = m_Data->iIndices.valueLoops;
+        auto &indicesPolys = m_Data->iIndices.valuePolys;
+
+        // sized up front, the vertices are filled in parallel
+        prim->verts.resize(vertices.size());
+        prim->uvs.resize(vertices.size());
         auto &ver = prim->verts;
         auto &trisInd = prim->tris;
         auto &polys = prim->polys;
@@ -327,71 +281,62 @@ struct EvalAnim{
         //std::cout << "Eval name: " << m_pathName.value << "\n";
         //std::cout << "Eval name: " << m_pathName.value_oriPath << "\n";
 
-        if(m_IndicesLoops.size() == 0){
+        if(indicesLoops.size() == 0){
             isTris = true;
         }else{
             isTris = false;
         }
-        //std::cout << "mesh size loops " << m_IndicesLoops.size() << " tris " << m_IndicesTris.size() << " is tris " << isTris <<"\n";
-        for(int i=0;i<m_FbxData.jointIndices_elementSize;i++){
-            prim->verts.add_attr<float>("jointIndice_" + std::to_string(i));
-            prim->verts.add_attr<float>("jointWeight_" + std::to_string(i));
-        }
+        //std::cout << "mesh size loops " << indicesLoops.size() << " tris " << indicesTris.size() << " is tris " << isTris <<"\n";
         int elemSize = m_FbxData.jointIndices_elementSize;
+        std::vector<float *> jointIndice(elemSize), jointWeight(elemSize);
+        for(int i=0;i<elemSize;i++){
+            jointIndice[i] = prim->verts.add_attr<float>("jointIndice_" + std::to_string(i)).data();
+            jointWeight[i] = prim->verts.add_attr<float>("jointWeight_" + std::to_string(i)).data();
+        }
         prim->userData().set2("jointIndicesElementSize", elemSize);
         float gscale = m_evalOption.globalScale;
 
         // Trans
-        auto pathName = m_pathName.value_oriPath;
+        auto pathName = m_Data->iPathName.value_oriPath;
         glm::mat4 pathTrans(1.0);
         int tranType = -1;
         if(pathName != "/__path__") {
             getPathTrans(pathName, pathTrans, tranType);
         }
 
-        for(unsigned int i=0; i<m_Vertices.size(); i++){
-            auto& bwe = m_Vertices[i].boneWeights;
-            auto& pos = m_Vertices[i].position;
-            auto& uvw = m_Vertices[i].texCoord;
-            auto& nor = m_Vertices[i].normal;
-            auto& vco = m_Vertices[i].vectexColor;
+        std::vector<glm::mat4> boneTrans(m_BoneTransforms.size());
+        for(size_t b=0; b<m_BoneTransforms.size(); b++){
+            auto& tr = m_BoneTransforms[b];
+            boneTrans[b] = glm::mat4(tr.a1,tr.b1,tr.c1,tr.d1,
+                                     tr.a2,tr.b2,tr.c2,tr.d2,
+                                     tr.a3,tr.b3,tr.c3,tr.d3,
+                                     tr.a4,tr.b4,tr.c4,tr.d4);
+        }
 
-//            auto& exi = m_Vertices[i].extraInfos;
-//            if(pathName == "/__path__") {
-//                getPathTrans(exi["path"], pathTrans, tranType);
-//            }
+        auto& mesh = *m_Mesh;
+        zeno::parallel_for(vertices.size(), [&] (size_t i) {
+            auto& pos = vertices[i].position;
+            auto& uvw = vertices[i].texCoord;
+            auto& nor = vertices[i].normal;
+            auto& vco = vertices[i].vectexColor;
 
             glm::vec4 tpos(0.0f, 0.0f, 0.0f, 0.0f);
 
             bool boneInflued = false;
-            int bCount = 0;
             // Influence
-            for(auto& b: bwe){
-                // e.g. b.first -> joint1
+            for(int k = mesh.influenceStart[i]; k < mesh.influenceStart[i+1]; k++){
+                int bCount = k - mesh.influenceStart[i];
+                float w = mesh.influenceWeight[k];
                 if(elemSize){
-                    float bIndex = (float)m_JointCorrespondingIndex[b.first];
-                    prim->verts.attr<float>("jointIndice_" + std::to_string(bCount)).push_back(bIndex);
-                    prim->verts.attr<float>("jointWeight_" + std::to_string(bCount)).push_back(b.second);
+                    jointIndice[bCount][i] = (float)mesh.influenceJoint[k];
+                    jointWeight[bCount][i] = w;
                 }
-                //std::cout << "FBX: Vert " << i << " name " << b.first << " bIndex " << bIndex << std::endl;
                 boneInflued = true;
-                auto& tr = m_BoneTransforms[b.first];
-                glm::mat4 trans = glm::mat4(tr.a1,tr.b1,tr.c1,tr.d1,
-                                            tr.a2,tr.b2,tr.c2,tr.d2,
-                                            tr.a3,tr.b3,tr.c3,tr.d3,
-                                            tr.a4,tr.b4,tr.c4,tr.d4);
+                glm::vec4 lpos = boneTrans[mesh.influenceBone[k]] * glm::vec4(pos.x, pos.y, pos.z, 1.0f);
 
-                glm::vec4 lpos = trans * glm::vec4(pos.x, pos.y, pos.z, 1.0f);
-
-                tpos += lpos * b.second;
-                bCount += 1;
-            }
-
-            // Supplement, joint index supplement 0, weight 0
-            for(int z=bCount; z<m_FbxData.jointIndices_elementSize; z++){
-                prim->verts.attr<float>("jointIndice_" + std::to_string(bCount)).push_back(0);
-                prim->verts.attr<float>("jointWeight_" + std::to_string(bCount)).push_back(0.0f);
+                tpos += lpos * w;
             }
+            // the rest of the joint slots stay index 0, weight 0
 
             // TODO (Bone Influence) Skeleton + Transform
             //  If remove follow `if`, we will get full transform animation, but the skel animation is gone
@@ -401,26 +346,26 @@ struct EvalAnim{
 
             glm::vec3 fpos = glm::vec3(tpos.x/tpos.w, tpos.y/tpos.w, tpos.z/tpos.w);
 
-            ver.emplace_back(fpos.x * gscale, fpos.y * gscale, fpos.z * gscale);
-            posb.emplace_back(0.0f, 0.0f, 0.0f);
-            uvs.emplace_back(uvw.x, uvw.y, uvw.z);
-            uv.emplace_back(uvw.x, uvw.y, uvw.z);
-            norm.emplace_back(nor.x, nor.y, nor.z);
-            clr0.emplace_back(vco.r, vco.g, vco.b);
-        }
+            ver[i] = zeno::vec3f(fpos.x * gscale, fpos.y * gscale, fpos.z * gscale);
+            posb[i] = zeno::vec3f(0.0f, 0.0f, 0.0f);
+            uvs[i] = zeno::vec2f(uvw.x, uvw.y);
+            uv[i] = zeno::vec3f(uvw.x, uvw.y, uvw.z);
+            norm[i] = zeno::vec3f(nor.x, nor.y, nor.z);
+            clr0[i] = zeno::vec3f(vco.r, vco.g, vco.b);
+        });
 
         if(isTris) {
-            for (unsigned int i = 0; i < m_IndicesTris.size(); i += 3) {
-                zeno::vec3i incs(m_IndicesTris[i], m_IndicesTris[i + 1], m_IndicesTris[i + 2]);
+            for (unsigned int i = 0; i < indicesTris.size(); i += 3) {
+                zeno::vec3i incs(indicesTris[i], indicesTris[i + 1], indicesTris[i + 2]);
                 trisInd.push_back(incs);
             }
             uvs.clear();
         }else{
-            for (unsigned int i = 0; i < m_IndicesLoops.size(); i ++) {
-                loops.emplace_back(m_IndicesLoops[i]);
+            for (unsigned int i = 0; i < indicesLoops.size(); i ++) {
+                loops.emplace_back(indicesLoops[i]);
             }
-            for (unsigned int i = 0; i < m_IndicesPolys.size(); i ++) {
-                polys.emplace_back(m_IndicesPolys[i]);
+            for (unsigned int i = 0; i < indicesPolys.size(); i ++) {
+                polys.emplace_back(indicesPolys[i]);
             }
             uv.clear();
         }
@@ -434,9 +379,9 @@ struct EvalAnim{
                 unsigned int _i1 = trisInd[i][0];
                 unsigned int _i2 = trisInd[i][1];
                 unsigned int _i3 = trisInd[i][2];
-                uv0[i] = zeno::vec3f(m_Vertices[_i1].texCoord[0], m_Vertices[_i1].texCoord[1], 0);
-                uv1[i] = zeno::vec3f(m_Vertices[_i2].texCoord[0], m_Vertices[_i2].texCoord[1], 0);
-                uv2[i] = zeno::vec3f(m_Vertices[_i3].texCoord[0], m_Vertices[_i3].texCoord[1], 0);
+                uv0[i] = zeno::vec3f(vertices[_i1].texCoord[0], vertices[_i1].texCoord[1], 0);
+                uv1[i] = zeno::vec3f(vertices[_i2].texCoord[0], vertices[_i2].texCoord[1], 0);
+                uv2[i] = zeno::vec3f(vertices[_i3].texCoord[0], vertices[_i3].texCoord[1], 0);
             }
         }else{
             // Crash
@@ -738,4 +683,68 @@ ZENDEFNODE(EvalFBXAnim,
                }
            });
 
+// the skinned prims of many meshes (e.g. the agents of a crowd) at many frames,
+// evaluated in parallel. meshes of the same archive share its sampled joints
+struct EvalFBXAnimBatch : zeno::INode {
+
+    virtual void apply() override {
+        std::vector<std::shared_ptr<FBXData>> datas;
+        auto data = get_input("data");
+        if (auto list = std::dynamic_pointer_cast<zeno::ListObject>(data)) {
+            datas = list->get<FBXData>();
+        } else {
+            datas.push_back(zeno::safe_dynamic_cast<FBXData>(data));
+        }
+        std::vector<int> frameids;
+        if (has_input("frameids")) {
+            for (auto const &f: get_input<zeno::ListObject>("frameids")->get<zeno::NumericObject>())
+                frameids.push_back(f->get<int>());
+        } else {
+            frameids.push_back(getGlobalState()->frameid);
+        }
+
+        SFBXEvalOption evalOption;
+        evalOption.globalScale = get_param<std::string>("unit") == "FROM_MAYA" ? 0.01f : 1.0f;
+        evalOption.interAnimData = true;
+
+        for (auto const &fbxData: datas) {
+            if(fbxData->nodeTree == nullptr || fbxData->boneTree == nullptr || fbxData->animInfo == nullptr){
+                zeno::log_error("FBX: Empty NodeTree, BoneTree or AnimInfo");
+                throw zeno::makeError("Empty FBX Data");
+            }
+        }
+
+        // mesh major: all the frames of datas[0], then of datas[1], ...
+        std::vector<std::shared_ptr<zeno::PrimitiveObject>> prims(datas.size() * frameids.size());
+        zeno::parallel_for(prims.size(), [&] (size_t i) {
+            auto &fbxData = datas[i / frameids.size()];
+            auto prim = std::make_shared<zeno::PrimitiveObject>();
+            EvalAnim anim;
+            anim.m_evalOption = evalOption;
+            anim.initAnim(fbxData->nodeTree, fbxData->boneTree, fbxData, fbxData->animInfo);
+            anim.updateAnimation(frameids[i % frameids.size()], prim);
+            prims[i] = std::move(prim);
+        });
+
+        auto list = std::make_shared<zeno::ListObject>();
+        list->arr.assign(prims.begin(), prims.end());
+        set_output("prims", std::move(list));
+    }
+};
+ZENDEFNODE(EvalFBXAnimBatch,
+           {       /* inputs: */
+               {
+                   "data", {"list", "frameids"},
+               },  /* outputs: */
+               {
+                   {"list", "prims", ""},
+               },  /* params: */
+               {
+                   {"enum FROM_MAYA DEFAULT", "unit", "FROM_MAYA"},
+               },  /* category: */
+               {
+                   "FBX",
+               }
+           });
+
 }
@@ -17,10 +17,10 @@ struct CFL : zeno::INode {
     {
       dx = get_input("Dx")->as<NumericObject>()->get<float>();
     }
-    float dt = FLIP_vdb::cfl(velocity->m_grid);
+    float dt = FLIP_vdb::cfl(velocity->grid());
     printf("CFL dt: %f\n", dt);
     auto out_dt = zeno::IObject::make<zeno::NumericObject>();
-    float scaling = dx / velocity->m_grid->voxelSize()[0];
+    float scaling = dx / velocity->grid()->voxelSize()[0];
     out_dt->set<float>(scaling * dt);
     set_output("cfl_dt", out_dt);
   }
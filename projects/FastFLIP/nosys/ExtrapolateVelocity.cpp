@@ -22,10 +22,11 @@ struct Vec3FieldExtrapolate : zeno::INode {
 		                            velocity->v[0],
 		                            velocity->v[1],
 		                            velocity->v[2],
-	  	                            &(liquidsdf->m_grid->tree()));
+	  	                            &(liquidsdf->grid()->tree()));
 #endif
         
-        vdb_velocity_extrapolator::extrapolate(n, velocity->m_grid);
+        vdb_velocity_extrapolator::extrapolate(n, velocity->grid());
+        velocity->markGridModified();
     }
 };
 
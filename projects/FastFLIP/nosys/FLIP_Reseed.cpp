@@ -10,8 +10,8 @@ struct FluidReseed : zeno::INode {
     auto particles = get_input("Particles")->as<VDBPointsGrid>();
     auto liquidSDF = get_input("LiquidSDF")->as<VDBFloatGrid>();
     auto liquidVel = get_input("FluidVel")->as<VDBFloat3Grid>();
-    FLIP_vdb::reseed_fluid(particles->m_grid, liquidSDF->m_grid,
-                           liquidVel->m_grid);
+    FLIP_vdb::reseed_fluid(particles->grid(), liquidSDF->grid(),
+                           liquidVel->grid());
   }
 };
 
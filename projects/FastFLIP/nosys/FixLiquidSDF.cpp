@@ -23,7 +23,7 @@ struct PushOutLiquidSDF : zeno::INode {
     auto liquid_sdf = get_input("LiquidSDF")->as<VDBFloatGrid>();
     auto solid_sdf = get_input("SolidSDF")->as<VDBFloatGrid>();
 
-    FLIP_vdb::immerse_liquid_phi_in_solids(liquid_sdf->m_grid, solid_sdf->m_grid,
+    FLIP_vdb::immerse_liquid_phi_in_solids(liquid_sdf->grid(), solid_sdf->grid(),
                                            dx);
   }
 };
@@ -29,19 +29,20 @@ struct G2P_Advector : zeno::INode {
 
     openvdb::FloatGrid::Ptr solid_sdf;
     if (has_input("SolidSDF"))
-      solid_sdf = get_input("SolidSDF")->as<VDBFloatGrid>()->m_grid;
+      solid_sdf = get_input("SolidSDF")->as<VDBFloatGrid>()->grid();
     else
       solid_sdf = nullptr;
 
     openvdb::Vec3fGrid::Ptr solid_vel;
     if (has_input("SolidVelocity"))
-      solid_vel = get_input("SolidVelocity")->as<VDBFloat3Grid>()->m_grid;
+      solid_vel = get_input("SolidVelocity")->as<VDBFloat3Grid>()->grid();
     else
       solid_vel = nullptr;
     auto velocity_after_p2g = get_input("PostAdvVelocity")->as<VDBFloat3Grid>();
 
-    FLIP_vdb::Advect(dt, dx, particles->m_grid, velocity->m_grid,
-                     velocity_after_p2g->m_grid, solid_sdf,
+    ZENO_SCOPE_TIMER("advect");
+    FLIP_vdb::Advect(dt, dx, particles->grid(), velocity->grid(),
+                     velocity_after_p2g->grid(), solid_sdf,
                      solid_vel, smoothness, RK_ORDER);
   }
 };
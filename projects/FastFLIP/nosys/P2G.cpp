@@ -22,22 +22,27 @@ struct FLIP_P2G : zeno::INode {
     auto PostP2GVelGrid = get_input("PostP2GVelocity")->as<VDBFloat3Grid>();
     auto LiquidSDFGrid = get_input("LiquidSDF")->as<VDBFloatGrid>();
 
-    packed_FloatGrid3 packed_VelGrid, packed_PostP2GVelGrid;
-    packed_VelGrid.from_vec3(VelGrid->m_grid);
-    packed_PostP2GVelGrid.from_vec3(PostP2GVelGrid->m_grid);
+    // both are overwritten, the packed copies then stay valid for the next FLIP nodes
+    auto &packed_VelGrid = VelGrid->usePackedGrid(true);
+    auto &packed_PostP2GVelGrid = PostP2GVelGrid->usePackedGrid(true);
 
-    FLIP_vdb::particle_to_grid_collect_style(
-        packed_VelGrid, packed_PostP2GVelGrid,
-        LiquidSDFGrid->m_grid, Particles->m_grid, dx);
-
-    vdb_velocity_extrapolator::union_extrapolate(n,
+    {
+      ZENO_SCOPE_TIMER("p2g");
+      FLIP_vdb::particle_to_grid_collect_style(
+          packed_VelGrid, packed_PostP2GVelGrid,
+          LiquidSDFGrid->grid(), Particles->grid(), dx);
+    }
+    {
+      ZENO_SCOPE_TIMER("extrapolate");
+      vdb_velocity_extrapolator::union_extrapolate(n,
 		                            packed_VelGrid.v[0],
 		                            packed_VelGrid.v[1],
 		                            packed_VelGrid.v[2],
-	  	                          &(LiquidSDFGrid->m_grid->tree()));
+	  	                          &(LiquidSDFGrid->grid()->tree()));
+    }
 
-    packed_VelGrid.to_vec3(VelGrid->m_grid);
-    packed_PostP2GVelGrid.to_vec3(PostP2GVelGrid->m_grid);
+    VelGrid->markPackedModified();
+    PostP2GVelGrid->markPackedModified();
   }
 };
 
@@ -17,7 +17,7 @@ struct ParticleEmitter : zeno::INode {
     openvdb::Vec3fGrid::Ptr velocityVolume = nullptr;
     if (has_input("VelocityVolume")) {
       if (!has_input<zeno::ConditionObject>("VelocityVolume")) {
-          velocityVolume = get_input("VelocityVolume")->as<VDBFloat3Grid>()->m_grid;
+          velocityVolume = get_input("VelocityVolume")->as<VDBFloat3Grid>()->grid();
       }
     }
 
@@ -28,10 +28,10 @@ struct ParticleEmitter : zeno::INode {
 
     openvdb::FloatGrid::Ptr liquid_sdf = nullptr;
     if (has_input("LiquidSDF")) {
-      liquid_sdf = get_input("LiquidSDF")->as<VDBFloatGrid>()->m_grid;
+      liquid_sdf = get_input("LiquidSDF")->as<VDBFloatGrid>()->grid();
     }
 
-    FLIP_vdb::emit_liquid(particles->m_grid, shape->m_grid,
+    FLIP_vdb::emit_liquid(particles->grid(), shape->grid(),
                           velocityVolume, liquid_sdf, vx, vy,
                           vz);
     set_output("Particles", get_input("Particles"));
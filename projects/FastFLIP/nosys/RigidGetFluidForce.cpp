@@ -251,8 +251,8 @@ struct RigidGetPressureForce : zeno::INode {
     }
     zeno::vec3f totalForce;
     zeno::vec3f totalTorc;
-    samplePressureForce(dt, pos, Pressure->m_grid, CellFWeight->m_grid,
-                        LiquidSDF->m_grid, massCenter, totalForce, totalTorc);
+    samplePressureForce(dt, pos, Pressure->grid(), CellFWeight->grid(),
+                        LiquidSDF->grid(), massCenter, totalForce, totalTorc);
     TotalForceImpulse->set<zeno::vec3f>(totalForce);
     TotalTorcImpulse->set<zeno::vec3f>(totalTorc);
     set_output("TotalForceImpulse", TotalForceImpulse);
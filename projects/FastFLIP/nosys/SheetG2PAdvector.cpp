@@ -33,22 +33,23 @@ struct G2PAdvectorSheet : zeno::INode {
     auto liquidsdf = get_input("LiquidSDF")->as<VDBFloatGrid>();
     openvdb::FloatGrid::Ptr solid_sdf;
     if (has_input("SolidSDF"))
-      solid_sdf = get_input("SolidSDF")->as<VDBFloatGrid>()->m_grid;
+      solid_sdf = get_input("SolidSDF")->as<VDBFloatGrid>()->grid();
     else
       solid_sdf = nullptr;
 
     openvdb::Vec3fGrid::Ptr solid_vel;
     if (has_input("SolidVelocity"))
-      solid_vel = get_input("SolidVelocity")->as<VDBFloat3Grid>()->m_grid;
+      solid_vel = get_input("SolidVelocity")->as<VDBFloat3Grid>()->grid();
     else
       solid_vel = nullptr;
     
     auto velocity_viscous = get_input("ViscousVelocity")->as<VDBFloat3Grid>();
     auto velocity_after_p2g = get_input("PostAdvVelocity")->as<VDBFloat3Grid>();
 
-    FLIP_vdb::AdvectSheetty(dt, dx, (float)surfaceSize * dx, particles->m_grid,
-                            liquidsdf->m_grid, velocity->m_grid, velocity_viscous->m_grid,
-                            velocity_after_p2g->m_grid, solid_sdf, solid_vel,
+    ZENO_SCOPE_TIMER("advect");
+    FLIP_vdb::AdvectSheetty(dt, dx, (float)surfaceSize * dx, particles->grid(),
+                            liquidsdf->grid(), velocity->grid(), velocity_viscous->grid(),
+                            velocity_after_p2g->grid(), solid_sdf, solid_vel,
                             smoothness_min, smoothness_max, RK_ORDER);
   }
 };
@@ -37,7 +37,7 @@ struct AssembleSolvePPE : zeno::INode {
 
     openvdb::FloatGrid::Ptr curvatureGrid = openvdb::FloatGrid::create();
     if(has_input("Curvature")) {
-      curvatureGrid = get_input("Curvature")->as<VDBFloatGrid>()->m_grid;
+      curvatureGrid = get_input("Curvature")->as<VDBFloatGrid>()->grid();
     }
     auto density = get_input("Density")->as<zeno::NumericObject>()->get<float>();
     auto tension_coef = get_input("SurfaceTension")->as<zeno::NumericObject>()->get<float>();
@@ -45,21 +45,23 @@ struct AssembleSolvePPE : zeno::INode {
 
 #if 0    
     FLIP_vdb::solve_pressure_simd(
-        liquid_sdf->m_grid, rhsgrid->m_grid,
-        curr_pressure->m_grid, face_weight->m_grid, velocity->m_grid,
-        solid_velocity->m_grid, dt, dx);
+        liquid_sdf->grid(), rhsgrid->grid(),
+        curr_pressure->grid(), face_weight->grid(), velocity->grid(),
+        solid_velocity->grid(), dt, dx);
 #endif
 
-    packed_FloatGrid3 packed_velocity;
-    packed_velocity.from_vec3(velocity->m_grid);
+    auto &packed_velocity = velocity->usePackedGrid();
         
-    FLIP_vdb::solve_pressure_simd_uaamg(
-        liquid_sdf->m_grid, curvatureGrid, rhsgrid->m_grid,
-        curr_pressure->m_grid, face_weight->m_grid,
-        packed_velocity, solid_velocity->m_grid,
-        density, tension_coef, enable_tension, dt, dx);
+    {
+      ZENO_SCOPE_TIMER("solve");
+      FLIP_vdb::solve_pressure_simd_uaamg(
+          liquid_sdf->grid(), curvatureGrid, rhsgrid->grid(),
+          curr_pressure->grid(), face_weight->grid(),
+          packed_velocity, solid_velocity->grid(),
+          density, tension_coef, enable_tension, dt, dx);
+    }
 
-    packed_velocity.to_vec3(velocity->m_grid);
+    velocity->markPackedModified();
 
   }
 };
@@ -40,19 +40,25 @@ struct SolveViscousTerm : zeno::INode {
         if (viscosity > eps) {
             auto viscosity_grid = openvdb::FloatGrid::create(viscosity);
 
-            packed_FloatGrid3 packed_velocity, packed_viscous_vel;
-            packed_velocity.from_vec3(velocity->m_grid);
-            packed_viscous_vel.from_vec3(velocity_viscous->m_grid);
-
-            FLIP_vdb::solve_viscosity(packed_velocity, packed_viscous_vel, liquid_sdf->m_grid, solid_sdf->m_grid,
-                                      solid_velocity->m_grid, viscosity_grid, density, dt);
-
-            vdb_velocity_extrapolator::union_extrapolate(n, packed_viscous_vel.v[0], packed_viscous_vel.v[1],
-                                                         packed_viscous_vel.v[2], &(liquid_sdf->m_grid->tree()));
-
-            packed_viscous_vel.to_vec3(velocity_viscous->m_grid);
+            auto &packed_velocity = velocity->usePackedGrid();
+            // the solve overwrites all of it
+            auto &packed_viscous_vel = velocity_viscous->usePackedGrid(true);
+
+            {
+                ZENO_SCOPE_TIMER("viscosity");
+                FLIP_vdb::solve_viscosity(packed_velocity, packed_viscous_vel, liquid_sdf->grid(), solid_sdf->grid(),
+                                          solid_velocity->grid(), viscosity_grid, density, dt);
+            }
+            {
+                ZENO_SCOPE_TIMER("extrapolate");
+                vdb_velocity_extrapolator::union_extrapolate(n, packed_viscous_vel.v[0], packed_viscous_vel.v[1],
+                                                             packed_viscous_vel.v[2], &(liquid_sdf->grid()->tree()));
+            }
+
+            velocity_viscous->markPackedModified();
         } else {
-            velocity_viscous->m_grid = velocity->m_grid->deepCopy();
+            // copies the packed grid too if it's newer, rather than unpacking it
+            *velocity_viscous = *velocity;
             velocity_viscous->setName("Velocity_Viscous");
         }
     }
@@ -95,17 +101,21 @@ struct SolveVariationalViscosity : zeno::INode {
         auto solid_sdf = get_input<VDBFloatGrid>("SolidSDF");
         auto solid_velocity = get_input<VDBFloat3Grid>("SolidVelocity");
 
-        packed_FloatGrid3 packed_velocity, packed_viscous_vel;
-        packed_velocity.from_vec3(velocity->m_grid);
-        packed_viscous_vel.from_vec3(velocity_viscous->m_grid);
+        auto &packed_velocity = velocity->usePackedGrid();
+        auto &packed_viscous_vel = velocity_viscous->usePackedGrid(true);
 
-        FLIP_vdb::solve_viscosity(packed_velocity, packed_viscous_vel, liquid_sdf->m_grid, solid_sdf->m_grid,
-                                  solid_velocity->m_grid, viscosity_grid->m_grid, density, dt);
-
-        vdb_velocity_extrapolator::union_extrapolate(n, packed_viscous_vel.v[0], packed_viscous_vel.v[1],
-                                                     packed_viscous_vel.v[2], &(liquid_sdf->m_grid->tree()));
+        {
+            ZENO_SCOPE_TIMER("viscosity");
+            FLIP_vdb::solve_viscosity(packed_velocity, packed_viscous_vel, liquid_sdf->grid(), solid_sdf->grid(),
+                                      solid_velocity->grid(), viscosity_grid->grid(), density, dt);
+        }
+        {
+            ZENO_SCOPE_TIMER("extrapolate");
+            vdb_velocity_extrapolator::union_extrapolate(n, packed_viscous_vel.v[0], packed_viscous_vel.v[1],
+                                                         packed_viscous_vel.v[2], &(liquid_sdf->grid()->tree()));
+        }
 
-        packed_viscous_vel.to_vec3(velocity_viscous->m_grid);
+        velocity_viscous->markPackedModified();
     }
 };
 
@@ -40,29 +40,33 @@ struct SubtractPressureGradient : zeno::INode {
 
     openvdb::FloatGrid::Ptr curvatureGrid = openvdb::FloatGrid::create();
     if(has_input("Curvature")) {
-      curvatureGrid = get_input("Curvature")->as<VDBFloatGrid>()->m_grid;
+      curvatureGrid = get_input("Curvature")->as<VDBFloatGrid>()->grid();
     }
     auto density = get_input("Density")->as<zeno::NumericObject>()->get<float>();
     auto tension_coef = get_input("SurfaceTension")->as<zeno::NumericObject>()->get<float>();
     bool enable_tension = tension_coef > 0? true : false;
 
-    packed_FloatGrid3 packed_velocity;
-    packed_velocity.from_vec3(velocity->m_grid);
+    auto &packed_velocity = velocity->usePackedGrid();
 
-    FLIP_vdb::apply_pressure_gradient(
-        liquid_sdf->m_grid, solid_sdf->m_grid,
-        curr_pressure->m_grid, face_weight->m_grid,
-        packed_velocity, solid_velocity->m_grid,
-        curvatureGrid, density, tension_coef, enable_tension, 
-        dt, dx);
-
-    vdb_velocity_extrapolator::union_extrapolate(n,
+    {
+      ZENO_SCOPE_TIMER("pressure_gradient");
+      FLIP_vdb::apply_pressure_gradient(
+          liquid_sdf->grid(), solid_sdf->grid(),
+          curr_pressure->grid(), face_weight->grid(),
+          packed_velocity, solid_velocity->grid(),
+          curvatureGrid, density, tension_coef, enable_tension, 
+          dt, dx);
+    }
+    {
+      ZENO_SCOPE_TIMER("extrapolate");
+      vdb_velocity_extrapolator::union_extrapolate(n,
 		                            packed_velocity.v[0],
 		                            packed_velocity.v[1],
 		                            packed_velocity.v[2],
-	  	                          &(liquid_sdf->m_grid->tree()));
+	  	                          &(liquid_sdf->grid()->tree()));
+    }
 
-    packed_velocity.to_vec3(velocity->m_grid);
+    velocity->markPackedModified();
   }
 };
 
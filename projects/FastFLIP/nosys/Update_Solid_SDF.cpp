@@ -21,10 +21,10 @@ struct FLIP_Solid_Modifier : zeno::INode {
 
     std::vector<openvdb::FloatGrid::Ptr> moving_solids;
     if (moving_solid_sdf != nullptr)
-      moving_solids.emplace_back(moving_solid_sdf->m_grid);
+      moving_solids.emplace_back(moving_solid_sdf->grid());
 
-    FLIP_vdb::update_solid_sdf(moving_solids, static_solid_sdf->m_grid,
-                               particles->m_grid);
+    FLIP_vdb::update_solid_sdf(moving_solids, static_solid_sdf->grid(),
+                               particles->grid());
   }
 };
 
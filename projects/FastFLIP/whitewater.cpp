@@ -27,9 +27,9 @@ struct WhitewaterSource : INode {
         }
         auto dt = get_input2<float>("dt");
         auto Lifespan = get_input2<float>("Lifespan");
-        auto &Liquid_sdf = get_input<VDBFloatGrid>("LiquidSDF")->m_grid;
-        auto &Solid_sdf = get_input<VDBFloatGrid>("SolidSDF")->m_grid;
-        auto &Velocity = get_input<VDBFloat3Grid>("Velocity")->m_grid;
+        auto &Liquid_sdf = get_input<VDBFloatGrid>("LiquidSDF")->grid();
+        auto &Solid_sdf = get_input<VDBFloatGrid>("SolidSDF")->grid();
+        auto &Velocity = get_input<VDBFloat3Grid>("Velocity")->grid();
 
         auto &par_pos = pars->verts.values;
         auto &par_vel = pars->add_attr<vec3f>("vel");
@@ -56,7 +56,7 @@ struct WhitewaterSource : INode {
             Curvature = openvdb::tools::meanCurvature(*Liquid_sdf);
         }
         if (acc_emit > eps) {
-            Pre_vel = get_input<VDBFloat3Grid>("PreVelocity")->m_grid;
+            Pre_vel = get_input<VDBFloat3Grid>("PreVelocity")->grid();
         }
         if (vor_emit > eps) {
             Vorticity = openvdb::tools::curl(*Velocity);
@@ -206,8 +206,8 @@ struct WhitewaterSolver : INode {
     void apply() override {
         auto pars = get_input<PrimitiveObject>("Primitive");
         auto dt = get_input2<float>("dt");
-        auto &Liquid_sdf = get_input<VDBFloatGrid>("LiquidSDF")->m_grid;
-        auto &Solid_sdf = get_input<VDBFloatGrid>("SolidSDF")->m_grid;
+        auto &Liquid_sdf = get_input<VDBFloatGrid>("LiquidSDF")->grid();
+        auto &Solid_sdf = get_input<VDBFloatGrid>("SolidSDF")->grid();
         auto TargetVelAttr = get_input2<std::string>("TargetVelAttr");
 
         auto gravity = vec_to_other<openvdb::Vec3f>(get_input2<vec3f>("Gravity"));
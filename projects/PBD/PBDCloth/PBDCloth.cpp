@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <iostream>
 #include "../Utils/myPrint.h"
+#include "../Utils/constraintColoring.h"
 namespace zeno {
 struct PBDCloth : zeno::INode {
 private:
@@ -123,8 +124,9 @@ private:
 
 
     /**
-     * @brief 求解PBD所有边约束（也叫距离约束）。目前采用Gauss-Seidel方式（难以并行）。
+     * @brief 求解PBD所有边约束（也叫距离约束）。采用Gauss-Seidel方式，按着色依次求解，同一颜色的边并行求解。
      * 
+     * @param colored 按颜色排列的边
      * @param edge 边连接关系
      * @param invMass 点质量的倒数
      * @param restLen 边的原长
@@ -133,6 +135,7 @@ private:
      * @param pos 点位置
      */
     void solveDistanceConstraints( 
+        const ColoredConstraints &colored,
         const std::vector<vec2i> &edges,
         const std::vector<float> &invMass,
         const std::vector<float> &restLen,
@@ -141,7 +144,7 @@ private:
         std::vector<vec3f> &pos)
     {
         float alpha = edgeCompliance / dt / dt;
-        for (auto i = 0; i < edges.size(); i++) 
+        colored.forEachColored([&] (int i)
         {
             int id0 = edges[i][0];
             int id1 = edges[i][1];
@@ -150,24 +153,25 @@ private:
             auto w1 = invMass[id1];
             auto w = w0 + w1;
             if (w == 0.0)
-                continue;
+                return;
 
             auto grads = pos[id0] - pos[id1];
             float Len = length(grads);
             if (Len == 0.0)
-                continue;
+                return;
             grads /= Len;
             auto C = Len - restLen[i];
             auto s = -C / (w + alpha);
             
             pos[id0] += grads *   s * invMass[id0];
             pos[id1] += grads * (-s * invMass[id1]);
-        }
+        });
     }
 
     /**
-     * @brief 利用对角距离法求解弯折约束。
+     * @brief 利用对角距离法求解弯折约束。按着色依次求解，同一颜色的三角形对并行求解。
      * 
+     * @param colored 按颜色排列的三角形对
      * @param quads 三角形对。其中下标2和3代表对角
      * @param invMass 质量倒数
      * @param bendingRestLen 对角距离原长
@@ -175,6 +179,7 @@ private:
      * @param pos 输出：位置
      */
     void solveBendingDistanceConstraints(
+        const ColoredConstraints &colored,
         const std::vector<vec4i> &quads,
         const std::vector<float> &invMass,
         const std::vector<float> &bendingRestLen,
@@ -184,7 +189,7 @@ private:
     {
         auto alpha = bendingCompliance / dt /dt;
 
-        for (auto i = 0; i < quads.size(); i++) 
+        colored.forEachColored([&] (int i)
         {
             int id0 = quads[i][2];
             int id1 = quads[i][3];
@@ -193,18 +198,18 @@ private:
             auto w1 = invMass[id1];
             auto w = w0 + w1;
             if (w == 0.0)
-                continue;
+                return;
 
             auto grads = pos[id0] - pos[id1];
             float Len = length(grads);
             if (Len == 0.0)
-                continue;
+                return;
             grads /= Len;
             auto C = Len - bendingRestLen[i];
             auto s = -C / (w + alpha);
             pos[id0] += grads *   s * invMass[id0];
             pos[id1] += grads * (-s * invMass[id1]);
-        }
+        });
     }
 
     void solveDihedralConstraints(PrimitiveObject *prim)
@@ -283,6 +288,19 @@ public:
         auto &prevPos = prim->verts.attr<vec3f>("prevPos");
         auto &vel = prim->verts.attr<vec3f>("vel");
 
+        //着色缓存在边和三角形对的_pbdColor属性上，拓扑不变时不重新计算
+        bool freshEdges = !prim->edges.has_attr("_pbdColor");
+        auto &edgeColor = prim->edges.add_attr<int>("_pbdColor");
+        updateConstraintColoring(prim->userData(), "edgeColorTopo", freshEdges, edges.size(), pos.size(),
+            [&] (int i, auto const &f) { f(edges[i][0]); f(edges[i][1]); }, edgeColor.data());
+        ColoredConstraints coloredEdges(edges.size(), edgeColor.data());
+
+        bool freshQuads = !prim->quads.has_attr("_pbdColor");
+        auto &quadColor = prim->quads.add_attr<int>("_pbdColor");
+        updateConstraintColoring(prim->userData(), "quadColorTopo", freshQuads, quads.size(), pos.size(),
+            [&] (int i, auto const &f) { f(quads[i][2]); f(quads[i][3]); }, quadColor.data());
+        ColoredConstraints coloredQuads(quads.size(), quadColor.data());
+
         static int frames=0;
         frames+=1;
 
@@ -291,8 +309,8 @@ public:
             if(frames==100)
                 echo(frames);
             preSolve(invMass,externForce, dt,pos,prevPos, vel);
-            solveDistanceConstraints(edges, invMass, restLen ,edgeCompliance, dt, pos);
-            solveBendingDistanceConstraints(quads,invMass,bendingRestLen,bendingCompliance,dt,pos);
+            solveDistanceConstraints(coloredEdges, edges, invMass, restLen ,edgeCompliance, dt, pos);
+            solveBendingDistanceConstraints(coloredQuads, quads,invMass,bendingRestLen,bendingCompliance,dt,pos);
             postSolve(pos,prevPos,invMass,dt,vel);
         }
 
@@ -1,6 +1,7 @@
 #include <zeno/zeno.h>
 #include <zeno/types/PrimitiveObject.h>
 #include "../Utils/myPrint.h"
+#include "../Utils/constraintColoring.h"
 #include <zeno/types/UserData.h>
 
 using namespace zeno;
@@ -36,7 +37,8 @@ struct PBDSolveDihedralConstraint : zeno::INode {
     }
 
     /**
-     * @brief 对所有的点求解二面角约束
+     * @brief 对所有的点求解二面角约束。约束按着色分组，同一颜色的约束没有公共点，并行求解。
+     * 高斯赛德尔法按颜色依次在原地修正pos；雅可比法先累加所有约束的修正，再对每个点取平均后修正pos。
      * 
      * @param prim 所传入的所有数据
      */
@@ -54,34 +56,74 @@ struct PBDSolveDihedralConstraint : zeno::INode {
         float dt = prim->userData().getLiterial<float>("dt");
         float isGaussSidel = prim->userData().getLiterial<bool>("isGaussSidel");
 
-        for (int i = 0; i < tris.size(); i++) //对所有三角面
-        {
-            for(int k=0; k<3; k++) //三个边，对应着三个邻接面
-            {
-                int id4 = adj4th[i][k]; //取出第四个点编号
-                if (id4 == -1) //如果编号为-1，证明没有这个邻接面
-                    continue;
+        //约束3*i+k：三角面i的三个点，和它第k个邻接面的第四个点。着色缓存在三角面的_pbdDihedralColor属性上
+        bool fresh = !prim->tris.has_attr("_pbdDihedralColor");
+        auto &color = prim->tris.add_attr<vec3i>("_pbdDihedralColor");
+        static_assert(sizeof(vec3i) == 3 * sizeof(int));
+        auto vertsOf = [&] (int c, auto const &f) {
+            int i = c / 3, k = c % 3;
+            if (adj4th[i][k] == -1) //如果编号为-1，证明没有这个邻接面
+                return;
+            f(tris[i][0]);
+            f(tris[i][1]);
+            f(tris[i][2]);
+            f(adj4th[i][k]);
+        };
+        int *colorData = reinterpret_cast<int *>(color.data());
+        updateConstraintColoring(prim->userData(), "dihedralColorTopo", fresh, 3 * tris.size(), pos.size(), vertsOf, colorData);
+        ColoredConstraints colored(3 * tris.size(), colorData);
+
+        std::vector<int> count;
+        if (!isGaussSidel) {
+            std::fill(dpos.begin(), dpos.end(), vec3f{0.0,0.0,0.0});
+            count.assign(pos.size(), 0);
+        }
 
-                //对四个点进行求解。注意顺序要按照Muller2006论文中的Fig4。1-2是共享边。3是自己的点，4是对方的点。
-                int id1 = tris[i][0];
-                int id2 = tris[i][1];
-                int id3 = tris[i][2];
-                vec4i id{id1,id2,id3,id4};
+        colored.forEachColored([&] (int c) {
+            int i = c / 3, k = c % 3;
+            int id4 = adj4th[i][k]; //取出第四个点编号
 
-                vec4f invMass4p{invMass[id[0]],invMass[id[1]],invMass[id[2]],invMass[id[3]]}; //4个点的invMass
-                float restAng4p{restAng[i][k]}; // 四个点的原角度
-                std::array<vec3f,4>  pos4p{pos[id[0]],pos[id[1]],pos[id[2]],pos[id[3]]}; 
-                std::array<vec3f,4>  dpos4p{vec3f{0.0,0.0,0.0},vec3f{0.0,0.0,0.0},vec3f{0.0,0.0,0.0},vec3f{0.0,0.0,0.0}}; //四个点的dpos，也就是待求解的对pos的修正值。
+            //对四个点进行求解。注意顺序要按照Muller2006论文中的Fig4。1-2是共享边。3是自己的点，4是对方的点。
+            int id1 = tris[i][0];
+            int id2 = tris[i][1];
+            int id3 = tris[i][2];
+            vec4i id{id1,id2,id3,id4};
 
-                //这里只传入需要的四个点的数据，求解得到4个dpos
-                dihedralConstraint(pos4p, invMass4p, restAng4p, dihedralCompliance, dt,  dpos4p);
+            vec4f invMass4p{invMass[id[0]],invMass[id[1]],invMass[id[2]],invMass[id[3]]}; //4个点的invMass
+            float restAng4p{restAng[i][k]}; // 四个点的原角度
+            std::array<vec3f,4>  pos4p{pos[id[0]],pos[id[1]],pos[id[2]],pos[id[3]]}; 
+            std::array<vec3f,4>  dpos4p{vec3f{0.0,0.0,0.0},vec3f{0.0,0.0,0.0},vec3f{0.0,0.0,0.0},vec3f{0.0,0.0,0.0}}; //四个点的dpos，也就是待求解的对pos的修正值。
 
+            //这里只传入需要的四个点的数据，求解得到4个dpos
+            dihedralConstraint(pos4p, invMass4p, restAng4p, dihedralCompliance, dt,  dpos4p);
+
+            if (isGaussSidel) //高斯赛德尔法在原地修正pos
+            {
                 for (size_t j = 0; j < 4; j++)
+                {
                     dpos[id[j]] = dpos4p[j];
+                    pos[id[j]] += dpos4p[j];
+                }
+            }
+            else //雅可比法只累加修正值
+            {
+                for (size_t j = 0; j < 4; j++)
+                {
+                    dpos[id[j]] += dpos4p[j];
+                    count[id[j]]++;
+                }
+            }
+        });
 
-                if (isGaussSidel) //高斯赛德尔法在原地修正pos
-                    for (size_t j = 0; j < 4; j++)
-                        pos[id[j]] += dpos[j];
+        if (!isGaussSidel)
+        {
+#pragma omp parallel for
+            for (int i = 0; i < (int)pos.size(); i++)
+            {
+                if (count[i] == 0)
+                    continue;
+                dpos[i] /= (float)count[i];
+                pos[i] += dpos[i];
             }
         }
     }
@@ -2,12 +2,14 @@
 #include <zeno/zeno.h>
 #include <zeno/types/UserData.h>
 #include <iostream>
+#include "Utils/constraintColoring.h"
 
 namespace zeno {
 struct PBDSolveDistanceConstraint : zeno::INode {
 private:
     /**
-     * @brief 求解PBD所有边约束（也叫距离约束）。目前采用Gauss-Seidel方式（难以并行）。
+     * @brief 求解PBD所有边约束（也叫距离约束）。采用Gauss-Seidel方式，按边的着色依次求解，同一颜色的边没有公共点，并行求解。
+     * 着色缓存在边的_pbdColor属性上，拓扑不变时不重新计算。
      * 
      * @param pos 点位置
      * @param edge 边连接关系
@@ -27,13 +29,21 @@ private:
         )
     {
         float alpha = disntanceCompliance / dt / dt;
-        zeno::vec3f grad{0, 0, 0};
-        for (int i = 0; i < edge.size(); i++) 
-        {
+
+        bool fresh = !prim->lines.has_attr("_pbdColor");
+        auto &color = prim->lines.add_attr<int>("_pbdColor");
+        auto vertsOf = [&] (int i, auto const &f) {
+            f(edge[i][0]);
+            f(edge[i][1]);
+        };
+        updateConstraintColoring(prim->userData(), "lineColorTopo", fresh, edge.size(), pos.size(), vertsOf, color.data());
+        ColoredConstraints colored(edge.size(), color.data());
+
+        colored.forEachColored([&] (int i) {
             int id0 = edge[i][0];
             int id1 = edge[i][1];
 
-            grad = pos[id0] - pos[id1];
+            zeno::vec3f grad = pos[id0] - pos[id1];
             float Len = length(grad);
             grad /= Len;
             float C = Len - restLen[i];
@@ -42,7 +52,7 @@ private:
 
             pos[id0] += grad *   s * invMass[id0];
             pos[id1] += grad * (-s * invMass[id1]);
-        }
+        });
     }
 
 
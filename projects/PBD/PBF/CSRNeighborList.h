@@ -0,0 +1,175 @@
+#pragma once
+#include <zeno/utils/vec.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace zeno
+{
+
+/**
+ * @brief 连续存储（CSR）的邻居列表，带Verlet皮层(skin)。
+ * 以 搜索半径+skin 建表，粒子自建表以来的位移都不超过 skin/2 时，半径内的邻居一定都在表里，直接复用，不用重建。
+ * 建表时先按格子对粒子排序（空间重排），同一格子的粒子在内存中相邻；再先数每个粒子的邻居个数，前缀和之后并行填表。
+ * 粒子i的候选邻居为 neighbors[offsets[i], offsets[i+1])，用forEachNeighbor只访问真正在半径内的。
+ */
+struct CSRNeighborList
+{
+    std::vector<int> offsets;   //numParticles+1个
+    std::vector<int> neighbors; //每个粒子的候选邻居，按格子的顺序
+    std::vector<vec3f> buildPos; //建表时的位置
+    float radius = 0;
+    float skin = 0;
+    int numBuilds = 0; //建表次数（调试用）
+
+    //每维格子数的上限：格子坐标加上邻居的+1和编码的+1偏移，仍然放得进21位
+    static constexpr int kMaxCells = (1 << 21) - 4;
+
+    size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+
+    /**
+     * @brief 是否需要重建：粒子数、半径变了，或者有粒子的位移超过了skin/2
+     */
+    bool needsRebuild(const std::vector<vec3f> &pos, float searchRadius, float skin_) const
+    {
+        if (pos.size() != size() || searchRadius != radius || skin_ != skin)
+            return true;
+        float maxDisp2 = skin * skin * 0.25f;
+        int moved = 0;
+        #pragma omp parallel for reduction(|: moved)
+        for (int i = 0; i < (int)pos.size(); i++)
+            moved |= lengthSquared(pos[i] - buildPos[i]) > maxDisp2;
+        return moved != 0;
+    }
+
+    /**
+     * @brief 需要时重建，返回是否重建了
+     */
+    bool update(const std::vector<vec3f> &pos, float searchRadius, float skin_)
+    {
+        if (!needsRebuild(pos, searchRadius, skin_))
+            return false;
+        build(pos, searchRadius, skin_);
+        return true;
+    }
+
+    void build(const std::vector<vec3f> &pos, float searchRadius, float skin_)
+    {
+        radius = searchRadius;
+        skin = skin_;
+        buildPos = pos;
+        numBuilds++;
+        const int n = pos.size();
+        offsets.assign(n + 1, 0);
+        neighbors.clear();
+        if (n == 0)
+            return;
+
+        //格子大小为建表半径，邻居只可能在周围27个格子里
+        const float cutoff = radius + skin;
+        const float cutoff2 = cutoff * cutoff;
+        vec3f pMin = pos[0], pMax = pos[0];
+        for (int i = 1; i < n; i++)
+        {
+            pMin = zeno::min(pMin, pos[i]);
+            pMax = zeno::max(pMax, pos[i]);
+        }
+        float extent = zeno::max(pMax[0] - pMin[0], zeno::max(pMax[1] - pMin[1], pMax[2] - pMin[2]));
+        if (!std::isfinite(extent))
+            throw std::runtime_error("CSRNeighborList: particle positions must be finite");
+        //格子编码每维只有21位。粒子分布得太广时放大格子，格子不小于建表半径就不会漏掉邻居
+        const float dxInv = std::min(1.0f / cutoff, float(kMaxCells) / extent);
+        auto cellOf = [&](const vec3f &p) {
+            return toint(floor((p - pMin) * dxInv));
+        };
+        //每维21位，格子坐标加1偏移，使得邻居格子坐标不会是负数
+        auto keyOf = [](vec3i c) {
+            return (std::uint64_t)(c[0] + 1) << 42 | (std::uint64_t)(c[1] + 1) << 21 | (std::uint64_t)(c[2] + 1);
+        };
+
+        //按格子排序，sorted[k]为第k个粒子（空间顺序）的编号和格子
+        std::vector<std::pair<std::uint64_t, int>> sorted(n);
+        #pragma omp parallel for
+        for (int i = 0; i < n; i++)
+            sorted[i] = {keyOf(cellOf(pos[i])), i};
+        std::sort(sorted.begin(), sorted.end());
+        std::vector<vec3f> sortedPos(n);
+        #pragma omp parallel for
+        for (int k = 0; k < n; k++)
+            sortedPos[k] = pos[sorted[k].second];
+
+        //非空格子及其粒子区间
+        std::vector<std::uint64_t> cellKeys;
+        std::vector<int> cellStart;
+        for (int k = 0; k < n; k++)
+        {
+            if (k == 0 || sorted[k].first != sorted[k - 1].first)
+            {
+                cellKeys.push_back(sorted[k].first);
+                cellStart.push_back(k);
+            }
+        }
+        cellStart.push_back(n);
+
+        //对粒子i周围27个格子里的每个候选粒子（空间顺序下标k）调用f(k)。
+        //z方向相邻的3个格子编码也相邻，其中的粒子在sorted里是连续的一段，所以只需查9次
+        auto visit = [&](int i, auto const &f) {
+            vec3i c = cellOf(pos[i]);
+            for (int dy = -1; dy <= 1; dy++)
+            for (int dx = -1; dx <= 1; dx++)
+            {
+                auto lo = keyOf(c + vec3i(dx, dy, -1)), hi = keyOf(c + vec3i(dx, dy, 1));
+                auto it = std::lower_bound(cellKeys.begin(), cellKeys.end(), lo);
+                auto cid = it - cellKeys.begin();
+                while (it != cellKeys.end() && *it <= hi)
+                    ++it;
+                int end = cellStart[it - cellKeys.begin()];
+                for (int k = cellStart[cid]; k < end; k++)
+                {
+                    if (sorted[k].second != i && lengthSquared(pos[i] - sortedPos[k]) < cutoff2)
+                        f(k);
+                }
+            }
+        };
+
+        //第一遍：数邻居个数。按空间顺序遍历粒子，相邻的查询访问同一批格子
+        #pragma omp parallel for schedule(dynamic, 256)
+        for (int k = 0; k < n; k++)
+        {
+            int i = sorted[k].second, count = 0;
+            visit(i, [&](int) { count++; });
+            offsets[i + 1] = count;
+        }
+        for (int i = 0; i < n; i++)
+            offsets[i + 1] += offsets[i];
+
+        //第二遍：填表
+        neighbors.resize(offsets[n]);
+        #pragma omp parallel for schedule(dynamic, 256)
+        for (int k = 0; k < n; k++)
+        {
+            int i = sorted[k].second, at = offsets[i];
+            visit(i, [&](int k2) { neighbors[at++] = sorted[k2].second; });
+        }
+    }
+
+    /**
+     * @brief 对粒子i当前在搜索半径内的每个邻居j调用f(j)
+     */
+    template <class F>
+    void forEachNeighbor(int i, const std::vector<vec3f> &pos, F const &f) const
+    {
+        const float radius2 = radius * radius;
+        for (int k = offsets[i]; k < offsets[i + 1]; k++)
+        {
+            int j = neighbors[k];
+            if (lengthSquared(pos[i] - pos[j]) < radius2)
+                f(j);
+        }
+    }
+};
+
+}//zeno
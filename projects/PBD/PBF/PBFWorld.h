@@ -1,5 +1,6 @@
 #include <zeno/zeno.h>
 #include <zeno/core/IObject.h>
+#include "./CSRNeighborList.h"
 namespace zeno
 {
 
@@ -20,6 +21,7 @@ struct PBFWorld:IObject
     float mass; //0.8*diam*diam*diam*rho0
     float h; // 4*radius
     float neighborSearchRadius; //h
+    float neighborSkin = 0.025; //邻居表的皮层厚度，粒子位移不超过它的一半就不用重建邻居表
     float lambdaEpsilon = 1e-6;
     float coeffDq = 0.3;
     float coeffK = 0.1;
@@ -35,8 +37,8 @@ struct PBFWorld:IObject
 
     // std::shared_ptr<zeno::PrimitiveObject> prim;
     
-    //neighborList
-    std::vector<std::vector<int>> neighborList;
+    //neighborList，各个子步之间复用
+    CSRNeighborList neighborList;
 };
 
     
@@ -37,6 +37,7 @@ struct PBFWorld_Setup : INode
         data->lambdaEpsilon = get_input<zeno::NumericObject>("lambdaEpsilon")->get<float>();
         data->coeffDq = get_input<zeno::NumericObject>("coeffDq")->get<float>();
         data->coeffK = get_input<zeno::NumericObject>("coeffK")->get<float>();
+        data->neighborSkin = get_input<zeno::NumericObject>("neighborSkin")->get<float>();
 
         //可以推导出来的参数
         auto diam = data->radius*2;
@@ -66,6 +67,7 @@ ZENDEFNODE(PBFWorld_Setup, {
         {"float","lambdaEpsilon","1e-6"},
         {"float","coeffDq","0.3"},
         {"float","coeffK","0.1"},
+        {"float","neighborSkin","0.025"},
         {"int","numSubsteps","5"}
     },
     {"prim","PBFWorld"},
@@ -14,6 +14,9 @@ struct PBFWorld_Solve : zeno::INode {
     //核心步骤
     void solve(PBFWorld* data, PrimitiveObject * prim)
     {
+        //粒子移出皮层时才重建邻居表
+        data->neighborList.update(prim->verts, data->neighborSearchRadius, data->neighborSkin);
+
         //计算lambda
         computeLambda(data, prim);
 
@@ -26,7 +29,8 @@ struct PBFWorld_Solve : zeno::INode {
 
         //apply the dpos to the pos
         auto & pos = prim->verts;
-        for (size_t i = 0; i < data->numParticles; i++)
+        #pragma omp parallel for
+        for (int i = 0; i < data->numParticles; i++)
             pos[i] += data->dpos[i];
     }
     
@@ -38,21 +42,21 @@ struct PBFWorld_Solve : zeno::INode {
         const auto &pos = prim->verts;//这里只访问，不修改
         const auto &neighborList = data->neighborList;//这里只访问，不修改
 
-        for (size_t i = 0; i < data->numParticles; i++)
+        #pragma omp parallel for
+        for (int i = 0; i < data->numParticles; i++)
         {
             vec3f gradI{0.0, 0.0, 0.0};
             float sumSqr = 0.0;
             float densityCons = 0.0;
 
-            for (size_t j = 0; j < neighborList[i].size(); j++)
+            neighborList.forEachNeighbor(i, pos, [&](int pj)//pj是邻居的下标
             {
-                int pj = neighborList[i][j];//pj是第j个邻居的下标
                 vec3f distVec = pos[i] - pos[pj];
                 vec3f gradJ = CubicKernel::gradW(distVec);
                 gradI += gradJ;
                 sumSqr += dot(gradJ, gradJ);
                 densityCons += CubicKernel::W(length(distVec));
-            }
+            });
             densityCons = (data->mass * densityCons / data->rho0) - 1.0;
 
             sumSqr += dot(gradI, gradI);
@@ -69,17 +73,17 @@ struct PBFWorld_Solve : zeno::INode {
         const auto &pos = prim->verts; //这里只访问，不修改
         const auto &neighborList = data->neighborList;//这里只访问，不修改
 
-        for (size_t i = 0; i < data->numParticles; i++)
+        #pragma omp parallel for
+        for (int i = 0; i < data->numParticles; i++)
         {
             vec3f dposI{0.0, 0.0, 0.0};
-            for (size_t j = 0; j < neighborList[i].size(); j++)
+            neighborList.forEachNeighbor(i, pos, [&](int pj)
             {
-                int pj = neighborList[i][j];
                 vec3f distVec = pos[i] - pos[pj];
 
                 float sCorr = 0.0;
                 dposI += (data->lambda[i] + data->lambda[pj] + sCorr) * CubicKernel::W(length(distVec));
-            }
+            });
             dposI /= data->rho0;
             data->dpos[i] = dposI;
 
@@ -1,4 +1,3 @@
-#include "../ZenoFX/LinearBvh.h"
 #include <zeno/types/PrimitiveObject.h>
 #include <zeno/zeno.h>
 #include "./PBFWorld.h"
@@ -24,38 +23,10 @@ struct PBFWorld_Step : zeno::INode {
         }
     }
 
-    void neighborhoodSearch(PBFWorld* data, std::shared_ptr<PrimitiveObject> prim)
+    void neighborhoodSearch(PBFWorld* data, PrimitiveObject * prim)
     {
-        auto &pos = prim->verts;
-
-        //构建BVH
-        auto lbvh = std::make_shared<zeno::LBvh>(prim,  data->neighborSearchRadius,zeno::LBvh::element_c<zeno::LBvh::element_e::point>);
-
-        //清零
-        data->neighborList.clear();
-        data->neighborList.resize(pos.size());
-
-        //邻域搜索
-        buildNeighborList(pos, data->neighborSearchRadius, lbvh.get(), data->neighborList);
-    }
-
-
-    void buildNeighborList(const std::vector<vec3f> &pos, float searchRadius, const zeno::LBvh *lbvh, std::vector<std::vector<int>> & list)
-    {
-        auto radius2 = searchRadius*searchRadius;
-        #pragma omp parallel for
-        for (int i = 0; i < pos.size(); i++) 
-        {
-            //BVH的使用
-            lbvh->iter_neighbors(pos[i], [&](int j) 
-                {
-                    if (lengthSquared(pos[i] - pos[j]) < radius2 && j!=i)
-                    {
-                        list[i].emplace_back(j);
-                    }
-                }
-            );
-        }
+        //粒子还没有移出皮层时复用上个子步的邻居表
+        data->neighborList.update(prim->verts, data->neighborSearchRadius, data->neighborSkin);
     }
 
     void boundaryHandling(vec3f & p, const vec3f &bounds_min, const vec3f &bounds_max)
@@ -83,7 +54,8 @@ struct PBFWorld_Step : zeno::INode {
 
         //apply the dpos to the pos
         auto & pos = prim->verts;
-        for (size_t i = 0; i < data->numParticles; i++)
+        #pragma omp parallel for
+        for (int i = 0; i < data->numParticles; i++)
             pos[i] += data->dpos[i];
     }
     
@@ -95,21 +67,21 @@ struct PBFWorld_Step : zeno::INode {
         const auto &pos = prim->verts;//这里只访问，不修改
         const auto &neighborList = data->neighborList;//这里只访问，不修改
 
-        for (size_t i = 0; i < data->numParticles; i++)
+        #pragma omp parallel for
+        for (int i = 0; i < data->numParticles; i++)
         {
             vec3f gradI{0.0, 0.0, 0.0};
             float sumSqr = 0.0;
             float densityCons = 0.0;
 
-            for (size_t j = 0; j < neighborList[i].size(); j++)
+            neighborList.forEachNeighbor(i, pos, [&](int pj)//pj是邻居的下标
             {
-                int pj = neighborList[i][j];//pj是第j个邻居的下标
                 vec3f distVec = pos[i] - pos[pj];
                 vec3f gradJ = SpikyKernel::gradW(distVec);
                 gradI += gradJ;
                 sumSqr += dot(gradJ, gradJ);
                 densityCons += Poly6Kernel::W(length(distVec));
-            }
+            });
             densityCons = (data->mass * densityCons / data->rho0) - 1.0;
 
             sumSqr += dot(gradI, gradI);
@@ -126,18 +98,18 @@ struct PBFWorld_Step : zeno::INode {
         const auto &pos = prim->verts; //这里只访问，不修改
         const auto &neighborList = data->neighborList;//这里只访问，不修改
 
-        for (size_t i = 0; i < data->numParticles; i++)
+        #pragma omp parallel for
+        for (int i = 0; i < data->numParticles; i++)
         {
             vec3f dposI{0.0, 0.0, 0.0};
-            for (size_t j = 0; j < neighborList[i].size(); j++)
+            neighborList.forEachNeighbor(i, pos, [&](int pj)
             {
-                int pj = neighborList[i][j];
                 vec3f distVec = pos[i] - pos[pj];
 
                 float sCorr = 0.0;
                 // float sCorr = computeScorr(distVec,data);
                 dposI += (data->lambda[i] + data->lambda[pj] + sCorr) * Poly6Kernel::W(length(distVec));
-            }
+            });
             dposI /= data->rho0;
             data->dpos[i] = dposI;
 
@@ -168,11 +140,11 @@ struct PBFWorld_Step : zeno::INode {
         preSolve(data.get(),prim.get());
         printf("pos[0] = %.5e, %.5e, %.5e \n",pos[0][0],pos[0][1], pos[0][2]);
 
-        neighborhoodSearch(data.get(),prim);
-        echoVec(data->neighborList[0]);
-
         for(int i=0; i<data->numSubsteps; i++)
+        {
+            neighborhoodSearch(data.get(),prim.get());
             solve(data.get(), prim.get());
+        }
         postSolve(data.get(),prim.get());
 
         set_output("outPrim", std::move(prim));
@@ -18,6 +18,10 @@ private:
     void extractSurf();
     void extractEdge();
 public:
+  bool canApplyInParallel() const override {
+    return true;
+  }
+
   void apply() override {
     auto path = get_input<StringObject>("path")->get();
     prim = std::make_shared<PrimitiveObject>();
@@ -0,0 +1,126 @@
+#pragma once
+#include <zeno/types/UserData.h>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace zeno {
+
+/**
+ * @brief 贪心着色：每个约束取其顶点上尚未被占用的最小颜色，同一颜色的约束之间没有公共顶点。
+ * 每轮用64位掩码记录64种颜色，放不下的约束留到下一轮。
+ *
+ * @param numCons 约束数
+ * @param numVerts 顶点数
+ * @param vertsOf vertsOf(i, f) 对约束i的每个顶点v调用f(v)。没有顶点的约束（无效约束）颜色为-1
+ * @param color 输出：每个约束的颜色
+ * @return int 颜色数
+ */
+template <class VertsOf>
+int colorConstraints(int numCons, int numVerts, VertsOf const &vertsOf, int *color) {
+    std::vector<std::uint64_t> used(numVerts);
+    std::vector<int> pending;
+    for (int i = 0; i < numCons; i++) {
+        bool valid = false;
+        vertsOf(i, [&] (int) { valid = true; });
+        color[i] = -1;
+        if (valid)
+            pending.push_back(i);
+    }
+
+    int numColors = 0;
+    for (int base = 0; !pending.empty(); base += 64) {
+        std::fill(used.begin(), used.end(), 0);
+        std::vector<int> deferred;
+        for (int i: pending) {
+            std::uint64_t mask = 0;
+            vertsOf(i, [&] (int v) { mask |= used[v]; });
+            if (~mask == 0) {
+                deferred.push_back(i);
+                continue;
+            }
+            int c = 0;
+            while (mask >> c & 1)
+                c++;
+            vertsOf(i, [&] (int v) { used[v] |= std::uint64_t(1) << c; });
+            color[i] = base + c;
+            numColors = std::max(numColors, base + c + 1);
+        }
+        pending.swap(deferred);
+    }
+    return numColors;
+}
+
+/**
+ * @brief 取prim上缓存的着色（约束的属性，用_pbdColor这样的保留名，以免覆盖用户的color属性），
+ * 拓扑（约束的顶点编号和顶点数）变了才重新着色。
+ *
+ * @param ud prim的userData，以name记录着色时的拓扑
+ * @param name 不同种类的约束用不同的名字
+ * @param fresh 着色属性是否刚刚添加
+ * @return 是否重新着色了
+ */
+template <class VertsOf>
+bool updateConstraintColoring(UserData &ud, std::string const &name, bool fresh,
+                              int numCons, int numVerts, VertsOf const &vertsOf, int *color) {
+    //FNV-1a，对约束的所有顶点编号
+    std::uint32_t key = 2166136261u;
+    auto mix = [&] (std::uint32_t x) {
+        key = (key ^ x) * 16777619u;
+    };
+    mix(numCons);
+    mix(numVerts);
+    for (int i = 0; i < numCons; i++)
+        vertsOf(i, [&] (int v) { mix(v); });
+
+    if (!fresh && ud.has<int>(name) && (std::uint32_t)ud.get2<int>(name) == key)
+        return false;
+    colorConstraints(numCons, numVerts, vertsOf, color);
+    ud.set2(name, (int)key);
+    return true;
+}
+
+/**
+ * @brief 按颜色排列的约束编号。Gauss-Seidel按颜色依次进行，每种颜色内的约束并行求解。
+ */
+struct ColoredConstraints {
+    std::vector<int> order;      // 按颜色排列的约束编号，同一颜色内保持原来的顺序
+    std::vector<int> colorStart; // 第c种颜色为 order[colorStart[c], colorStart[c+1])
+
+    ColoredConstraints(int numCons, int const *color) {
+        int numColors = 0;
+        for (int i = 0; i < numCons; i++)
+            numColors = std::max(numColors, color[i] + 1);
+        colorStart.assign(numColors + 1, 0);
+        for (int i = 0; i < numCons; i++)
+            if (color[i] >= 0)
+                colorStart[color[i] + 1]++;
+        for (int c = 0; c < numColors; c++)
+            colorStart[c + 1] += colorStart[c];
+        order.resize(colorStart[numColors]);
+        std::vector<int> cursor(colorStart.begin(), colorStart.end() - 1);
+        for (int i = 0; i < numCons; i++)
+            if (color[i] >= 0)
+                order[cursor[color[i]]++] = i;
+    }
+
+    int numColors() const {
+        return (int)colorStart.size() - 1;
+    }
+
+    /**
+     * @brief 按颜色依次对每种颜色内的约束并行调用 f(约束编号)。
+     */
+    template <class F>
+    void forEachColored(F const &f) const {
+        for (int c = 0; c < numColors(); c++) {
+            int begin = colorStart[c], end = colorStart[c + 1];
+#pragma omp parallel for
+            for (int k = begin; k < end; k++)
+                f(order[k]);
+        }
+    }
+};
+
+} // namespace zeno
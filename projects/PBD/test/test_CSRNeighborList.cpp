@@ -0,0 +1,99 @@
+#include <zeno/utils/vec.h>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+#include <iostream>
+#include "../Utils/myRand.h"
+#include "../PBF/CSRNeighborList.h"
+
+using namespace zeno;
+
+/**
+ * @brief 暴力求粒子i在半径内的邻居，与CSRNeighborList::forEachNeighbor的结果比较（不计顺序）。
+ *
+ * @param queries 要检查的粒子
+ * @return 不一致的粒子个数
+ */
+int compareBruteForce(const CSRNeighborList &list, const std::vector<vec3f> &pos, float radius, const std::vector<int> &queries)
+{
+    const float radius2 = radius * radius;
+    int numWrong = 0;
+    #pragma omp parallel for reduction(+: numWrong)
+    for (int q = 0; q < (int)queries.size(); q++)
+    {
+        int i = queries[q];
+        std::vector<int> expected, got;
+        for (int j = 0; j < (int)pos.size(); j++)
+            if (j != i && lengthSquared(pos[i] - pos[j]) < radius2)
+                expected.push_back(j);
+        list.forEachNeighbor(i, pos, [&](int j) { got.push_back(j); });
+        std::sort(got.begin(), got.end());
+        numWrong += got != expected;
+    }
+    return numWrong;
+}
+
+std::vector<int> sampleQueries(int n, int numQueries)
+{
+    std::vector<int> queries;
+    if (numQueries >= n)
+        for (int i = 0; i < n; i++)
+            queries.push_back(i);
+    else
+        for (int q = 0; q < numQueries; q++)
+            queries.push_back(genRndInt(0, n));
+    return queries;
+}
+
+bool report(const char *name, int numWrong, int numQueries)
+{
+    std::cout<<name<<": "<<numQueries<<" particles checked, "<<numWrong<<" wrong, "<<(numWrong == 0 ? "ok" : "FAILED")<<"\n";
+    return numWrong == 0;
+}
+
+int main()
+{
+    srand(42);
+    bool ok = true;
+
+    //20万个粒子，密度约每个粒子二十几个邻居
+    const int n = 200000;
+    const float radius = 0.1f, skin = 0.02f;
+    std::vector<vec3f> pos(n);
+    for (auto &p: pos)
+        p = vec3f(genRnd(0, 2), genRnd(0, 2), genRnd(0, 2));
+
+    CSRNeighborList list;
+    list.build(pos, radius, skin);
+    auto queries = sampleQueries(n, 2000);
+    ok &= report("200k particles", compareBruteForce(list, pos, radius, queries), queries.size());
+
+    //每个粒子都检查：表里的候选都在建表半径内
+    int outside = 0;
+    for (int i = 0; i < n; i++)
+        for (int k = list.offsets[i]; k < list.offsets[i + 1]; k++)
+            outside += list.neighbors[k] == i || length(pos[i] - pos[list.neighbors[k]]) >= radius + skin;
+    ok &= report("candidates within radius+skin", outside, n);
+
+    //位移不超过skin/2时复用旧表，结果仍然正确
+    for (auto &p: pos)
+        p += vec3f(genRnd(-1, 1), genRnd(-1, 1), genRnd(-1, 1)) * (skin * 0.25f);
+    bool reused = !list.update(pos, radius, skin);
+    std::cout<<"reused after small moves: "<<(reused ? "ok" : "FAILED")<<"\n";
+    ok &= reused;
+    ok &= report("200k particles, reused list", compareBruteForce(list, pos, radius, queries), queries.size());
+
+    //有粒子离得极远，格子数超出21位的编码，要放大格子
+    std::vector<vec3f> wide(2000);
+    for (auto &p: wide)
+        p = vec3f(genRnd(0, 1), genRnd(0, 1), genRnd(0, 1));
+    wide[0] = vec3f(1e6f, 0, 0);
+    wide[1] = vec3f(1e6f + 0.05f, 0, 0);
+    wide[2] = vec3f(0, -1e6f, 1e6f);
+    CSRNeighborList wideList;
+    wideList.build(wide, radius, skin);
+    auto all = sampleQueries(wide.size(), wide.size());
+    ok &= report("extent beyond 2^21 cells", compareBruteForce(wideList, wide, radius, all), all.size());
+
+    return ok ? 0 : 1;
+}
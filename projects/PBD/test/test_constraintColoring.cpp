@@ -0,0 +1,145 @@
+#include <zeno/utils/vec.h>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+#include <iostream>
+#include "../Utils/myRand.h"
+#include "../Utils/constraintColoring.h"
+
+using namespace zeno;
+
+/**
+ * @brief 检查着色是否有效：有顶点的约束都有颜色，同一颜色的约束之间没有公共顶点，
+ * 并且ColoredConstraints恰好把每个有效约束排进它自己的颜色一次。
+ *
+ * @param cons 每个约束的顶点，空的为无效约束
+ * @param color 每个约束的颜色
+ * @return 是否有效
+ */
+bool checkColoring(const std::vector<std::vector<int>> &cons, int numVerts, const std::vector<int> &color)
+{
+    int numCons = cons.size();
+    int numColors = 0;
+    for (int i = 0; i < numCons; i++)
+    {
+        if (cons[i].empty() != (color[i] < 0))
+        {
+            std::cout<<"constraint "<<i<<" has color "<<color[i]<<" but "<<cons[i].size()<<" verts\n";
+            return false;
+        }
+        numColors = std::max(numColors, color[i] + 1);
+    }
+
+    //每个顶点上每种颜色最多出现一次
+    std::vector<std::vector<int>> owner(numColors, std::vector<int>(numVerts, -1));
+    for (int i = 0; i < numCons; i++)
+        for (int v: cons[i])
+        {
+            int &o = owner[color[i]][v];
+            if (o != -1 && o != i)
+            {
+                std::cout<<"constraints "<<o<<" and "<<i<<" share vert "<<v<<" and color "<<color[i]<<"\n";
+                return false;
+            }
+            o = i;
+        }
+
+    ColoredConstraints colored(numCons, color.data());
+    if (colored.numColors() != numColors)
+    {
+        std::cout<<"ColoredConstraints has "<<colored.numColors()<<" colors, expected "<<numColors<<"\n";
+        return false;
+    }
+    std::vector<int> seen(numCons, 0);
+    for (int c = 0; c < colored.numColors(); c++)
+        for (int k = colored.colorStart[c]; k < colored.colorStart[c + 1]; k++)
+        {
+            int i = colored.order[k];
+            if (color[i] != c || seen[i]++)
+            {
+                std::cout<<"constraint "<<i<<" misplaced in color "<<c<<"\n";
+                return false;
+            }
+        }
+    for (int i = 0; i < numCons; i++)
+        if (seen[i] != (color[i] >= 0))
+        {
+            std::cout<<"constraint "<<i<<" missing from ColoredConstraints\n";
+            return false;
+        }
+    return true;
+}
+
+bool testColoring(const char *name, const std::vector<std::vector<int>> &cons, int numVerts)
+{
+    std::vector<int> color(cons.size());
+    int numColors = colorConstraints(cons.size(), numVerts,
+        [&] (int i, auto const &f) { for (int v: cons[i]) f(v); }, color.data());
+    bool ok = checkColoring(cons, numVerts, color);
+    std::cout<<name<<": "<<cons.size()<<" constraints, "<<numColors<<" colors, "<<(ok ? "ok" : "FAILED")<<"\n";
+    return ok;
+}
+
+/**
+ * @brief n*n的布料网格：结构边、剪切边，以及对角距离弯折约束的两个对角点。
+ */
+void genCloth(int n, std::vector<std::vector<int>> &edges, std::vector<std::vector<int>> &quads)
+{
+    auto id = [&] (int x, int y) { return y * n + x; };
+    for (int y = 0; y < n; y++)
+        for (int x = 0; x < n; x++)
+        {
+            if (x + 1 < n)
+                edges.push_back({id(x, y), id(x + 1, y)});
+            if (y + 1 < n)
+                edges.push_back({id(x, y), id(x, y + 1)});
+            if (x + 1 < n && y + 1 < n)
+            {
+                edges.push_back({id(x, y), id(x + 1, y + 1)});
+                quads.push_back({id(x + 1, y), id(x, y + 1)});
+            }
+        }
+}
+
+int main()
+{
+    srand(42);
+    bool ok = true;
+
+    const int n = 64;
+    std::vector<std::vector<int>> edges, quads;
+    genCloth(n, edges, quads);
+    ok &= testColoring("cloth edges", edges, n * n);
+    ok &= testColoring("cloth quads", quads, n * n);
+
+    //随机约束，其中一个顶点被几百个约束共用，颜色超过一轮的64种
+    const int numVerts = 1000;
+    std::vector<std::vector<int>> cons(5000);
+    for (int i = 0; i < cons.size(); i++)
+    {
+        int k = genRndInt(0, 5);
+        if (i % 16 == 0)
+            cons[i].push_back(0);
+        while (cons[i].size() < k)
+        {
+            int v = genRndInt(1, numVerts);
+            if (std::find(cons[i].begin(), cons[i].end(), v) == cons[i].end())
+                cons[i].push_back(v);
+        }
+    }
+    ok &= testColoring("random with a hub and empty constraints", cons, numVerts);
+
+    //拓扑不变时沿用缓存的着色，变了就重新着色
+    UserData ud;
+    std::vector<int> color(edges.size());
+    auto vertsOf = [&] (int i, auto const &f) { for (int v: edges[i]) f(v); };
+    bool recolored = updateConstraintColoring(ud, "edgeColorTopo", true, edges.size(), n * n, vertsOf, color.data());
+    bool cached = !updateConstraintColoring(ud, "edgeColorTopo", false, edges.size(), n * n, vertsOf, color.data());
+    std::swap(edges[0][1], edges[1][1]);
+    bool changed = updateConstraintColoring(ud, "edgeColorTopo", false, edges.size(), n * n, vertsOf, color.data());
+    bool valid = checkColoring(edges, n * n, color);
+    std::cout<<"coloring cache: "<<(recolored && cached && changed && valid ? "ok" : "FAILED")<<"\n";
+    ok &= recolored && cached && changed && valid;
+
+    return ok ? 0 : 1;
+}
@@ -1629,13 +1629,24 @@ ZENDEFNODE(BulletSliderConstraintSetSpring, {
 
 struct BulletMakeWorld : zeno::INode {
     virtual void apply() override {
-        auto world = std::make_shared<BulletWorld>();
+        auto worldType = get_input2<std::string>("worldType");
+        std::shared_ptr<BulletWorld> world;
+        if (worldType == "MultiThread") {
+#if BT_THREADSAFE
+            world = std::make_shared<BulletWorld>(get_input2<int>("numThreads"), get_input2<bool>("deterministic"));
+#else
+            throw std::runtime_error("BulletMakeWorld: MultiThread needs zeno built with BULLET2_MULTITHREADING=ON");
+#endif
+        } else
+            world = std::make_shared<BulletWorld>();
         set_output("world", std::move(world));
     }
 };
 
 ZENDEFNODE(BulletMakeWorld, {
-                                {},
+                                {{"enum SingleThread MultiThread", "worldType", "SingleThread"},
+                                 {"int", "numThreads", "0"},
+                                 {"bool", "deterministic", "true"}},
                                 {"world"},
                                 {},
                                 {"Bullet"},
@@ -28,7 +28,12 @@
 #include <BulletDynamics/Featherstone/btMultiBodySphericalJointLimit.h>
 #include <BulletDynamics/Featherstone/btMultiBodySphericalJointMotor.h>
 
+#include <algorithm>
 #include <iostream>
+#include <omp.h>
+#include <optional>
+#include <unordered_map>
+#include <utility>
 
 #ifndef ZENO_RIGIDTEST_H
 #define ZENO_RIGIDTEST_H
@@ -427,47 +432,170 @@ struct BulletConstraint : zeno::IObject {
     }
 };
 
-struct BulletWorld : zeno::IObject {
-#ifdef ZENO_RIGID_MULTITHREADING
-    // mt bullet not working for now
-    std::unique_ptr<btDefaultCollisionConfiguration> collisionConfiguration;
-    std::unique_ptr<btCollisionDispatcherMt> dispatcher;
-    std::unique_ptr<btBroadphaseInterface> broadphase;
-    std::unique_ptr<btSequentialImpulseConstraintSolverMt> solver;
-    std::vector<std::unique_ptr<btSequentialImpulseConstraintSolver>> solvers;
-    std::unique_ptr<btConstraintSolverPoolMt> solverPool;
+// the multithreaded world needs bullet built thread safe, BULLET2_MULTITHREADING
+// in Rigid/CMakeLists.txt, which also defines BT_THREADSAFE
+#if BT_THREADSAFE
+// runs bullet's parallel loops (collision pairs, islands, integration) on
+// zeno's OpenMP threads. loops are always cut into grainSize chunks and sums
+// are added up chunk by chunk in order, so no result depends on the number of
+// threads. getNumThreads() is fixed, bullet sizes its per-thread arrays with it.
+// the scheduler is shared by all worlds, so the limit a world steps with is kept
+// per stepping thread (see Use) rather than in the scheduler
+struct ZenoBulletTaskScheduler : btITaskScheduler {
+    int numThreads;
 
-    std::unique_ptr<btDiscreteDynamicsWorldMt> dynamicsWorld;
+    ZenoBulletTaskScheduler() : btITaskScheduler("Zeno") {
+        numThreads = std::max(1, std::min(omp_get_max_threads(), (int)BT_MAX_THREAD_COUNT - 1));
+    }
 
-    std::set<std::shared_ptr<BulletObject>> objects;
-    std::set<std::shared_ptr<BulletConstraint>> constraints;
+    // the scheduler shared by all multithreaded worlds, installed with btSetTaskScheduler
+    static ZenoBulletTaskScheduler *get() {
+        static ZenoBulletTaskScheduler scheduler;
+        if (btGetTaskScheduler() != &scheduler)
+            btSetTaskScheduler(&scheduler);
+        return &scheduler;
+    }
 
-    BulletWorld() {
-        /*if (NULL != btGetTaskScheduler() && gTaskSchedulerMgr.getNumTaskSchedulers() > 1) {
-            log_critical("bullet multithreading enabled!");
-        } else {
-            log_critical("bullet multithreading disabled...");
-        }*/
-        collisionConfiguration = std::make_unique<btDefaultCollisionConfiguration>();
-        dispatcher = std::make_unique<btCollisionDispatcherMt>(collisionConfiguration.get());
-        broadphase = std::make_unique<btDbvtBroadphase>();
-        solver = std::make_unique<btSequentialImpulseConstraintSolverMt>();
-        std::vector<btConstraintSolver *> solversPtr;
-        for (int i = 0; i < BT_MAX_THREAD_COUNT; i++) {
-            auto sol = std::make_unique<btSequentialImpulseConstraintSolver>();
-            solversPtr.push_back(sol.get());
-            solvers.push_back(std::move(sol));
+    // thread limit of the loops started on the calling thread, 0 for all of them
+    static int &threadLimit() {
+        static thread_local int limit = 0;
+        return limit;
+    }
+
+    // limits the threads of the steps run on this thread within its scope, a
+    // world stepped concurrently on another thread keeps its own limit
+    struct Use {
+        int saved;
+
+        explicit Use(int threads) : saved(std::exchange(threadLimit(), threads)) {
+            get();
+        }
+        ~Use() {
+            threadLimit() = saved;
+        }
+        Use(Use const &) = delete;
+        Use &operator=(Use const &) = delete;
+    };
+
+    int activeThreads() const {
+        int limit = threadLimit();
+        return limit > 0 ? std::min(limit, numThreads) : numThreads;
+    }
+
+    int getMaxNumThreads() const override {
+        return numThreads;
+    }
+
+    int getNumThreads() const override {
+        return numThreads;
+    }
+
+    // bullet's setter, limits the calling thread like Use but without a scope
+    void setNumThreads(int threads) override {
+        threadLimit() = threads;
+    }
+
+    void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody &body) override {
+        grainSize = std::max(grainSize, 1);
+        int nchunks = (iEnd - iBegin + grainSize - 1) / grainSize;
+        int threads = activeThreads();
+        // nested loops (e.g. the mt solver inside an island) run on the calling thread
+        if (nchunks <= 1 || threads <= 1 || omp_in_parallel()) {
+            if (iBegin < iEnd)
+                body.forLoop(iBegin, iEnd);
+            return;
+        }
+#pragma omp parallel for num_threads(std::min(threads, nchunks)) schedule(dynamic, 1)
+        for (int c = 0; c < nchunks; c++) {
+            int b = iBegin + c * grainSize;
+            body.forLoop(b, std::min(b + grainSize, iEnd));
         }
-        solverPool = std::make_unique<btConstraintSolverPoolMt>(solversPtr.data(), solversPtr.size());
-        dynamicsWorld = std::make_unique<btDiscreteDynamicsWorldMt>(
-            dispatcher.get(), broadphase.get(), solverPool.get(), solver.get(), collisionConfiguration.get());
-        dynamicsWorld->setGravity(btVector3(0, -10, 0));
     }
-#else
+
+    btScalar parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody &body) override {
+        grainSize = std::max(grainSize, 1);
+        int nchunks = (iEnd - iBegin + grainSize - 1) / grainSize;
+        std::vector<btScalar> sums(std::max(nchunks, 0));
+        int threads = activeThreads();
+        bool parallel = nchunks > 1 && threads > 1 && !omp_in_parallel();
+#pragma omp parallel for num_threads(std::max(1, std::min(threads, nchunks))) schedule(dynamic, 1) if (parallel)
+        for (int c = 0; c < nchunks; c++) {
+            int b = iBegin + c * grainSize;
+            sums[c] = body.sumLoop(b, std::min(b + grainSize, iEnd));
+        }
+        btScalar sum = 0;
+        for (int c = 0; c < nchunks; c++)
+            sum += sums[c];
+        return sum;
+    }
+};
+
+// orders manifolds by the world array indices of their bodies. the manifolds of
+// one pair of bodies are made by one thread, stable sorting keeps them in the
+// order that thread made them
+inline void bulletSortManifolds(btAlignedObjectArray<btPersistentManifold *> &manifolds) {
+    if (manifolds.size() == 0)
+        return;
+    std::stable_sort(&manifolds[0], &manifolds[0] + manifolds.size(),
+                     [](const btPersistentManifold *a, const btPersistentManifold *b) {
+                         int a0 = a->getBody0()->getWorldArrayIndex(), b0 = b->getBody0()->getWorldArrayIndex();
+                         if (a0 != b0)
+                             return a0 < b0;
+                         return a->getBody1()->getWorldArrayIndex() < b->getBody1()->getWorldArrayIndex();
+                     });
+}
+
+// btCollisionDispatcherMt appends the manifolds made by each thread in thread
+// order, which depends on how the pairs got scheduled. deterministic worlds sort
+// them back into an order that only depends on the bodies, so that islands and
+// the contacts in them are solved the same way on every run
+struct BulletCollisionDispatcherMt : btCollisionDispatcherMt {
+    bool deterministic;
+
+    BulletCollisionDispatcherMt(btCollisionConfiguration *config, bool deterministic_)
+        : btCollisionDispatcherMt(config), deterministic(deterministic_) {
+    }
+
+    void dispatchAllCollisionPairs(btOverlappingPairCache *pairCache, const btDispatcherInfo &info,
+                                   btDispatcher *dispatcher) override {
+        btCollisionDispatcherMt::dispatchAllCollisionPairs(pairCache, info, dispatcher);
+        if (!deterministic)
+            return;
+        bulletSortManifolds(m_manifoldsPtr);
+        for (int i = 0; i < m_manifoldsPtr.size(); i++)
+            m_manifoldsPtr[i]->m_index1a = i;
+    }
+};
+
+// same for the predictive (ccd) contacts, which btDiscreteDynamicsWorldMt
+// collects from all threads under a mutex
+struct BulletDynamicsWorldMt : btDiscreteDynamicsWorldMt {
+    bool deterministic;
+
+    BulletDynamicsWorldMt(btDispatcher *dispatcher, btBroadphaseInterface *pairCache,
+                          btConstraintSolverPoolMt *solverPool, btConstraintSolver *constraintSolverMt,
+                          btCollisionConfiguration *collisionConfiguration, bool deterministic_)
+        : btDiscreteDynamicsWorldMt(dispatcher, pairCache, solverPool, constraintSolverMt, collisionConfiguration),
+          deterministic(deterministic_) {
+    }
+
+  protected:
+    void createPredictiveContacts(btScalar timeStep) override {
+        btDiscreteDynamicsWorldMt::createPredictiveContacts(timeStep);
+        if (deterministic)
+            bulletSortManifolds(m_predictiveManifolds);
+    }
+};
+#endif
+
+struct BulletWorld : zeno::IObject {
     std::unique_ptr<btDefaultCollisionConfiguration> collisionConfiguration;
     std::unique_ptr<btCollisionDispatcher> dispatcher;
     std::unique_ptr<btBroadphaseInterface> broadphase;
-    std::unique_ptr<btSequentialImpulseConstraintSolver> solver;
+    std::unique_ptr<btConstraintSolver> solver;
+    // multithreaded world only: the solvers islands are solved with in parallel
+    std::vector<std::unique_ptr<btSequentialImpulseConstraintSolver>> solvers;
+    std::unique_ptr<btConstraintSolverPoolMt> solverPool;
 
     std::unique_ptr<btDiscreteDynamicsWorld> dynamicsWorld;
     std::unique_ptr<btCollisionWorld> collisionWorld;
@@ -475,6 +603,10 @@ struct BulletWorld : zeno::IObject {
     std::set<std::shared_ptr<BulletObject>> objects;
     std::set<std::shared_ptr<BulletConstraint>> constraints;
 
+    bool multithreaded = false;
+    bool deterministic = false;
+    int numThreads = 0;
+
     BulletWorld() {
         collisionConfiguration = std::make_unique<btDefaultCollisionConfiguration>();
         /*btDefaultCollisionConstructionInfo cci;
@@ -490,6 +622,39 @@ struct BulletWorld : zeno::IObject {
         dynamicsWorld->setGravity(btVector3(0, -10, 0));
         zeno::log_debug("creating bullet world {}", (void *)this);
     }
+
+#if BT_THREADSAFE
+    // multithreaded world on numThreads threads (0 for all of them). a
+    // deterministic one solves each island on a single thread, big islands
+    // included, so that reruns reproduce exactly whatever the thread count
+    BulletWorld(int numThreads_, bool deterministic_)
+        : multithreaded(true), deterministic(deterministic_), numThreads(numThreads_) {
+        // the mt dispatcher sizes its per-thread arrays from the current scheduler
+        auto scheduler = ZenoBulletTaskScheduler::get();
+        collisionConfiguration = std::make_unique<btDefaultCollisionConfiguration>();
+        dispatcher = std::make_unique<BulletCollisionDispatcherMt>(collisionConfiguration.get(), deterministic);
+        broadphase = std::make_unique<btDbvtBroadphase>();
+        std::vector<btConstraintSolver *> solversPtr;
+        for (int i = 0; i < scheduler->getNumThreads(); i++) {
+            auto sol = std::make_unique<btSequentialImpulseConstraintSolver>();
+            solversPtr.push_back(sol.get());
+            solvers.push_back(std::move(sol));
+        }
+        solverPool = std::make_unique<btConstraintSolverPoolMt>(solversPtr.data(), solversPtr.size());
+        if (deterministic)
+            solver = std::make_unique<btSequentialImpulseConstraintSolver>();
+        else
+            solver = std::make_unique<btSequentialImpulseConstraintSolverMt>();
+        dynamicsWorld = std::make_unique<BulletDynamicsWorldMt>(dispatcher.get(), broadphase.get(), solverPool.get(),
+                                                                solver.get(), collisionConfiguration.get(), deterministic);
+        if (deterministic) {
+            dynamicsWorld->getSolverInfo().m_solverMode &= ~SOLVER_RANDMIZE_ORDER;
+            dynamicsWorld->getDispatchInfo().m_deterministicOverlappingPairs = true;
+        }
+        dynamicsWorld->setGravity(btVector3(0, -10, 0));
+        zeno::log_debug("creating multithreaded bullet world {}, threads={}, deterministic={}", (void *)this,
+                        numThreads, deterministic);
+    }
 #endif
 
     void addObject(std::shared_ptr<BulletObject> obj) {
@@ -514,11 +679,20 @@ struct BulletWorld : zeno::IObject {
                 addObject(std::move(object));
             }
         }
-        for (auto const &object : std::set(objects)) {
+        // removed from the back of the world arrays first, not in pointer order, so
+        // that the bodies end up in the same order on every run
+        std::vector<std::shared_ptr<BulletObject>> removed;
+        for (auto const &object : objects) {
             if (objSet.find(object) == objSet.end()) {
-                removeObject(object);
+                removed.push_back(object);
             }
         }
+        std::sort(removed.begin(), removed.end(), [](auto const &a, auto const &b) {
+            return a->body->getWorldArrayIndex() > b->body->getWorldArrayIndex();
+        });
+        for (auto const &object : removed) {
+            removeObject(object);
+        }
     }
 
     void addConstraint(std::shared_ptr<BulletConstraint> cons) {
@@ -545,11 +719,21 @@ struct BulletWorld : zeno::IObject {
                 addConstraint(std::move(constraint));
             }
         }
-        for (auto const &constraint : std::set(constraints)) {
+        std::unordered_map<btTypedConstraint *, int> consIndex;
+        for (int i = 0; i < dynamicsWorld->getNumConstraints(); i++)
+            consIndex[dynamicsWorld->getConstraint(i)] = i;
+        std::vector<std::shared_ptr<BulletConstraint>> removed;
+        for (auto const &constraint : constraints) {
             if (consSet.find(constraint) == consSet.end()) {
-                removeConstraint(constraint);
+                removed.push_back(constraint);
             }
         }
+        std::sort(removed.begin(), removed.end(), [&](auto const &a, auto const &b) {
+            return consIndex[a->constraint.get()] > consIndex[b->constraint.get()];
+        });
+        for (auto const &constraint : removed) {
+            removeConstraint(constraint);
+        }
     }
 
     /*
@@ -578,6 +762,11 @@ struct BulletWorld : zeno::IObject {
 
     void step(float dt = 1.f / 60.f, int steps = 1) {
         zeno::log_debug("stepping with dt={}, steps={}, len(objects)={}", dt, steps, objects.size());
+#if BT_THREADSAFE
+        std::optional<ZenoBulletTaskScheduler::Use> limit;
+        if (multithreaded)
+            limit.emplace(numThreads);
+#endif
         //dt /= steps;
         for (int i = 0; i < steps; i++)
             // ref: src/BulletDynamics/Dynamics/btDiscreteDynamicsWorld.h L108
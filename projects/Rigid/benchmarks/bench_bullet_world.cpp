@@ -0,0 +1,140 @@
+// BulletWorld (RigidTest.h) stepping a fractured wall: n box pieces glued to
+// their neighbors by breakable fixed constraints, standing on the ground and
+// hit by a heavy ball, like the pieces BulletMaintainRigidBodiesAndConstraints
+// hands over in destruction shots. steps the single-threaded world, the
+// multithreaded one and the deterministic multithreaded one, reports the time
+// per step and whether deterministic runs (a rerun, and one on a single
+// thread) end with bitwise identical transforms.
+// usage: bench_bullet_world [pieces [steps]]   (default 10000 100000, 120)
+#include "../RigidTest.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+float frand(unsigned &seed) {
+    seed = seed * 1664525u + 1013904223u;
+    return (seed >> 8) * (1.0f / 16777216.0f);
+}
+
+double seconds(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+std::shared_ptr<BulletObject> makeBody(float mass, btVector3 const &origin, std::unique_ptr<btCollisionShape> shape) {
+    btTransform trans;
+    trans.setIdentity();
+    trans.setOrigin(origin);
+    return std::make_shared<BulletObject>(mass, trans, std::make_shared<BulletCollisionShape>(std::move(shape)));
+}
+
+struct Scene {
+    std::shared_ptr<BulletWorld> world;
+    std::vector<std::shared_ptr<BulletObject>> pieces;
+    std::vector<std::shared_ptr<BulletConstraint>> glues;
+
+    // a wall about 4:2:1 of n pieces with slightly jittered sizes, so that
+    // the contacts aren't all alike
+    Scene(std::shared_ptr<BulletWorld> world_, size_t n) : world(std::move(world_)) {
+        int nz = std::max(1, (int)std::cbrt(n / 8.0));
+        int ny = 2 * nz, nx = std::max(1, (int)(n / ((size_t)ny * nz)));
+        const float size = 0.2f;
+        unsigned seed = 7;
+
+        std::vector<std::shared_ptr<BulletObject>> objs;
+        objs.push_back(makeBody(0, btVector3(0, -1, 0), std::make_unique<btBoxShape>(btVector3(100, 1, 100))));
+        for (int x = 0; x < nx; x++)
+            for (int y = 0; y < ny; y++)
+                for (int z = 0; z < nz; z++) {
+                    btVector3 half(size * (0.45f + 0.04f * frand(seed)), size * 0.495f, size * 0.495f);
+                    btVector3 origin((x - nx / 2) * size, (y + 0.5f) * size, (z - nz / 2) * size);
+                    pieces.push_back(makeBody(1, origin, std::make_unique<btBoxShape>(half)));
+                    objs.push_back(pieces.back());
+                }
+        auto ball = makeBody(500, btVector3(0, ny * size / 2, -4), std::make_unique<btSphereShape>(ny * size / 4));
+        ball->body->setLinearVelocity(btVector3(0, 0, 15));
+        objs.push_back(ball);
+        world->setObjectList(objs);
+
+        auto at = [&](int x, int y, int z) { return pieces[((size_t)x * ny + y) * nz + z]->body.get(); };
+        for (int x = 0; x < nx; x++)
+            for (int y = 0; y < ny; y++)
+                for (int z = 0; z < nz; z++) {
+                    int nb[3][3] = {{x + 1, y, z}, {x, y + 1, z}, {x, y, z + 1}};
+                    for (auto const &p: nb) {
+                        if (p[0] >= nx || p[1] >= ny || p[2] >= nz)
+                            continue;
+                        auto glue = std::make_shared<BulletConstraint>(at(x, y, z), at(p[0], p[1], p[2]), "Fixed");
+                        glue->constraint->setBreakingImpulseThreshold(8);
+                        glue->constraint->setOverrideNumSolverIterations(20);
+                        world->addConstraint(glue);
+                        glues.push_back(std::move(glue));
+                    }
+                }
+    }
+
+    std::vector<btTransform> transforms() const {
+        std::vector<btTransform> ret;
+        for (auto const &p: pieces)
+            ret.push_back(p->body->getWorldTransform());
+        return ret;
+    }
+
+    size_t broken() const {
+        size_t ret = 0;
+        for (auto const &g: glues)
+            ret += !g->constraint->isEnabled();
+        return ret;
+    }
+};
+
+// compares the 12 used floats, the 4th lane of bullet's vectors may hold anything
+bool identical(std::vector<btTransform> const &a, std::vector<btTransform> const &b) {
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); i++)
+        for (int r = 0; r < 3; r++)
+            for (int c = 0; c < 3; c++)
+                if (a[i].getBasis()[r][c] != b[i].getBasis()[r][c] || a[i].getOrigin()[r] != b[i].getOrigin()[r])
+                    return false;
+    return true;
+}
+
+std::vector<btTransform> run(const char *name, std::shared_ptr<BulletWorld> world, size_t n, int steps) {
+    Scene scene(std::move(world), n);
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < steps; i++)
+        scene.world->step(1.f / 60.f, 1);
+    double t = seconds(t0);
+    printf("  %-24s %9.2f ms/step  %zd of %zd glues broken\n", name, t * 1000 / steps, scene.broken(),
+           scene.glues.size());
+    return scene.transforms();
+}
+
+}
+
+int main(int argc, char **argv) {
+    std::vector<size_t> sizes;
+    int steps = 120;
+    if (argc > 1)
+        sizes.push_back(std::atol(argv[1]));
+    else
+        sizes = {10000, 100000};
+    if (argc > 2)
+        steps = std::atoi(argv[2]);
+
+    for (size_t n: sizes) {
+        printf("%zd pieces, %d steps, %d threads\n", n, steps, ZenoBulletTaskScheduler::get()->getNumThreads());
+        run("single thread", std::make_shared<BulletWorld>(), n, steps);
+        run("multithread", std::make_shared<BulletWorld>(0, false), n, steps);
+        auto ref = run("deterministic", std::make_shared<BulletWorld>(0, true), n, steps);
+        auto rerun = run("deterministic rerun", std::make_shared<BulletWorld>(0, true), n, steps);
+        auto serial = run("deterministic 1 thread", std::make_shared<BulletWorld>(1, true), n, steps);
+        printf("  rerun %s, 1 thread %s\n", identical(ref, rerun) ? "identical" : "MISMATCH",
+               identical(ref, serial) ? "identical" : "MISMATCH");
+    }
+    return 0;
+}
@@ -9,12 +9,9 @@
 #include <igl/directed_edge_parents.h>
 #include <igl/forward_kinematics.h>
 #include <igl/deform_skeleton.h>
-#include <igl/dqs.h>
-
-
-#include <igl/lbs_matrix.h>
 
 #include "skinning_iobject.h"
+#include "sparse_skinning.h"
 
 namespace{
 using namespace zeno;
@@ -80,38 +77,33 @@ struct DoSkinning : zeno::INode {
         auto Ts_ = get_input<zeno::ListObject>("Ts")->get<NumericObject>();
 
         // std::cout << "GOT QS AND TS INPUT" << std::endl;
-        size_t dim = 3;
         size_t nm_handles = 0;
 
 
-        auto& out_chan = shape->add_attr<zeno::vec3f>(outputChannel);
+        shape->add_attr<zeno::vec3f>(outputChannel);
         // std::cout << "CHECKOUT_1" << std::endl;
 
-        while(true){
-            std::string attr_name = attr_prefix + "_" + std::to_string(nm_handles);
-            if(shape->has_attr(attr_name)){
-                nm_handles++;
-                continue;
-            }
-            break;
-        }
-
-        Eigen::MatrixXd W;
-        W.resize(shape->size(),nm_handles);
-        for(size_t i = 0;i < nm_handles;++i){ 
-            std::string attr_name = attr_prefix +  "_" + std::to_string(i);
-            for(size_t j = 0;j < shape->size();++j){
-                if(!shape->has_attr(attr_name)){
-                    std::cout << "DO NOT HAVE " << attr_name << std::endl;
-                    std::cout << "NM_QS_AND_TS : " << nm_handles << std::endl;
-                    throw std::runtime_error("The Skinned Prim Does Not Have Weight Attr");
-                }
-                W(j,i) = shape->attr<float>(attr_name)[j];
-                if(std::isnan(W(j,i))){
-                    std::cout << "NAN VALUE DETECTED IN SKINNING WEIGHT MATRIX : " << j << "\t" << i << "\t" << W(j,i) << std::endl;
-                    throw std::runtime_error("NAN VALUE DETECTED IN SKINNING WEIGHT MATRIX");
+        // top-K weights as <prefix>Indice_k/<prefix>Weight_k (see SparsifySkinningWeights or the FBX
+        // reader's jointIndice_k/jointWeight_k), else the dense <prefix>_i weights: all nonzero ones
+        // by default, which gives the same weights as the dense matrix, or the max_influences largest
+        SparseSkinningWeights W;
+        if(SparseSkinningWeights::hasAttrs(shape.get(),attr_prefix)){
+            nm_handles = Qs_.size();
+            W.fromSparseAttrs(shape.get(),attr_prefix,nm_handles);
+        }else{
+            while(true){
+                std::string attr_name = attr_prefix + "_" + std::to_string(nm_handles);
+                if(shape->has_attr(attr_name)){
+                    nm_handles++;
+                    continue;
                 }
+                break;
             }
+            W.fromDenseAttrs(shape.get(),attr_prefix,nm_handles,get_param<int>("max_influences"));
+        }
+        if(Qs_.size() < nm_handles || Ts_.size() < nm_handles){
+            std::cout << "NM_HANDLES : " << nm_handles << "\tNM_QS_AND_TS : " << Qs_.size() << "\t" << Ts_.size() << std::endl;
+            throw std::runtime_error("THE NUMBER OF QS AND TS DOES NOT MATCH THE SKINNING WEIGHTS");
         }
 
         std::vector<Eigen::Vector3d> Ts;
@@ -188,57 +180,43 @@ struct DoSkinning : zeno::INode {
 
         // std::cout << "CHECKOUT_3" << std::endl;
 
-        Eigen::MatrixXd T(nm_handles*(dim+1),dim);
-        for(int e = 0;e<nm_handles;e++){
-            Eigen::Affine3d a = Eigen::Affine3d::Identity();
-            a.translate(Ts[e]);
-            a.rotate(Qs[e]);
-            T.block(e*(dim+1),0,dim+1,dim) =
-                a.matrix().transpose().block(0,0,dim+1,dim);
-        }
-        // Compute deformation via LBS as matrix multiplication
-        Eigen::MatrixXd U,V;
-        V.resize(shape->size(),3);
-        for(size_t i = 0;i < V.rows();++i)
-            V.row(i) << shape->verts[i][0],shape->verts[i][1],shape->verts[i][2];
-
-
-        if(std::isnan(V.norm()) || std::isnan(W.norm()) || std::isnan(T.norm())){
-            std::cout << V.norm() << "\t" << W.norm() << std::endl;
-            throw std::runtime_error("IN SKINNING NAN VW DETECTED");
+        SkinningTransforms T(Qs,Ts);
+        for(size_t e = 0;e < T.mats.size();++e){
+            for(float c : T.mats[e]){
+                if(std::isnan(c)){
+                    std::cout << "Q<" << e << "> : " << Qs[e].coeffs().transpose() << std::endl;
+                    std::cout << "T<" << e << "> : " << Ts[e].transpose() << std::endl;
+                    throw std::runtime_error("IN SKINNING NAN VW DETECTED");
+                }
+            }
         }
 
+        auto deformed_shape = std::make_shared<zeno::PrimitiveObject>(*shape);// automatic copy all the attributes
+        auto& U = deformed_shape->attr<zeno::vec3f>(outputChannel);
         if(algorithm == "DQS"){
             // std::cout << "DQS SKINNING " << std::endl;
-            igl::dqs(V,W,Qs,Ts,U);
+            // unlike igl::dqs this flips influences into the hemisphere of the heaviest one, on
+            // purpose: otherwise q and -q of the same rotation blend the long way round or cancel
+            skinDQS(shape->verts,W,T,U);
         }else if(algorithm == "LBS"){
-            Eigen::MatrixXd M;
-            igl::lbs_matrix(V,W,M);
-            U = M*T;
-        }        
+            skinLBS(shape->verts,W,T,U);
+        }
 
-        auto deformed_shape = std::make_shared<zeno::PrimitiveObject>(*shape);// automatic copy all the attributes
-        // deformed_shape->resize(shape->size());
-        // deformed_shape->tris.resize(shape->tris.size());
-        // deformed_shape->quads.resize(shape->quads.size());
-
-        if(std::isnan(U.norm())){
-            std::cout << "W : \n" << W << std::endl;
-            std::cout << "NAN DEFORMED SHAPE DETECTED: " << U.norm() << std::endl;
-            std::cout << "AFFINE : " << std::endl;
-            for(size_t i = 0;i < nm_handles;++i){
-                std::cout << Qs[i].x() << "\t" 
-                            << Qs[i].y() << "\t" 
-                            << Qs[i].z() << "\t" 
-                            << Qs[i].w() << std::endl;
-                std::cout << Ts[i].transpose() << std::endl;
+        int nan_at = -1;
+        #pragma omp parallel for
+        for(intptr_t i = 0;i < (intptr_t)U.size();++i){
+            if(std::isnan(U[i][0] + U[i][1] + U[i][2])){
+                #pragma omp critical
+                nan_at = i;
             }
-
+        }
+        if(nan_at >= 0){
+            std::cout << "NAN DEFORMED SHAPE DETECTED AT VERTEX : " << nan_at << std::endl;
+            for(int k = 0;k < W.nm_influences;++k)
+                std::cout << W.indices[nan_at * W.nm_influences + k] << "\t" << W.weights[nan_at * W.nm_influences + k] << std::endl;
             throw std::runtime_error("NAN DEFORMED SHAPE DETECTED");
         }
         // std::cout << "CHECKOUT_4" << std::endl;
-        for(size_t i = 0;i < deformed_shape->size();++i)
-            out_chan[i] = zeno::vec3f(U.row(i)[0],U.row(i)[1],U.row(i)[2]);
 
         set_output("dshape",std::move(deformed_shape));
     }
@@ -247,7 +225,36 @@ struct DoSkinning : zeno::INode {
 ZENDEFNODE(DoSkinning, {
     {"shape","Qs","Ts","restBones"},
     {"dshape"},
-    {{"enum LBS DQS","algorithm","DQS"},{"string","attr_prefix","sw"},{"string","out_channel","curPos"},{"int","FK","0"}},
+    {{"enum LBS DQS","algorithm","DQS"},{"string","attr_prefix","sw"},{"string","out_channel","curPos"},{"int","FK","0"},{"int","max_influences","0"}},
+    {"Skinning"},
+});
+
+// keeps the max_influences largest (0: all nonzero ones) of the dense per bone weights
+// <prefix>_i as the sparse <prefix>Indice_k/<prefix>Weight_k that DoSkinning reads directly
+struct SparsifySkinningWeights : zeno::INode {
+    virtual void apply() override {
+        auto shape = get_input<PrimitiveObject>("shape");
+        auto attr_prefix = get_param<std::string>("attr_prefix");
+
+        size_t nm_handles = 0;
+        while(shape->has_attr(attr_prefix + "_" + std::to_string(nm_handles)))
+            nm_handles++;
+
+        SparseSkinningWeights W;
+        W.fromDenseAttrs(shape.get(),attr_prefix,nm_handles,get_param<int>("max_influences"));
+        W.toAttrs(shape.get(),attr_prefix);
+        if(get_param<int>("remove_dense")){
+            for(size_t i = 0;i < nm_handles;++i)
+                shape->verts.erase_attr(attr_prefix + "_" + std::to_string(i));
+        }
+        set_output("shape",std::move(shape));
+    }
+};
+
+ZENDEFNODE(SparsifySkinningWeights, {
+    {"shape"},
+    {"shape"},
+    {{"string","attr_prefix","sw"},{"int","max_influences","0"},{"int","remove_dense","1"}},
     {"Skinning"},
 });
 
@@ -0,0 +1,257 @@
+#pragma once
+
+#include <zeno/zeno.h>
+#include <zeno/types/PrimitiveObject.h>
+#include <zeno/types/UserData.h>
+
+#include <Eigen/Geometry>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace{
+using namespace zeno;
+
+// top-K skinning weights of each vertex, K slots per vertex stored contiguously,
+// unused slots have index 0 and weight 0. on a prim they live in the float attrs
+// <prefix>Indice_k and <prefix>Weight_k (k < K), the same layout the FBX reader
+// writes its jointIndice_k/jointWeight_k in, and K in userData <prefix>IndicesElementSize
+struct SparseSkinningWeights {
+    int nm_influences = 0;
+    std::vector<int> indices;
+    std::vector<float> weights;
+
+    size_t size() const {
+        return nm_influences ? weights.size() / nm_influences : 0;
+    }
+
+    static std::string indiceAttr(std::string const &prefix,int k) {
+        return prefix + "Indice_" + std::to_string(k);
+    }
+
+    static std::string weightAttr(std::string const &prefix,int k) {
+        return prefix + "Weight_" + std::to_string(k);
+    }
+
+    static bool hasAttrs(PrimitiveObject *prim,std::string const &prefix) {
+        return prim->has_attr(indiceAttr(prefix,0)) && prim->has_attr(weightAttr(prefix,0));
+    }
+
+    // keeps the K largest of the dense weights <prefix>_0 .. <prefix>_{nm_handles-1},
+    // scaled to the sum of the whole row so that truncating doesn't shrink the mesh.
+    // K <= 0 keeps all nonzero weights, K is then the most any vertex has
+    void fromDenseAttrs(PrimitiveObject *prim,std::string const &prefix,int nm_handles,int K) {
+        size_t nv = prim->size();
+        std::vector<float const *> cols(nm_handles);
+        for(int h = 0;h < nm_handles;++h){
+            std::string attr_name = prefix + "_" + std::to_string(h);
+            if(!prim->has_attr(attr_name)){
+                std::cout << "DO NOT HAVE " << attr_name << std::endl;
+                throw std::runtime_error("The Skinned Prim Does Not Have Weight Attr");
+            }
+            cols[h] = prim->attr<float>(attr_name).data();
+        }
+        if(K <= 0){
+            std::vector<int> nonzeros(nv,0);
+            for(int h = 0;h < nm_handles;++h){
+                #pragma omp parallel for
+                for(intptr_t i = 0;i < (intptr_t)nv;++i)
+                    nonzeros[i] += cols[h][i] != 0;
+            }
+            K = nonzeros.empty() ? 0 : *std::max_element(nonzeros.begin(),nonzeros.end());
+        }
+        nm_influences = std::max(std::min(K,nm_handles),1);
+        indices.assign(nv * nm_influences,0);
+        weights.assign(nv * nm_influences,0);
+        std::vector<float> rowSum(nv,0);
+        std::vector<char> truncated(nv,0);
+
+        // a column at a time, each attr is looked up once
+        for(int h = 0;h < nm_handles;++h){
+            float const *col = cols[h];
+            intptr_t nan_at = -1;
+            #pragma omp parallel for
+            for(intptr_t i = 0;i < (intptr_t)nv;++i){
+                float w = col[i];
+                if(std::isnan(w)){
+                    #pragma omp critical
+                    nan_at = i;
+                    continue;
+                }
+                rowSum[i] += w;
+                if(w == 0)
+                    continue;
+                // slots sorted by decreasing |weight|, insert if it beats the last one
+                int *idx = &indices[i * nm_influences];
+                float *wgt = &weights[i * nm_influences];
+                int k = nm_influences - 1;
+                if(std::abs(w) <= std::abs(wgt[k])){
+                    truncated[i] = 1;
+                    continue;
+                }
+                truncated[i] |= wgt[k] != 0;
+                for(;k > 0 && std::abs(w) > std::abs(wgt[k - 1]);--k){
+                    idx[k] = idx[k - 1];
+                    wgt[k] = wgt[k - 1];
+                }
+                idx[k] = h;
+                wgt[k] = w;
+            }
+            if(nan_at >= 0){
+                std::cout << "NAN VALUE DETECTED IN SKINNING WEIGHT MATRIX : " << nan_at << "\t" << h << std::endl;
+                throw std::runtime_error("NAN VALUE DETECTED IN SKINNING WEIGHT MATRIX");
+            }
+        }
+
+        // rows that kept all their weights are left exactly as they were
+        #pragma omp parallel for
+        for(intptr_t i = 0;i < (intptr_t)nv;++i){
+            if(!truncated[i])
+                continue;
+            float *wgt = &weights[i * nm_influences];
+            float kept = 0;
+            for(int k = 0;k < nm_influences;++k)
+                kept += wgt[k];
+            if(kept != 0)
+                for(int k = 0;k < nm_influences;++k)
+                    wgt[k] *= rowSum[i] / kept;
+        }
+    }
+
+    void fromSparseAttrs(PrimitiveObject *prim,std::string const &prefix,int nm_handles) {
+        int K = 0;
+        if(prim->userData().has<int>(prefix + "IndicesElementSize"))
+            K = prim->userData().get2<int>(prefix + "IndicesElementSize");
+        else
+            while(prim->has_attr(indiceAttr(prefix,K)))
+                K++;
+        size_t nv = prim->size();
+        nm_influences = std::max(K,1);
+        indices.assign(nv * nm_influences,0);
+        weights.assign(nv * nm_influences,0);
+        for(int k = 0;k < K;++k){
+            auto const &idx = prim->attr<float>(indiceAttr(prefix,k));
+            auto const &wgt = prim->attr<float>(weightAttr(prefix,k));
+            intptr_t bad_at = -1;
+            #pragma omp parallel for
+            for(intptr_t i = 0;i < (intptr_t)nv;++i){
+                int h = (int)idx[i];
+                float w = wgt[i];
+                if(std::isnan(w) || (w != 0 && (h < 0 || h >= nm_handles))){
+                    #pragma omp critical
+                    bad_at = i;
+                    continue;
+                }
+                indices[i * nm_influences + k] = w != 0 ? h : 0;
+                weights[i * nm_influences + k] = w;
+            }
+            if(bad_at >= 0){
+                std::cout << "INVALID SPARSE SKINNING WEIGHT : " << bad_at << "\t" << idx[bad_at] << "\t" << wgt[bad_at] << std::endl;
+                throw std::runtime_error("INVALID SPARSE SKINNING WEIGHT");
+            }
+        }
+    }
+
+    void toAttrs(PrimitiveObject *prim,std::string const &prefix) const {
+        size_t nv = size();
+        for(int k = 0;k < nm_influences;++k){
+            auto &idx = prim->add_attr<float>(indiceAttr(prefix,k));
+            auto &wgt = prim->add_attr<float>(weightAttr(prefix,k));
+            for(size_t i = 0;i < nv;++i){
+                idx[i] = (float)indices[i * nm_influences + k];
+                wgt[i] = weights[i * nm_influences + k];
+            }
+        }
+        prim->userData().set2(prefix + "IndicesElementSize",nm_influences);
+    }
+};
+
+// per-bone transforms x -> R(q) x + t in float, as the 3x4 row major matrix for
+// LBS and as the unit dual quaternion (q, 0.5 * t * q) for DQS
+struct SkinningTransforms {
+    std::vector<std::array<float,12>> mats;
+    std::vector<std::array<float,8>> dqs;   // q.w q.x q.y q.z e.w e.x e.y e.z
+
+    template<class RotationList,class TranslationList>
+    SkinningTransforms(RotationList const &Qs,TranslationList const &Ts) {
+        mats.resize(Qs.size());
+        dqs.resize(Qs.size());
+        for(size_t e = 0;e < Qs.size();++e){
+            Eigen::Matrix3d R = Qs[e].toRotationMatrix();
+            for(int r = 0;r < 3;++r){
+                for(int c = 0;c < 3;++c)
+                    mats[e][r * 4 + c] = (float)R(r,c);
+                mats[e][r * 4 + 3] = (float)Ts[e][r];
+            }
+            Eigen::Quaterniond q = Qs[e];
+            Eigen::Quaterniond d = Eigen::Quaterniond(0,Ts[e][0],Ts[e][1],Ts[e][2]) * q;
+            dqs[e] = {(float)q.w(),(float)q.x(),(float)q.y(),(float)q.z(),
+                (float)(0.5 * d.w()),(float)(0.5 * d.x()),(float)(0.5 * d.y()),(float)(0.5 * d.z())};
+        }
+    }
+};
+
+// linear blend skinning: blends the 3x4 bone matrices of each vertex's influences
+// (12 lanes, vectorized) and applies the blend once
+inline void skinLBS(std::vector<vec3f> const &V,SparseSkinningWeights const &W,
+        SkinningTransforms const &T,std::vector<vec3f> &U) {
+    const int K = W.nm_influences;
+    #pragma omp parallel for
+    for(intptr_t i = 0;i < (intptr_t)V.size();++i){
+        alignas(64) float m[12] = {};
+        for(int k = 0;k < K;++k){
+            float w = W.weights[i * K + k];
+            if(w == 0)
+                continue;
+            const float *b = T.mats[W.indices[i * K + k]].data();
+            #pragma omp simd
+            for(int c = 0;c < 12;++c)
+                m[c] += w * b[c];
+        }
+        auto v = V[i];
+        U[i] = vec3f(m[0] * v[0] + m[1] * v[1] + m[2] * v[2] + m[3],
+                     m[4] * v[0] + m[5] * v[1] + m[6] * v[2] + m[7],
+                     m[8] * v[0] + m[9] * v[1] + m[10] * v[2] + m[11]);
+    }
+}
+
+// dual quaternion skinning (Kavan et al, algorithm 1). influences whose rotation
+// is in the other hemisphere from the first one (the largest, for weights made
+// from dense ones) are blended negated, as q and -q are the same rotation
+inline void skinDQS(std::vector<vec3f> const &V,SparseSkinningWeights const &W,
+        SkinningTransforms const &T,std::vector<vec3f> &U) {
+    const int K = W.nm_influences;
+    #pragma omp parallel for
+    for(intptr_t i = 0;i < (intptr_t)V.size();++i){
+        alignas(32) float b[8] = {};
+        const float *pivot = nullptr;
+        for(int k = 0;k < K;++k){
+            float w = W.weights[i * K + k];
+            if(w == 0)
+                continue;
+            const float *dq = T.dqs[W.indices[i * K + k]].data();
+            if(!pivot)
+                pivot = dq;
+            else if(pivot[0] * dq[0] + pivot[1] * dq[1] + pivot[2] * dq[2] + pivot[3] * dq[3] < 0)
+                w = -w;
+            #pragma omp simd
+            for(int c = 0;c < 8;++c)
+                b[c] += w * dq[c];
+        }
+        float inv = 1.0f / std::sqrt(b[0] * b[0] + b[1] * b[1] + b[2] * b[2] + b[3] * b[3]);
+        for(int c = 0;c < 8;++c)
+            b[c] *= inv;
+
+        vec3f v = V[i];
+        vec3f d0(b[1],b[2],b[3]),de(b[5],b[6],b[7]);
+        float a0 = b[0],ae = b[4];
+        U[i] = v + 2 * cross(d0,cross(d0,v) + a0 * v) + 2 * (a0 * de - ae * d0 + cross(d0,de));
+    }
+}
+
+};
@@ -12,115 +12,168 @@
 
 namespace zeno {
 
-typename LBvh::BvFunc
-LBvh::getBvFunc(const std::shared_ptr<PrimitiveObject> &prim) const {
+namespace {
+
+using Ti = LBvh::Ti;
+using Tu = LBvh::Tu;
+using Box = LBvh::Box;
+
+// box of the vertices ids[0, n) of an element, grown by thickness
+template <typename Ids>
+Box element_box(const std::vector<vec3f> &refpos, const Ids &ids, int n,
+                float thickness) {
   constexpr auto ma = std::numeric_limits<float>::max();
   constexpr auto mi = std::numeric_limits<float>::lowest();
-  const Box defaultBox{TV{ma, ma, ma}, TV{mi, mi, mi}};
+  Box bv{vec3f{ma, ma, ma}, vec3f{mi, mi, mi}};
+  for (int j = 0; j != n; ++j) {
+    const auto &p = refpos[ids[j]];
+    for (int d = 0; d != 3; ++d) {
+      if (p[d] - thickness < bv.first[d])
+        bv.first[d] = p[d] - thickness;
+      if (p[d] + thickness > bv.second[d])
+        bv.second[d] = p[d] + thickness;
+    }
+  }
+  return bv;
+}
 
-  std::function<Box(typename LBvh::Ti)> getBv;
-  if (eleCategory == element_e::tet)
-    getBv = [&quads = prim->quads, &refpos = prim->attr<vec3f>("pos"),
-             defaultBox, this](Ti i) -> Box {
-      auto quad = quads[i];
-      Box bv = defaultBox;
-      for (int j = 0; j != 4; ++j) {
-        const auto &p = refpos[quad[j]];
-        for (int d = 0; d != 3; ++d) {
-          if (p[d] - thickness < bv.first[d])
-            bv.first[d] = p[d] - thickness;
-          if (p[d] + thickness > bv.second[d])
-            bv.second[d] = p[d] + thickness;
-        }
-      }
-      return bv;
-    };
-  else if (eleCategory == element_e::tri)
-    getBv = [&tris = prim->tris, &refpos = prim->attr<vec3f>("pos"), defaultBox,
-             this](Ti i) -> Box {
-      auto tri = tris[i];
-      Box bv = defaultBox;
-      for (int j = 0; j != 3; ++j) {
-        const auto &p = refpos[tri[j]];
-        for (int d = 0; d != 3; ++d) {
-          if (p[d] - thickness < bv.first[d])
-            bv.first[d] = p[d] - thickness;
-          if (p[d] + thickness > bv.second[d])
-            bv.second[d] = p[d] + thickness;
-        }
-      }
-      return bv;
-    };
-  else if (eleCategory == element_e::line)
-    getBv = [&lines = prim->lines, &refpos = prim->attr<vec3f>("pos"),
-             defaultBox, this](Ti i) -> Box {
-      auto line = lines[i];
-      Box bv = defaultBox;
-      for (int j = 0; j != 2; ++j) {
-        const auto &p = refpos[line[j]];
+// calls f(getBv) with the box function of element category et as a plain
+// lambda, so the per-element loops of build and refit get it inlined instead
+// of paying an indirect call per primitive
+template <LBvh::element_e et, typename F>
+void visit_bv_func(const PrimitiveObject &prim, float thickness,
+                   const std::string &radiusAttr,
+                   const std::string &neiRadiusAttr, F &&f) {
+  const auto &refpos = prim.attr<vec3f>("pos");
+  if constexpr (et == LBvh::element_e::tet) {
+    f([&quads = prim.quads.values, &refpos, thickness](Ti i) {
+      return element_box(refpos, quads[i], 4, thickness);
+    });
+  } else if constexpr (et == LBvh::element_e::tri) {
+    f([&tris = prim.tris.values, &refpos, thickness](Ti i) {
+      return element_box(refpos, tris[i], 3, thickness);
+    });
+  } else if constexpr (et == LBvh::element_e::line) {
+    f([&lines = prim.lines.values, &refpos, thickness](Ti i) {
+      return element_box(refpos, lines[i], 2, thickness);
+    });
+  } else if constexpr (et == LBvh::element_e::point) {
+    const auto &points = prim.points.values;
+    if (radiusAttr.empty() && neiRadiusAttr.empty()) {
+      f([&points, &refpos, thickness](Ti i) {
+        return element_box(refpos, &points[i], 1, thickness);
+      });
+    } else if (!radiusAttr.empty() && neiRadiusAttr.empty()) {
+      f([&points, &refpos, &radius = prim.verts.attr<float>(radiusAttr),
+         thickness](Ti i) {
+        const auto &p = refpos[points[i]];
+        Box bv;
         for (int d = 0; d != 3; ++d) {
-          if (p[d] - thickness < bv.first[d])
-            bv.first[d] = p[d] - thickness;
-          if (p[d] + thickness > bv.second[d])
-            bv.second[d] = p[d] + thickness;
+          bv.first[d] = p[d] - thickness - radius[i];
+          bv.second[d] = p[d] + thickness + radius[i];
         }
-      }
-      return bv;
-    };
-  else if (eleCategory == element_e::point)
-      if (radiusAttr.empty() && neiRadiusAttr.empty()) {
-        getBv = [&points = prim->points, &refpos = prim->attr<vec3f>("pos"),  
-             defaultBox, this](Ti i) -> Box {
+        return bv;
+      });
+    } else if (!radiusAttr.empty() && !neiRadiusAttr.empty()) {
+      f([&points, &refpos, &radius = prim.verts.attr<float>(radiusAttr),
+         &neiRadius = prim.verts.attr<float>(neiRadiusAttr), thickness](Ti i) {
         auto point = points[i];
-        Box bv = defaultBox;
         const auto &p = refpos[point];
+        Box bv;
         for (int d = 0; d != 3; ++d) {
-          if (p[d] - thickness < bv.first[d])
-            bv.first[d] = p[d] - thickness ;
-          if (p[d] + thickness > bv.second[d])
-            bv.second[d] = p[d] + thickness;
-          }
-      return bv;
-        };
-      } 
-      else if(!radiusAttr.empty() && neiRadiusAttr.empty()) {
-        getBv = [&points = prim->points, &refpos = prim->attr<vec3f>("pos"), 
-        &radius = prim->verts.attr<float>(radiusAttr),
-             defaultBox, this](Ti i) -> Box {
-        auto point = points[i];
-        Box bv = defaultBox;
-        const auto &p = refpos[point];
-        for (int d = 0; d != 3; ++d) {
-          if (p[d] - thickness - radius[i] < bv.first[d])
-            bv.first[d] = p[d] - thickness - radius[i];
-          if (p[d] + thickness + radius[i]  > bv.second[d])
-            bv.second[d] = p[d] + thickness + radius[i];
-          }
-      return bv;
-      };
+          bv.first[d] = p[d] - thickness - radius[i] - neiRadius[point];
+          bv.second[d] = p[d] + thickness + radius[i] + neiRadius[point];
+        }
+        return bv;
+      });
+    } else {
+      throw std::runtime_error(
+          "neiRadiusAttr should be empty when radiusAttr is empty");
     }
-      else if(!radiusAttr.empty() && !neiRadiusAttr.empty()) {
-        getBv = [&points = prim->points, &refpos = prim->attr<vec3f>("pos"), 
-        &radius = prim->verts.attr<float>(radiusAttr),
-        &neiRadius = prim->verts.attr<float>(neiRadiusAttr),
-             defaultBox, this](Ti i) -> Box {
-        auto point = points[i];
-        Box bv = defaultBox;
-        const auto &p = refpos[point];
-        for (int d = 0; d != 3; ++d) {
-          if (p[d] - thickness - radius[i] - neiRadius[point] < bv.first[d])
-            bv.first[d] = p[d] - thickness - radius[i]- neiRadius[point] ;
-          if (p[d] + thickness + radius[i]  + neiRadius[point]> bv.second[d])
-            bv.second[d] = p[d] + thickness + radius[i] + neiRadius[point];
-          }
-      return bv;
-      };
+  } else {
+    f([](Ti) {
+      constexpr auto ma = std::numeric_limits<float>::max();
+      constexpr auto mi = std::numeric_limits<float>::lowest();
+      return Box{vec3f{ma, ma, ma}, vec3f{mi, mi, mi}};
+    });
+  }
+}
+
+// morton code of a point in the unit cube
+Tu morton_code(const vec3f &p) {
+  auto expand_bits = [](Tu v) -> Tu { // expands lower 10-bits to 30 bits
+    v = (v * 0x00010001u) & 0xFF0000FFu;
+    v = (v * 0x00000101u) & 0x0F00F00Fu;
+    v = (v * 0x00000011u) & 0xC30C30C3u;
+    v = (v * 0x00000005u) & 0x49249249u;
+    return v;
+  };
+  return (expand_bits((Tu)(p[0] * 1024.f)) << (Tu)2) |
+         (expand_bits((Tu)(p[1] * 1024.f)) << (Tu)1) |
+         expand_bits((Tu)(p[2] * 1024.f));
+}
+
+int num_chunks(Ti n) {
+#if defined(_OPENMP)
+  return std::max(1, std::min<int>(omp_get_max_threads(), n / 65536));
+#else
+  return 1;
+#endif
+}
+
+// stable parallel LSD radix sort of <morton code, id> records by their code.
+// the ids come in ascending, so this is the same order as sorting the pairs
+void sort_records(std::vector<std::pair<Tu, Ti>> &records, int numBits) {
+  const Ti n = records.size();
+  const int nchunks = num_chunks(n);
+  std::vector<std::pair<Tu, Ti>> tmp(n);
+  std::vector<Ti> counts(nchunks * 256);
+  for (int shift = 0; shift < numBits; shift += 8) {
+    std::fill(counts.begin(), counts.end(), 0);
+#if defined(_OPENMP)
+#pragma omp parallel for
+#endif
+    for (int t = 0; t < nchunks; ++t) {
+      Ti *cnt = counts.data() + t * 256;
+      for (Ti i = (int64_t)n * t / nchunks; i < (int64_t)n * (t + 1) / nchunks; ++i)
+        cnt[(records[i].first >> shift) & 255]++;
     }
-      else{
-          throw std::runtime_error("neiRadiusAttr should be empty when radiusAttr is empty");
+    // digit-major, chunk-minor offsets keep the sort stable
+    Ti sum = 0;
+    for (int b = 0; b != 256; ++b)
+      for (int t = 0; t != nchunks; ++t) {
+        Ti c = counts[t * 256 + b];
+        counts[t * 256 + b] = sum;
+        sum += c;
       }
-  else if (eleCategory == element_e::unknown)
-    getBv = [defaultBox](Ti) -> Box { return defaultBox; };
+#if defined(_OPENMP)
+#pragma omp parallel for
+#endif
+    for (int t = 0; t < nchunks; ++t) {
+      Ti *cnt = counts.data() + t * 256;
+      for (Ti i = (int64_t)n * t / nchunks; i < (int64_t)n * (t + 1) / nchunks; ++i)
+        tmp[cnt[(records[i].first >> shift) & 255]++] = records[i];
+    }
+    records.swap(tmp);
+  }
+}
+
+} // namespace
+
+typename LBvh::BvFunc
+LBvh::getBvFunc(const std::shared_ptr<PrimitiveObject> &prim) const {
+  BvFunc getBv;
+  auto assign = [&getBv](const auto &f) { getBv = f; };
+  if (eleCategory == element_e::tet)
+    visit_bv_func<element_e::tet>(*prim, thickness, radiusAttr, neiRadiusAttr, assign);
+  else if (eleCategory == element_e::tri)
+    visit_bv_func<element_e::tri>(*prim, thickness, radiusAttr, neiRadiusAttr, assign);
+  else if (eleCategory == element_e::line)
+    visit_bv_func<element_e::line>(*prim, thickness, radiusAttr, neiRadiusAttr, assign);
+  else if (eleCategory == element_e::point)
+    visit_bv_func<element_e::point>(*prim, thickness, radiusAttr, neiRadiusAttr, assign);
+  else
+    visit_bv_func<element_e::unknown>(*prim, thickness, radiusAttr, neiRadiusAttr, assign);
   return getBv;
 }
 
@@ -164,7 +217,6 @@ void LBvh::build(const std::shared_ptr<PrimitiveObject> &prim, float thickness,
     }
   }
 
-  const auto &refpos = prim->attr<vec3f>("pos");
   const Ti numNodes = numLeaves > 2 ? numLeaves + numLeaves - 1 : numLeaves;
   sortedBvs.resize(numNodes);
   auxIndices.resize(numNodes);
@@ -172,7 +224,17 @@ void LBvh::build(const std::shared_ptr<PrimitiveObject> &prim, float thickness,
   parents.resize(numNodes);
   leafIndices.resize(numLeaves);
 
-  this->getBv = getBvFunc(prim);
+  visit_bv_func<et>(*prim, thickness, radiusAttr, neiRadiusAttr,
+                    [&](const auto &getBv) {
+                      build_impl(prim, getBv, element_c<et>);
+                    });
+}
+
+template <LBvh::element_e et, typename GetBv>
+void LBvh::build_impl(const std::shared_ptr<PrimitiveObject> &prim,
+                      const GetBv &getBv, element_t<et>) {
+  const auto &refpos = prim->attr<vec3f>("pos");
+  const Ti numLeaves = getNumLeaves();
 
   if (numLeaves <= 2) { // edge cases where not enough primitives to form a tree
     for (Ti i = 0; i != numLeaves; ++i) {
@@ -190,38 +252,27 @@ void LBvh::build(const std::shared_ptr<PrimitiveObject> &prim, float thickness,
   constexpr auto mi = std::numeric_limits<float>::lowest();
   Box wholeBox{TV{ma, ma, ma}, TV{mi, mi, mi}};
 
-  // fmt::print("wholebox before[{}, {}, {}] - [{}, {}, {}]\n",
-  // wholeBox.first[0], wholeBox.first[1], wholeBox.first[2],
-  // wholeBox.second[0], wholeBox.second[1], wholeBox.second[2]);
-  /// whole box
+  /// whole box, one pass over all the points
   TV minVec = {ma, ma, ma};
   TV maxVec = {mi, mi, mi};
-
-  // ref: https://www.openmp.org/spec-html/5.0/openmpsu107.html
-  for (int d = 0; d != dim; ++d) {
-    float &v = minVec[d];
-#ifndef _MSC_VER
 #if defined(_OPENMP)
-#pragma omp parallel for reduction(min : v)
+#pragma omp parallel
 #endif
+  {
+    TV lmin = minVec, lmax = maxVec;
+#if defined(_OPENMP)
+#pragma omp for nowait
 #endif
-    for (Ti i = 0; i < refpos.size(); ++i) {
-      const auto &p = refpos[i];
-      if (p[d] < v)
-        v = p[d];
+    for (Ti i = 0; i < (Ti)refpos.size(); ++i) {
+      lmin = zeno::min(lmin, refpos[i]);
+      lmax = zeno::max(lmax, refpos[i]);
     }
-  }
-  for (int d = 0; d != dim; ++d) {
-    float &v = maxVec[d];
-#ifndef _MSC_VER
 #if defined(_OPENMP)
-#pragma omp parallel for reduction(max : v)
-#endif
+#pragma omp critical
 #endif
-    for (Ti i = 0; i < refpos.size(); ++i) {
-      const auto &p = refpos[i];
-      if (p[d] > v)
-        v = p[d];
+    {
+      minVec = zeno::min(minVec, lmin);
+      maxVec = zeno::max(maxVec, lmax);
     }
   }
   wholeBox.first = minVec;
@@ -236,18 +287,6 @@ void LBvh::build(const std::shared_ptr<PrimitiveObject> &prim, float thickness,
 
   std::vector<std::pair<Tu, Ti>> records(numLeaves); // <mc, id>
   /// morton codes
-  auto getMortonCode = [](const TV &p) -> Tu {
-    auto expand_bits = [](Tu v) -> Tu { // expands lower 10-bits to 30 bits
-      v = (v * 0x00010001u) & 0xFF0000FFu;
-      v = (v * 0x00000101u) & 0x0F00F00Fu;
-      v = (v * 0x00000011u) & 0xC30C30C3u;
-      v = (v * 0x00000005u) & 0x49249249u;
-      return v;
-    };
-    return (expand_bits((Tu)(p[0] * 1024.f)) << (Tu)2) |
-           (expand_bits((Tu)(p[1] * 1024.f)) << (Tu)1) |
-           expand_bits((Tu)(p[2] * 1024.f));
-  };
   {
     const auto lengths = wholeBox.second - wholeBox.first;
     auto getUniformCoord = [&wholeBox, &lengths](const TV &p) {
@@ -267,7 +306,7 @@ void LBvh::build(const std::shared_ptr<PrimitiveObject> &prim, float thickness,
         auto uc = getUniformCoord((refpos[quad[0]] + refpos[quad[1]] +
                                    refpos[quad[2]] + refpos[quad[3]]) /
                                   4);
-        records[i] = std::make_pair(getMortonCode(uc), i);
+        records[i] = std::make_pair(morton_code(uc), i);
       }
     } else if constexpr (et == element_e::tri) {
 #if defined(_OPENMP)
@@ -277,7 +316,7 @@ void LBvh::build(const std::shared_ptr<PrimitiveObject> &prim, float thickness,
         auto tri = prim->tris[i];
         auto uc = getUniformCoord(
             (refpos[tri[0]] + refpos[tri[1]] + refpos[tri[2]]) / 3);
-        records[i] = std::make_pair(getMortonCode(uc), i);
+        records[i] = std::make_pair(morton_code(uc), i);
       }
     } else if constexpr (et == element_e::line) {
 #if defined(_OPENMP)
@@ -286,7 +325,7 @@ void LBvh::build(const std::shared_ptr<PrimitiveObject> &prim, float thickness,
       for (Ti i = 0; i < numLeaves; ++i) {
         auto line = prim->lines[i];
         auto uc = getUniformCoord((refpos[line[0]] + refpos[line[1]]) / 2);
-        records[i] = std::make_pair(getMortonCode(uc), i);
+        records[i] = std::make_pair(morton_code(uc), i);
       }
     } else if constexpr (et == element_e::point) {
 #if defined(_OPENMP)
@@ -295,11 +334,11 @@ void LBvh::build(const std::shared_ptr<PrimitiveObject> &prim, float thickness,
       for (Ti i = 0; i < numLeaves; ++i) {
         auto pi = prim->points[i];
         auto uc = getUniformCoord(refpos[pi]);
-        records[i] = std::make_pair(getMortonCode(uc), i);
+        records[i] = std::make_pair(morton_code(uc), i);
       }
     }
   }
-  std::sort(std::begin(records), std::end(records));
+  sort_records(records, 30);
 
   std::vector<Tu> splits(numLeaves);
   ///
@@ -521,9 +560,22 @@ void LBvh::refit() {
   if (!prim)
     throw std::runtime_error(
         "the primitive object referenced by lbvh not available anymore");
-  const auto &refpos = prim->attr<vec3f>("pos");
 
-  const auto numLeaves = getNumLeaves();
+  auto refitWith = [this](const auto &getBv) { refit_impl(getBv); };
+  if (eleCategory == element_e::tet)
+    visit_bv_func<element_e::tet>(*prim, thickness, radiusAttr, neiRadiusAttr, refitWith);
+  else if (eleCategory == element_e::tri)
+    visit_bv_func<element_e::tri>(*prim, thickness, radiusAttr, neiRadiusAttr, refitWith);
+  else if (eleCategory == element_e::line)
+    visit_bv_func<element_e::line>(*prim, thickness, radiusAttr, neiRadiusAttr, refitWith);
+  else if (eleCategory == element_e::point)
+    visit_bv_func<element_e::point>(*prim, thickness, radiusAttr, neiRadiusAttr, refitWith);
+  else
+    visit_bv_func<element_e::unknown>(*prim, thickness, radiusAttr, neiRadiusAttr, refitWith);
+}
+
+template <typename GetBv> void LBvh::refit_impl(const GetBv &getBv) {
+  const Ti numLeaves = getNumLeaves();
   if (numLeaves <= 2) {
     for (Ti i = 0; i != numLeaves; ++i) {
       sortedBvs[i] = getBv(i);
@@ -535,51 +587,277 @@ void LBvh::refit() {
     return;
   }
   const auto numNodes = numLeaves * 2 - 1;
+  // zero-initialized by the default ctor, see build
   std::vector<std::atomic<Ti>> refitFlags(numNodes);
-#if 0
-        // comment out with the same reason in build
+
+  // bottom up from every leaf, the second thread to arrive at a node merges its
+  // children and goes on, the first one stops there
+#if defined(_OPENMP)
 #pragma omp parallel for
-        for (Ti i = 0; i < numNodes; ++i)
-            refitFlags[i] = 0;
 #endif
+  for (Ti nid = 0; nid < numLeaves; ++nid) {
+    auto idx = leafIndices[nid];
+    sortedBvs[idx] = getBv(auxIndices[idx]);
 
-  {
+    auto par = parents[idx];
+    while (par != -1) {
+      if (refitFlags[par].fetch_add(1, std::memory_order_acq_rel) == 0)
+        break;
+      auto lc = par + 1;
+      auto rc = levels[lc] == 0 ? lc + 1 : auxIndices[lc];
+      // merge box
+      const auto &leftBox = sortedBvs[lc];
+      const auto &rightBox = sortedBvs[rc];
+      Box bv{};
+      for (int d = 0; d != 3; ++d) {
+        bv.first[d] = leftBox.first[d] < rightBox.first[d]
+                          ? leftBox.first[d]
+                          : rightBox.first[d];
+        bv.second[d] = leftBox.second[d] > rightBox.second[d]
+                           ? leftBox.second[d]
+                           : rightBox.second[d];
+      }
+      sortedBvs[par] = bv;
+      par = parents[par];
+    }
+  }
+}
+
+namespace {
+
+float half_area(const Box &bv) {
+  auto e = bv.second - bv.first;
+  return e[0] * e[1] + e[1] * e[2] + e[2] * e[0];
+}
+
+Box merge(const Box &a, const Box &b) {
+  return Box{zeno::min(a.first, b.first), zeno::max(a.second, b.second)};
+}
+
+// the bvh as a plain binary tree indexed by the node positions of the linear
+// layout it came from, for the treelet restructuring below
+struct ExplicitTree {
+  std::vector<Ti> lc, rc, parents, numLeaves;
+  std::vector<Box> bvs;
+
+  static constexpr int maxTreeletSize = 7;
+
+  bool isLeaf(Ti node) const { return lc[node] == -1; }
+
+  // gathers the treelet of up to maxTreeletSize leaves below root by always
+  // opening its largest leaf, finds the topology of least total internal node
+  // area over those leaves by dynamic programming over their subsets and
+  // rewires the treelet's internal nodes into it. only touches nodes below
+  // root, so treelets of disjoint subtrees can be worked on in parallel
+  void restructure(Ti root) {
+    Ti leaves[maxTreeletSize], internals[maxTreeletSize - 1];
+    int nl = 0, ni = 0;
+    leaves[nl++] = lc[root];
+    leaves[nl++] = rc[root];
+    float oldCost = half_area(bvs[root]);
+    while (nl < maxTreeletSize) {
+      int best = -1;
+      float bestArea = -1.f;
+      for (int j = 0; j != nl; ++j)
+        if (!isLeaf(leaves[j]))
+          if (float a = half_area(bvs[leaves[j]]); a > bestArea)
+            best = j, bestArea = a;
+      if (best == -1)
+        break;
+      auto node = leaves[best];
+      internals[ni++] = node;
+      oldCost += bestArea;
+      leaves[best] = lc[node];
+      leaves[nl++] = rc[node];
+    }
+    if (nl < 3)
+      return;
+
+    const int numSets = 1 << nl;
+    Box setBvs[1 << maxTreeletSize];
+    float cost[1 << maxTreeletSize];
+    unsigned char split[1 << maxTreeletSize];
+    for (int s = 1; s != numSets; ++s) {
+      const int low = s & -s;
+      if (s == low) {
+        int j = 0;
+        while (!(s >> j & 1))
+          ++j;
+        setBvs[s] = bvs[leaves[j]];
+        cost[s] = 0.f;
+        continue;
+      }
+      setBvs[s] = merge(setBvs[low], setBvs[s ^ low]);
+      // every partition once, as the part holding the lowest leaf
+      const int rest = s ^ low;
+      float best = std::numeric_limits<float>::max();
+      for (int t = rest;; t = (t - 1) & rest) {
+        const int p = t | low;
+        if (p != s)
+          if (float c = cost[p] + cost[s ^ p]; c < best)
+            best = c, split[s] = p;
+        if (!t)
+          break;
+      }
+      cost[s] = half_area(setBvs[s]) + best;
+    }
+    if (!(cost[numSets - 1] < oldCost))
+      return;
+
+    int nextInternal = 0;
+    auto rebuild = [&](auto &&self, int s, Ti node) -> void {
+      Ti children[2];
+      const int parts[2] = {split[s], s ^ split[s]};
+      for (int k = 0; k != 2; ++k) {
+        const int part = parts[k];
+        if (!(part & (part - 1))) {
+          int j = 0;
+          while (!(part >> j & 1))
+            ++j;
+          children[k] = leaves[j];
+        } else {
+          children[k] = internals[nextInternal++];
+          self(self, part, children[k]);
+        }
+        parents[children[k]] = node;
+      }
+      lc[node] = children[0];
+      rc[node] = children[1];
+      bvs[node] = setBvs[s];
+      numLeaves[node] = numLeaves[children[0]] + numLeaves[children[1]];
+    };
+    rebuild(rebuild, numSets - 1, root);
+  }
+};
+
+} // namespace
+
+void LBvh::optimizeTreelets(int rounds) {
+  const Ti numLeaves = getNumLeaves();
+  if (numLeaves <= 2)
+    return;
+  const Ti numNodes = numLeaves * 2 - 1;
+
+  ExplicitTree tree;
+  tree.lc.resize(numNodes);
+  tree.rc.resize(numNodes);
+  tree.numLeaves.resize(numNodes);
+  tree.parents = parents;
+  tree.bvs = sortedBvs;
 #if defined(_OPENMP)
 #pragma omp parallel for
 #endif
-    for (Ti nid = 0; nid < numLeaves; ++nid) {
-      auto idx = leafIndices[nid];
-      sortedBvs[idx] = getBv(auxIndices[idx]);
+  for (Ti node = 0; node < numNodes; ++node) {
+    if (levels[node] == 0) {
+      tree.lc[node] = tree.rc[node] = -1;
+      tree.numLeaves[node] = 1;
+    } else {
+      auto lc = node + 1;
+      tree.lc[node] = lc;
+      tree.rc[node] = levels[lc] == 0 ? lc + 1 : auxIndices[lc];
+    }
+  }
 
-      auto par = parents[idx];
+  // bottom up like refit. the treelet at a node is only restructured once both
+  // its subtrees are done; small subtrees are skipped, more so in later rounds
+  for (Ti round = 0, minLeaves = ExplicitTree::maxTreeletSize; round < rounds;
+       ++round, minLeaves *= 2) {
+    std::vector<std::atomic<Ti>> flags(numNodes);
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic, 1024)
+#endif
+    for (Ti nid = 0; nid < numLeaves; ++nid) {
+      auto par = tree.parents[leafIndices[nid]];
       while (par != -1) {
-        Ti old{0};
-        if (refitFlags[par].compare_exchange_strong(old, (Ti)1,
-                                                    std::memory_order_acquire))
+        if (flags[par].fetch_add(1, std::memory_order_acq_rel) == 0)
           break;
-        auto lc = par + 1;
-        auto rc = levels[lc] == 0 ? lc + 1 : auxIndices[lc];
-        // merge box
-        const auto &leftBox = sortedBvs[lc];
-        const auto &rightBox = sortedBvs[rc];
-        Box bv{};
-        for (int d = 0; d != 3; ++d) {
-          bv.first[d] = leftBox.first[d] < rightBox.first[d]
-                            ? leftBox.first[d]
-                            : rightBox.first[d];
-          bv.second[d] = leftBox.second[d] > rightBox.second[d]
-                             ? leftBox.second[d]
-                             : rightBox.second[d];
-        }
-        sortedBvs[par] = bv;
-        atomic_thread_fence(std::memory_order_release);
-        par = parents[par];
+        tree.numLeaves[par] =
+            tree.numLeaves[tree.lc[par]] + tree.numLeaves[tree.rc[par]];
+        if (tree.numLeaves[par] >= minLeaves)
+          tree.restructure(par);
+        par = tree.parents[par];
       }
     }
   }
+
+  /// back to the linear layout, nodes in preorder
+  std::vector<Ti> dst(numNodes);
+  {
+    std::vector<Ti> stack{0};
+    Ti offset = 0, leafNo = 0;
+    while (!stack.empty()) {
+      auto node = stack.back();
+      stack.pop_back();
+      dst[node] = offset++;
+      if (tree.isLeaf(node)) {
+        leafIndices[leafNo++] = dst[node];
+      } else {
+        stack.push_back(tree.rc[node]);
+        stack.push_back(tree.lc[node]);
+      }
+    }
+  }
+  std::vector<Ti> oldAuxIndices = std::move(auxIndices);
+  auxIndices.resize(numNodes);
+#if defined(_OPENMP)
+#pragma omp parallel for
+#endif
+  for (Ti node = 0; node < numNodes; ++node) {
+    const auto d = dst[node];
+    sortedBvs[d] = tree.bvs[node];
+    parents[d] = tree.parents[node] == -1 ? -1 : dst[tree.parents[node]];
+    if (tree.isLeaf(node)) {
+      // primitive index, and the level of every left-branch ancestor
+      auxIndices[d] = oldAuxIndices[node];
+      levels[d] = 0;
+      Ti level = 0;
+      for (auto child = node, par = tree.parents[node];
+           par != -1 && tree.lc[par] == child; child = par, par = tree.parents[par])
+        levels[dst[par]] = ++level;
+    } else {
+      // escape index
+      const auto escape = d + tree.numLeaves[node] * 2 - 1;
+      auxIndices[d] = escape < numNodes ? escape : -1;
+    }
+  }
 }
 
 /// nearest primitive
+namespace {
+
+// distance from pos to element eid, with the weights of its closest point
+template <LBvh::element_e et>
+float element_distance(const PrimitiveObject &prim,
+                       const std::vector<vec3f> &refpos, const vec3f &pos,
+                       Ti eid, vec3f &wsTmp) {
+  if constexpr (et == LBvh::element_e::point)
+    return dist_pp(refpos[prim.points[eid]], pos, wsTmp);
+  else if constexpr (et == LBvh::element_e::line) {
+    auto line = prim.lines[eid];
+    return dist_pe(pos, refpos[line[0]], refpos[line[1]], wsTmp);
+  } else if constexpr (et == LBvh::element_e::tri) {
+    auto tri = prim.tris[eid];
+    return dist_pt(pos, refpos[tri[0]], refpos[tri[1]], refpos[tri[2]], wsTmp);
+  } else if constexpr (et == LBvh::element_e::tet)
+    return LBvh::dist_tet(pos, refpos, prim.quads[eid], wsTmp);
+  else
+    return std::numeric_limits<float>::max();
+}
+
+// calls f(element_c<et>) with the element category of the bvh
+template <typename F> void visit_category(LBvh::element_e category, F &&f) {
+  if (category == LBvh::element_e::tet)
+    f(LBvh::element_c<LBvh::element_e::tet>);
+  else if (category == LBvh::element_e::tri)
+    f(LBvh::element_c<LBvh::element_e::tri>);
+  else if (category == LBvh::element_e::line)
+    f(LBvh::element_c<LBvh::element_e::line>);
+  else
+    f(LBvh::element_c<LBvh::element_e::point>);
+}
+
+} // namespace
+
 template <LBvh::element_e et>
 typename LBvh::TV LBvh::find_nearest(TV const &pos, Ti &id, float &dist,
                                      element_t<et>) const {
@@ -602,34 +880,7 @@ typename LBvh::TV LBvh::find_nearest(TV const &pos, Ti &id, float &dist,
     // leaf node check
     if (level == 0) {
       const auto eid = auxIndices[node];
-      float d = std::numeric_limits<float>::max();
-      if constexpr (et == element_e::point)
-        d = dist_pp(refpos[prim->points[eid]], pos, wsTmp);
-      else if constexpr (et == element_e::line) {
-        auto line = prim->lines[eid];
-        d = dist_pe(pos, refpos[line[0]], refpos[line[1]], wsTmp);
-      } else if constexpr (et == element_e::tri) {
-        auto tri = prim->tris[eid];
-        d = dist_pt(pos, refpos[tri[0]], refpos[tri[1]], refpos[tri[2]], wsTmp);
-      } else if constexpr (et == element_e::tet) {
-        auto tet = prim->quads[eid];
-        if (auto dd = dist_pt(pos, refpos[tet[0]], refpos[tet[1]],
-                              refpos[tet[2]], wsTmp);
-            dd < d)
-          d = dd;
-        if (auto dd = dist_pt(pos, refpos[tet[1]], refpos[tet[3]],
-                              refpos[tet[2]], wsTmp);
-            dd < d)
-          d = dd;
-        if (auto dd = dist_pt(pos, refpos[tet[0]], refpos[tet[3]],
-                              refpos[tet[2]], wsTmp);
-            dd < d)
-          d = dd;
-        if (auto dd = dist_pt(pos, refpos[tet[0]], refpos[tet[2]],
-                              refpos[tet[3]], wsTmp);
-            dd < d)
-          d = dd;
-      }
+      const float d = element_distance<et>(*prim, refpos, pos, eid, wsTmp);
       if (d < dist) {
         id = eid;
         dist = d;
@@ -666,6 +917,114 @@ typename LBvh::TV LBvh::find_nearest(TV const &pos, Ti &id, float &dist) const {
     return find_nearest(pos, id, dist, element_c<element_e::point>);
 }
 
+std::vector<LBvh::Ti> LBvh::morton_order(const std::vector<TV> &pos) const {
+  const Ti n = pos.size();
+  constexpr auto ma = std::numeric_limits<float>::max();
+  constexpr auto mi = std::numeric_limits<float>::lowest();
+  TV minVec = {ma, ma, ma};
+  TV maxVec = {mi, mi, mi};
+#if defined(_OPENMP)
+#pragma omp parallel
+#endif
+  {
+    TV lmin = minVec, lmax = maxVec;
+#if defined(_OPENMP)
+#pragma omp for nowait
+#endif
+    for (Ti i = 0; i < n; ++i) {
+      lmin = zeno::min(lmin, pos[i]);
+      lmax = zeno::max(lmax, pos[i]);
+    }
+#if defined(_OPENMP)
+#pragma omp critical
+#endif
+    {
+      minVec = zeno::min(minVec, lmin);
+      maxVec = zeno::max(maxVec, lmax);
+    }
+  }
+  TV scale;
+  for (int d = 0; d != 3; ++d)
+    scale[d] = maxVec[d] > minVec[d] ? 1.f / (maxVec[d] - minVec[d]) : 0.f;
+
+  std::vector<std::pair<Tu, Ti>> records(n);
+#if defined(_OPENMP)
+#pragma omp parallel for
+#endif
+  for (Ti i = 0; i < n; ++i) {
+    auto uc = (pos[i] - minVec) * scale;
+    for (int d = 0; d != 3; ++d)
+      uc[d] = std::clamp(uc[d], 0.f, 1023.f / 1024.f);
+    records[i] = std::make_pair(morton_code(uc), i);
+  }
+  sort_records(records, 30);
+  std::vector<Ti> order(n);
+#if defined(_OPENMP)
+#pragma omp parallel for
+#endif
+  for (Ti i = 0; i < n; ++i)
+    order[i] = records[i].second;
+  return order;
+}
+
+void LBvh::find_nearest_batch(const std::vector<TV> &pos, std::vector<Ti> &ids,
+                              std::vector<float> &dists,
+                              std::vector<TV> &ws) const {
+  std::shared_ptr<const PrimitiveObject> prim = primPtr.lock();
+  if (!prim)
+    throw std::runtime_error(
+        "the primitive object referenced by lbvh not available anymore");
+  const auto &refpos = prim->attr<vec3f>("pos");
+  visit_category(eleCategory, [&](auto category) {
+    constexpr element_e et = decltype(category)::value;
+    find_nearest_packets(pos, ids, dists, ws, [&](Ti i, Ti eid, TV &wsTmp) {
+      return element_distance<et>(*prim, refpos, pos[i], eid, wsTmp);
+    });
+  });
+}
+
+
+namespace {
+
+// takes element eid if it's clearly nearer than the current one, or about as
+// near with a closer uv
+template <LBvh::element_e et>
+void uv_candidate(const PrimitiveObject &prim, const std::vector<vec3f> &refpos,
+                  const vec3f *refUvs, const vec3f &pos, const vec3f &uv,
+                  Ti eid, Ti &id, float &dist, float &uvDist2, vec3f &ws) {
+  vec3f wsTmp{0.f, 0.f, 0.f}, wsUvTmp{};
+  float d = std::numeric_limits<float>::max();
+  zeno::vec3f refUv{0, 0, 0};
+
+  if constexpr (et == LBvh::element_e::point) {
+    d = dist_pp(refpos[prim.points[eid]], pos, wsTmp);
+    refUv = refUvs[prim.points[eid]];
+  } else if constexpr (et == LBvh::element_e::line) {
+    auto line = prim.lines[eid];
+    d = dist_pe(pos, refpos[line[0]], refpos[line[1]], wsTmp);
+    refUv = refUvs[line[0]] * wsTmp[0] + refUvs[line[1]] * wsTmp[1];
+  } else if constexpr (et == LBvh::element_e::tri) {
+    auto tri = prim.tris[eid];
+    d = dist_pt(pos, refpos[tri[0]], refpos[tri[1]], refpos[tri[2]], wsTmp);
+    refUv = refUvs[tri[0]] * wsTmp[0] + refUvs[tri[1]] * wsTmp[1] +
+            refUvs[tri[2]] * wsTmp[2];
+  }
+
+  if (strictly_greater(dist, d)) {
+    id = eid;
+    dist = d;
+    ws = wsTmp;
+    uvDist2 = dist_pp_sqr(refUv, uv, wsUvTmp);
+  } else if (auto newUvDist2 = dist_pp(refUv, uv, wsUvTmp);
+             loosely_greater(dist, d) && newUvDist2 < uvDist2) {
+    id = eid;
+    dist = d;
+    ws = wsTmp;
+    uvDist2 = newUvDist2;
+  }
+}
+
+} // namespace
 
 template <LBvh::element_e et>
 typename LBvh::TV LBvh::find_nearest_with_uv(TV const &pos, TV const &uv, Ti &id, float &dist,
@@ -684,7 +1043,6 @@ typename LBvh::TV LBvh::find_nearest_with_uv(TV const &pos, TV const &uv, Ti &id
   const Ti numNodes = sortedBvs.size();
   Ti node = 0;
   TV ws{0.f, 0.f, 0.f};
-  TV wsTmp{0.f, 0.f, 0.f}, wsUvTmp{};
   while (node != -1 && node != numNodes) {
     Ti level = levels[node];
     // level and node are always in sync
@@ -693,63 +1051,8 @@ typename LBvh::TV LBvh::find_nearest_with_uv(TV const &pos, TV const &uv, Ti &id
         break;
     // leaf node check
     if (level == 0) {
-      const auto eid = auxIndices[node];
-      float d = std::numeric_limits<float>::max();
-      zeno::vec3f refUv{0, 0, 0};
-
-      if constexpr (et == element_e::point) {
-        d = dist_pp(refpos[prim->points[eid]], pos, wsTmp);
-        refUv = refUvs[prim->points[eid]];
-      }
-      else if constexpr (et == element_e::line) {
-        auto line = prim->lines[eid];
-        d = dist_pe(pos, refpos[line[0]], refpos[line[1]], wsTmp);
-        refUv = refUvs[line[0]] * wsTmp[0] + refUvs[line[1]] * wsTmp[1];
-      } else if constexpr (et == element_e::tri) {
-        auto tri = prim->tris[eid];
-        d = dist_pt(pos, refpos[tri[0]], refpos[tri[1]], refpos[tri[2]], wsTmp);
-        refUv = refUvs[tri[0]] * wsTmp[0] + refUvs[tri[1]] * wsTmp[1] + refUvs[tri[2]] * wsTmp[2];
-      }
-
-
-#if 0
-      auto newUvDist2 = dist_pp_sqr(refUv, uv, wsUvTmp);
-      if (newUvDist2 < uvDist2) {
-        id = eid;
-        dist = d;
-        ws = wsTmp;
-        uvDist2 = newUvDist2;
-      } else if (strictly_greater(dist, d)) {
-        id = eid;
-        dist = d;
-        ws = wsTmp;
-        uvDist2 = newUvDist2;
-      }
-#else
-      if (
-#if 0
-        d + std::numeric_limits<float>::epsilon() * 2 < dist
-#else
-        strictly_greater(dist, d)
-#endif
-        ) {
-        id = eid;
-        dist = d;
-        ws = wsTmp;
-        uvDist2 = dist_pp_sqr(refUv, uv, wsUvTmp);
-      } else if (auto newUvDist2 = dist_pp(refUv, uv, wsUvTmp); 
-#if 0
-        d < dist + std::numeric_limits<float>::epsilon() * 2 && newUvDist2 < uvDist2
-#else
-        loosely_greater(dist, d) && newUvDist2 < uvDist2
-#endif
-        ) {
-        id = eid;
-        dist = d;
-        ws = wsTmp;
-        uvDist2 = newUvDist2;
-      }
-#endif
+      uv_candidate<et>(*prim, refpos, refUvs, pos, uv, auxIndices[node], id,
+                       dist, uvDist2, ws);
       node++;
     } else // separate at internal nodes
       node = auxIndices[node];
@@ -776,6 +1079,60 @@ typename LBvh::TV LBvh::find_nearest_with_uv(TV const &pos, TV const &uv, Ti &id
     return find_nearest_with_uv(pos, uv, id, dist, uvDist, distEps, element_c<element_e::point>);
 }
 
+void LBvh::find_nearest_with_uv_batch(const std::vector<TV> &pos,
+                                      const TV *uvs, std::vector<Ti> &ids,
+                                      std::vector<float> &dists,
+                                      std::vector<float> &uvDists2,
+                                      std::vector<TV> &ws,
+                                      float distEps) const {
+  std::shared_ptr<const PrimitiveObject> prim = primPtr.lock();
+  if (!prim)
+    throw std::runtime_error(
+        "the primitive object referenced by lbvh not available anymore");
+  const auto &refpos = prim->attr<vec3f>("pos");
+  const zeno::vec3f *refUvs = prim->verts.attr<zeno::vec3f>("uv").data();
+
+  const Ti n = pos.size();
+  ids.assign(n, -1);
+  dists.assign(n, std::numeric_limits<float>::max());
+  uvDists2.assign(n, std::numeric_limits<float>::max());
+  ws.assign(n, TV{0.f, 0.f, 0.f});
+  if (!n || sortedBvs.empty())
+    return;
+  // no seeding here: which element wins depends on the order they are met in
+  const auto order = morton_order(pos);
+  const Ti numPackets = (n + PacketSize - 1) / PacketSize;
+
+  auto run = [&](auto category) {
+    constexpr element_e et = decltype(category)::value;
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic, 8)
+#endif
+    for (Ti pk = 0; pk < numPackets; ++pk) {
+      const Ti base = pk * PacketSize;
+      const int cnt = std::min((Ti)PacketSize, n - base);
+      TV points[PacketSize];
+      float bounds[PacketSize];
+      for (int k = 0; k != cnt; ++k) {
+        points[k] = pos[order[base + k]];
+        bounds[k] = dists[order[base + k]] + distEps;
+      }
+      traverse_packet(points, cnt, bounds, [&](int k, Ti eid) {
+        const auto i = order[base + k];
+        uv_candidate<et>(*prim, refpos, refUvs, pos[i], uvs[i], eid, ids[i],
+                         dists[i], uvDists2[i], ws[i]);
+        bounds[k] = dists[i] + distEps;
+      });
+    }
+  };
+  if (eleCategory == element_e::tri)
+    run(element_c<element_e::tri>);
+  else if (eleCategory == element_e::line)
+    run(element_c<element_e::line>);
+  else // if (eleCategory == element_e::point)
+    run(element_c<element_e::point>);
+}
+
 std::shared_ptr<PrimitiveObject> LBvh::retrievePrimitive(Ti eid) const {
   std::shared_ptr<const PrimitiveObject> prim = primPtr.lock();
   if (!prim)
@@ -5,6 +5,9 @@
 #include <zeno/types/PrimitiveObject.h>
 #include <zeno/utils/vec.h>
 #include <zeno/zeno.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <exception>
 #include <stdexcept>
 #include "SpatialUtils.hpp"
@@ -27,7 +30,6 @@ struct LBvh : IObjectClone<LBvh> {
   using BvFunc = std::function<Box(Ti)>;
 
   std::weak_ptr<const PrimitiveObject> primPtr;
-  BvFunc getBv;
   std::vector<Box> sortedBvs;
   std::vector<Ti> auxIndices, levels, parents, leafIndices;
   float thickness{0};
@@ -66,8 +68,19 @@ struct LBvh : IObjectClone<LBvh> {
   void build(const std::shared_ptr<PrimitiveObject> &prim, float thickness, std::string radiusAttr, std::string neiRadiusAttr);
 
 
+  /// boxes are recomputed from the primitive, bottom up in parallel
   void refit();
 
+  /// restructures the built tree treelet by treelet for a lower surface area
+  /// cost (Karras & Aila 2013), keeping the same layout. takes a few times as
+  /// long as the build itself, worth it for static geometry queried many times
+  void optimizeTreelets(int rounds = 3);
+
+  template <element_e et, typename GetBv>
+  void build_impl(const std::shared_ptr<PrimitiveObject> &prim,
+                  const GetBv &getBv, element_t<et>);
+  template <typename GetBv> void refit_impl(const GetBv &getBv);
+
   static bool intersect(const Box &box, const TV &p) noexcept {
     constexpr int dim = 3;
     for (Ti d = 0; d != dim; ++d)
@@ -202,6 +215,241 @@ struct LBvh : IObjectClone<LBvh> {
   return ws;
 }
 
+  /// batched queries
+  static constexpr int PacketSize = 16;
+
+  /// indices of pos in morton order of their positions
+  std::vector<Ti> morton_order(const std::vector<TV> &pos) const;
+
+  /// walks the tree once for a packet of up to PacketSize points, testing the
+  /// boxes of all of them at a time. every point visits the same nodes in the
+  /// same order as if it were traversed alone with its pruning distance in
+  /// bounds[k]: leaf(k, eid) is called for each element eid point k reaches,
+  /// and may lower bounds[k]
+  template <typename F>
+  void traverse_packet(const TV *points, int n, float *bounds, F &&leaf) const {
+    using Mask = std::uint32_t;
+    static_assert(PacketSize <= 32, "packet masks are 32 bits");
+    float px[PacketSize], py[PacketSize], pz[PacketSize], bs[PacketSize];
+    for (int k = 0; k != PacketSize; ++k) {
+      const auto &p = points[k < n ? k : 0];
+      px[k] = p[0], py[k] = p[1], pz[k] = p[2];
+    }
+    const Mask all = n >= 32 ? ~(Mask)0 : ((Mask)1 << n) - 1;
+    // the internal nodes on the current path, with the points that got past them
+    std::vector<std::pair<Ti, Mask>> path;
+
+    const Ti numNodes = sortedBvs.size();
+    Ti node = 0;
+    Mask mask = all;
+    while (node != -1 && node != numNodes) {
+      Ti level = levels[node];
+      for (; level; --level, ++node) {
+        // same arithmetic as distance(), lane by lane
+        const auto &[mi, ma] = sortedBvs[node];
+        const TV center = (mi + ma) / 2, half = (ma - mi) / 2;
+        for (int k = 0; k != PacketSize; ++k)
+          bs[k] = bounds[k < n ? k : 0];
+        unsigned char pass[PacketSize];
+#if defined(_OPENMP)
+#pragma omp simd
+#endif
+        for (int k = 0; k < PacketSize; ++k) {
+          float x = std::abs(px[k] - center[0]) - half[0];
+          float y = std::abs(py[k] - center[1]) - half[1];
+          float z = std::abs(pz[k] - center[2]) - half[2];
+          float m = std::max(std::max(x, y), z);
+          x = x < 0 ? 0.f : x;
+          y = y < 0 ? 0.f : y;
+          z = z < 0 ? 0.f : z;
+          float d = (m < 0.f ? m : 0.f) + std::sqrt(x * x + y * y + z * z);
+          pass[k] = !(d > bs[k]);
+        }
+        Mask passed = 0;
+        for (int k = 0; k != PacketSize; ++k)
+          passed |= (Mask)pass[k] << k;
+        mask &= passed;
+        if (!mask)
+          break;
+        path.emplace_back(node, mask);
+      }
+      if (level == 0) {
+        for (Mask m = mask; m; m &= m - 1) {
+          int k = 0;
+          while (!(m >> k & 1))
+            ++k;
+          leaf(k, auxIndices[node]);
+        }
+        node++;
+      } else
+        node = auxIndices[node];
+      // a node is entered by the points that got past its parent
+      if (node != -1 && node != numNodes) {
+        const auto par = parents[node];
+        while (!path.empty() && path.back().first != par)
+          path.pop_back();
+        mask = path.empty() ? all : path.back().second;
+      }
+    }
+  }
+
+  /// runs find_nearest-like queries for all of pos at once, in packets of
+  /// points close to each other (morton order). each point is first bounded by
+  /// its distance to the nearest element of the point in the same lane of the
+  /// previous packet, which prunes most of the tree from the start.
+  /// eval(i, eid, ws) is the distance of point i to element eid, or max for
+  /// elements it can't match. ids of points that found nothing stay -1
+  template <typename Eval>
+  void find_nearest_packets(const std::vector<TV> &pos, std::vector<Ti> &ids,
+                            std::vector<float> &dists, std::vector<TV> &ws,
+                            Eval &&eval) const {
+    const Ti n = pos.size();
+    ids.assign(n, -1);
+    dists.assign(n, std::numeric_limits<float>::max());
+    ws.assign(n, TV{0.f, 0.f, 0.f});
+    if (!n || sortedBvs.empty())
+      return;
+    const auto order = morton_order(pos);
+    const Ti numPackets = (n + PacketSize - 1) / PacketSize;
+    // coordinate magnitude of the tree, from the root box (or the leaves of a
+    // tree without one), for the slack of the seeds
+    float extent = 0.f;
+    const Ti numTop = sortedBvs.size() > 2 ? 1 : sortedBvs.size();
+    for (Ti node = 0; node != numTop; ++node)
+      for (int d = 0; d != 3; ++d)
+        extent = std::max(extent, std::max(std::abs(sortedBvs[node].first[d]),
+                                           std::abs(sortedBvs[node].second[d])));
+#if defined(_OPENMP)
+#pragma omp parallel
+#endif
+    {
+      Ti prevIds[PacketSize];
+      std::fill(std::begin(prevIds), std::end(prevIds), (Ti)-1);
+#if defined(_OPENMP)
+#pragma omp for schedule(dynamic, 8)
+#endif
+      for (Ti pk = 0; pk < numPackets; ++pk) {
+        const Ti base = pk * PacketSize;
+        const int cnt = std::min((Ti)PacketSize, n - base);
+        TV points[PacketSize], pws[PacketSize], seedWs[PacketSize];
+        float bounds[PacketSize], seedDists[PacketSize];
+        Ti pids[PacketSize], seedIds[PacketSize];
+        TV wsTmp;
+        for (int k = 0; k != cnt; ++k) {
+          const auto i = order[base + k];
+          points[k] = pos[i];
+          pids[k] = -1;
+          bounds[k] = std::numeric_limits<float>::max();
+          seedIds[k] = -1;
+          seedDists[k] = std::numeric_limits<float>::max();
+          for (int j = 0; j != PacketSize; ++j) {
+            if (prevIds[j] == -1)
+              continue;
+            if (auto d = eval(i, prevIds[j], wsTmp); d < seedDists[k])
+              seedIds[k] = prevIds[j], seedDists[k] = d, seedWs[k] = wsTmp;
+          }
+          // a bit above the seed, more than box distances can be off by
+          // rounding, so the first element in traversal order at the nearest
+          // distance (often shared by neighbors) still wins, as in find_nearest
+          if (seedIds[k] != -1) {
+            const auto &p = pos[i];
+            const float scale =
+                std::max(std::max(std::abs(p[0]), std::abs(p[1])), std::abs(p[2]));
+            bounds[k] = seedDists[k] + std::numeric_limits<float>::epsilon() *
+                                           16 * (scale + extent + seedDists[k]);
+          }
+        }
+        traverse_packet(points, cnt, bounds, [&](int k, Ti eid) {
+          const auto d = eval(order[base + k], eid, wsTmp);
+          if (d < bounds[k]) {
+            pids[k] = eid;
+            bounds[k] = d;
+            pws[k] = wsTmp;
+          }
+        });
+        for (int k = 0; k != cnt; ++k) {
+          const auto i = order[base + k];
+          if (pids[k] == -1 && seedIds[k] != -1)
+            pids[k] = seedIds[k], bounds[k] = seedDists[k], pws[k] = seedWs[k];
+          if (pids[k] != -1) {
+            ids[i] = pids[k];
+            dists[i] = bounds[k];
+            ws[i] = pws[k];
+            prevIds[k] = pids[k];
+          }
+        }
+      }
+    }
+  }
+
+  /// find_nearest for every point of pos
+  void find_nearest_batch(const std::vector<TV> &pos, std::vector<Ti> &ids,
+                          std::vector<float> &dists, std::vector<TV> &ws) const;
+  /// find_nearest_with_uv for every point of pos and uv of uvs
+  void find_nearest_with_uv_batch(
+      const std::vector<TV> &pos, const TV *uvs, std::vector<Ti> &ids,
+      std::vector<float> &dists, std::vector<float> &uvDists2,
+      std::vector<TV> &ws,
+      float distEps = std::numeric_limits<float>::epsilon() * 4) const;
+
+  /// find_nearest_within_group for every point of pos, pred(i, vert) tells if
+  /// the vertex vert is in the group of point i
+  template <typename SameGroupPred, element_e et = element_e::tri>
+  void find_nearest_within_group_batch(const std::vector<TV> &pos,
+                                       std::vector<Ti> &ids,
+                                       std::vector<float> &dists,
+                                       std::vector<TV> &ws, SameGroupPred &&pred,
+                                       element_t<et> = {}) const {
+    std::shared_ptr<const PrimitiveObject> prim = primPtr.lock();
+    if (!prim)
+      throw std::runtime_error(
+          "the primitive object referenced by lbvh not available anymore");
+    const auto &refpos = prim->attr<vec3f>("pos");
+    find_nearest_packets(pos, ids, dists, ws, [&](Ti i, Ti eid, TV &wsTmp) {
+      const auto &p = pos[i];
+      auto g = [&](Ti v) { return pred(i, v); };
+      float d = std::numeric_limits<float>::max();
+      if constexpr (et == element_e::point) {
+        auto pt = prim->points[eid];
+        if (g(pt))
+          d = dist_pp(refpos[pt], p, wsTmp);
+      } else if constexpr (et == element_e::line) {
+        auto line = prim->lines[eid];
+        if (g(line[0]) && g(line[1]))
+          d = dist_pe(p, refpos[line[0]], refpos[line[1]], wsTmp);
+      } else if constexpr (et == element_e::tri) {
+        auto tri = prim->tris[eid];
+        if (g(tri[0]) && g(tri[1]) && g(tri[2]))
+          d = dist_pt(p, refpos[tri[0]], refpos[tri[1]], refpos[tri[2]], wsTmp);
+      } else if constexpr (et == element_e::tet) {
+        auto tet = prim->quads[eid];
+        if (g(tet[0]) && g(tet[1]) && g(tet[2]) && g(tet[3]))
+          d = dist_tet(p, refpos, tet, wsTmp);
+      }
+      return d;
+    });
+  }
+
+  /// distance to the nearest of the four faces of a tet, with the weights of
+  /// the last face like find_nearest
+  static float dist_tet(const TV &p, const std::vector<vec3f> &refpos,
+                        const vec4i &tet, TV &wsTmp) {
+    float d = std::numeric_limits<float>::max();
+    if (auto dd = dist_pt(p, refpos[tet[0]], refpos[tet[1]], refpos[tet[2]], wsTmp);
+        dd < d)
+      d = dd;
+    if (auto dd = dist_pt(p, refpos[tet[1]], refpos[tet[3]], refpos[tet[2]], wsTmp);
+        dd < d)
+      d = dd;
+    if (auto dd = dist_pt(p, refpos[tet[0]], refpos[tet[3]], refpos[tet[2]], wsTmp);
+        dd < d)
+      d = dd;
+    if (auto dd = dist_pt(p, refpos[tet[0]], refpos[tet[2]], refpos[tet[3]], wsTmp);
+        dd < d)
+      d = dd;
+    return d;
+  }
+
   std::shared_ptr<PrimitiveObject> retrievePrimitive(Ti eid) const;
   vec3f retrievePrimitiveCenter(Ti eid, const TV &w) const;
 
@@ -0,0 +1,323 @@
+#pragma once
+
+#include <zeno/utils/vec.h>
+#include <zeno/utils/Error.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+namespace zeno {
+
+// uniform grid of cells `radius` wide, with the particles sorted by cell in CSR layout:
+// the particles of cell c sit at sorted slots cellStart[c] .. cellStart[c + 1] - 1,
+// order[] maps slots back to particle indices and points[] holds their positions.
+// a grid with at most a few cells per particle gets one cellStart entry per cell,
+// sparse domains (splashes) keep only the occupied cells, in morton order, and find
+// them with an open addressing hash. both are built with a parallel radix sort that
+// keeps particles of one cell in ascending index order
+struct NeighborGrid {
+    float radius = 0;
+    float inv_dx = 0;
+    vec3f pMin{0};
+    vec3i gridRes{0};
+    bool sparse = false;
+
+    std::vector<int> order;
+    std::vector<vec3f> points;
+    std::vector<int> cellStart;
+
+    // sparse only: morton key of each occupied cell, and a table of (key + 1, cell) slots
+    std::vector<uint64_t> cellKeys;
+    std::vector<uint64_t> slotKeys;
+    std::vector<int> slotCells;
+
+    static constexpr int kMortonBits = 21;
+
+    NeighborGrid() = default;
+
+    explicit NeighborGrid(std::vector<vec3f> const &pos, float radius_, float maxDenseCellsPerPoint = 4.f) {
+        build(pos, radius_, maxDenseCellsPerPoint);
+    }
+
+    size_t size() const {
+        return order.size();
+    }
+
+    size_t numCells() const {
+        return cellStart.empty() ? 0 : cellStart.size() - 1;
+    }
+
+    size_t bytes() const {
+        return order.size() * sizeof(int) + points.size() * sizeof(vec3f) + cellStart.size() * sizeof(int)
+            + cellKeys.size() * sizeof(uint64_t) + slotKeys.size() * sizeof(uint64_t) + slotCells.size() * sizeof(int);
+    }
+
+    static uint64_t spreadBits(uint64_t x) {
+        x &= 0x1fffff;
+        x = (x | x << 32) & 0x1f00000000ffffull;
+        x = (x | x << 16) & 0x1f0000ff0000ffull;
+        x = (x | x << 8) & 0x100f00f00f00f00full;
+        x = (x | x << 4) & 0x10c30c30c30c30c3ull;
+        x = (x | x << 2) & 0x1249249249249249ull;
+        return x;
+    }
+
+    static uint64_t mortonKey(vec3i const &c) {
+        return spreadBits(c[0]) | spreadBits(c[1]) << 1 | spreadBits(c[2]) << 2;
+    }
+
+    // cell coordinate of a point, clamped one cell outside of the grid so it can't overflow;
+    // a NaN coordinate lands below the grid, where it has no neighbors
+    vec3i cellOf(vec3f const &p) const {
+        vec3i c;
+        for (int d = 0; d < 3; d++) {
+            float f = std::floor((p[d] - pMin[d]) * inv_dx);
+            c[d] = f >= -2.f ? (int)std::min(f, (float)gridRes[d] + 1.f) : -2;
+        }
+        return c;
+    }
+
+    // cell index of a cell coordinate, -1 if it's empty or out of the grid
+    int cellIndex(vec3i const &c) const {
+        if (c[0] < 0 || c[1] < 0 || c[2] < 0 || c[0] >= gridRes[0] || c[1] >= gridRes[1] || c[2] >= gridRes[2])
+            return -1;
+        if (!sparse)
+            return c[0] + gridRes[0] * (c[1] + (int64_t)gridRes[1] * c[2]);
+        uint64_t key = mortonKey(c);
+        size_t mask = slotKeys.size() - 1;
+        for (size_t s = hashSlot(key, mask);; s = (s + 1) & mask) {
+            if (slotKeys[s] == key + 1)
+                return slotCells[s];
+            if (!slotKeys[s])
+                return -1;
+        }
+    }
+
+    // calls f(begin, end) with the sorted slot range of each of the 27 cells around pos
+    template <class F>
+    void iter_cells(vec3f const &pos, F const &f) const {
+        auto coor = cellOf(pos);
+        for (int dz = -1; dz < 2; dz++) {
+            for (int dy = -1; dy < 2; dy++) {
+                for (int dx = -1; dx < 2; dx++) {
+                    int c = cellIndex(coor + vec3i(dx, dy, dz));
+                    if (c >= 0 && cellStart[c] != cellStart[c + 1])
+                        f(cellStart[c], cellStart[c + 1]);
+                }
+            }
+        }
+    }
+
+    // calls f(pid) for every particle in the 27 cells around pos
+    template <class F>
+    void iter_neighbors(vec3f const &pos, F const &f) const {
+        iter_cells(pos, [&] (int begin, int end) {
+            for (int k = begin; k < end; k++)
+                f(order[k]);
+        });
+    }
+
+    void build(std::vector<vec3f> const &pos, float radius_, float maxDenseCellsPerPoint = 4.f) {
+        radius = radius_;
+        inv_dx = 1.0f / radius;
+        order.clear();
+        points.clear();
+        cellStart.clear();
+        cellKeys.clear();
+        slotKeys.clear();
+        slotCells.clear();
+        gridRes = vec3i(0);
+        int n = pos.size();
+        if (!n)
+            return;
+
+        vec3f bmin = pos[0], bmax = pos[0];
+        bool finite = true;
+#pragma omp parallel
+        {
+            vec3f lmin = pos[0], lmax = pos[0];
+            bool lfinite = true;
+#pragma omp for nowait
+            for (int i = 0; i < n; i++) {
+                lmin = zeno::min(lmin, pos[i]);
+                lmax = zeno::max(lmax, pos[i]);
+                lfinite &= std::isfinite(pos[i][0]) && std::isfinite(pos[i][1]) && std::isfinite(pos[i][2]);
+            }
+#pragma omp critical
+            {
+                bmin = zeno::min(bmin, lmin);
+                bmax = zeno::max(bmax, lmax);
+                finite &= lfinite;
+            }
+        }
+        // min/max may skip NaNs, and such a particle would be binned out of the grid
+        if (!finite)
+            throw makeError("neighbor grid: particle positions must be finite");
+        // one empty cell of margin around the particles, like the old HashGrid
+        pMin = bmin - radius;
+        auto extent = (bmax + radius - pMin) * inv_dx;
+        for (int d = 0; d < 3; d++) {
+            if (!(extent[d] < (float)(1 << kMortonBits)))
+                throw makeError("neighbor grid: radius " + std::to_string(radius) + " is too small for the particle bounds");
+            gridRes[d] = (int)std::floor(extent[d]) + 1;
+        }
+        int64_t ncells = (int64_t)gridRes[0] * gridRes[1] * gridRes[2];
+        sparse = ncells > (int64_t)(maxDenseCellsPerPoint * n) + 4096 || ncells >= (1ll << 31) - 1;
+
+        std::vector<uint64_t> keys(n);
+#pragma omp parallel for
+        for (int i = 0; i < n; i++) {
+            auto c = cellOf(pos[i]);
+            keys[i] = sparse ? mortonKey(c) : (uint64_t)(c[0] + gridRes[0] * (c[1] + (int64_t)gridRes[1] * c[2]));
+        }
+        uint64_t maxKey = sparse ? mortonKey(gridRes - 1) : (uint64_t)(ncells - 1);
+        radixSort(keys, maxKey);
+
+        points.resize(n);
+#pragma omp parallel for
+        for (int k = 0; k < n; k++)
+            points[k] = pos[order[k]];
+
+        if (!sparse) {
+            // slot k starts all the cells after the previous particle's cell up to its own
+            cellStart.resize(ncells + 1);
+#pragma omp parallel for
+            for (int k = 0; k <= n; k++) {
+                int64_t lo = k ? (int64_t)keys[k - 1] + 1 : 0;
+                int64_t hi = k < n ? (int64_t)keys[k] : ncells;
+                for (int64_t c = lo; c <= hi; c++)
+                    cellStart[c] = k;
+            }
+            return;
+        }
+
+        std::vector<int> firsts(n);
+#pragma omp parallel for
+        for (int k = 0; k < n; k++)
+            firsts[k] = !k || keys[k] != keys[k - 1];
+        int nocc = exclusiveScan(firsts);
+        cellKeys.resize(nocc);
+        cellStart.resize(nocc + 1);
+        cellStart[nocc] = n;
+#pragma omp parallel for
+        for (int k = 0; k < n; k++) {
+            if (!k || keys[k] != keys[k - 1]) {
+                cellKeys[firsts[k]] = keys[k];
+                cellStart[firsts[k]] = k;
+            }
+        }
+
+        size_t nslots = 16;
+        while (nslots < 2 * (size_t)nocc)
+            nslots *= 2;
+        std::vector<std::atomic<uint64_t>> slots(nslots);
+        slotCells.assign(nslots, -1);
+        // keys are unique, so whoever claims a slot owns its cell entry too
+        size_t mask = nslots - 1;
+#pragma omp parallel for
+        for (int c = 0; c < nocc; c++) {
+            for (size_t s = hashSlot(cellKeys[c], mask);; s = (s + 1) & mask) {
+                uint64_t expected = 0;
+                if (slots[s].compare_exchange_strong(expected, cellKeys[c] + 1, std::memory_order_relaxed)) {
+                    slotCells[s] = c;
+                    break;
+                }
+            }
+        }
+        slotKeys.resize(nslots);
+#pragma omp parallel for
+        for (int64_t s = 0; s < (int64_t)nslots; s++)
+            slotKeys[s] = slots[s].load(std::memory_order_relaxed);
+    }
+
+private:
+    static size_t hashSlot(uint64_t key, size_t mask) {
+        return (size_t)((key * 0x9e3779b97f4a7c15ull) >> 20) & mask;
+    }
+
+    static int numChunks(size_t n) {
+#if defined(_OPENMP)
+        return (int)std::max<size_t>(1, std::min<size_t>(omp_get_max_threads(), n / 65536));
+#else
+        return 1;
+#endif
+    }
+
+    // in-place exclusive prefix sum, returns the total
+    static int exclusiveScan(std::vector<int> &a) {
+        int n = a.size();
+        int nchunks = numChunks(n);
+        std::vector<int> sums(nchunks + 1);
+#pragma omp parallel for
+        for (int t = 0; t < nchunks; t++) {
+            int s = 0;
+            for (int i = (int64_t)n * t / nchunks; i < (int64_t)n * (t + 1) / nchunks; i++)
+                s += a[i];
+            sums[t + 1] = s;
+        }
+        for (int t = 0; t < nchunks; t++)
+            sums[t + 1] += sums[t];
+#pragma omp parallel for
+        for (int t = 0; t < nchunks; t++) {
+            int s = sums[t];
+            for (int i = (int64_t)n * t / nchunks; i < (int64_t)n * (t + 1) / nchunks; i++) {
+                int x = a[i];
+                a[i] = s;
+                s += x;
+            }
+        }
+        return sums[nchunks];
+    }
+
+    // stable LSD radix sort of the keys, carrying the particle indices along into order
+    void radixSort(std::vector<uint64_t> &keys, uint64_t maxKey) {
+        int n = keys.size();
+        order.resize(n);
+#pragma omp parallel for
+        for (int i = 0; i < n; i++)
+            order[i] = i;
+        int bits = 0;
+        while (bits < 64 && (maxKey >> bits))
+            bits++;
+        int nchunks = numChunks(n);
+        std::vector<uint64_t> keys2(n);
+        std::vector<int> order2(n);
+        std::vector<int> counts(nchunks * 256);
+        for (int shift = 0; shift < bits; shift += 8) {
+            std::fill(counts.begin(), counts.end(), 0);
+#pragma omp parallel for
+            for (int t = 0; t < nchunks; t++) {
+                int *cnt = counts.data() + t * 256;
+                for (int i = (int64_t)n * t / nchunks; i < (int64_t)n * (t + 1) / nchunks; i++)
+                    cnt[(keys[i] >> shift) & 255]++;
+            }
+            // digit-major, chunk-minor offsets keep the sort stable
+            int sum = 0;
+            for (int b = 0; b < 256; b++) {
+                for (int t = 0; t < nchunks; t++) {
+                    int x = counts[t * 256 + b];
+                    counts[t * 256 + b] = sum;
+                    sum += x;
+                }
+            }
+#pragma omp parallel for
+            for (int t = 0; t < nchunks; t++) {
+                int *cnt = counts.data() + t * 256;
+                for (int i = (int64_t)n * t / nchunks; i < (int64_t)n * (t + 1) / nchunks; i++) {
+                    int dst = cnt[(keys[i] >> shift) & 255]++;
+                    keys2[dst] = keys[i];
+                    order2[dst] = order[i];
+                }
+            }
+            keys.swap(keys2);
+            order.swap(order2);
+        }
+    }
+};
+
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <zfx/x64.h>
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace zeno {
+
+// runs the batch kernel of exec over the first size elements of chs, in blocks so
+// that the kernel accesses the attributes in place; the elements past the last
+// whole SimdWidth group go one at a time. false if the CPU has no batch kernels
+template <class Buffer>
+bool batch_wrangle
+    ( zfx::x64::Executable *exec
+    , std::vector<Buffer> const &chs
+    , size_t size
+    ) {
+    std::vector<int> strides;
+    for (auto const &ch: chs)
+        strides.push_back(ch.stride);
+    auto batch = exec->batch(strides);
+    if (!batch)
+        return false;
+
+    constexpr size_t kBlockSize = 4096;
+    size_t full = size / batch->SimdWidth * batch->SimdWidth;
+    #pragma omp parallel for
+    for (int begin = 0; begin < full; begin += kBlockSize) {
+        std::vector<float *> bases(chs.size());
+        for (int j = 0; j < chs.size(); j++)
+            bases[j] = chs[j].base + chs[j].stride * begin;
+        auto ctx = batch->make_context();
+        ctx.execute_batch(bases.data(), (std::min(full, begin + kBlockSize) - begin) / batch->SimdWidth);
+    }
+    for (int i = full; i < size; i++) {
+        auto ctx = exec->make_context();
+        for (int j = 0; j < chs.size(); j++)
+            ctx.channel(j)[0] = chs[j].base[chs[j].stride * i];
+        ctx.execute();
+        for (int j = 0; j < chs.size(); j++)
+            chs[j].base[chs[j].stride * i] = ctx.channel(j)[0];
+    }
+    return true;
+}
+
+// runs a neighbor wrangle SimdWidth query particles at a time: lane l holds the
+// particle channels (which == 0) of its own query and steps through that query's
+// neighbor list, getting one neighbor's channels (which == 1) per execution. a lane
+// is written back as soon as its list runs out, so every particle goes through the
+// same sequence of executions as it would one at a time, whatever the code does.
+//
+// gather(k, neighbors) fills the neighbor list of the k-th query to visit and
+// returns its particle index; store(i) tells whether particle i is written back
+template <class Buffer, class Gather, class Store>
+void neighbor_lanes_wrangle
+    ( zfx::x64::Executable *exec
+    , std::vector<Buffer> const &chs
+    , std::vector<Buffer> const &chs2
+    , size_t nqueries
+    , Gather const &gather
+    , Store const &store
+    ) {
+    if (chs.size() == 0)
+        return;
+
+    std::vector<int> own, nei;
+    for (int k = 0; k < chs.size(); k++)
+        (chs[k].which ? nei : own).push_back(k);
+
+    const size_t width = exec->SimdWidth;
+    const int ngroups = (nqueries + width - 1) / width;
+
+    #pragma omp parallel
+    {
+        std::vector<int> neighbors[zfx::x64::Executable::MaxSimdWidth];
+        int ids[zfx::x64::Executable::MaxSimdWidth];
+        size_t cursor[zfx::x64::Executable::MaxSimdWidth];
+        bool done[zfx::x64::Executable::MaxSimdWidth];
+
+        #pragma omp for
+        for (int g = 0; g < ngroups; g++) {
+            auto ctx = exec->make_context();
+            size_t nlanes = std::min(width, nqueries - g * width);
+            size_t active = 0;
+
+            auto finish = [&] (size_t l) {
+                if (!store(ids[l]))
+                    return;
+                for (int k: own)
+                    chs[k].base[chs[k].stride * ids[l]] = ctx.channel(k)[l];
+            };
+
+            for (size_t l = 0; l < nlanes; l++) {
+                neighbors[l].clear();
+                ids[l] = gather(g * width + l, neighbors[l]);
+                cursor[l] = 0;
+                for (int k: own)
+                    ctx.channel(k)[l] = chs[k].base[chs[k].stride * ids[l]];
+                done[l] = neighbors[l].empty();
+                if (done[l])
+                    finish(l);
+                else
+                    active++;
+            }
+
+            int pids[zfx::x64::Executable::MaxSimdWidth] = {};
+            while (active) {
+                // finished lanes keep computing on their last neighbor, nobody reads them
+                for (size_t l = 0; l < nlanes; l++) {
+                    if (!done[l])
+                        pids[l] = neighbors[l][cursor[l]++];
+                }
+                for (int k: nei) {
+                    auto base = chs2[k].base;
+                    auto stride = chs2[k].stride;
+                    auto lanes = ctx.channel(k);
+                    for (size_t l = 0; l < nlanes; l++)
+                        lanes[l] = base[stride * pids[l]];
+                }
+                ctx.execute();
+                for (size_t l = 0; l < nlanes; l++) {
+                    if (!done[l] && cursor[l] == neighbors[l].size()) {
+                        finish(l);
+                        done[l] = true;
+                        active--;
+                    }
+                }
+            }
+        }
+    }
+}
+
+}
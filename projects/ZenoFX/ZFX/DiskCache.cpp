@@ -0,0 +1,308 @@
+#include <zfx/diskcache.h>
+#include <zfx/zfx.h>
+#include <zfx/utils.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+#if !defined(_WIN32)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace zfx {
+
+namespace fs = std::filesystem;
+
+static constexpr char kMagic[4] = {'Z', 'F', 'X', 'C'};
+// bump whenever the layout of an entry or the meaning of its payload changes
+static constexpr uint64_t kVersion = 2;
+#ifndef ZFX_SOURCE_HASH
+#define ZFX_SOURCE_HASH __DATE__ " " __TIME__
+#endif
+// entries of other zfx builds are misses, and get overwritten by this one's
+static constexpr char kBuildId[] = ZFX_SOURCE_HASH;
+
+static uint64_t fnv1a(const char *p, size_t n, uint64_t h = 0xcbf29ce484222325ull) {
+    for (size_t i = 0; i < n; i++) {
+        h ^= (uint8_t)p[i];
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+static fs::path default_cache_dir() {
+#if defined(_WIN32)
+    if (auto dir = std::getenv("LOCALAPPDATA"))
+        return fs::path(dir) / "zfx";
+#else
+    if (auto dir = std::getenv("XDG_CACHE_HOME"); dir && *dir)
+        return fs::path(dir) / "zfx";
+    if (auto dir = std::getenv("HOME"); dir && *dir)
+        return fs::path(dir) / ".cache" / "zfx";
+#endif
+    return {};
+}
+
+#if !defined(_WIN32)
+// what's in the cache gets executed, so it has to be the user's own and closed to others
+static bool is_private(struct stat const &st) {
+    return st.st_uid == geteuid() && !(st.st_mode & (S_IWGRP | S_IWOTH));
+}
+#endif
+
+DiskCache *DiskCache::instance() {
+    static std::unique_ptr<DiskCache> cache = [] () -> std::unique_ptr<DiskCache> {
+        fs::path dir;
+        if (auto env = std::getenv("ZFX_CACHE_DIR")) {
+            if (!*env || !std::strcmp(env, "off") || !std::strcmp(env, "0"))
+                return nullptr;
+            dir = env;
+        } else {
+            dir = default_cache_dir();
+        }
+        if (dir.empty())
+            return nullptr;
+        if (!dir.has_filename())
+            dir = dir.parent_path();
+        std::error_code ec;
+#if defined(_WIN32)
+        fs::create_directories(dir, ec);
+        if (!fs::is_directory(dir, ec))
+            return nullptr;
+#else
+        // the parents as usual, the cache directory itself private to the user
+        if (dir.has_parent_path())
+            fs::create_directories(dir.parent_path(), ec);
+        if (::mkdir(dir.c_str(), 0700) != 0 && errno != EEXIST)
+            return nullptr;
+        struct stat st;
+        if (::stat(dir.c_str(), &st) != 0 || !S_ISDIR(st.st_mode) || !is_private(st))
+            return nullptr;
+#endif
+        auto ret = std::make_unique<DiskCache>();
+        ret->dir = dir.string();
+        uint64_t mb = 256;
+        if (auto env = std::getenv("ZFX_CACHE_SIZE_MB"); env && *env)
+            mb = std::strtoull(env, nullptr, 10);
+        ret->maxBytes = mb << 20;
+        return ret;
+    }();
+    return cache.get();
+}
+
+static fs::path entry_path(std::string const &dir, std::string const &key) {
+    return fs::path(dir) / format("%016llx.zfxc",
+        (unsigned long long)fnv1a(key.data(), key.size()));
+}
+
+static bool read_entry(fs::path const &path, std::string &buf) {
+#if defined(_WIN32)
+    std::ifstream fin(path, std::ios::binary);
+    if (!fin)
+        return false;
+    buf.assign(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+    return true;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    bool ok = ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && is_private(st);
+    if (ok) {
+        buf.resize(st.st_size);
+        size_t got = 0;
+        while (got < buf.size()) {
+            auto n = ::read(fd, buf.data() + got, buf.size() - got);
+            if (n <= 0)
+                break;
+            got += n;
+        }
+        ok = got == buf.size();
+    }
+    ::close(fd);
+    return ok;
+#endif
+}
+
+static bool write_entry(fs::path const &path, std::string const &buf) {
+#if defined(_WIN32)
+    std::ofstream fout(path, std::ios::binary);
+    if (!fout)
+        return false;
+    fout.write(buf.data(), buf.size());
+    return (bool)fout.flush();
+#else
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd < 0)
+        return false;
+    size_t put = 0;
+    while (put < buf.size()) {
+        auto n = ::write(fd, buf.data() + put, buf.size() - put);
+        if (n <= 0)
+            break;
+        put += n;
+    }
+    return (::close(fd) == 0) & (put == buf.size());
+#endif
+}
+
+bool DiskCache::load(std::string const &key, std::string &payload) const {
+    auto path = entry_path(dir, key);
+    std::string buf;
+    if (!read_entry(path, buf))
+        return false;
+    if (buf.size() < sizeof(kMagic) || std::memcmp(buf.data(), kMagic, sizeof(kMagic)))
+        return false;
+    Reader r(buf);
+    r.p += sizeof(kMagic);
+    if (r.u64() != kVersion || r.str() != kBuildId || r.str() != key)
+        return false;
+    std::string data = r.str();
+    uint64_t sum = r.u64();
+    if (!r.ok() || sum != fnv1a(data.data(), data.size()))
+        return false;
+    payload = std::move(data);
+    // the modification time doubles as the last use, for trim()
+    std::error_code ec;
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    return true;
+}
+
+void DiskCache::store(std::string const &key, std::string const &payload) const {
+    Writer w;
+    w.buf.append(kMagic, sizeof(kMagic));
+    w.u64(kVersion);
+    w.str(kBuildId);
+    w.str(key);
+    w.str(payload);
+    w.u64(fnv1a(payload.data(), payload.size()));
+
+    // unique among the processes and threads that may be writing the same entry
+    static std::atomic<uint64_t> counter{0};
+    auto path = entry_path(dir, key);
+    auto tmp = path;
+    tmp += format(".%016llx.tmp", (unsigned long long)(
+        std::hash<std::thread::id>{}(std::this_thread::get_id())
+        ^ std::chrono::steady_clock::now().time_since_epoch().count()
+        ^ (counter++ << 48)));
+    // someone else may have won the race, their entry is just as good
+    std::error_code ec;
+    if (write_entry(tmp, w.buf))
+        fs::rename(tmp, path, ec);
+    else
+        ec = std::make_error_code(std::errc::io_error);
+    if (ec)
+        fs::remove(tmp, ec);
+
+    // a scan of the directory per few new entries, they only come from compiling
+    static std::atomic<uint64_t> stores{0};
+    if (stores++ % 16 == 0)
+        trim();
+}
+
+void DiskCache::trim() const {
+    if (!maxBytes)
+        return;
+    struct Entry {
+        fs::file_time_type time;
+        uint64_t size;
+        fs::path path;
+    };
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+    auto now = fs::file_time_type::clock::now();
+    std::error_code ec;
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        auto const &path = it->path();
+        auto time = it->last_write_time(ec);
+        if (ec)
+            continue;
+        // left behind by a writer that died
+        if (path.extension() == ".tmp") {
+            if (now - time > std::chrono::hours(1))
+                fs::remove(path, ec);
+            continue;
+        }
+        if (path.extension() != ".zfxc")
+            continue;
+        auto size = it->file_size(ec);
+        if (ec)
+            continue;
+        entries.push_back({time, size, path});
+        total += size;
+    }
+    if (total <= maxBytes)
+        return;
+    std::sort(entries.begin(), entries.end(), [] (Entry const &a, Entry const &b) {
+        return a.time < b.time;
+    });
+    for (auto const &e: entries) {
+        if (total <= maxBytes / 4 * 3)
+            break;
+        // gone already if another process is trimming too
+        fs::remove(e.path, ec);
+        total -= e.size;
+    }
+}
+
+static std::string program_cache_key(std::string const &key) {
+    return "program\n" + key;
+}
+
+bool load_cached_program(std::string const &key, Program &prog) {
+    auto cache = DiskCache::instance();
+    std::string payload;
+    if (!cache || !cache->load(program_cache_key(key), payload))
+        return false;
+    DiskCache::Reader r(payload);
+    Program ret;
+    ret.assembly = r.str();
+    for (auto *list: {&ret.symbols, &ret.params}) {
+        auto n = r.u64();
+        for (uint64_t i = 0; r.good && i < n; i++) {
+            auto name = r.str();
+            list->emplace_back(name, (int)r.u64());
+        }
+    }
+    auto n = r.u64();
+    for (uint64_t i = 0; r.good && i < n; i++) {
+        auto name = r.str();
+        ret.newsyms[name] = (int)r.u64();
+    }
+    if (!r.ok())
+        return false;
+    prog = std::move(ret);
+    return true;
+}
+
+void store_cached_program(std::string const &key, Program const &prog) {
+    auto cache = DiskCache::instance();
+    if (!cache)
+        return;
+    DiskCache::Writer w;
+    w.str(prog.assembly);
+    for (auto *list: {&prog.symbols, &prog.params}) {
+        w.u64(list->size());
+        for (auto const &[name, dim]: *list) {
+            w.str(name);
+            w.u64(dim);
+        }
+    }
+    w.u64(prog.newsyms.size());
+    for (auto const &[name, dim]: prog.newsyms) {
+        w.str(name);
+        w.u64(dim);
+    }
+    cache->store(program_cache_key(key), w.buf);
+}
+
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace zfx {
+
+// content addressed store for compiled programs and machine code, shared by all
+// processes of one user: one file per entry named after the hash of its key,
+// written to a temporary and renamed into place, so readers never see half of one.
+// each entry carries its full key, the zfx build that wrote it and a checksum,
+// anything that doesn't match is treated as a miss. the directory is
+// $ZFX_CACHE_DIR, by default ~/.cache/zfx (%LOCALAPPDATA%\zfx on windows);
+// ZFX_CACHE_DIR=off disables it. it may be deleted at any time.
+// entries hold machine code that gets run, so on posix the directory is created
+// 0700, and a directory or entry not owned by the user, or writable by others,
+// is never read from. the entries used least recently are deleted once they
+// take more than $ZFX_CACHE_SIZE_MB (default 256) in all
+struct DiskCache {
+    std::string dir;
+    uint64_t maxBytes = 0;
+
+    // nullptr if disabled, or the directory can't be created or isn't safe to use
+    static DiskCache *instance();
+
+    bool load(std::string const &key, std::string &payload) const;
+    void store(std::string const &key, std::string const &payload) const;
+
+    // deletes the least recently used entries until they fit in 3/4 of maxBytes
+    void trim() const;
+
+    struct Writer {
+        std::string buf;
+
+        void u64(uint64_t x) {
+            buf.append((const char *)&x, sizeof(x));
+        }
+
+        void bytes(const void *p, size_t n) {
+            u64(n);
+            buf.append((const char *)p, n);
+        }
+
+        void str(std::string const &s) {
+            bytes(s.data(), s.size());
+        }
+    };
+
+    // every read checks bounds, ok() tells if the whole payload was well formed
+    struct Reader {
+        const char *p;
+        const char *end;
+        bool good = true;
+
+        explicit Reader(std::string const &buf)
+            : p(buf.data()), end(buf.data() + buf.size()) {}
+
+        uint64_t u64() {
+            uint64_t x = 0;
+            if (end - p < (ptrdiff_t)sizeof(x)) {
+                good = false;
+                return 0;
+            }
+            std::memcpy(&x, p, sizeof(x));
+            p += sizeof(x);
+            return x;
+        }
+
+        const char *bytes(size_t &n) {
+            n = u64();
+            if (!good || (size_t)(end - p) < n) {
+                good = false;
+                n = 0;
+                return nullptr;
+            }
+            auto q = p;
+            p += n;
+            return q;
+        }
+
+        std::string str() {
+            size_t n;
+            auto q = bytes(n);
+            return q ? std::string(q, n) : std::string();
+        }
+
+        bool ok() const {
+            return good && p == end;
+        }
+    };
+};
+
+}
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <cstring>
 #include <string>
+#include <vector>
+#include <mutex>
 #include <map>
 
 namespace zfx::x64 {
@@ -13,11 +17,28 @@ struct Executable {
     float consts[1024];
     void **functable = nullptr;
 
-    static constexpr size_t SimdWidth = 4;
+    // lanes per channel: 4 (xmm), 8 (ymm) or 16 (zmm), fixed at assembly time
+    size_t SimdWidth = 4;
+
+    static constexpr size_t MinSimdWidth = 4;
+    static constexpr size_t MaxSimdWidth = 16;
+
+    std::string lines;
+
+    // batch kernels only: floats between two elements of each channel
+    std::vector<int> batchStrides;
+    std::map<int, std::vector<int32_t>> gatherIndices;
+    std::map<std::vector<int>, std::unique_ptr<Executable>> batches;
+    std::mutex batchesMutex;
+
+    struct BatchArgs {
+        size_t count;
+        float *bases[256];
+    };
 
     struct Context {
         Executable *exec;
-        float locals[SimdWidth * 256];
+        float locals[MaxSimdWidth * 256];
 
         void execute() {
             auto entry = (void(*)(void *, void *, void *))exec->mem;
@@ -25,7 +46,19 @@ struct Executable {
         }
 
         float *channel(int chid) {
-            return locals + SimdWidth * chid;
+            return locals + exec->SimdWidth * chid;
+        }
+
+        // batch kernels only: runs count groups of SimdWidth elements in one call,
+        // channel j reading and writing memory from bases[j] on
+        void execute_batch(float *const *bases, size_t count) {
+            if (!count)
+                return;
+            BatchArgs args;
+            args.count = count;
+            std::copy_n(bases, exec->batchStrides.size(), args.bases);
+            auto entry = (void(*)(void *, void *, void *, void *))exec->mem;
+            entry((void *)locals, (void *)exec->consts, (void *)exec->functable, (void *)&args);
         }
     };
 
@@ -34,26 +67,52 @@ struct Executable {
     }
 
     inline Context make_context() {
-        return {this};
+        Context ctx;
+        ctx.exec = this;
+        std::memset(ctx.locals, 0, sizeof(float) * SimdWidth * 256);
+        return ctx;
     }
 
+    // widest supported by this CPU, $ZFX_SIMD_WIDTH may lower it
+    static size_t bestSimdWidth();
+
     Executable() = default;
     Executable(Executable const &) = delete;
     ~Executable();
 
     static std::unique_ptr<Executable> assemble
         ( std::string const &lines
+        , size_t simdWidth = MinSimdWidth
+        );
+
+    // kernel that loops over whole blocks itself, loading and storing the channels
+    // straight from attribute arrays with the given strides (in floats)
+    static std::unique_ptr<Executable> assemble_batch
+        ( std::string const &lines
+        , size_t simdWidth
+        , std::vector<int> const &strides
         );
+
+    static bool supportsBatch();
+
+    // batch kernel of this program for the given channel strides, it takes over the
+    // parameters set on this one at each call; nullptr if the CPU can't run it
+    Executable *batch(std::vector<int> const &strides);
 };
 
 struct Assembler {
     std::map<std::string, std::unique_ptr<Executable>> cache;
+    size_t simdWidth;
+
+    // wranglers that execute one element per context should stay at MinSimdWidth
+    explicit Assembler(size_t simdWidth = Executable::bestSimdWidth())
+        : simdWidth(simdWidth) {}
 
     Executable *assemble(std::string const &lines) {
         if (auto it = cache.find(lines); it != cache.end()) {
             return it->second.get();
         }
-        auto prog = Executable::assemble(lines);
+        auto prog = Executable::assemble(lines, simdWidth);
         auto raw_ptr = prog.get();
         cache[lines] = std::move(prog);
         return raw_ptr;
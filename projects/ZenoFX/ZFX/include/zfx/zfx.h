@@ -68,6 +68,12 @@ struct Options {
         os << '|' << reassign_channels;
         os << '|' << save_math_registers;
         os << '|' << arch_maxregs;
+        os << '|' << demote_math_funcs;
+        os << '|' << detect_new_symbols;
+        os << '|' << reassign_parameters;
+        os << '|' << merge_identical;
+        os << '|' << kill_unreachable;
+        os << '|' << constant_fold;
     }
 };
 
@@ -116,6 +122,11 @@ struct Program {
     }
 };
 
+// the on-disk cache shared with other processes (see zfx/diskcache.h),
+// keyed by the same string as Compiler::cache
+bool load_cached_program(std::string const &key, Program &prog);
+void store_cached_program(std::string const &key, Program const &prog);
+
 struct Compiler {
     std::map<std::string, std::unique_ptr<Program>> cache;
 
@@ -133,20 +144,23 @@ struct Compiler {
             return it->second.get();
         }
 
-        auto 
-            [ assembly
-            , symbols
-            , params
-            , newsyms
-            ] = compile_to_assembly
-            ( code
-            , options
-            );
         auto prog = std::make_unique<Program>();
-        prog->assembly = assembly;
-        prog->symbols = symbols;
-        prog->params = params;
-        prog->newsyms = newsyms;
+        if (!load_cached_program(key, *prog)) {
+            auto
+                [ assembly
+                , symbols
+                , params
+                , newsyms
+                ] = compile_to_assembly
+                ( code
+                , options
+                );
+            prog->assembly = assembly;
+            prog->symbols = symbols;
+            prog->params = params;
+            prog->newsyms = newsyms;
+            store_cached_program(key, *prog);
+        }
 
         auto raw_ptr = prog.get();
         cache[key] = std::move(prog);
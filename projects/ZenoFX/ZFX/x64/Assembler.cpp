@@ -1,9 +1,16 @@
 #include "SIMDBuilder.h"
 #include "Executable.h"
 #include "FuncTable.h"
+#define VCL_NAMESPACE zfx::x64::vcl
+#include "vectorclass/instrset.h"
+#include <zfx/diskcache.h>
 #include <zfx/utils.h>
 #include <zfx/x64.h>
 #include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <set>
 #include <sstream>
 #include <map>
 
@@ -15,17 +22,118 @@ namespace zfx::x64 {
     } \
 } while (0)
 
+static int simdKindOfWidth(size_t simdWidth) {
+    switch (simdWidth) {
+    case 4: return simdtype::xmmps;
+    case 8: return simdtype::ymmps;
+    case 16: return simdtype::zmmps;
+    default: error("unsupported simd width %zd", simdWidth);
+    }
+}
+
+static FuncTable &funcTableOfWidth(size_t simdWidth) {
+    static FuncTable sse(4), avx2(8), avx512(16);
+    return simdWidth == 16 ? avx512 : simdWidth == 8 ? avx2 : sse;
+}
+
 struct ImplAssembler {
     int simdkind = simdtype::xmmps;
 
     std::unique_ptr<SIMDBuilder> builder = std::make_unique<SIMDBuilder>();
     std::unique_ptr<Executable> exec = std::make_unique<Executable>();
-    static inline std::unique_ptr<FuncTable> functable;
 
     int nconsts = 0;
     int nlocals = 0;
     //int nglobals = 0;
 
+    // batch kernels keep the Executable::BatchArgs in rbx, which the function table calls preserve
+    bool batch = false;
+    std::set<int> batchStored;
+    size_t batchLoop = 0;
+
+    static int batchBaseOffset(int chid) {
+        return offsetof(Executable::BatchArgs, bases) + chid * sizeof(float *);
+    }
+
+    const int32_t *gatherIndexOf(int stride) {
+        auto &index = exec->gatherIndices[stride];
+        if (index.empty()) {
+            for (int i = 0; i < Executable::MaxSimdWidth; i++)
+                index.push_back(i * stride);
+        }
+        return index.data();
+    }
+
+    void emitBatchBegin() {
+        builder->addPushReg(opreg::rbx);
+        builder->addAdjStackTop(-8);  // calls expect the same stack alignment as at entry
+        builder->addRegularMoveOp(opreg::rbx, opreg::a4);
+        batchLoop = builder->getResult().size();
+        int size = SIMDBuilder::sizeOfType(simdkind);
+        for (int j = 0; j < exec->batchStrides.size(); j++) {
+            int stride = exec->batchStrides[j];
+            if (stride == 1) {
+                builder->addRegularLoadOp(opreg::rax,
+                    {opreg::rbx, memflag::reg_imm8, batchBaseOffset(j)});
+                builder->addAvxMemoryOp(simdkind, opcode::loadu,
+                    opreg::mm0, opreg::rax);
+            } else {
+                builder->addRegularLoadImm64Op(opreg::rax, (uint64_t)gatherIndexOf(stride));
+                builder->addAvxMemoryOp(simdkind, opcode::loadu,
+                    opreg::mm1, opreg::rax);
+                builder->addRegularLoadOp(opreg::rax,
+                    {opreg::rbx, memflag::reg_imm8, batchBaseOffset(j)});
+                builder->addAvxFullMaskOp(simdkind, opreg::mm2);
+                builder->addAvxGatherOp(simdkind, opreg::mm0, opreg::rax,
+                    opreg::mm1, opreg::mm2);
+            }
+            builder->addAvxMemoryOp(simdkind, opcode::storeu,
+                opreg::mm0, {opreg::a1, memflag::reg_imm8, j * size});
+        }
+    }
+
+    void emitBatchEnd() {
+        int size = SIMDBuilder::sizeOfType(simdkind);
+        for (int j: batchStored) {
+            int stride = exec->batchStrides[j];
+            builder->addAvxMemoryOp(simdkind, opcode::loadu,
+                opreg::mm0, {opreg::a1, memflag::reg_imm8, j * size});
+            if (stride == 1) {
+                builder->addRegularLoadOp(opreg::rax,
+                    {opreg::rbx, memflag::reg_imm8, batchBaseOffset(j)});
+                builder->addAvxMemoryOp(simdkind, opcode::storeu,
+                    opreg::mm0, opreg::rax);
+            } else if (simdkind == simdtype::zmmps) {
+                builder->addRegularLoadImm64Op(opreg::rax, (uint64_t)gatherIndexOf(stride));
+                builder->addAvxMemoryOp(simdkind, opcode::loadu,
+                    opreg::mm1, opreg::rax);
+                builder->addRegularLoadOp(opreg::rax,
+                    {opreg::rbx, memflag::reg_imm8, batchBaseOffset(j)});
+                builder->addAvxFullMaskOp(simdkind, 0);
+                builder->addAvxScatterOp(simdkind, opreg::mm0, opreg::rax, opreg::mm1);
+            } else {
+                // no scatter before AVX-512, store lane by lane
+                builder->addRegularLoadOp(opreg::rax,
+                    {opreg::rbx, memflag::reg_imm8, batchBaseOffset(j)});
+                for (int k = 0; k < exec->SimdWidth; k++) {
+                    if (k == 4)
+                        builder->addAvxExtractHighOp(opreg::mm1, opreg::mm0);
+                    builder->addAvxStoreLaneOp(k < 4 ? opreg::mm0 : opreg::mm1,
+                        {opreg::rax, memflag::reg_imm8, k * stride * (int)sizeof(float)}, k % 4);
+                }
+            }
+        }
+        for (int j = 0; j < exec->batchStrides.size(); j++) {
+            builder->addRegularAddMemoryOp({opreg::rbx, memflag::reg_imm8, batchBaseOffset(j)},
+                exec->SimdWidth * exec->batchStrides[j] * sizeof(float));
+        }
+        builder->addRegularAddMemoryOp({opreg::rbx, memflag::reg_imm8,
+            offsetof(Executable::BatchArgs, count)}, -1);
+        builder->addJumpIfNotZeroOp(batchLoop);
+        builder->addAdjStackTop(8);
+        builder->addPopReg(opreg::rbx);
+    }
+
     static float parse_float(std::string const &expr) {
         float value = 0.0f;
         if (std::istringstream(expr) >> value)
@@ -39,6 +147,8 @@ struct ImplAssembler {
     }
 
     void parse(std::string const &lines) {
+        if (batch)
+            emitBatchBegin();
         for (auto line: split_str(lines, '\n')) {
             if (!line.size()) continue;
 
@@ -76,6 +186,8 @@ struct ImplAssembler {
                 auto dst = from_string<int>(linesep[1]);
                 auto id = from_string<int>(linesep[2]);
                 nlocals = std::max(nlocals, id + 1);
+                if (batch && id < exec->batchStrides.size())
+                    batchStored.insert(id);
                 int offset = id * SIMDBuilder::sizeOfType(simdkind);
                 builder->addAvxMemoryOp(simdkind, opcode::storeu,
                     dst, {opreg::a1, memflag::reg_imm8, offset});
@@ -347,6 +459,10 @@ struct ImplAssembler {
             }
         }
 
+        if (batch)
+            emitBatchEnd();
+        if (simdkind != simdtype::xmmps)
+            builder->addAvxZeroUpper();
         builder->addReturn();
         auto const &insts = builder->getResult();
 
@@ -364,26 +480,128 @@ struct ImplAssembler {
         }
 #endif
 
-        if (!functable)
-            functable = std::make_unique<FuncTable>();
-        exec->functable = functable->funcptrs.data();
-        exec->memsize = (insts.size() + 4095) / 4096 * 4096;
+        load(insts.data(), insts.size());
+    }
+
+    void load(const uint8_t *insts, size_t size) {
+        exec->functable = funcTableOfWidth(exec->SimdWidth).funcptrs.data();
+        exec->memsize = (size + 4095) / 4096 * 4096;
         exec->mem = (uint8_t *)exec_page_allocate(exec->memsize);
-        for (int i = 0; i < insts.size(); i++) {
+        for (int i = 0; i < size; i++) {
             exec->mem[i] = insts[i];
         }
         exec_page_mark_executable(exec->mem, exec->memsize);
     }
 };
 
+// machine code only calls through the function table and addresses memory relative
+// to its arguments, so it can be reused by any process with the same tables; batch
+// kernels embed pointers to their gather indices and are never cached
+static std::string diskCacheKeyOf(std::string const &lines, size_t simdWidth) {
+    std::ostringstream ss;
+    ss << "x64\n" << simdWidth << '|' << vcl::instrset_detect() << '|' << vcl::hasFMA3();
+    for (auto const &name: FuncTable::funcnames)
+        ss << '|' << name;
+    ss << '\n' << lines;
+    return ss.str();
+}
+
+static bool loadFromDiskCache(ImplAssembler &a, std::string const &key) {
+    auto cache = DiskCache::instance();
+    std::string payload;
+    if (!cache || !cache->load(key, payload))
+        return false;
+    DiskCache::Reader r(payload);
+    size_t codesize, constsize;
+    auto code = r.bytes(codesize);
+    auto consts = r.bytes(constsize);
+    if (!r.ok() || !codesize || constsize > sizeof(a.exec->consts))
+        return false;
+    std::memcpy(a.exec->consts, consts, constsize);
+    a.load((const uint8_t *)code, codesize);
+    return true;
+}
+
+static void storeToDiskCache(ImplAssembler &a, std::string const &key) {
+    auto cache = DiskCache::instance();
+    if (!cache)
+        return;
+    auto const &insts = a.builder->getResult();
+    // the constant pool is indexed by ldp, parameters are set later by the caller
+    size_t nconsts = std::min<size_t>(a.nconsts, std::size(a.exec->consts));
+    DiskCache::Writer w;
+    w.bytes(insts.data(), insts.size());
+    w.bytes(a.exec->consts, nconsts * sizeof(float));
+    cache->store(key, w.buf);
+}
+
 std::unique_ptr<Executable> Executable::assemble
     ( std::string const &lines
+    , size_t simdWidth
     ) {
     ImplAssembler a;
+    a.simdkind = simdKindOfWidth(simdWidth);
+    a.exec->SimdWidth = simdWidth;
+    a.exec->lines = lines;
+    auto key = diskCacheKeyOf(lines, simdWidth);
+    if (!loadFromDiskCache(a, key)) {
+        a.parse(lines);
+        storeToDiskCache(a, key);
+    }
+    return std::move(a.exec);
+}
+
+std::unique_ptr<Executable> Executable::assemble_batch
+    ( std::string const &lines
+    , size_t simdWidth
+    , std::vector<int> const &strides
+    ) {
+    ImplAssembler a;
+    a.simdkind = simdKindOfWidth(simdWidth);
+    a.exec->SimdWidth = simdWidth;
+    a.exec->batchStrides = strides;
+    a.exec->lines = lines;
+    a.batch = true;
     a.parse(lines);
     return std::move(a.exec);
 }
 
+Executable *Executable::batch(std::vector<int> const &strides) {
+    if (!supportsBatch())
+        return nullptr;
+    // wranglers of different nodes may share this program and run in parallel
+    std::lock_guard lock(batchesMutex);
+    auto &prog = batches[strides];
+    if (!prog)
+        prog = assemble_batch(lines, SimdWidth, strides);
+    std::copy(std::begin(consts), std::end(consts), std::begin(prog->consts));
+    return prog.get();
+}
+
+bool Executable::supportsBatch() {
+    // the channel gathers need AVX2
+    return vcl::instrset_detect() >= 8;
+}
+
+size_t Executable::bestSimdWidth() {
+    static size_t width = [] {
+        // the wide function tables are built with FMA enabled as well
+        int iset = vcl::instrset_detect();
+        size_t best = MinSimdWidth;
+        if (iset >= 8 && vcl::hasFMA3())
+            best = 8;
+        if (iset >= 10 && vcl::hasFMA3())
+            best = 16;
+        if (auto env = std::getenv("ZFX_SIMD_WIDTH")) {
+            size_t want = from_string<size_t>(env);
+            while (best > MinSimdWidth && best > want)
+                best /= 2;
+        }
+        return best;
+    }();
+    return width;
+}
+
 Executable::~Executable() {
     if (mem) {
         exec_page_free(mem, memsize);
@@ -1,83 +1,55 @@
 #pragma once
 
-#define VCL_NAMESPACE zfx::x64::vcl
-#include "vectorclass/vectorclass.h"
-#include "vectorclass/vectormath_trig.h"
-#include "vectorclass/vectormath_exp.h"
 #include <vector>
 #include <string>
-#include <cmath>
+#include <cstddef>
+
+// F1 takes one operand, F2 takes two, the order is the layout of the table
+#define ZFX_X64_FUNCS(F1, F2) \
+F1(sin) \
+F1(cos) \
+F1(tan) \
+F1(asin) \
+F1(acos) \
+F1(atan) \
+F1(exp) \
+F1(log) \
+F1(floor) \
+F1(ceil) \
+F1(fb2i) \
+F1(ib2f) \
+F2(atan2) \
+F2(pow) \
+F2(fmod)
 
 namespace zfx::x64 {
 
-struct FuncTable {
-#define DEF_FN1(name) static void func_##name(float *a) { vcl::Vec4f x; x.load(a); x = vcl::name(x); x.store(a); }
-#define DEF_FN2(name) static void func_##name(float *a, float *b) { vcl::Vec4f x, y; x.load(a); y.load(b); x = vcl::name(x, y); x.store(a); }
-DEF_FN1(sin)
-DEF_FN1(cos)
-DEF_FN1(tan)
-DEF_FN1(asin)
-DEF_FN1(acos)
-DEF_FN1(atan)
-DEF_FN1(exp)
-DEF_FN1(log)
-DEF_FN1(floor)
-DEF_FN1(ceil)
-DEF_FN2(atan2)
-DEF_FN2(pow)
-static void func_fb2i(float *a) { vcl::Vec4f x; x.load(a); x = vcl::fb2i(x); x.store(a); }
-static void func_ib2f(float *a) { vcl::Vec4f x; x.load(a); x = vcl::ib2f(x); x.store(a); }
-static void func_fmod(float *a, float *b) { vcl::Vec4f x, y; x.load(a); y.load(b); x = x - vcl::floor(x / y) * y; x.store(a); }
-#undef DEF_FN1
-#undef DEF_FN2
+// each one lives in its own translation unit, compiled for the matching instruction set
+void fillFuncTableSSE(void **ptrs);
+void fillFuncTableAVX2(void **ptrs);
+void fillFuncTableAVX512(void **ptrs);
 
+struct FuncTable {
     static inline std::vector<std::string> funcnames = {
 #define DEF_FN1(name) #name,
 #define DEF_FN2(name) DEF_FN1(name)
-DEF_FN1(sin)
-DEF_FN1(cos)
-DEF_FN1(tan)
-DEF_FN1(asin)
-DEF_FN1(acos)
-DEF_FN1(atan)
-DEF_FN1(exp)
-DEF_FN1(log)
-DEF_FN1(floor)
-DEF_FN1(ceil)
-DEF_FN1(fb2i)
-DEF_FN1(ib2f)
-DEF_FN2(atan2)
-DEF_FN2(pow)
-DEF_FN2(fmod)
+ZFX_X64_FUNCS(DEF_FN1, DEF_FN2)
 #undef DEF_FN1
 #undef DEF_FN2
     };
 
     std::vector<void *> funcptrs;
 
-    FuncTable() {
+    // functions take pointers to simdWidth floats
+    explicit FuncTable(size_t simdWidth) {
         // we have to assign funcptrs at runtime to prevent dll relocation
-        for (int i = 0; i < funcnames.size(); i++) {
-#define DEF_FN1(name) funcptrs.push_back((void *)func_##name);
-#define DEF_FN2(name) DEF_FN1(name)
-DEF_FN1(sin)
-DEF_FN1(cos)
-DEF_FN1(tan)
-DEF_FN1(asin)
-DEF_FN1(acos)
-DEF_FN1(atan)
-DEF_FN1(exp)
-DEF_FN1(log)
-DEF_FN1(floor)
-DEF_FN1(ceil)
-DEF_FN1(fb2i)
-DEF_FN1(ib2f)
-DEF_FN2(atan2)
-DEF_FN2(pow)
-DEF_FN2(fmod)
-#undef DEF_FN1
-#undef DEF_FN2
-        }
+        funcptrs.resize(funcnames.size());
+        if (simdWidth == 16)
+            fillFuncTableAVX512(funcptrs.data());
+        else if (simdWidth == 8)
+            fillFuncTableAVX2(funcptrs.data());
+        else
+            fillFuncTableSSE(funcptrs.data());
     }
 };
 
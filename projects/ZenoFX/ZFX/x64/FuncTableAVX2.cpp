@@ -0,0 +1,6 @@
+// compiled with AVX2 and FMA enabled, only called when the CPU has them
+#define VCL_NAMESPACE zfx::x64::vcl_avx2
+#define ZFX_VECF Vec8f
+#define ZFX_VECI Vec8i
+#define ZFX_FILL_FUNCS fillFuncTableAVX2
+#include "FuncTableImpl.h"
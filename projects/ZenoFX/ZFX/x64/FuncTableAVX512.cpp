@@ -0,0 +1,6 @@
+// compiled with AVX-512 enabled, only called when the CPU has it
+#define VCL_NAMESPACE zfx::x64::vcl_avx512
+#define ZFX_VECF Vec16f
+#define ZFX_VECI Vec16i
+#define ZFX_FILL_FUNCS fillFuncTableAVX512
+#include "FuncTableImpl.h"
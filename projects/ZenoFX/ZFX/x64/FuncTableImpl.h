@@ -0,0 +1,47 @@
+// no include guard: included once per instruction set, the includer defines
+// VCL_NAMESPACE (distinct per set so nothing is shared across them),
+// ZFX_VECF, ZFX_VECI (vector class names) and ZFX_FILL_FUNCS before including this file
+
+#include "vectorclass/vectorclass.h"
+#include "vectorclass/vectormath_trig.h"
+#include "vectorclass/vectormath_exp.h"
+#include "FuncTable.h"
+
+namespace zfx::x64 {
+
+namespace {
+
+using Vecf = VCL_NAMESPACE::ZFX_VECF;
+using Veci = VCL_NAMESPACE::ZFX_VECI;
+
+#define DEF_FN1(name) void func_##name(float *a) { Vecf x; x.load(a); x = VCL_NAMESPACE::name(x); x.store(a); }
+#define DEF_FN2(name) void func_##name(float *a, float *b) { Vecf x, y; x.load(a); y.load(b); x = VCL_NAMESPACE::name(x, y); x.store(a); }
+DEF_FN1(sin)
+DEF_FN1(cos)
+DEF_FN1(tan)
+DEF_FN1(asin)
+DEF_FN1(acos)
+DEF_FN1(atan)
+DEF_FN1(exp)
+DEF_FN1(log)
+DEF_FN1(floor)
+DEF_FN1(ceil)
+DEF_FN2(atan2)
+DEF_FN2(pow)
+void func_fb2i(float *a) { Vecf x; x.load(a); x = VCL_NAMESPACE::to_float(Veci(VCL_NAMESPACE::reinterpret_i(x))); x.store(a); }
+void func_ib2f(float *a) { Vecf x; x.load(a); x = VCL_NAMESPACE::reinterpret_f(VCL_NAMESPACE::roundi(x)); x.store(a); }
+void func_fmod(float *a, float *b) { Vecf x, y; x.load(a); y.load(b); x = x - VCL_NAMESPACE::floor(x / y) * y; x.store(a); }
+#undef DEF_FN1
+#undef DEF_FN2
+
+}
+
+void ZFX_FILL_FUNCS(void **ptrs) {
+#define DEF_FN1(name) *ptrs++ = (void *)func_##name;
+#define DEF_FN2(name) DEF_FN1(name)
+ZFX_X64_FUNCS(DEF_FN1, DEF_FN2)
+#undef DEF_FN1
+#undef DEF_FN2
+}
+
+}
@@ -0,0 +1,5 @@
+#define VCL_NAMESPACE zfx::x64::vcl
+#define ZFX_VECF Vec4f
+#define ZFX_VECI Vec4i
+#define ZFX_FILL_FUNCS fillFuncTableSSE
+#include "FuncTableImpl.h"
@@ -103,6 +103,15 @@ namespace simdtype {
         ymmpd = 0x05,
         ymmss = 0x06,
         ymmsd = 0x07,
+        zmmps = 0x08,  // EVEX encoded, requires AVX512F and AVX512DQ
+    };
+};
+
+namespace evexmap {
+    enum {
+        map0f = 0x01,
+        map0f38 = 0x02,
+        map0f3a = 0x03,
     };
 };
 
@@ -126,11 +135,14 @@ struct SIMDBuilder {   // requires AVX2
         , adr2shift(adr2shift)
         {}
 
-        void dump(std::vector<uint8_t> &res, int val, int flag = 0) {
+        // EVEX scales an 8-bit displacement by the operand size (disp8*N)
+        void dump(std::vector<uint8_t> &res, int val, int flag = 0, int dispscale = 1) {
+            int disp = immadr;
             if (mflag & (memflag::reg_imm8 | memflag::reg_imm32)) {
                 mflag &= ~(memflag::reg_imm8 | memflag::reg_imm32);
-                if (-128 <= immadr && immadr <= 127) {
+                if (disp % dispscale == 0 && -128 <= disp / dispscale && disp / dispscale <= 127) {
                     mflag |= memflag::reg_imm8;
+                    disp /= dispscale;
                 } else {
                     mflag |= memflag::reg_imm32;
                 }
@@ -148,12 +160,12 @@ struct SIMDBuilder {   // requires AVX2
                 res.push_back(adr2 | adr2shift << 6);
             }
             if (mflag & memflag::reg_imm8) {
-                res.push_back(immadr & 0xff);
+                res.push_back(disp & 0xff);
             } else if (mflag & memflag::reg_imm32) {
-                res.push_back(immadr & 0xff);
-                res.push_back(immadr >> 8 & 0xff);
-                res.push_back(immadr >> 16 & 0xff);
-                res.push_back(immadr >> 24 & 0xff);
+                res.push_back(disp & 0xff);
+                res.push_back(disp >> 8 & 0xff);
+                res.push_back(disp >> 16 & 0xff);
+                res.push_back(disp >> 24 & 0xff);
             }
         }
     };
@@ -166,6 +178,7 @@ struct SIMDBuilder {   // requires AVX2
         case simdtype::xmmsd: return sizeof(double);
         case simdtype::ymmps: return sizeof(float);
         case simdtype::ymmpd: return sizeof(double);
+        case simdtype::zmmps: return sizeof(float);
         default: return 0;
         }
     }
@@ -178,11 +191,32 @@ struct SIMDBuilder {   // requires AVX2
         case simdtype::xmmsd: return 1 * sizeof(double);
         case simdtype::ymmps: return 8 * sizeof(float);
         case simdtype::ymmpd: return 4 * sizeof(double);
+        case simdtype::zmmps: return 16 * sizeof(float);
         default: return 0;
         }
     }
 
+    // 512-bit EVEX prefix, pp: 0 = none, 1 = 66, 2 = F3, 3 = F2; registers must be below 16
+    void addEvexPrefix(int map, int pp, int reg, int vvvv, int rm, int opmask = 0) {
+        res.push_back(0x62);
+        res.push_back((~reg >> 3 & 1) << 7 | 0x40 | (~rm >> 3 & 1) << 5 | 0x10 | map);
+        res.push_back((~vvvv & 0x0f) << 3 | 0x04 | pp);
+        res.push_back(0x40 | 0x08 | opmask);
+    }
+
+    void addEvexRegOp(int map, int pp, int op, int reg, int vvvv, int rm, int opmask = 0) {
+        addEvexPrefix(map, pp, reg, vvvv, rm, opmask);
+        res.push_back(op);
+        res.push_back(0xc0 | reg << 3 & 0x38 | rm & 0x07);
+    }
+
     void addAvxBroadcastLoadOp(int type, int val, MemoryAddress adr) {
+        if (type == simdtype::zmmps) {
+            addEvexPrefix(evexmap::map0f38, 1, val, 0, adr.adr);
+            res.push_back(0x18);
+            adr.dump(res, val, 0, scalarSizeOfType(type));
+            return;
+        }
         res.push_back(0xc4);
         res.push_back(0x62 | ~val >> 3 << 7);
         res.push_back(0x79 | type & 0x04);
@@ -200,6 +234,12 @@ struct SIMDBuilder {   // requires AVX2
     }
 
     void addAvxMemoryOp(int type, int op, int val, MemoryAddress adr) {
+        if (type == simdtype::zmmps) {
+            addEvexPrefix(evexmap::map0f, 0, val, 0, adr.adr);
+            res.push_back(op);
+            adr.dump(res, val, 0, sizeOfType(type));
+            return;
+        }
         res.push_back(0xc5);
         res.push_back(type | 0x78 | ~val >> 3 << 7);
         res.push_back(op);
@@ -224,11 +264,52 @@ struct SIMDBuilder {   // requires AVX2
         res.push_back(0xc0 | dst & 0x07 | src << 3 & 0x38);
     }
 
+    void addRegularLoadImm64Op(int val, uint64_t imm) {
+        res.push_back(0x48 | val >> 3);
+        res.push_back(0xb8 | val & 0x07);
+        for (int i = 0; i < 8; i++)
+            res.push_back(imm >> i * 8 & 0xff);
+    }
+
+    // add qword [adr], imm
+    void addRegularAddMemoryOp(MemoryAddress adr, int imm) {
+        res.push_back(0x48 | adr.adr >> 3);
+        bool imm8 = -128 <= imm && imm <= 127;
+        res.push_back(imm8 ? 0x83 : 0x81);
+        adr.dump(res, 0);
+        res.push_back(imm & 0xff);
+        if (!imm8) {
+            res.push_back(imm >> 8 & 0xff);
+            res.push_back(imm >> 16 & 0xff);
+            res.push_back(imm >> 24 & 0xff);
+        }
+    }
+
+    // jnz to an earlier (or later) position of res
+    void addJumpIfNotZeroOp(size_t target) {
+        int off = (int)target - (int)(res.size() + 6);
+        res.push_back(0x0f);
+        res.push_back(0x85);
+        res.push_back(off & 0xff);
+        res.push_back(off >> 8 & 0xff);
+        res.push_back(off >> 16 & 0xff);
+        res.push_back(off >> 24 & 0xff);
+    }
+
     void addAdjStackTop(int imm_add) {
         res.push_back(0x48);
-        res.push_back(0x83);
-        res.push_back(0xc4);
-        res.push_back(imm_add);
+        if (-128 <= imm_add && imm_add <= 127) {
+            res.push_back(0x83);
+            res.push_back(0xc4);
+            res.push_back(imm_add & 0xff);
+        } else {
+            res.push_back(0x81);
+            res.push_back(0xc4);
+            res.push_back(imm_add & 0xff);
+            res.push_back(imm_add >> 8 & 0xff);
+            res.push_back(imm_add >> 16 & 0xff);
+            res.push_back(imm_add >> 24 & 0xff);
+        }
     }
 
     void addCallOp(MemoryAddress adr) {
@@ -239,6 +320,17 @@ struct SIMDBuilder {   // requires AVX2
     }
 
     void addAvxBinaryOp(int type, int op, int dst, int lhs, int rhs) {
+        if (type == simdtype::zmmps) {
+            if ((op & 0xff) == opcode::cmp_eq) {
+                // compare into k1, then expand k1 to an all-ones/zeros lane mask like vcmpps ymm does
+                addEvexRegOp(evexmap::map0f, 0, op & 0xff, 1, lhs, rhs);
+                res.push_back(op >> 8);
+                addEvexRegOp(evexmap::map0f38, 2, 0x38, dst, 0, 1);  // vpmovm2d
+            } else {
+                addEvexRegOp(evexmap::map0f, 0, op & 0xff, dst, lhs, rhs);
+            }
+            return;
+        }
         if (rhs >= 8) {
             res.push_back(0xc4);
             res.push_back(0x41 | ~dst >> 3 << 7);
@@ -258,7 +350,74 @@ struct SIMDBuilder {   // requires AVX2
         addAvxBinaryOp(type, op, dst, opreg::mm0, src);
     }
 
+    // all lanes set in the gather/scatter mask: vpcmpeqd mask, mask, mask (k1 for zmm)
+    void addAvxFullMaskOp(int type, int mask) {
+        if (type == simdtype::zmmps) {
+            res.push_back(0xc5);  // kxnorw k1, k0, k0
+            res.push_back(0xfc);
+            res.push_back(0x46);
+            res.push_back(0xc8);
+            return;
+        }
+        res.push_back(0xc5);
+        res.push_back(0x01 | ~mask << 3 & 0x78 | type & 0x04 | ~mask >> 3 << 7);
+        res.push_back(0x76);
+        res.push_back(0xc0 | mask << 3 & 0x38 | mask & 0x07);
+    }
+
+    // dst = base[index * 4] for the lanes in mask (k1 for zmm), requires AVX2,
+    // the mask is cleared afterwards; registers must be below 8
+    void addAvxGatherOp(int type, int dst, int base, int index, int mask) {
+        if (type == simdtype::zmmps) {
+            addEvexPrefix(evexmap::map0f38, 1, dst, 0, base, 1);
+        } else {
+            res.push_back(0xc4);
+            res.push_back(0xe0 | evexmap::map0f38);
+            res.push_back(0x01 | ~mask << 3 & 0x78 | type & 0x04);
+        }
+        res.push_back(0x92);
+        res.push_back(0x04 | dst << 3 & 0x38);
+        res.push_back(0x80 | index << 3 & 0x38 | base & 0x07);
+    }
+
+    // base[index * 4] = src for the lanes in k1, zmm only
+    void addAvxScatterOp(int type, int src, int base, int index) {
+        addEvexPrefix(evexmap::map0f38, 1, src, 0, base, 1);
+        res.push_back(0xa2);
+        res.push_back(0x04 | src << 3 & 0x38);
+        res.push_back(0x80 | index << 3 & 0x38 | base & 0x07);
+    }
+
+    // dst = upper 128 bits of the ymm src
+    void addAvxExtractHighOp(int dst, int src) {
+        res.push_back(0xc4);
+        res.push_back(0x43 | ~src >> 3 << 7 | (~dst >> 3 & 1) << 5);
+        res.push_back(0x7d);
+        res.push_back(0x19);
+        res.push_back(0xc0 | src << 3 & 0x38 | dst & 0x07);
+        res.push_back(0x01);
+    }
+
+    // store float lane of the xmm val to adr: vmovss for lane 0, vextractps otherwise
+    void addAvxStoreLaneOp(int val, MemoryAddress adr, int lane) {
+        if (lane == 0) {
+            addAvxMemoryOp(simdtype::xmmss, opcode::storeu, val, adr);
+            return;
+        }
+        res.push_back(0xc4);
+        res.push_back(0x63 | ~val >> 3 << 7);
+        res.push_back(0x79);
+        res.push_back(0x17);
+        adr.dump(res, val);
+        res.push_back(lane);
+    }
+
     void addAvxBlendvOp(int type, int dst, int lhs, int rhs, int mask) {
+        if (type == simdtype::zmmps) {
+            addEvexRegOp(evexmap::map0f38, 2, 0x39, 1, 0, mask);  // vpmovd2m k1, mask
+            addEvexRegOp(evexmap::map0f38, 1, 0x65, dst, lhs, rhs, 1);  // vblendmps dst{k1}, lhs, rhs
+            return;
+        }
         res.push_back(0xc4);
         res.push_back(0x43 | ~dst >> 3 << 7 | (~rhs >> 3 & 1) << 5);
         res.push_back(0x01 | type & 0x04 | ~lhs << 3 & 0x78);
@@ -268,7 +427,14 @@ struct SIMDBuilder {   // requires AVX2
     }
 
     void addAvxMoveOp(int type, int dst, int src) {
-        addAvxBinaryOp(opcode::loadu, opcode::mov, dst, opreg::mm0, src);
+        addAvxBinaryOp(type, opcode::mov, dst, opreg::mm0, src);
+    }
+
+    // avoids the SSE transition penalty in the caller after touching ymm/zmm upper halves
+    void addAvxZeroUpper() {
+        res.push_back(0xc5);
+        res.push_back(0xf8);
+        res.push_back(0x77);
     }
 
     void addJumpOp(int off) {
@@ -0,0 +1,144 @@
+// LBvh (LinearBvh.h) on a bumpy sphere of n triangles: build, refit and the
+// treelet optimization, then nearest primitive queries for a scatter of points
+// around the surface, one point at a time (find_nearest, as QueryNearestPrimitive
+// used to) and batched (find_nearest_batch), on the plain tree and on the
+// optimized one. also reports the surface area cost (sum of internal node box
+// areas over the root's) of both trees.
+// usage: bench_lbvh [triangles [queries]]   (default 10000000 100000)
+#include "../LinearBvh.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+constexpr float kPi = 3.14159265f;
+
+float frand(unsigned &seed) {
+    seed = seed * 1664525u + 1013904223u;
+    return (seed >> 8) * (1.0f / 16777216.0f);
+}
+
+float bump(float theta, float phi) {
+    return 1.f + 0.05f * std::sin(13 * theta) * std::cos(17 * phi);
+}
+
+zeno::vec3f spherePoint(float theta, float phi) {
+    float r = bump(theta, phi);
+    return r * zeno::vec3f(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+}
+
+// a uv sphere with about ntris triangles
+std::shared_ptr<zeno::PrimitiveObject> makeMesh(size_t ntris) {
+    int nu = (int)std::sqrt(ntris / 4.0) + 1;
+    int nv = 2 * nu;
+    auto prim = std::make_shared<zeno::PrimitiveObject>();
+    auto &pos = prim->verts.values;
+    pos.resize((size_t)(nu + 1) * nv);
+    for (int i = 0; i <= nu; i++)
+        for (int j = 0; j < nv; j++)
+            pos[(size_t)i * nv + j] = spherePoint(kPi * i / nu, 2 * kPi * j / nv);
+    auto &tris = prim->tris.values;
+    tris.reserve((size_t)nu * nv * 2);
+    for (int i = 0; i < nu; i++) {
+        for (int j = 0; j < nv; j++) {
+            int a = i * nv + j, b = i * nv + (j + 1) % nv;
+            int c = a + nv, d = b + nv;
+            tris.push_back({a, c, b});
+            tris.push_back({b, c, d});
+        }
+    }
+    prim->tris.update();
+    return prim;
+}
+
+std::vector<zeno::vec3f> makeQueries(size_t n) {
+    std::vector<zeno::vec3f> ret(n);
+    unsigned seed = 3;
+    for (auto &p: ret) {
+        float theta = std::acos(1 - 2 * frand(seed)), phi = 2 * kPi * frand(seed);
+        p = spherePoint(theta, phi) * (0.9f + 0.2f * frand(seed));
+    }
+    return ret;
+}
+
+double seconds(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+float areaOf(zeno::LBvh::Box const &bv) {
+    auto e = bv.second - bv.first;
+    return e[0] * e[1] + e[1] * e[2] + e[2] * e[0];
+}
+
+double sahCost(zeno::LBvh const &bvh) {
+    double sum = 0;
+    for (size_t i = 0; i < bvh.sortedBvs.size(); i++)
+        if (bvh.levels[i])
+            sum += areaOf(bvh.sortedBvs[i]);
+    return sum / areaOf(bvh.sortedBvs[0]);
+}
+
+// one find_nearest per point
+double query(zeno::LBvh const &bvh, std::vector<zeno::vec3f> const &queries, std::vector<float> &dists) {
+    dists.assign(queries.size(), 0);
+    auto t0 = std::chrono::steady_clock::now();
+#pragma omp parallel for schedule(guided, 4)
+    for (int i = 0; i < (int)queries.size(); i++) {
+        int id = -1;
+        float dist = std::numeric_limits<float>::max();
+        bvh.find_nearest(queries[i], id, dist);
+        dists[i] = dist;
+    }
+    return seconds(t0);
+}
+
+double queryBatch(zeno::LBvh const &bvh, std::vector<zeno::vec3f> const &queries, std::vector<float> &dists) {
+    std::vector<int> ids;
+    std::vector<zeno::vec3f> ws;
+    auto t0 = std::chrono::steady_clock::now();
+    bvh.find_nearest_batch(queries, ids, dists, ws);
+    return seconds(t0);
+}
+
+void report(const char *name, double t, size_t n, std::vector<float> const &dists, std::vector<float> const &ref) {
+    printf("  %-16s %8.3f s  %10.0f queries/s%s\n", name, t, n / t, dists == ref ? "" : "  MISMATCH");
+}
+
+}
+
+int main(int argc, char **argv) {
+    size_t ntris = argc > 1 ? std::atol(argv[1]) : 10000000;
+    size_t nqueries = argc > 2 ? std::atol(argv[2]) : 100000;
+
+    auto prim = makeMesh(ntris);
+    auto queries = makeQueries(nqueries);
+    printf("%zd triangles, %zd queries\n", prim->tris.size(), queries.size());
+
+    auto t0 = std::chrono::steady_clock::now();
+    zeno::LBvh bvh(prim, 0.f, zeno::LBvh::element_c<zeno::LBvh::element_e::tri>);
+    printf("  build     %8.3f s\n", seconds(t0));
+
+    t0 = std::chrono::steady_clock::now();
+    bvh.refit();
+    printf("  refit     %8.3f s\n", seconds(t0));
+
+    std::vector<float> ref, dists;
+    double t = query(bvh, queries, ref);
+    printf("  cost %.1f\n", sahCost(bvh));
+    report("find_nearest", t, queries.size(), ref, ref);
+    t = queryBatch(bvh, queries, dists);
+    report("batch", t, queries.size(), dists, ref);
+
+    t0 = std::chrono::steady_clock::now();
+    bvh.optimizeTreelets();
+    printf("  treelets  %8.3f s, cost %.1f\n", seconds(t0), sahCost(bvh));
+
+    t = query(bvh, queries, dists);
+    report("find_nearest", t, queries.size(), dists, ref);
+    t = queryBatch(bvh, queries, dists);
+    report("batch", t, queries.size(), dists, ref);
+    return 0;
+}
@@ -0,0 +1,199 @@
+// neighbor grid of ParticlesBuildHashGrid (NeighborGrid.h) against the dense
+// vector-of-vectors table it replaced, on a uniform block of particles and on a
+// splash (a thin pool plus droplets thrown over a 50x larger domain). reports
+// build time, memory and a neighbor loop counting the particles within radius,
+// visiting queries in index order (like before) and in the grid's cell order.
+// usage: bench_neighbor_grid [points...]   (default 1000000 10000000 50000000)
+#include "../NeighborGrid.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+// the HashGrid of pnw.cpp before NeighborGrid, minus the unused hashing modes
+struct LegacyHashGrid {
+    float inv_dx;
+    std::vector<zeno::vec3f> const &refpos;
+    std::vector<std::vector<int>> table;
+    zeno::vec3f pMin, pMax;
+    zeno::vec3i gridRes;
+
+    int hash(int x, int y, int z) {
+        return (x%gridRes[0]+gridRes[0])%gridRes[0] + ((y%gridRes[1]+gridRes[1])%gridRes[1]) * gridRes[0] + ((z%gridRes[2]+gridRes[2])%gridRes[2]) * gridRes[0] * gridRes[1];
+    }
+
+    static zeno::vec3i resolution(std::vector<zeno::vec3f> const &refpos, float radius) {
+        auto pMin = refpos[0], pMax = refpos[0];
+        for (auto const &p: refpos) {
+            pMin = zeno::min(pMin, p);
+            pMax = zeno::max(pMax, p);
+        }
+        return zeno::toint(zeno::floor((pMax - pMin + 2 * radius) / radius)) + 1;
+    }
+
+    LegacyHashGrid(std::vector<zeno::vec3f> const &refpos_, float radius) : refpos(refpos_) {
+        inv_dx = 1.0f / radius;
+        pMin = refpos[0];
+        pMax = refpos[0];
+        for (int i = 1; i < refpos.size(); i++) {
+            auto coor = refpos[i];
+            pMin = zeno::min(pMin, coor);
+            pMax = zeno::max(pMax, coor);
+        }
+        pMin -= radius;
+        pMax += radius;
+        gridRes = zeno::toint(zeno::floor((pMax - pMin) * inv_dx)) + 1;
+        table.resize(gridRes[0] * gridRes[1] * gridRes[2]);
+        for (int i = 0; i < refpos.size(); i++) {
+            auto coor = zeno::toint(zeno::floor((refpos[i] - pMin) * inv_dx));
+            table[hash(coor[0], coor[1], coor[2])].push_back(i);
+        }
+    }
+
+    size_t bytes() const {
+        size_t ret = table.capacity() * sizeof(table[0]);
+        for (auto const &cell: table)
+            ret += cell.capacity() * sizeof(int);
+        return ret;
+    }
+
+    template <class F>
+    void iter_neighbors(zeno::vec3f const &pos, F const &f) {
+        auto coor = zeno::toint(zeno::floor((pos - pMin) * inv_dx));
+        for (int dz = -1; dz < 2; dz++)
+            for (int dy = -1; dy < 2; dy++)
+                for (int dx = -1; dx < 2; dx++)
+                    for (int pid: table[hash(coor[0] + dx, coor[1] + dy, coor[2] + dz)])
+                        f(pid);
+    }
+};
+
+struct Scene {
+    std::string name;
+    std::vector<zeno::vec3f> pos;
+    float radius;
+};
+
+float frand(unsigned &seed) {
+    seed = seed * 1664525u + 1013904223u;
+    return (seed >> 8) * (1.0f / 16777216.0f);
+}
+
+// about 8 particles per cell in the dense parts
+Scene makeBlock(size_t n) {
+    Scene s{"block", std::vector<zeno::vec3f>(n), 0};
+    unsigned seed = 1;
+    for (auto &p: s.pos)
+        p = zeno::vec3f(frand(seed), frand(seed), frand(seed));
+    s.radius = std::cbrt(8.0f / n);
+    return s;
+}
+
+Scene makeSplash(size_t n) {
+    Scene s{"splash", std::vector<zeno::vec3f>(n), 0};
+    unsigned seed = 2;
+    size_t npool = n * 95 / 100;
+    float h = 0.02f;
+    for (size_t i = 0; i < n; i++) {
+        if (i < npool)
+            s.pos[i] = zeno::vec3f(frand(seed), frand(seed) * h, frand(seed));
+        else
+            s.pos[i] = zeno::vec3f(frand(seed) * 50 - 25, frand(seed) * 50, frand(seed) * 50 - 25);
+    }
+    s.radius = std::cbrt(8.0f * h / npool);
+    return s;
+}
+
+double seconds(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+template <class Visit>
+size_t countNeighbors(size_t n, Visit const &visit) {
+    size_t total = 0;
+#pragma omp parallel for reduction(+: total)
+    for (int i = 0; i < n; i++) {
+        total += visit(i);
+    }
+    return total;
+}
+
+void run(Scene const &s) {
+    auto const &pos = s.pos;
+    size_t n = pos.size();
+    float r2 = s.radius * s.radius;
+    printf("%-6s %9zd points:\n", s.name.c_str(), n);
+
+    auto t0 = std::chrono::steady_clock::now();
+    zeno::NeighborGrid grid(pos, s.radius);
+    double tbuild = seconds(t0);
+    printf("  csr     build %8.3f s  %8.1f MB  %s, %zd cells\n", tbuild, grid.bytes() / 1e6,
+           grid.sparse ? "sparse" : "dense", grid.numCells());
+
+    t0 = std::chrono::steady_clock::now();
+    size_t count = countNeighbors(n, [&] (int i) {
+        int c = 0;
+        grid.iter_neighbors(pos[i], [&] (int pid) {
+            auto d = pos[pid] - pos[i];
+            c += zeno::dot(d, d) <= r2;
+        });
+        return c;
+    });
+    printf("  csr     query %8.3f s  (index order, %zd pairs)\n", seconds(t0), count);
+
+    t0 = std::chrono::steady_clock::now();
+    size_t count2 = countNeighbors(n, [&] (int k) {
+        int c = 0;
+        auto p = grid.points[k];
+        grid.iter_cells(p, [&] (int begin, int end) {
+            for (int j = begin; j < end; j++) {
+                auto d = grid.points[j] - p;
+                c += zeno::dot(d, d) <= r2;
+            }
+        });
+        return c;
+    });
+    printf("  csr     query %8.3f s  (cell order, %zd pairs)%s\n", seconds(t0), count2,
+           count2 == count ? "" : "  MISMATCH");
+
+    auto res = LegacyHashGrid::resolution(pos, s.radius);
+    double cells = (double)res[0] * res[1] * res[2];
+    if (cells * sizeof(std::vector<int>) > 8e9 || cells >= 2147483647.0) {
+        printf("  legacy  skipped, %.3g cells\n", cells);
+        return;
+    }
+    t0 = std::chrono::steady_clock::now();
+    LegacyHashGrid legacy(pos, s.radius);
+    tbuild = seconds(t0);
+    printf("  legacy  build %8.3f s  %8.1f MB  %zd cells\n", tbuild, legacy.bytes() / 1e6, legacy.table.size());
+
+    t0 = std::chrono::steady_clock::now();
+    size_t count3 = countNeighbors(n, [&] (int i) {
+        int c = 0;
+        legacy.iter_neighbors(pos[i], [&] (int pid) {
+            auto d = pos[pid] - pos[i];
+            c += zeno::dot(d, d) <= r2;
+        });
+        return c;
+    });
+    printf("  legacy  query %8.3f s  (index order, %zd pairs)%s\n", seconds(t0), count3,
+           count3 == count ? "" : "  MISMATCH");
+}
+
+}
+
+int main(int argc, char **argv) {
+    std::vector<size_t> sizes;
+    for (int i = 1; i < argc; i++)
+        sizes.push_back(std::atol(argv[i]));
+    if (sizes.empty())
+        sizes = {1000000, 10000000, 50000000};
+    for (size_t n: sizes) {
+        run(makeBlock(n));
+        run(makeSplash(n));
+    }
+    return 0;
+}
@@ -0,0 +1,168 @@
+// ZFX x64 backend throughput at each simd width this CPU supports, over a set of
+// typical particle wrangles, both with a context per group of elements (copying
+// channels lane by lane) and with batch kernels looping over the arrays themselves,
+// like pw.cpp (single threaded, so the numbers compare code generation rather
+// than scaling). all results are checked against the 4 lane per-context ones.
+// usage: bench_zfx_simd [points=4000000] [rounds=3]
+#include <zfx/zfx.h>
+#include <zfx/x64.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Snippet {
+    const char *name;
+    const char *code;
+};
+
+const Snippet snippets[] = {
+    {"advect", "@vel = @vel * 0.99 + vec3(0, -9.8, 0) * 0.04\n@pos = @pos + @vel * 0.04\n"},
+    {"trig", "@clr = vec3(sin(@pos.x * 3), cos(@pos.y * 5), atan2(@pos.z, @pos.x))\n"},
+    {"exp", "@rad = exp(-dot(@pos, @pos)) + pow(abs(@pos.y) + 1, 1.5) + log(@rad + 2)\n"},
+    {"normalize", "@clr = normalizesafe(@pos) * length(@vel) + fmod(@pos, 0.25)\n"},
+    {"bounce", "@vel.y = @pos.y < 0 ? abs(@vel.y) * 0.5 : @vel.y\n@pos.y = abs(@pos.y)\n"},
+    {"clamp", "@clr = clamp(mix(@pos, @vel, 0.3), -1, 1)\n@rad = max(min(@rad, 2), 0.5) + floor(@pos.x * 4) / 4\n"},
+};
+
+struct Attr {
+    const char *name;
+    int dim;
+    std::vector<float> data;
+};
+
+struct Buffer {
+    float *base;
+    size_t stride;
+};
+
+void wrangleBatch(zfx::x64::Executable *exec, zfx::x64::Executable *batch, std::vector<Buffer> const &chs, size_t size) {
+    size_t w = batch->SimdWidth;
+    std::vector<float *> bases;
+    for (auto const &ch: chs)
+        bases.push_back(ch.base);
+    auto ctx = batch->make_context();
+    ctx.execute_batch(bases.data(), size / w);
+    for (size_t i = size / w * w; i < size; i++) {
+        auto ctx = exec->make_context();
+        for (size_t j = 0; j < chs.size(); j++)
+            ctx.channel(j)[0] = chs[j].base[chs[j].stride * i];
+        ctx.execute();
+        for (size_t j = 0; j < chs.size(); j++)
+            chs[j].base[chs[j].stride * i] = ctx.channel(j)[0];
+    }
+}
+
+void wrangle(zfx::x64::Executable *exec, std::vector<Buffer> const &chs, size_t size) {
+    size_t w = exec->SimdWidth;
+    for (size_t i = 0; i < size / w * w; i += w) {
+        auto ctx = exec->make_context();
+        for (size_t j = 0; j < chs.size(); j++)
+            for (size_t k = 0; k < w; k++)
+                ctx.channel(j)[k] = chs[j].base[chs[j].stride * (i + k)];
+        ctx.execute();
+        for (size_t j = 0; j < chs.size(); j++)
+            for (size_t k = 0; k < w; k++)
+                chs[j].base[chs[j].stride * (i + k)] = ctx.channel(j)[k];
+    }
+    for (size_t i = size / w * w; i < size; i++) {
+        auto ctx = exec->make_context();
+        for (size_t j = 0; j < chs.size(); j++)
+            ctx.channel(j)[0] = chs[j].base[chs[j].stride * i];
+        ctx.execute();
+        for (size_t j = 0; j < chs.size(); j++)
+            chs[j].base[chs[j].stride * i] = ctx.channel(j)[0];
+    }
+}
+
+std::vector<Attr> makeAttrs(size_t n) {
+    std::vector<Attr> attrs{{"@pos", 3, {}}, {"@vel", 3, {}}, {"@clr", 3, {}}, {"@rad", 1, {}}};
+    unsigned seed = 1;
+    for (auto &attr: attrs) {
+        attr.data.resize(n * attr.dim);
+        for (auto &x: attr.data) {
+            seed = seed * 1664525u + 1013904223u;
+            x = (seed >> 8) * (2.0f / 16777216.0f) - 1.0f;
+        }
+    }
+    return attrs;
+}
+
+}
+
+int main(int argc, char **argv) {
+    size_t n = argc > 1 ? std::atol(argv[1]) : 4000000;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 3;
+
+    std::vector<size_t> widths;
+    for (size_t w = zfx::x64::Executable::MinSimdWidth; w <= zfx::x64::Executable::bestSimdWidth(); w *= 2)
+        widths.push_back(w);
+    printf("%zd points, best simd width %zd\n", n, zfx::x64::Executable::bestSimdWidth());
+
+    zfx::Compiler compiler;
+    for (auto const &snippet: snippets) {
+        zfx::Options opts(zfx::Options::for_x64);
+        auto attrs = makeAttrs(n);
+        for (auto const &attr: attrs)
+            opts.define_symbol(attr.name, attr.dim);
+        auto prog = compiler.compile(snippet.code, opts);
+
+        std::vector<float> reference;
+        for (int mode = 0; mode < 2 * widths.size(); mode++) {
+            size_t w = widths[mode % widths.size()];
+            bool useBatch = mode >= widths.size();
+            if (useBatch && !zfx::x64::Executable::supportsBatch())
+                break;
+            zfx::x64::Assembler assembler(w);
+            auto exec = assembler.assemble(prog->assembly);
+            zfx::x64::Executable *batch = nullptr;
+
+            double best = 1e30;
+            for (int r = 0; r < rounds; r++) {
+                attrs = makeAttrs(n);
+                std::vector<Buffer> chs;
+                for (auto const &[name, dimid]: prog->symbols) {
+                    auto &attr = *std::find_if(attrs.begin(), attrs.end(),
+                        [&, name = name] (Attr const &a) { return name == a.name; });
+                    chs.push_back({attr.data.data() + dimid, (size_t)attr.dim});
+                }
+                if (useBatch && !batch) {
+                    std::vector<int> strides;
+                    for (auto const &ch: chs)
+                        strides.push_back(ch.stride);
+                    batch = exec->batch(strides);
+                }
+                auto t0 = std::chrono::steady_clock::now();
+                if (batch)
+                    wrangleBatch(exec, batch, chs, n);
+                else
+                    wrangle(exec, chs, n);
+                auto t1 = std::chrono::steady_clock::now();
+                best = std::min(best, std::chrono::duration<double>(t1 - t0).count());
+            }
+
+            std::vector<float> result;
+            for (auto const &attr: attrs)
+                result.insert(result.end(), attr.data.begin(), attr.data.end());
+            double maxerr = 0;
+            if (reference.empty()) {
+                reference = std::move(result);
+            } else {
+                for (size_t i = 0; i < result.size(); i++) {
+                    if (std::isnan(result[i]) != std::isnan(reference[i]))
+                        maxerr = INFINITY;
+                    else if (!std::isnan(result[i]))
+                        maxerr = std::max(maxerr, (double)std::abs(result[i] - reference[i]));
+                }
+            }
+            printf("%-10s %-5s x%-2zd %8.2f ns/pt %8.1f Mpt/s  maxdiff %g\n", snippet.name, useBatch ? "batch" : "ctx", w,
+                   best * 1e9 / n, n / best * 1e-6, maxerr);
+        }
+    }
+    return 0;
+}
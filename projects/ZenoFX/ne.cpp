@@ -19,7 +19,7 @@ namespace zeno {
 
 namespace {
 static zfx::Compiler compiler;
-static zfx::x64::Assembler assembler;
+static zfx::x64::Assembler assembler(zfx::x64::Executable::MinSimdWidth);
 
 static void numeric_eval (zfx::x64::Executable *exec,
                          std::vector<float> &chs) {
@@ -17,7 +17,7 @@ namespace {
     using namespace zeno;
 
 static zfx::Compiler compiler;
-static zfx::x64::Assembler assembler;
+static zfx::x64::Assembler assembler(zfx::x64::Executable::MinSimdWidth);
 
 static void numeric_wrangle
     ( zfx::x64::Executable *exec
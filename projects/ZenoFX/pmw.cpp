@@ -37,7 +37,7 @@ static void vectors_wrangle
     }
 
     #pragma omp parallel for
-    for (int i = 0; i < size - exec->SimdWidth + 1; i += exec->SimdWidth) {
+    for (int i = 0; i < size / exec->SimdWidth * exec->SimdWidth; i += exec->SimdWidth) {
         auto ctx = exec->make_context();
         for (int j = 0; j < chs.size(); j++) {
             for (int k = 0; k < exec->SimdWidth; k++)
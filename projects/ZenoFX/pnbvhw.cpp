@@ -11,6 +11,7 @@
 #include <zfx/x64.h>
 #include <cassert>
 #include "dbg_printf.h"
+#include "NeighborWrangle.h"
 #include <cmath>
 #include <atomic>
 #include <algorithm>
@@ -37,44 +38,30 @@ static void sorted_bvh_vectors_wrangle(zfx::x64::Executable *exec,
                                 std::vector<zeno::vec3f> const &opos,
                                 bool isBox, float radius2, int upper,
                                 zeno::LBvh *lbvh) {
-  if (chs.size() == 0)
-    return;
-
   if (upper < 0)
     upper = std::numeric_limits<int>::max();
 
-#pragma omp parallel for
-  for (int i = 0; i < pos.size(); i++) {
-    using pair = std::pair<float, int>;
-    std::vector<pair> neighbors;
-    auto ctx = exec->make_context();
-    for (int k = 0; k < chs.size(); k++) {
-      if (!chs[k].which)
-        ctx.channel(k)[0] = chs[k].base[chs[k].stride * i];
-    }
-    /// count
-    lbvh->iter_neighbors(pos[i], [&](int pid) {
-      auto dist2 = lengthSquared(pos[i] - opos[pid]);
-      if (!isBox)
-        if (dist2 > radius2)
-          return;
-      neighbors.push_back(std::make_pair(dist2, pid));
-    });
-    std::sort(std::begin(neighbors), std::end(neighbors));
-    int id = 0;
-    for (const auto &neighbor : neighbors) {
-      if (id++ >= upper) break;
-      for (int k = 0; k < chs.size(); k++) {
-        if (chs[k].which)
-          ctx.channel(k)[0] = chs2[k].base[chs2[k].stride * neighbor.second];
+  neighbor_lanes_wrangle(exec, chs, chs2, pos.size(),
+    [&](size_t i, std::vector<int> &ids) {
+      using pair = std::pair<float, int>;
+      thread_local std::vector<pair> neighbors;
+      neighbors.clear();
+      /// count
+      lbvh->iter_neighbors(pos[i], [&](int pid) {
+        auto dist2 = lengthSquared(pos[i] - opos[pid]);
+        if (!isBox)
+          if (dist2 > radius2)
+            return;
+        neighbors.push_back(std::make_pair(dist2, pid));
+      });
+      std::sort(std::begin(neighbors), std::end(neighbors));
+      int id = 0;
+      for (const auto &neighbor : neighbors) {
+        if (id++ >= upper) break;
+        ids.push_back(neighbor.second);
       }
-      ctx.execute();
-    }
-    for (int k = 0; k < chs.size(); k++) {
-      if (!chs[k].which)
-        chs[k].base[chs[k].stride * i] = ctx.channel(k)[0];
-    }
-  }
+      return (int)i;
+    }, [](int) { return true; });
 }
 
 static void bvh_vectors_wrangle(zfx::x64::Executable *exec,
@@ -84,31 +71,16 @@ static void bvh_vectors_wrangle(zfx::x64::Executable *exec,
                                 std::vector<zeno::vec3f> const &opos,
                                 bool isBox, float radius2,
                                 zeno::LBvh *lbvh) {
-  if (chs.size() == 0)
-    return;
-
-#pragma omp parallel for
-  for (int i = 0; i < pos.size(); i++) {
-    auto ctx = exec->make_context();
-    for (int k = 0; k < chs.size(); k++) {
-      if (!chs[k].which)
-        ctx.channel(k)[0] = chs[k].base[chs[k].stride * i];
-    }
-    lbvh->iter_neighbors(pos[i], [&](int pid) {
-      if (!isBox)
-        if (lengthSquared(pos[i] - opos[pid]) > radius2)
-          return;
-      for (int k = 0; k < chs.size(); k++) {
-        if (chs[k].which)
-          ctx.channel(k)[0] = chs2[k].base[chs2[k].stride * pid];
-      }
-      ctx.execute();
-    });
-    for (int k = 0; k < chs.size(); k++) {
-      if (!chs[k].which)
-        chs[k].base[chs[k].stride * i] = ctx.channel(k)[0];
-    }
-  }
+  neighbor_lanes_wrangle(exec, chs, chs2, pos.size(),
+    [&](size_t i, std::vector<int> &ids) {
+      lbvh->iter_neighbors(pos[i], [&](int pid) {
+        if (!isBox)
+          if (lengthSquared(pos[i] - opos[pid]) > radius2)
+            return;
+        ids.push_back(pid);
+      });
+      return (int)i;
+    }, [](int) { return true; });
 }
 
 static void bvh_vectors_wrangle_radius_two(zfx::x64::Executable *exec,
@@ -123,66 +95,40 @@ static void bvh_vectors_wrangle_radius_two(zfx::x64::Executable *exec,
                                 std::string neiRadiusAttr,
                                 bool isBox, float bvhradius,
                                 zeno::LBvh *lbvh) {
-  if (chs.size() == 0)
-    return;
-
-#pragma omp parallel for
-  for (int i = 0; i < pos.size(); i++) {
-    auto ctx = exec->make_context();
-    for (int k = 0; k < chs.size(); k++) {
-      if (!chs[k].which)
-        ctx.channel(k)[0] = chs[k].base[chs[k].stride * i];
-    }
-    if (radiusAttr.empty()&&neiRadiusAttr.empty()){
-      lbvh->iter_neighbors(pos[i], [&](int pid) {
-        if (!isBox)
-          if (lengthSquared(pos[i] - opos[pid]) > (bvhradius) * (bvhradius))
-            return;
-        for (int k = 0; k < chs.size(); k++) {
-          if (chs[k].which)
-            ctx.channel(k)[0] = chs2[k].base[chs2[k].stride * pid];
-        }
-        ctx.execute();
-      });
-    }
-    else if(!radiusAttr.empty()&&neiRadiusAttr.empty()){
-      auto &radius = prim->verts.attr<float>(radiusAttr);
-      lbvh->iter_neighbors_radius(pos[i], radius[i], [&](int pid) {
-        if (!isBox)
-          if (lengthSquared(pos[i] - opos[pid]) > (bvhradius + radius[i]) * (bvhradius + radius[i]))
-            return;
-        for (int k = 0; k < chs.size(); k++) {
-          if (chs[k].which)
-            ctx.channel(k)[0] = chs2[k].base[chs2[k].stride * pid];
-        }
-        ctx.execute();
-      });
-    }
-    else if(!radiusAttr.empty()&&!neiRadiusAttr.empty()){
-      auto &radius = prim->verts.attr<float>(radiusAttr);
-      auto &neiRadius = primNei->verts.attr<float>(neiRadiusAttr);
-      lbvh->iter_neighbors_radius_two(pos[i], radius[i], neiRadius, [&](int pid) {
-        if (!isBox)
-          if (lengthSquared(pos[i] - opos[pid]) > (bvhradius + radius[i]  + neiRadius[pid]) * (bvhradius + radius[i]  + neiRadius[pid]))
-          //if (length(pos[i] - opos[pid]) > sqrt((bvhradius + radius[i]  + neiRadius[pid]) * (bvhradius + radius[i]  + neiRadius[pid])))
-            return;
-        for (int k = 0; k < chs.size(); k++) {
-          if (chs[k].which)
-            ctx.channel(k)[0] = chs2[k].base[chs2[k].stride * pid];
-        }
-        ctx.execute();
-      });
-    }
-    else{
-        throw zeno::makeError("neiRadiusAttr need to be empty when radiusAttr is empty");
-    }
-    for (int k = 0; k < chs.size(); k++) {
-      if (!chs[k].which)
-        if (maskarr[i] != 0) {
-          chs[k].base[chs[k].stride * i] = ctx.channel(k)[0];
-        }
-    }
-  }
+  if (radiusAttr.empty() && !neiRadiusAttr.empty())
+    throw zeno::makeError("neiRadiusAttr need to be empty when radiusAttr is empty");
+  auto *radius = radiusAttr.empty() ? nullptr : &prim->verts.attr<float>(radiusAttr);
+  auto *neiRadius = neiRadiusAttr.empty() ? nullptr : &primNei->verts.attr<float>(neiRadiusAttr);
+
+  neighbor_lanes_wrangle(exec, chs, chs2, pos.size(),
+    [&](size_t i, std::vector<int> &ids) {
+      if (!radius) {
+        lbvh->iter_neighbors(pos[i], [&](int pid) {
+          if (!isBox)
+            if (lengthSquared(pos[i] - opos[pid]) > (bvhradius) * (bvhradius))
+              return;
+          ids.push_back(pid);
+        });
+      }
+      else if (!neiRadius) {
+        lbvh->iter_neighbors_radius(pos[i], (*radius)[i], [&](int pid) {
+          if (!isBox)
+            if (lengthSquared(pos[i] - opos[pid]) > (bvhradius + (*radius)[i]) * (bvhradius + (*radius)[i]))
+              return;
+          ids.push_back(pid);
+        });
+      }
+      else {
+        lbvh->iter_neighbors_radius_two(pos[i], (*radius)[i], *neiRadius, [&](int pid) {
+          if (!isBox)
+            if (lengthSquared(pos[i] - opos[pid]) > (bvhradius + (*radius)[i]  + (*neiRadius)[pid]) * (bvhradius + (*radius)[i]  + (*neiRadius)[pid]))
+            //if (length(pos[i] - opos[pid]) > sqrt((bvhradius + radius[i]  + neiRadius[pid]) * (bvhradius + radius[i]  + neiRadius[pid])))
+              return;
+          ids.push_back(pid);
+        });
+      }
+      return (int)i;
+    }, [&](int i) { return maskarr[i] != 0; });
 }
 
 struct ParticlesBuildBvh : zeno::INode {
@@ -216,32 +162,32 @@ struct BuildPrimitiveBvh : zeno::INode {
             ? get_input<zeno::NumericObject>("thickness")->get<float>()
             : 0.f;
     auto primType = get_param<std::string>("prim_type");
+    std::shared_ptr<zeno::LBvh> lbvh;
     if (primType == "auto") {
-      auto lbvh = std::make_shared<zeno::LBvh>(prim, thickness);
-      set_output("lbvh", std::move(lbvh));
+      lbvh = std::make_shared<zeno::LBvh>(prim, thickness);
     } else if (primType == "point") {
-      auto lbvh = std::make_shared<zeno::LBvh>(
+      lbvh = std::make_shared<zeno::LBvh>(
           prim, thickness, zeno::LBvh::element_c<zeno::LBvh::element_e::point>);
-      set_output("lbvh", std::move(lbvh));
     } else if (primType == "line") {
-      auto lbvh = std::make_shared<zeno::LBvh>(
+      lbvh = std::make_shared<zeno::LBvh>(
           prim, thickness, zeno::LBvh::element_c<zeno::LBvh::element_e::line>);
-      set_output("lbvh", std::move(lbvh));
     } else if (primType == "tri") {
-      auto lbvh = std::make_shared<zeno::LBvh>(
+      lbvh = std::make_shared<zeno::LBvh>(
           prim, thickness, zeno::LBvh::element_c<zeno::LBvh::element_e::tri>);
-      set_output("lbvh", std::move(lbvh));
     } else if (primType == "quad") {
-      auto lbvh = std::make_shared<zeno::LBvh>(
+      lbvh = std::make_shared<zeno::LBvh>(
           prim, thickness, zeno::LBvh::element_c<zeno::LBvh::element_e::tet>);
-      set_output("lbvh", std::move(lbvh));
     }
+    if (lbvh && get_input2<bool>("optimize"))
+      lbvh->optimizeTreelets();
+    set_output("lbvh", std::move(lbvh));
   }
 };
 
 ZENDEFNODE(BuildPrimitiveBvh,
            {
-               {{"PrimitiveObject", "prim"}, {"float", "thickness", "0"}},
+               {{"PrimitiveObject", "prim"}, {"float", "thickness", "0"},
+                {"bool", "optimize", "0"}},
                {{"LBvh", "lbvh"}},
                {{"enum auto point line tri quad", "prim_type", "auto"}},
                {"zenofx"},
@@ -316,14 +262,17 @@ struct QueryNearestPrimitive : zeno::INode {
       auto &closestPoints = prim->add_attr<zeno::vec3f>(closestPointTag);
 
       std::vector<KVPair> kvs(prim->size());
-      std::vector<Ti> ids(prim->size(), -1);
+      std::vector<Ti> ids;
+      std::vector<float> nearestDists;
+      std::vector<zeno::vec3f> nearestWs;
+      lbvh->find_nearest_batch(prim->verts.values, ids, nearestDists, nearestWs);
 #if defined(_OPENMP)
-#pragma omp parallel for schedule(guided, 4)
+#pragma omp parallel for
 #endif
       for (Ti i = 0; i < prim->size(); ++i) {
-        kvs[i].dist = std::numeric_limits<float>::max();
+        kvs[i].dist = nearestDists[i];
         kvs[i].pid = i;
-        kvs[i].w = lbvh->find_nearest(prim->verts[i], ids[i], kvs[i].dist);
+        kvs[i].w = nearestWs[i];
         // record info as attribs
         bvhids[i] = ids[i];
         dists[i] = kvs[i].dist;
@@ -446,16 +395,18 @@ struct QueryNearestPrimitiveWithUV : zeno::INode {
         throw std::runtime_error("missing vertex property [uv] in either querying prim or bvh-associated prim!");
 
       std::vector<KVPair> kvs(prim->size());
-      std::vector<Ti> ids(prim->size(), -1);
+      std::vector<Ti> ids;
+      std::vector<float> nearestDists, nearestUvDists2;
+      std::vector<zeno::vec3f> nearestWs;
+      lbvh->find_nearest_with_uv_batch(prim->verts.values, uvs, ids, nearestDists, nearestUvDists2, nearestWs);
 #if defined(_OPENMP)
-#pragma omp parallel for schedule(guided, 4)
+#pragma omp parallel for
 #endif
       for (Ti i = 0; i < prim->size(); ++i) {
-        kvs[i].dist = std::numeric_limits<float>::max();
-        kvs[i].uvDist2 = std::numeric_limits<float>::max();
+        kvs[i].dist = nearestDists[i];
+        kvs[i].uvDist2 = nearestUvDists2[i];
         kvs[i].pid = i;
-        zeno::vec3f uv = uvs[i];
-        kvs[i].w = lbvh->find_nearest_with_uv(prim->verts[i], uv, ids[i], kvs[i].dist, kvs[i].uvDist2);
+        kvs[i].w = nearestWs[i];
         // record info as attribs
         bvhids[i] = ids[i];
         dists[i] = kvs[i].dist;
@@ -659,16 +610,19 @@ struct QueryNearestPrimitiveWithinGroup : zeno::INode {
       const auto &targetGroupIds = lbvh->primPtr.lock()->attr<int>(groupTag);
 
       std::vector<KVPair> kvs(prim->size());
-      std::vector<Ti> ids(prim->size(), -1);
+      std::vector<Ti> ids;
+      std::vector<float> nearestDists;
+      std::vector<zeno::vec3f> nearestWs;
+      lbvh->find_nearest_within_group_batch(prim->verts.values, ids, nearestDists, nearestWs, [&groupIds, &targetGroupIds](int i, int no) {
+        return groupIds[i] == targetGroupIds[no];
+      }, LBvh::template element_c<LBvh::tri>);
 #if defined(_OPENMP)
-#pragma omp parallel for schedule(guided, 4)
+#pragma omp parallel for
 #endif
       for (Ti i = 0; i < prim->size(); ++i) {
-        kvs[i].dist = std::numeric_limits<float>::max();
+        kvs[i].dist = nearestDists[i];
         kvs[i].pid = i;
-        kvs[i].w = lbvh->find_nearest_within_group(prim->verts[i], ids[i], kvs[i].dist, [&groupIds, &targetGroupIds, i](int no) {
-          return groupIds[i] == targetGroupIds[no];
-        }, LBvh::template element_c<LBvh::tri>);
+        kvs[i].w = nearestWs[i];
         // record info as attribs
         bvhids[i] = ids[i];
         dists[i] = kvs[i].dist;
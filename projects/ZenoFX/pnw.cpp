@@ -9,6 +9,8 @@
 #include <zfx/x64.h>
 #include <cassert>
 #include "dbg_printf.h"
+#include "NeighborGrid.h"
+#include "NeighborWrangle.h"
 #include <cmath>
 #include <atomic>
 #include <algorithm>
@@ -31,111 +33,23 @@ struct Buffer {
 };
 
 struct HashGrid : zeno::IObject {
-    float inv_dx;
     float radius;
     float radius_sqr;
     float radius_sqr_min;
-    std::vector<zeno::vec3f> const &refpos;
 
-    std::vector<std::vector<int>> table;
+    // particles sorted into cells of `radius`, see NeighborGrid.h
+    zeno::NeighborGrid grid;
 
-//#define DILEI
-#define XUBEN
-
-    int hash(int x, int y, int z) {
-#ifdef XUBEN
-        return (x%gridRes[0]+gridRes[0])%gridRes[0] + ((y%gridRes[1]+gridRes[1])%gridRes[1]) * gridRes[0] + ((z%gridRes[2]+gridRes[2])%gridRes[2]) * gridRes[0] * gridRes[1];
-#else
-        return ((73856093 * x) ^ (19349663 * y) ^ (83492791 * z)) % table.size();
-#endif
-    }
-
-#ifdef XUBEN
-    zeno::vec3f pMin, pMax;
-    zeno::vec3i gridRes;
-#endif
-
-    HashGrid(std::vector<zeno::vec3f> const &refpos_,
+    HashGrid(std::vector<zeno::vec3f> const &refpos,
             float radius_, float radius_min)
-        : refpos(refpos_) {
+        : grid(refpos, radius_) {
 
         radius = radius_;
         radius_sqr = radius * radius;
         radius_sqr_min = radius_min < 0.f ? -1.f : radius_min * radius_min;
-#ifdef DILEI
-        inv_dx = 0.5f / radius;
-#else
-        inv_dx = 1.0f / radius;
-#endif
 
-#ifdef XUBEN
-        pMin = refpos[0];
-        pMax = refpos[0];
-        for (int i = 1; i < refpos.size(); i++) {
-            auto coor = refpos[i];
-            pMin = zeno::min(pMin, coor);
-            pMax = zeno::max(pMax, coor);
-        }
-        pMin -= radius;
-        pMax += radius;
-        gridRes = zeno::toint(zeno::floor((pMax - pMin) * inv_dx)) + 1;
-
-        dbg_printf("grid res: %dx%dx%d\n", gridRes[0], gridRes[1], gridRes[2]);
-        table.clear();
-        table.resize(gridRes[0] * gridRes[1] * gridRes[2]);
-#else
-        int table_size = refpos.size() / 8;
-        dbg_printf("table size: %d\n", table_size);
-        table.clear();
-        table.resize(table_size);
-#endif
-
-        for (int i = 0; i < refpos.size(); i++) {
-#ifdef XUBEN
-            auto coor = zeno::toint(zeno::floor((refpos[i] - pMin) * inv_dx));
-#else
-            auto coor = zeno::toint(zeno::floor(refpos[i] * inv_dx));
-#endif
-            auto key = hash(coor[0], coor[1], coor[2]);
-            table[key].push_back(i);
-        }
-    }
-
-    template <class F>
-    void iter_neighbors(zeno::vec3f const &pos, F const &f) {
-#ifdef XUBEN
-#ifdef DILEI
-        auto coor = zeno::toint(zeno::floor((pos - pMin) * inv_dx - 0.5f));
-#else
-        auto coor = zeno::toint(zeno::floor((pos - pMin) * inv_dx));
-#endif
-#else
-#ifdef DILEI
-        auto coor = zeno::toint(zeno::floor(pos * inv_dx - 0.5f));
-#else
-        auto coor = zeno::toint(zeno::floor(pos * inv_dx));
-#endif
-#endif
-#ifdef DILEI
-        for (int dz = 0; dz < 2; dz++) {
-            for (int dy = 0; dy < 2; dy++) {
-                for (int dx = 0; dx < 2; dx++) {
-#else
-        for (int dz = -1; dz < 2; dz++) {
-            for (int dy = -1; dy < 2; dy++) {
-                for (int dx = -1; dx < 2; dx++) {
-#endif
-                    int key = hash(coor[0] + dx, coor[1] + dy, coor[2] + dz);
-                    for (int pid: table[key]) {
-                        //auto dist = refpos[pid] - pos;
-                        //auto dis2 = zeno::dot(dist, dist);
-                        //if (dis2 <= radius_sqr && dis2 > radius_sqr_min) {
-                            f(pid);
-                        //}
-                    }
-                }
-            }
-        }
+        dbg_printf("grid res: %dx%dx%d, %zd cells (%s)\n", grid.gridRes[0], grid.gridRes[1],
+            grid.gridRes[2], grid.numCells(), grid.sparse ? "sparse" : "dense");
     }
 };
 
@@ -146,28 +60,43 @@ static void vectors_wrangle
     , std::vector<zeno::vec3f> const &pos
     , HashGrid *hashgrid
     ) {
-    if (chs.size() == 0)
-        return;
+    // any permutation will do; when querying the particles the grid was built from,
+    // its own order visits them cell by cell, so consecutive ones share neighbors in cache
+    auto const &order = hashgrid->grid.order;
+    bool sorted = order.size() == pos.size();
 
-    #pragma omp parallel for
-    for (int i = 0; i < pos.size(); i++) {
-        auto ctx = exec->make_context();
-        for (int k = 0; k < chs.size(); k++) {
-            if (!chs[k].which)
-                ctx.channel(k)[0] = chs[k].base[chs[k].stride * i];
-        }
-        hashgrid->iter_neighbors(pos[i], [&] (int pid) {
-            for (int k = 0; k < chs.size(); k++) {
-                if (chs[k].which)
-                    ctx.channel(k)[0] = chs2[k].base[chs2[k].stride * pid];
-            }
-            ctx.execute();
-        });
-        for (int k = 0; k < chs.size(); k++) {
-            if (!chs[k].which)
-                chs[k].base[chs[k].stride * i] = ctx.channel(k)[0];
+    // read the neighbor channels from copies in the grid's order, so that each cell
+    // is one contiguous run in every channel (this also means @@ channels are read
+    // as they were before the wrangle, even when prim and primNei are the same)
+    bool slots = std::all_of(chs2.begin(), chs2.end(), [&] (Buffer const &b) {
+        return !b.which || b.count == order.size();
+    });
+    std::vector<std::vector<float>> copies(chs2.size());
+    std::vector<Buffer> chs3 = chs2;
+    if (slots) {
+        for (int k = 0; k < chs2.size(); k++) {
+            if (!chs2[k].which)
+                continue;
+            copies[k].resize(order.size());
+            #pragma omp parallel for
+            for (int j = 0; j < order.size(); j++)
+                copies[k][j] = chs2[k].base[chs2[k].stride * order[j]];
+            chs3[k].base = copies[k].data();
+            chs3[k].stride = 1;
         }
     }
+
+    zeno::neighbor_lanes_wrangle(exec, chs, chs3, pos.size(),
+        [&] (size_t k, std::vector<int> &neighbors) {
+            int i = sorted ? order[k] : k;
+            hashgrid->grid.iter_cells(pos[i], [&] (int begin, int end) {
+                for (int j = begin; j < end; j++)
+                    neighbors.push_back(slots ? j : order[j]);
+            });
+            return i;
+        }, [] (int i) {
+            return true;
+        });
 }
 
 struct ParticlesBuildHashGrid : zeno::INode {
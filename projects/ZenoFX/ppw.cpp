@@ -16,7 +16,7 @@ namespace zeno {
 namespace {
 
 static zfx::Compiler compiler;
-static zfx::x64::Assembler assembler;
+static zfx::x64::Assembler assembler(zfx::x64::Executable::MinSimdWidth);
 
 struct Buffer {
     float *base = nullptr;
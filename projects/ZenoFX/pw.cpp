@@ -9,6 +9,7 @@
 #include <zfx/x64.h>
 #include <cassert>
 #include "dbg_printf.h"
+#include "NeighborWrangle.h"
 
 namespace zeno {
     std::string preApplyRefs(const std::string& code, Graph* pGraph);
@@ -35,8 +36,11 @@ static void vectors_wrangle
         size = std::min(chs[i].count, size);
     }
 
+    if (batch_wrangle(exec, chs, size))
+        return;
+
     #pragma omp parallel for
-    for (int i = 0; i < size - exec->SimdWidth + 1; i += exec->SimdWidth) {
+    for (int i = 0; i < size / exec->SimdWidth * exec->SimdWidth; i += exec->SimdWidth) {
         auto ctx = exec->make_context();
         for (int j = 0; j < chs.size(); j++) {
             for (int k = 0; k < exec->SimdWidth; k++)
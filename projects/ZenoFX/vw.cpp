@@ -21,7 +21,7 @@ namespace zeno {
 namespace {
 
 static zfx::Compiler compiler;
-static zfx::x64::Assembler assembler;
+static zfx::x64::Assembler assembler(zfx::x64::Executable::MinSimdWidth);
 
 template <class GridPtr>
 void vdb_wrangle(zfx::x64::Executable *exec, GridPtr &grid, bool modifyActive, bool changeBackground, bool hasPos) {
@@ -231,9 +231,11 @@ struct VDBWrangle : zeno::INode {
         auto changeBackground = has_input("ChangeBackground") ?
             (get_input<zeno::StringObject>("ChangeBackground")->get())=="true" : false;
         if (auto p = std::dynamic_pointer_cast<zeno::VDBFloatGrid>(grid); p)
-            vdb_wrangle(exec, p->m_grid, modifyActive, changeBackground, hasPos);
-        else if (auto p = std::dynamic_pointer_cast<zeno::VDBFloat3Grid>(grid); p)
-            vdb_wrangle(exec, p->m_grid, modifyActive, changeBackground, hasPos);
+            vdb_wrangle(exec, p->grid(), modifyActive, changeBackground, hasPos);
+        else if (auto p = std::dynamic_pointer_cast<zeno::VDBFloat3Grid>(grid); p) {
+            vdb_wrangle(exec, p->grid(), modifyActive, changeBackground, hasPos);
+            p->markGridModified();
+        }
 
         set_output("grid", std::move(grid));
     }
@@ -68,13 +68,14 @@ struct  ResampleVDBGrid : zeno::INode {
         {
           auto target = get_input("resampleTo")->as<VDBFloatGrid>();
           auto source = get_input("resampleFrom")->as<VDBFloatGrid>();
-          resampleVDB<openvdb::FloatGrid>(source->m_grid, target->m_grid);
+          resampleVDB<openvdb::FloatGrid>(source->grid(), target->grid());
         }
         else if (sourceType==std::string("Vec3fGrid"))
         {
           auto target = get_input("resampleTo")->as<VDBFloat3Grid>();
           auto source = get_input("resampleFrom")->as<VDBFloat3Grid>();
-          resampleVDB<openvdb::Vec3fGrid>(source->m_grid, target->m_grid);
+          resampleVDB<openvdb::Vec3fGrid>(source->grid(), target->grid());
+          target->markGridModified();
         }
         set_output("resampleTo", get_input("resampleTo"));
     } else {
@@ -108,23 +109,23 @@ struct CombineVDB : zeno::INode{
         auto target = get_input("FieldA")->as<VDBFloatGrid>();
         auto source = get_input("FieldB")->as<VDBFloatGrid>();
         if (get_param<bool>("writeBack")) {
-            auto srcgrid = source->m_grid->deepCopy();
+            auto srcgrid = source->grid()->deepCopy();
             if(OpType=="CSGUnion") {
-              openvdb::tools::csgUnion(*(target->m_grid), *(srcgrid));
+              openvdb::tools::csgUnion(*(target->grid()), *(srcgrid));
             } else if(OpType=="CSGIntersection") {
-              openvdb::tools::csgIntersection(*(target->m_grid), *(srcgrid));
+              openvdb::tools::csgIntersection(*(target->grid()), *(srcgrid));
             } else if(OpType=="CSGDifference") {
-              openvdb::tools::csgDifference(*(target->m_grid), *(srcgrid));
+              openvdb::tools::csgDifference(*(target->grid()), *(srcgrid));
             }
             set_output("FieldOut", get_input("FieldA"));
         } else {
             auto result = std::make_shared<VDBFloatGrid>();
             if(OpType=="CSGUnion") {
-              result->m_grid = openvdb::tools::csgUnionCopy(*(target->m_grid), *(source->m_grid));
+              result->m_grid = openvdb::tools::csgUnionCopy(*(target->grid()), *(source->grid()));
             } else if(OpType=="CSGIntersection") {
-              result->m_grid = openvdb::tools::csgIntersectionCopy(*(target->m_grid), *(source->m_grid));
+              result->m_grid = openvdb::tools::csgIntersectionCopy(*(target->grid()), *(source->grid()));
             } else if(OpType=="CSGDifference") {
-              result->m_grid = openvdb::tools::csgDifferenceCopy(*(target->m_grid), *(source->m_grid));
+              result->m_grid = openvdb::tools::csgDifferenceCopy(*(target->grid()), *(source->grid()));
             }
             set_output("FieldOut", result);
         }
@@ -135,15 +136,16 @@ struct CombineVDB : zeno::INode{
       if(targetType == sourceType && targetType==std::string("FloatGrid")){
         auto target = get_input("FieldA")->as<VDBFloatGrid>();
         auto source = get_input("FieldB")->as<VDBFloatGrid>();
-        auto srcgrid = source->m_grid->deepCopy();
-        openvdb::tools::compSum(*(target->m_grid), *(srcgrid));
+        auto srcgrid = source->grid()->deepCopy();
+        openvdb::tools::compSum(*(target->grid()), *(srcgrid));
         set_output("FieldOut", get_input("FieldA"));
       }
       if(targetType == sourceType && targetType==std::string("Vec3fGrid")){
         auto target = get_input("FieldA")->as<VDBFloat3Grid>();
         auto source = get_input("FieldB")->as<VDBFloat3Grid>();
-        auto srcgrid = source->m_grid->deepCopy();
-        openvdb::tools::compSum(*(target->m_grid), *(srcgrid));
+        auto srcgrid = source->grid()->deepCopy();
+        openvdb::tools::compSum(*(target->grid()), *(srcgrid));
+        target->markGridModified();
         set_output("FieldOut", get_input("FieldA"));
       }
     }
@@ -152,15 +154,16 @@ struct CombineVDB : zeno::INode{
       if(targetType == sourceType && targetType==std::string("FloatGrid")){
         auto target = get_input("FieldA")->as<VDBFloatGrid>();
         auto source = get_input("FieldB")->as<VDBFloatGrid>();
-        auto srcgrid = source->m_grid->deepCopy();
-        openvdb::tools::compMul(*(target->m_grid), *(srcgrid));
+        auto srcgrid = source->grid()->deepCopy();
+        openvdb::tools::compMul(*(target->grid()), *(srcgrid));
         set_output("FieldOut", get_input("FieldA"));
       }
       if(targetType == sourceType && targetType==std::string("Vec3fGrid")){
         auto target = get_input("FieldA")->as<VDBFloat3Grid>();
         auto source = get_input("FieldB")->as<VDBFloat3Grid>();
-        auto srcgrid = source->m_grid->deepCopy();
-        openvdb::tools::compMul(*(target->m_grid), *(srcgrid));
+        auto srcgrid = source->grid()->deepCopy();
+        openvdb::tools::compMul(*(target->grid()), *(srcgrid));
+        target->markGridModified();
         set_output("FieldOut", get_input("FieldA"));
       }
     }
@@ -169,15 +172,16 @@ struct CombineVDB : zeno::INode{
       if(targetType == sourceType && targetType==std::string("FloatGrid")){
         auto target = get_input("FieldA")->as<VDBFloatGrid>();
         auto source = get_input("FieldB")->as<VDBFloatGrid>();
-        auto srcgrid = source->m_grid->deepCopy();
-        openvdb::tools::compReplace(*(target->m_grid), *(srcgrid));
+        auto srcgrid = source->grid()->deepCopy();
+        openvdb::tools::compReplace(*(target->grid()), *(srcgrid));
         set_output("FieldOut", get_input("FieldA"));
       }
       if(targetType == sourceType && targetType==std::string("Vec3fGrid")){
         auto target = get_input("FieldA")->as<VDBFloat3Grid>();
         auto source = get_input("FieldB")->as<VDBFloat3Grid>();
-        auto srcgrid = source->m_grid->deepCopy();
-        openvdb::tools::compReplace(*(target->m_grid), *(srcgrid));
+        auto srcgrid = source->grid()->deepCopy();
+        openvdb::tools::compReplace(*(target->grid()), *(srcgrid));
+        target->markGridModified();
         set_output("FieldOut", get_input("FieldA"));
       }
     }
@@ -206,8 +210,8 @@ struct VDBDeactivate : zeno::INode
     auto mType = get_input("Mask")->as<VDBGrid>()->getType();
     if(gType == mType && gType==std::string("FloatGrid"))
     {
-      auto const &grid = get_input<VDBFloatGrid>("Field")->m_grid;
-      auto const &mask = get_input<VDBFloatGrid>("Mask")->m_grid;
+      auto const &grid = get_input<VDBFloatGrid>("Field")->grid();
+      auto const &mask = get_input<VDBFloatGrid>("Mask")->grid();
       auto modifier = [&](auto &leaf, openvdb::Index leafpos) {
         for (auto iter = leaf.beginValueOn(); iter != leaf.endValueOn(); ++iter) {
             auto coord = iter.getCoord();
@@ -228,8 +232,8 @@ struct VDBDeactivate : zeno::INode
     }
     if(gType == mType && gType==std::string("Vec3fGrid"))
     {
-      auto const &grid = get_input<VDBFloat3Grid>("Field")->m_grid;
-      auto const &mask = get_input<VDBFloat3Grid>("Mask")->m_grid;
+      auto const &grid = get_input<VDBFloat3Grid>("Field")->grid();
+      auto const &mask = get_input<VDBFloat3Grid>("Mask")->grid();
       auto modifier = [&](auto &leaf, openvdb::Index leafpos) {
         for (auto iter = leaf.beginValueOn(); iter != leaf.endValueOn(); ++iter) {
             auto coord = iter.getCoord();
@@ -10,7 +10,7 @@ namespace zeno {
 
 struct GetVDBPoints : zeno::INode {
   virtual void apply() override {
-    auto grid = get_input("grid")->as<VDBPointsGrid>()->m_grid;
+    auto grid = get_input("grid")->as<VDBPointsGrid>()->grid();
 
     std::vector<openvdb::points::PointDataTree::LeafNodeType*> leafs;
     grid->tree().getNodes(leafs);
@@ -63,7 +63,7 @@ static int defGetVDBPoints = zeno::defNodeClass<GetVDBPoints>("GetVDBPoints",
 #if 0
 struct GetVDBPointsLeafCount : zeno::INode {
   virtual void apply() override {
-    auto grid = get_input("grid")->as<VDBPointsGrid>()->m_grid;
+    auto grid = get_input("grid")->as<VDBPointsGrid>()->grid();
     std::vector<openvdb::points::PointDataTree::LeafNodeType*> leafs;
     grid->tree().getNodes(leafs);
     auto ret = std::make_shared<zeno::NumericObject>();
@@ -75,7 +75,7 @@ struct GetVDBPointsLeafCount : zeno::INode {
 
 struct VDBPointsToPrimitive : zeno::INode {
   virtual void apply() override {
-    auto grid = get_input("grid")->as<VDBPointsGrid>()->m_grid;
+    auto grid = get_input("grid")->as<VDBPointsGrid>()->grid();
 
     std::vector<openvdb::points::PointDataTree::LeafNodeType *> leafs;
     grid->tree().getNodes(leafs);
@@ -270,8 +270,8 @@ static int defVDBPointsToPrimitive = zeno::defNodeClass<VDBPointsToPrimitive>("V
 
 struct GetVDBPointsDroplets : zeno::INode {
   virtual void apply() override {
-    auto grid = get_input("grid")->as<VDBPointsGrid>()->m_grid;
-    auto sdf = get_input("sdf")->as<VDBFloatGrid>()->m_grid;
+    auto grid = get_input("grid")->as<VDBPointsGrid>()->grid();
+    auto sdf = get_input("sdf")->as<VDBFloatGrid>()->grid();
     auto dx = sdf->voxelSize()[0];
     std::vector<openvdb::points::PointDataTree::LeafNodeType*> leafs;
     grid->tree().getNodes(leafs);
@@ -25,34 +25,34 @@ struct MakeVDBGrid : zeno::INode {
       auto transform = openvdb::math::Transform::createLinearTransform(dx);
       if(structure==std::string("vertex"))
         transform->postTranslate(openvdb::Vec3d{ -0.5,-0.5,-0.5 }*double(dx));
-      tmp->m_grid->setTransform(transform);
-      tmp->m_grid->setName(name);
+      tmp->grid()->setTransform(transform);
+      tmp->grid()->setName(name);
       data = std::move(tmp);
     } else if (type == "float3") {
       auto tmp = !has_input("background") ? zeno::IObject::make<VDBFloat3Grid>()
           : std::make_shared<VDBFloat3Grid>(openvdb::Vec3fGrid::create(
                   zeno::vec_to_other<openvdb::Vec3f>(get_input("background")
                                                      ->as<NumericObject>()->get<vec3f>())));
-      tmp->m_grid->setTransform(openvdb::math::Transform::createLinearTransform(dx));
-      tmp->m_grid->setName(name);
+      tmp->grid()->setTransform(openvdb::math::Transform::createLinearTransform(dx));
+      tmp->grid()->setName(name);
       if (structure == "Staggered") {
-        tmp->m_grid->setGridClass(openvdb::GridClass::GRID_STAGGERED);
+        tmp->grid()->setGridClass(openvdb::GridClass::GRID_STAGGERED);
       }
       data = std::move(tmp);
     } else if (type == "int") {
       auto tmp = zeno::IObject::make<VDBIntGrid>();
-      tmp->m_grid->setTransform(openvdb::math::Transform::createLinearTransform(dx));
-      tmp->m_grid->setName(name);
+      tmp->grid()->setTransform(openvdb::math::Transform::createLinearTransform(dx));
+      tmp->grid()->setName(name);
       data = std::move(tmp);
     } else if (type == "int3") {
       auto tmp = zeno::IObject::make<VDBInt3Grid>();
-      tmp->m_grid->setTransform(openvdb::math::Transform::createLinearTransform(dx));
-      tmp->m_grid->setName(name);
+      tmp->grid()->setTransform(openvdb::math::Transform::createLinearTransform(dx));
+      tmp->grid()->setName(name);
       data = std::move(tmp);
     } else if (type == "points") {
       auto tmp = zeno::IObject::make<VDBPointsGrid>();
-      tmp->m_grid->setTransform(openvdb::math::Transform::createLinearTransform(dx));
-      tmp->m_grid->setName(name);
+      tmp->grid()->setTransform(openvdb::math::Transform::createLinearTransform(dx));
+      tmp->grid()->setName(name);
       data = std::move(tmp);
     } else {
       printf("%s\n", type.c_str());
@@ -47,7 +47,7 @@ struct MeshToSDF : zeno::INode{
         vdbtransform->postTranslate(openvdb::Vec3d{ -0.5,-0.5,-0.5 }*double(h));
     }
     result->m_grid = openvdb::tools::meshToSignedDistanceField<openvdb::FloatGrid>(*vdbtransform,points, triangles, quads, 4, 4);
-    openvdb::tools::signedFloodFill(result->m_grid->tree());
+    openvdb::tools::signedFloodFill(result->grid()->tree());
     set_output("sdf", result);
   }
 };
@@ -108,7 +108,7 @@ struct PrimitiveToSDF : zeno::INode{
         vdbtransform->postTranslate(openvdb::Vec3d{ -0.5,-0.5,-0.5 }*double(h));
     }
     result->m_grid = openvdb::tools::meshToSignedDistanceField<openvdb::FloatGrid>(*vdbtransform,points, triangles, quads, 4, 4);
-    openvdb::tools::signedFloodFill(result->m_grid->tree());
+    openvdb::tools::signedFloodFill(result->grid()->tree());
     set_output("sdf", result);
   }
 };
@@ -130,10 +130,10 @@ struct SDFToFog : INode
     virtual void apply() override {
         auto sdf = get_input<VDBFloatGrid>("SDF");
         if (!has_input("inplace") || !get_input2<bool>("inplace")) {
-            sdf = std::make_shared<VDBFloatGrid>(sdf->m_grid->deepCopy());
+            sdf = std::make_shared<VDBFloatGrid>(sdf->grid()->deepCopy());
         }
-        //auto dx = sdf->m_grid->voxelSize()[0];
-        openvdb::tools::sdfToFogVolume(*(sdf->m_grid));
+        //auto dx = sdf->grid()->voxelSize()[0];
+        openvdb::tools::sdfToFogVolume(*(sdf->grid()));
         set_output("oSDF", std::move(sdf));
     }
 };
@@ -1,4 +1,6 @@
 #include <zeno/zeno.h>
+#include <zeno/extra/GlobalState.h>
+#include <zeno/extra/FramePrefetcher.h>
 #include <zeno/StringObject.h>
 #include <zeno/NumericObject.h>
 #include <zeno/ZenoInc.h>
@@ -7,6 +9,9 @@
 #include <zeno/types/NumericObject.h>
 #include <filesystem>
 #include <zeno/utils/type_traits.h>
+#include <zeno/utils/string.h>
+#include <zeno/utils/format.h>
+#include <algorithm>
 
 //#include "../../Library/MnBase/Meta/Polymorphism.h"
 // openvdb::io::File(filename).write({grid});
@@ -14,7 +19,8 @@
 namespace zeno {
 namespace {
 
-static std::shared_ptr<VDBGrid> readGenericVDBGrid(const std::string &fn) {
+// the first grid of a type zeno wraps that opts asks for
+static std::shared_ptr<VDBGrid> readGenericVDBGrid(const std::string &fn, VDBReadOptions const &opts = {}) {
   using GridTypes = std::tuple
     < openvdb::points::PointDataGrid
     , openvdb::FloatGrid
@@ -23,25 +29,29 @@ static std::shared_ptr<VDBGrid> readGenericVDBGrid(const std::string &fn) {
     , openvdb::Vec3IGrid
     >;
   openvdb::io::File file(fn);
-  file.open();
-  openvdb::GridPtrVecPtr my_grids = file.getGrids();
-  file.close();
+  file.open(opts.delayLoad);
+  // only the metadata to find the grid, the trees of the others aren't read
+  openvdb::GridPtrVecPtr metas = file.readAllGridMetadata();
   std::shared_ptr<VDBGrid> grid;
-  for (openvdb::GridPtrVec::iterator iter = my_grids->begin();
-       iter != my_grids->end(); ++iter) {
-    openvdb::GridBase::Ptr it = *iter;
-    if (zeno::static_for<0, std::tuple_size_v<GridTypes>>([&] (auto i) {
-        using GridT = std::tuple_element_t<i, GridTypes>;
-        if ((*iter)->isType<GridT>()) {
-          
+  for (std::size_t i = 0; i < metas->size(); i++) {
+    auto const &meta = (*metas)[i];
+    if (!opts.wants(meta->getName()))
+      continue;
+    if (zeno::static_for<0, std::tuple_size_v<GridTypes>>([&] (auto t) {
+        using GridT = std::tuple_element_t<t, GridTypes>;
+        if (meta->isType<GridT>()) {
           auto pGrid = std::make_shared<VDBGridWrapper<GridT>>();
-          pGrid->m_grid = openvdb::gridPtrCast<GridT>(*iter);
+          pGrid->m_grid = openvdb::gridPtrCast<GridT>(readVDBGrid(file, *metas, i, opts));
           grid = pGrid;
           return true;
         }
         return false;
-      })) return grid;
+      })) {
+      file.close();
+      return grid;
+    }
   }
+  file.close();
   throw zeno::Exception("failed to readGenericVDBGrid: " + fn);
 }
 
@@ -49,6 +59,10 @@ static std::shared_ptr<VDBGrid> readGenericVDBGrid(const std::string &fn) {
 struct CacheVDBGrid : zeno::INode {
     int m_framecounter = 0;
 
+    virtual bool requiresAllInputs() const override {
+        return false;
+    }
+
     virtual void preApply() override {
         if (get_param<bool>("mute")) {
             requireInput("inGrid");
@@ -100,11 +114,11 @@ ZENDEFNODE(CacheVDBGrid,
     "deprecated",
     }});
 
-static std::shared_ptr<VDBGrid> readvdb(std::string path, std::string type)
+static std::shared_ptr<VDBGrid> readvdb(std::string path, std::string type, VDBReadOptions const &opts = {})
 {
     if (type == "") {
       std::cout << "vdb read generic data" << std::endl;
-      return readGenericVDBGrid(path);
+      return readGenericVDBGrid(path, opts);
     }
     std::shared_ptr<VDBGrid> data;
     if (type == "float") {
@@ -125,16 +139,34 @@ static std::shared_ptr<VDBGrid> readvdb(std::string path, std::string type)
       printf("%s\n", type.c_str());
       assert(0 && "bad VDBGrid type");
     }
-    data->input(path);
+    data->input(path, opts);
     return data;
 }
 
+// the grids of the next frames are read in the background when path is a sequence
+static std::shared_ptr<VDBGrid> readSequence(std::string const &node, std::string const &path, std::string const &type,
+                                             int frameid, VDBReadOptions const &opts = {}) {
+    auto reader = "readvdb:" + node + ":" + type + ":" + zeno::join_str(opts.names, ",");
+    if (opts.clip)
+      reader += zeno::format(":{},{},{}:{},{},{}", opts.clip->min()[0], opts.clip->min()[1], opts.clip->min()[2],
+                             opts.clip->max()[0], opts.clip->max()[1], opts.clip->max()[2]);
+    auto obj = zeno::FramePrefetcher::instance().readSequence(reader, path, frameid,
+        [type, opts] (std::string const &path) -> std::shared_ptr<zeno::IObject> {
+      return readvdb(path, type, opts);
+    });
+    return std::static_pointer_cast<VDBGrid>(obj);
+}
 
+// each read opens its own io::File, the prefetcher reads them on other threads too
 struct ReadVDBGrid : zeno::INode {
+  virtual bool canApplyInParallel() const override {
+    return true;
+  }
+
   virtual void apply() override {
     auto path = get_param<std::string>(("path"));
     auto type = get_param<std::string>(("type"));
-    auto data = readvdb(path, type);
+    auto data = readSequence(myname, path, type, getGlobalState()->frameid);
     set_output("data", data);
   }
 };
@@ -154,10 +186,28 @@ static int defReadVDBGrid = zeno::defNodeClass<ReadVDBGrid>(
                     }});
 
 struct ImportVDBGrid : zeno::INode {
+  virtual bool canApplyInParallel() const override {
+    return true;
+  }
+
   virtual void apply() override {
     auto path = get_input("path")->as<zeno::StringObject>()->get();
     // auto type = get_param<std::string>(("type"));
-    auto data = readvdb(path, "");
+    VDBReadOptions opts;
+    if (has_input("gridNames")) {
+      // space or comma separated
+      auto names = get_input2<std::string>("gridNames");
+      std::replace(names.begin(), names.end(), ',', ' ');
+      for (auto const &name: zeno::split_str(names, ' '))
+        if (!name.empty())
+          opts.names.push_back(name);
+    }
+    if (has_input("clip") && get_input2<bool>("clip")) {
+      auto bmin = get_input2<zeno::vec3f>("clipMin");
+      auto bmax = get_input2<zeno::vec3f>("clipMax");
+      opts.clip = openvdb::BBoxd(openvdb::Vec3d(bmin[0], bmin[1], bmin[2]), openvdb::Vec3d(bmax[0], bmax[1], bmax[2]));
+    }
+    auto data = readSequence(myname, path, "", getGlobalState()->frameid, opts);
     set_output("data", std::move(data));
   }
 };
@@ -178,6 +228,10 @@ struct ReadVDB : ImportVDBGrid {
 static int defReadVDB = zeno::defNodeClass<ReadVDB>("ReadVDB",
     { /* inputs: */ {
     {"readpath", "path"},
+    {"string", "gridNames", ""},
+    {"bool", "clip", "0"},
+    {"vec3f", "clipMin", "-1,-1,-1"},
+    {"vec3f", "clipMax", "1,1,1"},
     }, /* outputs: */ {
     "data",
     }, /* params: */ {
@@ -50,7 +50,7 @@ void sampleVDBAttribute(std::vector<vec3f> const &pos, std::vector<T> &arr,
     zeno::log_error("ERROR: vdb attribute type mismatch!");
     throw std::runtime_error("ERROR: vdb attribute type mismatch!");
   }
-  auto grid = ptr->m_grid;
+  auto grid = ptr->grid();
 
 #pragma omp parallel for
   for (int i = 0; i < pos.size(); i++) {
@@ -79,7 +79,7 @@ void sampleVDBAttribute2(
         zeno::log_error("ERROR: vdb attribute type mismatch!");
         throw std::runtime_error("ERROR: vdb attribute type mismatch!");
     }
-    auto grid = ptr->m_grid;
+    auto grid = ptr->grid();
 
     #pragma omp parallel for
     for (int i = 0; i < pos.size(); i++) {
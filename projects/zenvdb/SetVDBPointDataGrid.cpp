@@ -100,7 +100,7 @@ struct PrimToVDBPointDataGrid : zeno::INode {
     {
         auto input = get_input("vdbPoints"); 
         auto data = input->as<VDBPointsGrid>();
-        dx = data->m_grid->transformPtr()->voxelSize()[0];
+        dx = data->grid()->transformPtr()->voxelSize()[0];
         data->m_grid = particleArrayToGrid(positions, velocitys, dx);
         set_output("Particles", std::move(input));
     }
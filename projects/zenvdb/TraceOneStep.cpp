@@ -35,7 +35,7 @@ struct TraceOneStep : INode {
         
         auto p1 = vec_to_other<openvdb::Vec3R>(p0);
         auto p2 = vecField->worldToIndex(p1);
-        auto vel = openvdb::tools::BoxSampler::sample(vecField->m_grid->tree(), p2);
+        auto vel = openvdb::tools::BoxSampler::sample(vecField->grid()->tree(), p2);
         velarr[i-size] = other_to_vec<3>(vel);
         auto pend = p0;
         if(lengtharr[i-size]<maxlength && maxlength>0)
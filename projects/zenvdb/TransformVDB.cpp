@@ -28,19 +28,20 @@ struct TransformVDB : INode {
 
         auto type = vdb->getType();
         if (type == "FloatGrid") {
-            auto &grid = std::dynamic_pointer_cast<VDBFloatGrid>(vdb)->m_grid;
+            auto &grid = std::dynamic_pointer_cast<VDBFloatGrid>(vdb)->grid();
             vdb_transform(grid, tran, euler, sca);
         } else if (type == "Int32Grid") {
-            auto &grid = std::dynamic_pointer_cast<VDBIntGrid>(vdb)->m_grid;
+            auto &grid = std::dynamic_pointer_cast<VDBIntGrid>(vdb)->grid();
             vdb_transform(grid, tran, euler, sca);
         } else if (type == "Vec3fGrid") {
-            auto &grid = std::dynamic_pointer_cast<VDBFloat3Grid>(vdb)->m_grid;
-            vdb_transform(grid, tran, euler, sca);
+            auto p = std::dynamic_pointer_cast<VDBFloat3Grid>(vdb);
+            vdb_transform(p->grid(), tran, euler, sca);
+            p->markGridModified();
         } else if (type == "Vec3IGrid") {
-            auto &grid = std::dynamic_pointer_cast<VDBInt3Grid>(vdb)->m_grid;
+            auto &grid = std::dynamic_pointer_cast<VDBInt3Grid>(vdb)->grid();
             vdb_transform(grid, tran, euler, sca);
         } else if (type == "PointDataGrid") {
-            auto &grid = std::dynamic_pointer_cast<VDBPointsGrid>(vdb)->m_grid;
+            auto &grid = std::dynamic_pointer_cast<VDBPointsGrid>(vdb)->grid();
             vdb_transform(grid, tran, euler, sca);
         } else {
             throw zeno::Exception("Bad VDB type.");
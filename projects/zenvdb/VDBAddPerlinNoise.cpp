@@ -38,7 +38,7 @@ struct VDBPerlinNoise : INode {
         auto average = get_input2<float>("average");
         auto strength = get_input2<float>("strength");
 
-    auto grid = inoutSDF->m_grid;
+    auto grid = inoutSDF->grid();
     float dx = grid->voxelSize()[0];
     strength *= dx;
     scale3d *= scale * dx;
@@ -120,7 +120,7 @@ struct VDBAddPerlinNoise : INode {
         : vec3f(0);
     auto inv_scale = 1.f / (scale * scaling);
 
-    auto grid = inoutSDF->m_grid;
+    auto grid = inoutSDF->grid();
     float dx = grid->voxelSize()[0];
     strength *= dx;
 
@@ -257,7 +257,7 @@ struct VDBAddTurbulentNoise : INode {
         : vec3f(0);
     auto inv_scale = 1.f / (scale * scaling);
 
-    auto grid = inoutSDF->m_grid;
+    auto grid = inoutSDF->grid();
     float dx = grid->voxelSize()[0];
     strength *= dx;
 
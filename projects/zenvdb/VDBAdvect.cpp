@@ -12,8 +12,8 @@ struct SDFAdvect : zeno::INode {
     virtual void apply() override {
         auto inSDF = get_input("InoutSDF")->as<VDBFloatGrid>();
         auto vecField = get_input("VecField")->as<VDBFloat3Grid>();
-        auto grid = inSDF->m_grid;
-        auto field = vecField->m_grid;
+        auto grid = inSDF->grid();
+        auto field = vecField->grid();
         auto timeStep = get_input<NumericObject>("TimeStep")->get<float>();
         auto velField = openvdb::tools::DiscreteField<openvdb::Vec3SGrid>(*field);
         auto advection = openvdb::tools::LevelSetAdvection<openvdb::FloatGrid, decltype(velField)>(*grid, velField);
@@ -117,8 +117,8 @@ struct VolumeAdvect : zeno::INode {
         //
         //auto inSDF = get_input("InoutField")->as<VDBFloatGrid>();
         auto vecField = get_input("VecField")->as<VDBFloat3Grid>();
-        //auto grid = inSDF->m_grid;
-        auto field = vecField->m_grid;
+        //auto grid = inSDF->grid();
+        auto field = vecField->grid();
         auto timeStep = get_input<NumericObject>("TimeStep")->get<float>();
         //auto velField = openvdb::tools::DiscreteField<openvdb::Vec3SGrid>(*field);
         using VolumeAdvection =
@@ -168,7 +168,7 @@ struct VolumeAdvect : zeno::INode {
         {
             
             auto f = get_input("InField")->as<VDBFloatGrid>();
-            auto f2 = f->m_grid->deepCopy();
+            auto f2 = f->grid()->deepCopy();
             //auto result = std::make_shared<VDBFloatGrid>();
             auto res = advection.template advect<openvdb::FloatGrid,
                     openvdb::tools::Sampler<1, false>>(*f2, timeStep);
@@ -178,10 +178,11 @@ struct VolumeAdvect : zeno::INode {
         else if(get_input("InField")->as<VDBGrid>()->getType()=="Vec3fGrid")
         {
             auto f = get_input("InField")->as<VDBFloat3Grid>();
-            auto f2 = f->m_grid->deepCopy();
+            auto f2 = f->grid()->deepCopy();
             auto res = advection.template advect<openvdb::Vec3fGrid,
                     openvdb::tools::Sampler<1, true>>(*f2, timeStep);
             f->m_grid = res->deepCopy();
+            f->markGridModified();
             //set_output("outField", get_input("InField"));
         }
         //advection.advect(0.0, timeStep);
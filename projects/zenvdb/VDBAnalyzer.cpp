@@ -12,7 +12,7 @@ namespace zeno {
 struct ScalarFieldAnalyzer : zeno::INode {
     virtual void apply() override {
         auto inSDF = get_input("InVDB")->as<VDBFloatGrid>();
-        auto grid = inSDF->m_grid;
+        auto grid = inSDF->grid();
         auto OpType = get_param<std::string>(("Operator"));
         if (OpType == "Gradient") {
             auto result = std::make_shared<VDBFloat3Grid>(openvdb::tools::gradient(*grid));
@@ -66,7 +66,7 @@ ZENO_DEFNODE(ScalarFieldAnalyzer)(
 struct VectorFieldAnalyzer : zeno::INode {
     virtual void apply() override {
         auto inSDF = get_input("InVDB")->as<VDBFloat3Grid>();
-        auto grid = inSDF->m_grid;
+        auto grid = inSDF->grid();
         auto OpType = get_param<std::string>(("Operator"));
         if (OpType == "Divergence") {
             auto result = std::make_shared<VDBFloatGrid>(openvdb::tools::divergence(*grid));
@@ -118,7 +118,7 @@ struct VDBExplosiveTurbulentNoise : INode {
         : vec3f(0);
     auto inv_scale = 1.f / (scale * scaling);
 
-    auto grid = inoutSDF->m_grid;
+    auto grid = inoutSDF->grid();
     float dx = grid->voxelSize()[0];
     strength *= dx;
 
@@ -31,12 +31,13 @@ struct VDBFillActiveVoxels : INode {
     auto value = get_input<NumericObject>("fillValue")->value;
     if (auto p = std::dynamic_pointer_cast<VDBFloatGrid>(grid); p) {
         auto velman = openvdb::tree::LeafManager
-            <std::decay_t<decltype(p->m_grid->tree())>>(p->m_grid->tree());
+            <std::decay_t<decltype(p->grid()->tree())>>(p->grid()->tree());
         velman.foreach(fill_voxels_op(std::get<float>(value)));
     } else if (auto p = std::dynamic_pointer_cast<VDBFloat3Grid>(grid); p) {
         auto velman = openvdb::tree::LeafManager
-            <std::decay_t<decltype(p->m_grid->tree())>>(p->m_grid->tree());
+            <std::decay_t<decltype(p->grid()->tree())>>(p->grid()->tree());
         velman.foreach(fill_voxels_op(vec_to_other<openvdb::Vec3f>(std::get<vec3f>(value))));
+        p->markGridModified();
     }
 
     set_output("grid", get_input("grid"));
@@ -74,11 +75,11 @@ struct VDBMultiplyOperation : INode {
     auto value = get_input<NumericObject>("fillValue")->value;
     if (auto p = std::dynamic_pointer_cast<VDBFloatGrid>(grid); p) {
         auto velman = openvdb::tree::LeafManager
-            <std::decay_t<decltype(p->m_grid->tree())>>(p->m_grid->tree());
+            <std::decay_t<decltype(p->grid()->tree())>>(p->grid()->tree());
         velman.foreach(fill_voxels_op(std::get<float>(value)));
     } else if (auto p = std::dynamic_pointer_cast<VDBFloat3Grid>(grid); p) {
         auto velman = openvdb::tree::LeafManager
-            <std::decay_t<decltype(p->m_grid->tree())>>(p->m_grid->tree());
+            <std::decay_t<decltype(p->grid()->tree())>>(p->grid()->tree());
         velman.foreach(fill_voxels_op(vec_to_other<openvdb::Vec3f>(std::get<vec3f>(value))));
     }
 
@@ -127,9 +128,10 @@ struct VDBTouchAABBRegion : INode {
     auto bmin = get_input<NumericObject>("bmin")->get<vec3f>();
     auto bmax = get_input<NumericObject>("bmax")->get<vec3f>();
     if (auto p = std::dynamic_pointer_cast<VDBFloatGrid>(grid); p) {
-        touch_aabb_region(p->m_grid, bmin, bmax);
+        touch_aabb_region(p->grid(), bmin, bmax);
     } else if (auto p = std::dynamic_pointer_cast<VDBFloat3Grid>(grid); p) {
-        touch_aabb_region(p->m_grid, bmin, bmax);
+        touch_aabb_region(p->grid(), bmin, bmax);
+        p->markGridModified();
     }
 
     set_output("grid", get_input("grid"));
@@ -156,33 +158,34 @@ struct VDBTopoCopy : INode{
     if (auto p = std::dynamic_pointer_cast<VDBFloatGrid>(grid); p) {
         if(auto t = std::dynamic_pointer_cast<VDBFloatGrid>(topo); t)
         {
-            p->m_grid->setTree(std::make_shared<openvdb::FloatTree>(t->m_grid->tree(),0, openvdb::TopologyCopy()));
+            p->grid()->setTree(std::make_shared<openvdb::FloatTree>(t->grid()->tree(),0, openvdb::TopologyCopy()));
             openvdb::tools::dilateActiveValues(
-            p->m_grid->tree(), 1,
+            p->grid()->tree(), 1,
             openvdb::tools::NearestNeighbors::NN_FACE_EDGE_VERTEX, openvdb::tools::TilePolicy::EXPAND_TILES);
         }
         else if (auto t = std::dynamic_pointer_cast<VDBFloat3Grid>(topo); t)
         {
-            p->m_grid->setTree(std::make_shared<openvdb::FloatTree>(t->m_grid->tree(),0, openvdb::TopologyCopy()));
+            p->grid()->setTree(std::make_shared<openvdb::FloatTree>(t->grid()->tree(),0, openvdb::TopologyCopy()));
             openvdb::tools::dilateActiveValues(
-            p->m_grid->tree(), 1,
+            p->grid()->tree(), 1,
             openvdb::tools::NearestNeighbors::NN_FACE_EDGE_VERTEX, openvdb::tools::TilePolicy::EXPAND_TILES);
         }
     } else if (auto p = std::dynamic_pointer_cast<VDBFloat3Grid>(grid); p) {
         if(auto t = std::dynamic_pointer_cast<VDBFloatGrid>(topo); t)
         {
-            p->m_grid->setTree(std::make_shared<openvdb::Vec3fTree>(t->m_grid->tree(), openvdb::Vec3f{0}, openvdb::TopologyCopy()));
+            p->grid()->setTree(std::make_shared<openvdb::Vec3fTree>(t->grid()->tree(), openvdb::Vec3f{0}, openvdb::TopologyCopy()));
             openvdb::tools::dilateActiveValues(
-            p->m_grid->tree(), 1,
+            p->grid()->tree(), 1,
             openvdb::tools::NearestNeighbors::NN_FACE_EDGE_VERTEX, openvdb::tools::TilePolicy::EXPAND_TILES);
         }
         else if (auto t = std::dynamic_pointer_cast<VDBFloat3Grid>(topo); t)
         {
-            p->m_grid->setTree(std::make_shared<openvdb::Vec3fTree>(t->m_grid->tree(), openvdb::Vec3f{0}, openvdb::TopologyCopy()));
+            p->grid()->setTree(std::make_shared<openvdb::Vec3fTree>(t->grid()->tree(), openvdb::Vec3f{0}, openvdb::TopologyCopy()));
             openvdb::tools::dilateActiveValues(
-            p->m_grid->tree(), 1,
+            p->grid()->tree(), 1,
             openvdb::tools::NearestNeighbors::NN_FACE_EDGE_VERTEX, openvdb::tools::TilePolicy::EXPAND_TILES);
         }
+        p->markGridModified();
     }
 
 
@@ -13,9 +13,10 @@ struct VDBChangeBackground : INode{
   virtual void apply() override {
     auto grid = get_input<VDBGrid>("grid");
     if (auto p = std::dynamic_pointer_cast<VDBFloatGrid>(grid); p) {
-        openvdb::tools::changeBackground(p->m_grid->tree(), get_input2<float>("background"));
+        openvdb::tools::changeBackground(p->grid()->tree(), get_input2<float>("background"));
     } else if (auto p = std::dynamic_pointer_cast<VDBFloat3Grid>(grid); p) {
-        openvdb::tools::changeBackground(p->m_grid->tree(), vec_to_other<openvdb::Vec3f>(get_input2<vec3f>("background")));
+        openvdb::tools::changeBackground(p->grid()->tree(), vec_to_other<openvdb::Vec3f>(get_input2<vec3f>("background")));
+        p->markGridModified();
     }
 
     set_output("grid", get_input("grid"));
@@ -35,9 +36,9 @@ struct VDBGetBackground : INode{
   virtual void apply() override {
     auto grid = get_input<VDBGrid>("grid");
     if (auto p = std::dynamic_pointer_cast<VDBFloatGrid>(grid); p) {
-        set_output2("background", p->m_grid->background());
+        set_output2("background", p->grid()->background());
     } else if (auto p = std::dynamic_pointer_cast<VDBFloat3Grid>(grid); p) {
-        set_output2("background", other_to_vec<3>(p->m_grid->background()));
+        set_output2("background", other_to_vec<3>(p->grid()->background()));
     }
 
     set_output("grid", get_input("grid"));
@@ -72,9 +73,10 @@ struct VDBInvertSDF : INode{
     };
 
     if (auto p = std::dynamic_pointer_cast<VDBFloatGrid>(grid)) {
-        visitor(p->m_grid);
+        visitor(p->grid());
     } else if (auto p = std::dynamic_pointer_cast<VDBFloat3Grid>(grid)) {
-        visitor(p->m_grid);
+        visitor(p->grid());
+        p->markGridModified();
     }
 
     set_output("grid", get_input("grid"));
@@ -99,9 +101,10 @@ struct VDBPruneFootprint : INode{
     };
 
     if (auto p = std::dynamic_pointer_cast<VDBFloatGrid>(grid)) {
-        visitor(p->m_grid);
+        visitor(p->grid());
     } else if (auto p = std::dynamic_pointer_cast<VDBFloat3Grid>(grid)) {
-        visitor(p->m_grid);
+        visitor(p->grid());
+        p->markGridModified();
     }
 
     set_output("grid", get_input("grid"));
@@ -27,17 +27,17 @@ struct VDBPointScatter : INode{
     if (seed == -1) seed = std::random_device{}();
 
     if (!istotal && isuniform) {
-        count *= grid->m_grid->tree().activeVoxelCount();
+        count *= grid->grid()->tree().activeVoxelCount();
     }
     if (istotal && !isuniform) {
-        auto avc = grid->m_grid->tree().activeVoxelCount();
+        auto avc = grid->grid()->tree().activeVoxelCount();
         count += avc - 1;
         count /= avc;
     }
 
     auto points = std::make_shared<VDBPointsGrid>(isuniform ?
-        openvdb::points::uniformPointScatter(*grid->m_grid, count, seed, spread) :
-        openvdb::points::nonUniformPointScatter(*grid->m_grid, count, seed, spread)
+        openvdb::points::uniformPointScatter(*grid->grid(), count, seed, spread) :
+        openvdb::points::nonUniformPointScatter(*grid->grid(), count, seed, spread)
         );
 
     set_output("points", std::move(points));
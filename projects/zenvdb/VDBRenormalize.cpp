@@ -21,7 +21,7 @@ namespace zeno {
     auto inoutSDF = get_input("inoutSDF")->as<VDBFloatGrid>();
     int normIter = get_param<int>(("iterations"));
     int dilateIter = get_param<int>(("dilateIters"));
-    auto lstracker = openvdb::tools::LevelSetTracker<openvdb::FloatGrid>(*(inoutSDF->m_grid));
+    auto lstracker = openvdb::tools::LevelSetTracker<openvdb::FloatGrid>(*(inoutSDF->grid()));
     lstracker.setState({openvdb::math::FIRST_BIAS, openvdb::math::TVD_RK3, 1, 1});
     lstracker.setTrimming(openvdb::tools::lstrack::TrimMode::kNone);
 
@@ -31,8 +31,8 @@ namespace zeno {
         lstracker.erode(dilateIter);
     for(int i=0;i<normIter;i++)
         lstracker.normalize();
-    //openvdb::tools::changeBackground(inoutSDF->m_grid->tree(), ((float)normIter)*(inoutSDF->m_grid->transformPtr()->voxelSize()[0]));
-    //openvdb::tools::signedFloodFill(inoutSDF->m_grid->tree());
+    //openvdb::tools::changeBackground(inoutSDF->grid()->tree(), ((float)normIter)*(inoutSDF->grid()->transformPtr()->voxelSize()[0]));
+    //openvdb::tools::signedFloodFill(inoutSDF->grid()->tree());
 
     set_output("inoutSDF", get_input("inoutSDF"));
   }
@@ -60,12 +60,12 @@ struct VDBSmooth : zeno::INode {
 
         openvdb::FloatGrid::Ptr mask = nullptr;
         if(has_input("MaskGrid")) {
-            mask = get_input("MaskGrid")->as<VDBFloatGrid>()->m_grid;
+            mask = get_input("MaskGrid")->as<VDBFloatGrid>()->grid();
         }
 
         if (inoutVDBtype == std::string("FloatGrid")) {
             auto inoutVDB = get_input("inoutVDB")->as<VDBFloatGrid>();
-            auto lsf = openvdb::tools::Filter<openvdb::FloatGrid>(*(inoutVDB->m_grid));
+            auto lsf = openvdb::tools::Filter<openvdb::FloatGrid>(*(inoutVDB->grid()));
             lsf.setGrainSize(1);
             if(type == "Gaussian")
               lsf.gaussian(width, iterations, mask.get());
@@ -73,12 +73,12 @@ struct VDBSmooth : zeno::INode {
               lsf.mean(width, iterations, mask.get());
             else if(type == "Median")
               lsf.median(width, iterations, mask.get());
-            //openvdb::tools::ttls_internal::smoothLevelSet(*inoutSDF->m_grid, normIter, halfWidth);
+            //openvdb::tools::ttls_internal::smoothLevelSet(*inoutSDF->grid(), normIter, halfWidth);
             set_output("inoutVDB", get_input("inoutVDB"));
         }
         else if (inoutVDBtype == std::string("Vec3fGrid")) {
             auto inoutVDB = get_input("inoutVDB")->as<VDBFloat3Grid>();
-            auto lsf = openvdb::tools::Filter<openvdb::Vec3fGrid>(*(inoutVDB->m_grid));
+            auto lsf = openvdb::tools::Filter<openvdb::Vec3fGrid>(*(inoutVDB->grid()));
             lsf.setGrainSize(1);
             if(type == "Gaussian")
               lsf.gaussian(width, iterations, mask.get());
@@ -86,6 +86,7 @@ struct VDBSmooth : zeno::INode {
               lsf.mean(width, iterations, mask.get());
             else if(type == "Median")
               lsf.median(width, iterations, mask.get());
+            inoutVDB->markGridModified();
             set_output("inoutVDB", get_input("inoutVDB"));
         }
     }
@@ -111,10 +112,10 @@ struct  VDBSmoothSDF : zeno::INode { /* cihou old graph */
     auto inoutSDF = get_input("inoutSDF")->as<VDBFloatGrid>();
     int width = get_param<int>(("width"));
     int iterations = get_param<int>(("iterations"));
-    auto lsf = openvdb::tools::Filter<openvdb::FloatGrid>(*(inoutSDF->m_grid));
+    auto lsf = openvdb::tools::Filter<openvdb::FloatGrid>(*(inoutSDF->grid()));
     lsf.setGrainSize(1);
     lsf.gaussian(width, iterations, nullptr);
-    //openvdb::tools::ttls_internal::smoothLevelSet(*inoutSDF->m_grid, normIter, halfWidth);
+    //openvdb::tools::ttls_internal::smoothLevelSet(*inoutSDF->grid(), normIter, halfWidth);
     set_output("inoutSDF", get_input("inoutSDF"));
   }
 };
@@ -156,7 +157,7 @@ static int defVDBDilateTopo = zeno::defNodeClass<VDBDilateTopo>("VDBDilateTopo",
 struct VDBErodeSDF : zeno::INode {
   virtual void apply() override {
     auto inoutSDF = get_input("inoutSDF")->as<VDBFloatGrid>();
-    auto grid = inoutSDF->m_grid;
+    auto grid = inoutSDF->grid();
     auto depth = get_input("depth")->as<zeno::NumericObject>()->get<float>();
     auto wrangler = [&](auto &leaf, openvdb::Index leafpos) {
         for (auto iter = leaf.beginValueOn(); iter != leaf.endValueOn(); ++iter) {
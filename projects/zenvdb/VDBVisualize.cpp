@@ -19,7 +19,7 @@ struct ParticleAsVoxels : INode{
         
         if(type=="FloatGrid"){
             auto ingrid = get_input<VDBFloatGrid>("vdbGrid");
-            auto const &grid = ingrid->m_grid;
+            auto const &grid = ingrid->grid();
             auto inparticles = get_input<PrimitiveObject>("particles");
             auto attrName = get_input<StringObject>("Attr")->value;
 
@@ -39,7 +39,7 @@ struct ParticleAsVoxels : INode{
         }
         if(type=="Vec3fGrid") {
             auto ingrid = get_input<VDBFloat3Grid>("vdbGrid");
-            auto const &grid = ingrid->m_grid;
+            auto const &grid = ingrid->grid();
             auto inparticles = get_input<PrimitiveObject>("particles");
             auto attrName = get_input<StringObject>("Attr")->value;
             inparticles->attr_visit(attrName, [&](auto &arr) {
@@ -81,7 +81,7 @@ struct VDBVoxelAsParticles : INode {
         auto type = get_input<VDBGrid>("vdbGrid")->getType();
         if(type == "FloatGrid"){
             auto ingrid = get_input<VDBFloatGrid>("vdbGrid");
-            auto const &grid = ingrid->m_grid;
+            auto const &grid = ingrid->grid();
 
             auto hasInactive = get_param<bool>("hasInactive");
             // tbb::concurrent_vector<vec3f> pos;
@@ -152,7 +152,7 @@ struct VDBVoxelAsParticles : INode {
         else if(type == "Vec3fGrid")
         {
             auto ingrid = get_input<VDBFloat3Grid>("vdbGrid");
-            auto const &grid = ingrid->m_grid;
+            auto const &grid = ingrid->grid();
 
             auto hasInactive = get_param<bool>("hasInactive");
             auto asStaggers = get_param<bool>("asStaggers");
@@ -247,7 +247,7 @@ struct VDBVoxelAsParticles : INode {
         zeno::log_info("VDBVoxelAsParticles got vdbGrid type: {}", type);
         if(type == "FloatGrid"){
             auto ingrid = get_input<VDBFloatGrid>("vdbGrid");
-            auto const &grid = ingrid->m_grid;
+            auto const &grid = ingrid->grid();
 
             auto hasInactive = get_param<bool>("hasInactive");
             // tbb::concurrent_vector<vec3f> pos;
@@ -322,7 +322,7 @@ struct VDBVoxelAsParticles : INode {
         else if(type == "Vec3fGrid")
         {
             auto ingrid = get_input<VDBFloat3Grid>("vdbGrid");
-            auto const &grid = ingrid->m_grid;
+            auto const &grid = ingrid->grid();
 
             auto hasInactive = get_param<bool>("hasInactive");
             auto asStaggers = get_param<bool>("asStaggers");
@@ -433,7 +433,7 @@ ZENDEFNODE(VDBVoxelAsParticles, {
 struct VDBLeafAsParticles : INode {
     template <typename VDBGridPtr>
     auto LeafAsParticle(VDBGridPtr ingrid) {
-        auto const &grid = ingrid->m_grid;
+        auto const &grid = ingrid->grid();
         auto h = grid->voxelSize()[0];
         tbb::concurrent_vector<vec3f> pos;
         auto wrangler = [&](auto &leaf, openvdb::Index leafpos) {
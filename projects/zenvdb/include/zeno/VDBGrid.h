@@ -1,8 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <optional>
+#include <string>
 #include <vector>
 #include <zeno/zeno.h>
+#include <zeno/utils/log.h>
+#include <zeno/utils/Timer.h>
 
 #include <openvdb/points/PointCount.h>
 #include <openvdb/tree/LeafManager.h>
@@ -14,31 +18,64 @@
 #include "packed3grids.h"
 namespace zeno {
 
-template <typename GridT>
-typename GridT::Ptr readFloatGrid(const std::string &fn) {
+// what to read of a .vdb file. only the descriptors and metadata of the grids are
+// read to pick the ones wanted, whose trees are then read alone: with delayLoad the
+// leaf buffers stay in the memory-mapped file until touched, and with clip set only
+// the nodes overlapping that world space box are read, clipped to it
+struct VDBReadOptions {
+  std::vector<std::string> names;  // any grid when empty
+  bool delayLoad = true;
+  std::optional<openvdb::BBoxd> clip;
+
+  bool wants(std::string const &name) const {
+    return names.empty() || std::find(names.begin(), names.end(), name) != names.end();
+  }
+};
+
+// the idx-th grid of the file, metas being what readAllGridMetadata gave
+inline openvdb::GridBase::Ptr readVDBGrid(openvdb::io::File &file, openvdb::GridPtrVec const &metas, std::size_t idx,
+                                          VDBReadOptions const &opts) {
+  auto const &name = metas[idx]->getName();
+  if (std::count_if(metas.begin(), metas.end(), [&] (auto const &meta) { return meta->getName() == name; }) == 1)
+    return opts.clip ? file.readGrid(name, *opts.clip) : file.readGrid(name);
+  // readGrid would take the first grid of that name, read them all to get this one
+  auto grid = file.getGrids()->at(idx);
+  if (opts.clip)
+    grid->clipGrid(*opts.clip);
+  return grid;
+}
+
+// the grids of the file that opts asks for, in file order
+inline openvdb::GridPtrVecPtr readVDBGrids(const std::string &fn, VDBReadOptions const &opts = {}) {
   openvdb::io::File file(fn);
-  file.open();
-  openvdb::GridPtrVecPtr my_grids = file.getGrids();
+  file.open(opts.delayLoad);
+  auto metas = file.readAllGridMetadata();
+  auto grids = std::make_shared<openvdb::GridPtrVec>();
+  for (std::size_t i = 0; i < metas->size(); i++) {
+    if (opts.wants((*metas)[i]->getName()))
+      grids->push_back(readVDBGrid(file, *metas, i, opts));
+  }
   file.close();
-  int count = 0;
-  typename GridT::Ptr grid;
-  for (openvdb::GridPtrVec::iterator iter = my_grids->begin();
-       iter != my_grids->end(); ++iter) {
-    openvdb::GridBase::Ptr it = *iter;
-    if ((*iter)->isType<GridT>()) {
-      grid = openvdb::gridPtrCast<GridT>(*iter);
-      count++;
-      /// display meta data
-      for (openvdb::MetaMap::MetaIterator it = grid->beginMeta();
-           it != grid->endMeta(); ++it) {
-        const std::string &name = it->first;
-        openvdb::Metadata::Ptr value = it->second;
-        std::string valueAsString = value->str();
-        std::cout << name << " = " << valueAsString << std::endl;
-      }
-    }
+  return grids;
+}
+
+// the last grid of type GridT in the file that opts asks for
+template <typename GridT>
+typename GridT::Ptr readFloatGrid(const std::string &fn, VDBReadOptions const &opts = {}) {
+  openvdb::io::File file(fn);
+  file.open(opts.delayLoad);
+  auto metas = file.readAllGridMetadata();
+  std::optional<std::size_t> found;
+  for (std::size_t i = 0; i < metas->size(); i++) {
+    if ((*metas)[i]->isType<GridT>() && opts.wants((*metas)[i]->getName()))
+      found = i;
   }
-  std::cout << "count = " << count << std::endl;
+  typename GridT::Ptr grid;
+  if (found)
+    grid = openvdb::gridPtrCast<GridT>(readVDBGrid(file, *metas, *found, opts));
+  file.close();
+  zeno::log_debug("read {} grid [{}] of the {} grids in {}", GridT::gridType(), grid ? grid->getName() : "",
+                  metas->size(), fn);
   return grid;
 }
 
@@ -51,7 +88,7 @@ void writeFloatGrid(const std::string &fn, typename GridT::Ptr grid) {
 
 struct VDBGrid : zeno::IObject {
   virtual void output(std::string path) = 0;
-  virtual void input(std::string path) = 0;
+  virtual void input(std::string path, VDBReadOptions const &opts = {}) = 0;
   virtual void setTransform(openvdb::math::Transform::Ptr const &trans) = 0;
   virtual std::string method_node(std::string const &op) override {
       if (op == "view") {
@@ -89,6 +126,12 @@ struct VDBGridWrapper : zeno::IObjectClone<VDBGridWrapper<GridT>, VDBGrid> {
           m_grid = other.m_grid->deepCopy();
   }
 
+  // only Vec3fGrid keeps a second copy to sync with, see below
+  typename GridT::Ptr &grid() noexcept {
+    return m_grid;
+  }
+  void markGridModified() noexcept {}
+
   VDBGridWrapper &operator=(VDBGridWrapper const &other) {
       if (other.m_grid)
           m_grid = other.m_grid->deepCopy();
@@ -116,8 +159,8 @@ struct VDBGridWrapper : zeno::IObjectClone<VDBGridWrapper<GridT>, VDBGrid> {
     openvdb::io::File(path).write({ m_grid });
   }
 
-  virtual void input(std::string path) override {
-    m_grid = readFloatGrid<GridT>(path);
+  virtual void input(std::string path, VDBReadOptions const &opts = {}) override {
+    m_grid = readFloatGrid<GridT>(path, opts);
   }
 
   virtual void
@@ -176,6 +219,19 @@ struct VDBGridWrapper<openvdb::Vec3fGrid> : zeno::IObjectClone<VDBGridWrapper<op
 
   ///
   std::optional<packed_FloatGrid3> m_packedGrid;
+  // FLIP nodes work on the packed grid and mark what they wrote to it
+  // (markPackedModified); it's unpacked into m_grid only once someone reads the
+  // values through grid(), so a chain of FLIP nodes never unpacks. code that
+  // writes m_grid in place calls markGridModified() after, code that replaces
+  // m_grid doesn't need to: the packed grid only stands for the grid it was
+  // packed from (m_packedFor)
+  bool m_packedValid = false;  // the packed grid holds the values of m_packedFor
+  bool m_gridStale = false;    // and they are newer than the tree of m_packedFor
+  std::weak_ptr<GridT> m_packedFor;
+
+  bool packedForGrid() const noexcept {
+    return !m_packedFor.owner_before(m_grid) && !m_grid.owner_before(m_packedFor);
+  }
 
   bool hasPackedGrid() const noexcept {
     return m_packedGrid.has_value();
@@ -188,6 +244,52 @@ struct VDBGridWrapper<openvdb::Vec3fGrid> : zeno::IObjectClone<VDBGridWrapper<op
     if (!hasPackedGrid()) throw std::runtime_error("packed version of vec3fgrid is not initialized!");
     return *m_packedGrid;
   }
+
+  // the packed grid holding the values of m_grid, packing them unless it still
+  // has them; discard skips that when the caller overwrites it all. callers
+  // writing to it then call markPackedModified()
+  packed_FloatGrid3 &usePackedGrid(bool discard = false) {
+    if (!hasPackedGrid())
+      m_packedGrid.emplace();
+    if (!packedForGrid()) {
+      m_packedValid = false;
+      m_gridStale = false;
+    }
+    if (discard) {
+      m_packedValid = false;
+      m_packedFor = m_grid;
+    } else if (!m_packedValid) {
+      ZENO_SCOPE_TIMER("pack");
+      m_packedGrid->from_vec3(m_grid);
+      m_packedValid = true;
+      m_packedFor = m_grid;
+    }
+    return *m_packedGrid;
+  }
+
+  // what a FLIP node wrote to the packed grid is unpacked when grid() is used
+  void markPackedModified() noexcept {
+    m_packedValid = true;
+    m_gridStale = true;
+    m_packedFor = m_grid;
+  }
+
+  // m_grid with the values last written to either grid. only its tree is left
+  // behind by the packed grid, transform and metadata can be read from m_grid
+  typename GridT::Ptr &grid() {
+    if (m_gridStale && packedForGrid()) {
+      ZENO_SCOPE_TIMER("unpack");
+      m_packedGrid->to_vec3(m_grid);
+    }
+    m_gridStale = false;
+    return m_grid;
+  }
+
+  // after m_grid was written in place through grid(), the packed grid is out of date then
+  void markGridModified() noexcept {
+    m_packedValid = false;
+    m_gridStale = false;
+  }
   ///
 
   virtual ~VDBGridWrapper() override = default;
@@ -197,18 +299,26 @@ struct VDBGridWrapper<openvdb::Vec3fGrid> : zeno::IObjectClone<VDBGridWrapper<op
   VDBGridWrapper(typename GridT::Ptr &&ptr) { m_grid = std::move(ptr); }
 
   VDBGridWrapper(VDBGridWrapper const &other) {
-      if (other.m_grid)
-          m_grid = other.m_grid->deepCopy();
+      *this = other;
   }
 
   VDBGridWrapper &operator=(VDBGridWrapper const &other) {
+      m_packedGrid = {};
+      m_packedValid = false;
+      m_gridStale = false;
+      m_packedFor.reset();
       if (other.m_grid) {
           m_grid = other.m_grid->deepCopy();
-          if (other.hasPackedGrid())
+          // otherwise the packed grid gets packed again when used anyway, a newer
+          // one is copied as it is and unpacked by whoever reads the copy
+          if (other.m_packedValid && other.packedForGrid()) {
             m_packedGrid = other.refPackedGrid().fullCopy();
+            m_packedValid = true;
+            m_gridStale = other.m_gridStale;
+            m_packedFor = m_grid;
+          }
       } else {
           m_grid = nullptr;
-          m_packedGrid = {};
       }
       return *this;
   }
@@ -219,7 +329,7 @@ struct VDBGridWrapper<openvdb::Vec3fGrid> : zeno::IObjectClone<VDBGridWrapper<op
   // }
 
   openvdb::CoordBBox evalActiveVoxelBoundingBox() override {
-    return m_grid->evalActiveVoxelBoundingBox();
+    return grid()->evalActiveVoxelBoundingBox();
   }
   openvdb::Vec3d indexToWorld(openvdb::Coord &c) override {
     return m_grid->transform().indexToWorld(c);
@@ -229,30 +339,27 @@ struct VDBGridWrapper<openvdb::Vec3fGrid> : zeno::IObjectClone<VDBGridWrapper<op
   }
   virtual void output(std::string path) override {
     //writeFloatGrid<GridT>(path, m_grid);
-    openvdb::io::File(path).write({ m_grid });
-    // refPackedGrid().to_vec3(m_grid);
+    openvdb::io::File(path).write({ grid() });
   }
 
-  virtual void input(std::string path) override {
-    m_grid = readFloatGrid<GridT>(path);
-    m_packedGrid = packed_FloatGrid3{};
-    auto &packed = refPackedGrid();
-    packed.from_vec3(m_grid);
+  virtual void input(std::string path, VDBReadOptions const &opts = {}) override {
+    m_grid = readFloatGrid<GridT>(path, opts);
+    m_packedGrid = {};
+    m_packedValid = false;
+    m_gridStale = false;
   }
 
   virtual void
   setTransform(openvdb::math::Transform::Ptr const &trans) override {
-    m_grid->setTransform(trans);
+    grid()->setTransform(trans);
+    markGridModified();
   }
   virtual void
   dilateTopo(int l) override {
     openvdb::tools::dilateActiveValues(
-      m_grid->tree(), l,
+      grid()->tree(), l,
       openvdb::tools::NearestNeighbors::NN_FACE_EDGE_VERTEX, openvdb::tools::TilePolicy::EXPAND_TILES);
-      if (hasPackedGrid()) {
-        auto &packed = refPackedGrid();
-        packed.from_vec3(m_grid);
-      }
+    markGridModified();
   }
 
   virtual zeno::vec3f getVoxelSize() const override {
@@ -261,10 +368,11 @@ struct VDBGridWrapper<openvdb::Vec3fGrid> : zeno::IObjectClone<VDBGridWrapper<op
   }
 
   virtual void setName(std::string const &name) override {
-      m_grid->setName(name);
+      m_grid->setName(name);  // not in the packed grid
   }
 
   virtual void setGridClass(std::string const &gridClass) override {
+      grid();
       if (gridClass == "UNKNOWN")
           m_grid->setGridClass(openvdb::GridClass::GRID_UNKNOWN);
       else if (gridClass == "LEVEL_SET")
@@ -273,6 +381,7 @@ struct VDBGridWrapper<openvdb::Vec3fGrid> : zeno::IObjectClone<VDBGridWrapper<op
           m_grid->setGridClass(openvdb::GridClass::GRID_FOG_VOLUME);
       else if (gridClass == "STAGGERED")
           m_grid->setGridClass(openvdb::GridClass::GRID_STAGGERED);
+      markGridModified();  // decides how the channels are offset when packed
   }
 
   virtual std::string getType() const override {
@@ -60,8 +60,6 @@ void packed_FloatGrid3::to_vec3(openvdb::Vec3fGrid::Ptr out_v) const
 		out_v->topologyUnion(*v[i]);
 	}
 
-	std::atomic<int> vcounter{ 0 };
-
 	auto filler = [&](openvdb::Vec3fTree::LeafNodeType& leaf, openvdb::Index) {
 		for (int i = 0; i < 3; i++) {
 			auto channel_leaf = v[i]->tree().probeConstLeaf(leaf.origin());
@@ -69,9 +67,6 @@ void packed_FloatGrid3::to_vec3(openvdb::Vec3fGrid::Ptr out_v) const
 				for (auto iter = channel_leaf->beginValueOn(); iter; ++iter) {
 					auto val = leaf.getValue(iter.offset());
 					val[i] = iter.getValue();
-					if (val[i] != 0) {
-						vcounter++;
-					}
 					leaf.setValueOn(iter.offset(), val);
 				}
 			}
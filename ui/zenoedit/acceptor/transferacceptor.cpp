@@ -529,6 +529,10 @@ void TransferAcceptor::setOptions(const QString& id, const QStringList& options)
         {
             opts |= OPT_CACHE;
         }
+        else if (optName == "MEMOIZE")
+        {
+            opts |= OPT_MEMOIZE;
+        }
         else if (optName == "collapsed")
         {
             data[ROLE_COLLASPED] = true;
@@ -8,6 +8,7 @@
 #include <zeno/core/Graph.h>
 #include <zeno/extra/GlobalState.h>
 #include <zeno/extra/GlobalComm.h>
+#include <zeno/extra/FrameCacheWriter.h>
 #include <zeno/extra/GlobalStatus.h>
 #include <zeno/extra/GraphException.h>
 #include <zeno/extra/EventCallbacks.h>
@@ -19,8 +20,13 @@
 #include <QTcpServer>
 #include <QtWidgets>
 #include <QTcpSocket>
+#elif !defined(_WIN32)
+#include <sys/uio.h>
+#include <cerrno>
 #endif
 #include <zeno/utils/scope_exit.h>
+#include <zeno/utils/envconfig.h>
+#include <zeno/utils/SharedMemory.h>
 #include "corelaunch.h"
 #include "viewdecode.h"
 #include "settings/zsettings.h"
@@ -63,24 +69,58 @@ static void send_packet(std::string_view info, const char *buf, size_t len) {
 
     zeno::log_debug("runner tx head-buffer {} data-buffer {}", headbuffer.size(), len);
 #ifdef ZENO_IPC_USE_TCP
-    for (char c: headbuffer) {
-        clientSocket->write(&c, 1);
-    }
+    clientSocket->write(headbuffer.data(), headbuffer.size());
     clientSocket->write(buf, len);
     while (clientSocket->bytesToWrite() > 0) {
         clientSocket->waitForBytesWritten();
     }
 #else
-    for (char c : headbuffer) {
-        fputc(c, ourfp);
-    }
-    for (size_t i = 0; i < len; i++) {
-        fputc(buf[i], ourfp);
-    }
+    fflush(ourfp);  // log text may still be buffered in the same stream
+#ifdef _WIN32
+    fwrite(headbuffer.data(), 1, headbuffer.size(), ourfp);
+    fwrite(buf, 1, len, ourfp);
     fflush(ourfp);
+#else
+    struct iovec iov[2] = {{headbuffer.data(), headbuffer.size()}, {(void *)buf, len}};
+    struct iovec *piov = iov;
+    int niov = 2;
+    int fd = fileno(ourfp);
+    while (niov) {
+        ssize_t ret = writev(fd, piov, niov);
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        while (niov && (size_t)ret >= piov->iov_len) {
+            ret -= piov->iov_len;
+            piov++;
+            niov--;
+        }
+        if (niov) {
+            piov->iov_base = (char *)piov->iov_base + ret;
+            piov->iov_len -= ret;
+        }
+    }
+#endif
 #endif
 }
 
+// objects of $ZENO_IPC_SHM_THRESHOLD MB or more skip the pipe/socket, the packet only names a
+// shared memory block holding them; off by default, see benchmarks/bench_ipc_throughput
+static void send_view_object(std::string const &key, std::vector<char> const &buffer) {
+    static const size_t threshold = (size_t)zeno::envconfig::getInt("IPC_SHM_THRESHOLD", 0) << 20;
+    if (threshold && buffer.size() >= threshold) {
+        std::string name = zeno::shm_publish(buffer.data(), buffer.size());
+        if (!name.empty()) {
+            send_packet("{\"action\":\"viewObject\",\"key\":\"" + key + "\",\"shm\":\"" + name
+                        + "\",\"shmsize\":" + std::to_string(buffer.size()) + "}", "", 0);
+            return;
+        }
+    }
+    send_packet("{\"action\":\"viewObject\",\"key\":\"" + key + "\"}", buffer.data(), buffer.size());
+}
+
 static int runner_start(std::string const &progJson, int sessionid, const LAUNCH_PARAM& param) {
     zeno::log_trace("runner got program JSON: {}", progJson);
     //MessageBox(0, "runner", "runner", MB_OK);           //convient to attach process by debugger, at windows.
@@ -111,7 +151,25 @@ static int runner_start(std::string const &progJson, int sessionid, const LAUNCH
         zeno::getSession().globalComm->frameCache("", 0);
     }
 
+    // frames are dumped in the background, $ZENO_CACHE_WRITE_BUDGET (MB) bounds the memory they may hold
+    std::unique_ptr<zeno::FrameCacheWriter> cacheWriter;
+    if (param.enableCache) {
+        cacheWriter = std::make_unique<zeno::FrameCacheWriter>(
+            (size_t)zeno::envconfig::getInt("CACHE_WRITE_BUDGET", 4096) << 20,
+            zeno::envconfig::getInt("CACHE_WRITE_THREADS", 1));
+    }
+    // the ui counts finishFrame packets, so they go out in frame order once the cache is on disk
+    auto sendWrittenFrames = [&] (bool waitAll) {
+        if (!cacheWriter)
+            return;
+        if (waitAll)
+            cacheWriter->wait();
+        for (int frame : cacheWriter->takeWrittenFrames())
+            send_packet("{\"action\":\"finishFrame\",\"key\":\"" + std::to_string(frame) + "\"}", "", 0);
+    };
+
     auto onfail = [&] {
+        sendWrittenFrames(true);
         auto statJson = session->globalStatus->toJson();
         send_packet("{\"action\":\"reportStatus\"}", statJson.data(), statJson.size());
         return 1;
@@ -124,6 +182,11 @@ static int runner_start(std::string const &progJson, int sessionid, const LAUNCH
         return onfail();
 
     std::vector<char> buffer;
+    zeno::ObjectDeltaState deltaState;
+    zeno::ObjectCodecOptions deltaOptions;
+    deltaOptions.compress = false;
+    deltaOptions.delta = zeno::envconfig::getBool("IPC_DELTA", true) ? &deltaState : nullptr;
+    deltaOptions.deltaKeyframeInterval = zeno::envconfig::getInt("IPC_KEYFRAME", 30);
 
     session->globalComm->initFrameRange(graph->beginFrameNumber, graph->endFrameNumber);
     send_packet("{\"action\":\"frameRange\",\"key\":\""
@@ -177,28 +240,35 @@ static int runner_start(std::string const &progJson, int sessionid, const LAUNCH
         send_packet("{\"action\":\"newFrame\",\"key\":\"" + std::to_string(frame) +"\"}", "", 0);
 
         if (param.enableCache) {
-            //construct cache lock.
+            //construct cache lock, held until the writer is done with this frame.
             std::string sLockFile = param.cacheDir.toStdString() + "/" + zeno::iotags::sZencache_lockfile_prefix + std::to_string(frame) + ".lock";
-            QLockFile lckFile(QString::fromStdString(sLockFile));
-            bool ret = lckFile.tryLock();
-            //dump cache to disk.
-            session->globalComm->dumpFrameCache(frame, param.applyLightAndCameraOnly, param.applyMaterialOnly);
+            auto lckFile = std::make_shared<QLockFile>(QString::fromStdString(sLockFile));
+            bool ret = lckFile->tryLock();
+            //dump cache to disk in the background.
+            std::string cacheDir = session->globalComm->cachePath();
+            cacheWriter->push(frame, session->globalComm->takeFrameObjects(frame),
+                [cacheDir, frame, lightCameraOnly = param.applyLightAndCameraOnly, materialOnly = param.applyMaterialOnly,
+                 lckFile = std::move(lckFile)] (zeno::GlobalComm::ViewObjects &objs) {
+                    zeno::GlobalComm::toDisk(cacheDir, frame, objs, lightCameraOnly, materialOnly);
+                });
+            sendWrittenFrames(false);
         } else {
             auto const& viewObjs = session->globalComm->getViewObjects();
             zeno::log_debug("runner got {} view objects", viewObjs.size());
             for (auto const& [key, obj] : viewObjs) {
-                if (zeno::encodeObject(obj.get(), buffer))
-                    send_packet("{\"action\":\"viewObject\",\"key\":\"" + key + "\"}",
-                        buffer.data(), buffer.size());
+                //arrays unchanged since the last frame of the same ToView are sent as references.
+                deltaOptions.deltaChannel = zeno::GlobalComm::viewObjectChannel(key);
+                if (zeno::encodeObject(obj.get(), buffer, deltaOptions))
+                    send_view_object(key, buffer);
                 buffer.clear();
             }
+            send_packet("{\"action\":\"finishFrame\",\"key\":\"" + std::to_string(frame) + "\"}", "", 0);
         }
 
-        send_packet("{\"action\":\"finishFrame\",\"key\":\"" + std::to_string(frame) + "\"}", "", 0);
-
         if (session->globalStatus->failed())
             return onfail();
     }
+    sendWrittenFrames(true);
     return 0;
 }
 
@@ -377,6 +377,10 @@ static void serializeGraph(IGraphsModel* pGraphsModel, const QModelIndex& subgId
             AddParams(opStr, ident, paramName, paramValue, param_info.typeDesc, writer);
         }
 
+        if (opts & OPT_MEMOIZE) {
+            AddStringList({ "memoizeNode", ident }, writer);
+        }
+
         if (opts & OPT_ONCE) {
             AddStringList({ "addNode", "HelperOnce", noOnceIdent }, writer);
             for (OUTPUT_SOCKET output : outputs) {
@@ -10,6 +10,7 @@
 #include <zeno/extra/GlobalComm.h>
 #include <zeno/extra/GlobalStatus.h>
 #include <zeno/funcs/ObjectCodec.h>
+#include <zeno/utils/SharedMemory.h>
 #ifdef ZENO_WITH_UnrealBridge
 #include "unrealhook.h"
 #endif
@@ -44,7 +45,11 @@ struct PacketProc {
     std::string fcPath = {};
     int fcMax = 0;
 
+    //previous frame of each ToView, the runner sends only the arrays that changed.
+    zeno::ObjectDeltaState deltaState;
+
     void onStart() {
+        deltaState = {};
         globalCommNeedClean = 1;
         globalCommNeedNewFrame = 0;
         zeno::getSession().globalState->clearState();
@@ -75,7 +80,7 @@ struct PacketProc {
 
         if (action == "viewObject") {
             zeno::log_debug("decoding object");
-            auto object = zeno::decodeObject(buf, len);
+            auto object = zeno::decodeObject(buf, len, &deltaState, zeno::GlobalComm::viewObjectChannel(objKey));
             //zeno::log_debug("object ident=[{}]", object->userData().get("ident"));
             if (!object) {
                 zeno::log_warn("failed to decode view object");
@@ -200,6 +205,23 @@ struct PacketProc {
             objKey.assign(it->value.GetString(), it->value.GetStringLength());
         }
 
+        // payload handed over in shared memory by the runner instead of inline
+        if (auto it = root.FindMember("shm"); it != root.MemberEnd() && it->value.IsString()) {
+            std::string shmName(it->value.GetString(), it->value.GetStringLength());
+            size_t shmSize = 0;
+            if (auto it = root.FindMember("shmsize"); it != root.MemberEnd() && it->value.IsUint64())
+                shmSize = it->value.GetUint64();
+            zeno::log_debug("decoder got action=[{}] key=[{}] shm={} size={}", action, objKey, shmName, shmSize);
+            bool ret = false;
+            if (!zeno::shm_consume(shmName, shmSize, [&] (const char *data, size_t size) {
+                ret = processPacket(action, objKey, data, size);
+            })) {
+                zeno::log_warn("failed to map shared memory {}", shmName);
+                zeno::shm_discard(shmName);
+            }
+            return ret;
+        }
+
         const char *data = buf + header.info_size;
         size_t size = header.total_size - header.info_size;
 
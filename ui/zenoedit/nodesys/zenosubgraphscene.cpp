@@ -45,6 +45,7 @@ ZenoSubGraphScene::ZenoSubGraphScene(QObject *parent)
     , m_bOnceOn(false)
     , m_bBypassOn(false)
     , m_bViewOn(false)
+    , m_bMemoizeOn(false)
 {
     ZtfUtil &inst = ZtfUtil::GetInstance();
     m_nodeParams = inst.toUtilParam(inst.loadZtf(":/templates/node-example.xml"));
@@ -1228,6 +1229,10 @@ void ZenoSubGraphScene::keyPressEvent(QKeyEvent* event)
     {
         updateNodeStatus(m_bViewOn, OPT_VIEW);
     }
+    else if (!event->isAccepted() && uKey == ZenoSettingsManager::GetInstance().getShortCut(ShortCut_Memoize))
+    {
+        updateNodeStatus(m_bMemoizeOn, OPT_MEMOIZE);
+    }
 }
 
 void ZenoSubGraphScene::updateNodeStatus(bool &bOn, int option) 
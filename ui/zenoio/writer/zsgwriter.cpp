@@ -402,6 +402,9 @@ void ZsgWriter::dumpNode(const NODE_DATA& data, RAPIDJSON_WRITER& writer)
         if (opts & OPT_CACHE) {
             options.push_back("CACHE");
         }
+        if (opts & OPT_MEMOIZE) {
+            options.push_back("MEMOIZE");
+        }
         if (data[ROLE_COLLASPED].toBool())
         {
             options.push_back("collapsed");
@@ -75,7 +75,8 @@ enum NODE_OPTION {
     OPT_MUTE = 1 << 1,
     OPT_VIEW = 1 << 2,
     OPT_PREP = 1 << 3,
-    OPT_CACHE = 1 << 4
+    OPT_CACHE = 1 << 4,
+    OPT_MEMOIZE = 1 << 5    // reuse outputs while the inputs hash the same
 };
 
 enum SOCKET_PROPERTY {
@@ -1050,6 +1050,10 @@ void ModelAcceptor::setOptions(const QString& id, const QStringList& options)
         {
             opts |= OPT_CACHE;
         }
+        else if (optName == "MEMOIZE")
+        {
+            opts |= OPT_MEMOIZE;
+        }
         else if (optName == "collapsed")
         {
             m_currentGraph->setData(idx, true, ROLE_COLLASPED);
@@ -0,0 +1,177 @@
+// runner -> editor payload transfer, comparing the ways send_packet can move bytes:
+//   fputc   one libc call per byte (the old pipe path)
+//   writev  header and payload in one vectored write
+//   tcp     header and payload over a loopback socket (the default ZENO_IPC_USE_TCP setup)
+//   shm     payload in shared memory, only its name goes through the pipe
+// usage: bench_ipc_throughput [megabytes=256] [rounds=3]
+#include <zeno/utils/SharedMemory.h>
+#include <sys/uio.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+bool readAll(int fd, void *dst, size_t size) {
+    auto p = (char *)dst;
+    while (size) {
+        ssize_t ret = read(fd, p, size);
+        if (ret <= 0)
+            return false;
+        p += ret;
+        size -= ret;
+    }
+    return true;
+}
+
+void writeAll(int fd, const void *src, size_t size) {
+    struct iovec iov{(void *)src, size};
+    while (iov.iov_len) {
+        ssize_t ret = writev(fd, &iov, 1);
+        if (ret <= 0)
+            return;
+        iov.iov_base = (char *)iov.iov_base + ret;
+        iov.iov_len -= ret;
+    }
+}
+
+uint64_t checksum(const char *data, size_t size) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < size; i += 64)
+        sum += (unsigned char)data[i];
+    return sum;
+}
+
+// receiving side, like viewdecode: copy the payload into a buffer (or map it) and touch it
+void receiver(int in, int tcp, int ack) {
+    std::vector<char> buffer;
+    while (true) {
+        char mode;
+        uint64_t size;
+        if (!readAll(in, &mode, 1) || !readAll(in, &size, sizeof(size)))
+            return;
+        uint64_t sum = 0;
+        if (mode == 's') {
+            uint64_t namelen;
+            readAll(in, &namelen, sizeof(namelen));
+            std::string name(namelen, '\0');
+            readAll(in, name.data(), namelen);
+            zeno::shm_consume(name, size, [&] (const char *data, size_t size) {
+                sum = checksum(data, size);
+            });
+        } else {
+            buffer.resize(size);
+            readAll(mode == 't' ? tcp : in, buffer.data(), size);
+            sum = checksum(buffer.data(), size);
+        }
+        writeAll(ack, &sum, sizeof(sum));
+    }
+}
+
+double sendOnce(char mode, std::vector<char> const &payload, int out, int tcp, int ack) {
+    auto t0 = std::chrono::steady_clock::now();
+    uint64_t size = payload.size();
+    if (mode == 'f') {
+        FILE *fp = fdopen(dup(out), "wb");
+        fputc(mode, fp);
+        for (size_t i = 0; i < sizeof(size); i++)
+            fputc(((const char *)&size)[i], fp);
+        for (char c: payload)
+            fputc(c, fp);
+        fclose(fp);
+    } else if (mode == 'w') {
+        struct iovec iov[3] = {{&mode, 1}, {&size, sizeof(size)}, {(void *)payload.data(), payload.size()}};
+        struct iovec *p = iov;
+        int n = 3;
+        while (n) {
+            ssize_t ret = writev(out, p, n);
+            if (ret <= 0)
+                break;
+            while (n && (size_t)ret >= p->iov_len) {
+                ret -= p->iov_len;
+                p++;
+                n--;
+            }
+            if (n) {
+                p->iov_base = (char *)p->iov_base + ret;
+                p->iov_len -= ret;
+            }
+        }
+    } else if (mode == 't') {
+        writeAll(out, &mode, 1);
+        writeAll(out, &size, sizeof(size));
+        writeAll(tcp, payload.data(), payload.size());
+    } else {
+        std::string name = zeno::shm_publish(payload.data(), payload.size());
+        uint64_t namelen = name.size();
+        writeAll(out, &mode, 1);
+        writeAll(out, &size, sizeof(size));
+        writeAll(out, &namelen, sizeof(namelen));
+        writeAll(out, name.data(), namelen);
+    }
+    uint64_t sum;
+    readAll(ack, &sum, sizeof(sum));
+    auto t1 = std::chrono::steady_clock::now();
+    if (sum != checksum(payload.data(), payload.size()))
+        std::fprintf(stderr, "checksum mismatch in mode %c\n", mode);
+    return std::chrono::duration<double>(t1 - t0).count();
+}
+
+}
+
+int main(int argc, char **argv) {
+    size_t megabytes = argc > 1 ? std::atoi(argv[1]) : 256;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 3;
+    std::vector<char> payload(megabytes << 20);
+    for (size_t i = 0; i < payload.size(); i++)
+        payload[i] = (char)(i * 2654435761u >> 24);
+
+    int topipe[2], ackpipe[2];
+    if (pipe(topipe) || pipe(ackpipe))
+        return 1;
+    int server = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addrlen = sizeof(addr);
+    if (bind(server, (sockaddr *)&addr, sizeof(addr)) || listen(server, 1)
+        || getsockname(server, (sockaddr *)&addr, &addrlen))
+        return 1;
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(topipe[1]);
+        close(ackpipe[0]);
+        int tcp = socket(AF_INET, SOCK_STREAM, 0);
+        if (connect(tcp, (sockaddr *)&addr, sizeof(addr)))
+            _exit(1);
+        receiver(topipe[0], tcp, ackpipe[1]);
+        _exit(0);
+    }
+    close(topipe[0]);
+    close(ackpipe[1]);
+    int tcp = accept(server, nullptr, nullptr);
+
+    std::printf("payload %zu MB, best of %d rounds\n", megabytes, rounds);
+    for (char mode: {'f', 'w', 't', 's'}) {
+        double best = 1e30;
+        for (int r = 0; r < rounds; r++)
+            best = std::min(best, sendOnce(mode, payload, topipe[1], tcp, ackpipe[0]));
+        const char *name = mode == 'f' ? "fputc" : mode == 'w' ? "writev" : mode == 't' ? "tcp" : "shm";
+        std::printf("%-8s %8.3f s %10.1f MB/s\n", name, best, megabytes / best);
+    }
+
+    close(topipe[1]);
+    close(tcp);
+    close(server);
+    waitpid(pid, nullptr, 0);
+    close(ackpipe[0]);
+    return 0;
+}
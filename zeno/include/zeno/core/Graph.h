@@ -4,10 +4,13 @@
 #include <zeno/core/IObject.h>
 #include <zeno/utils/safe_dynamic_cast.h>
 #include <zeno/types/UserData.h>
+#include <condition_variable>
 #include <functional>
 #include <variant>
 #include <memory>
+#include <thread>
 #include <string>
+#include <mutex>
 #include <set>
 #include <any>
 #include <map>
@@ -47,6 +50,12 @@ struct Graph : std::enable_shared_from_this<Graph> {
     std::unique_ptr<Context> ctx;
     std::unique_ptr<DirtyChecker> dirtyChecker;
 
+    // run independent upstream branches on WorkStealingPool, defaults to $ZENO_PARALLEL_APPLY
+    bool parallelApply = false;
+    std::mutex applyMtx;
+    std::condition_variable applyCv;
+    std::map<std::string, std::thread::id> applyingNodes;
+
     ZENO_API Graph();
     ZENO_API ~Graph();
 
@@ -59,6 +68,7 @@ struct Graph : std::enable_shared_from_this<Graph> {
     ZENO_API void clearNodes();
     ZENO_API void applyNodesToExec();
     ZENO_API void applyNodes(std::set<std::string> const &ids);
+    ZENO_API void applyNodesParallel(std::set<std::string> const &ids);
     ZENO_API void addNode(std::string const &cls, std::string const &id);
     ZENO_API Graph *addSubnetNode(std::string const &id);
     ZENO_API Graph *getSubnetGraph(std::string const &id) const;
@@ -81,6 +91,7 @@ struct Graph : std::enable_shared_from_this<Graph> {
     ZENO_API std::map<std::string, zany> callTempNode(std::string const &id,
             std::map<std::string, zany> inputs) const;
     ZENO_API void setTempCache(std::string const& id);
+    ZENO_API void setMemoize(std::string const& id);
 };
 
 }
@@ -35,6 +35,9 @@ public:
     zany muted_output;
 
     bool bTmpCache = false;
+    bool bMemoize = false;          // reuse outputs while hashInputs() stays the same
+    bool memoHit = false;           // whether the last doApply reused the outputs
+    std::size_t outputsVersion = 0; // bumped each time the outputs get recomputed
 
     ZENO_API INode();
     ZENO_API virtual ~INode();
@@ -50,6 +53,7 @@ public:
     ZENO_API zany resolveInput(std::string const& id);
     ZENO_API bool getTmpCache();
     ZENO_API void writeTmpCaches();
+    ZENO_API std::size_t hashInputs() const;
 
 protected:
     ZENO_API virtual void complete();
@@ -60,6 +64,15 @@ public:
 
     ZENO_API virtual void preApply();
 
+    // opt-in: true for nodes whose apply() may run on a pool worker alongside other
+    // nodes (no unguarded process-wide state, e.g. the shared ZFX compiler), only
+    // they are scheduled by Graph::applyNodesParallel, and only if all their upstream is
+    ZENO_API virtual bool canApplyInParallel() const;
+
+    // false for nodes that resolve inputs lazily or touch graph-wide state,
+    // Graph::applyNodesParallel doesn't look upstream of them nor schedules anything downstream
+    ZENO_API virtual bool requiresAllInputs() const;
+
     ZENO_API Graph *getThisGraph() const;
     ZENO_API Session *getThisSession() const;
     ZENO_API GlobalState *getGlobalState() const;
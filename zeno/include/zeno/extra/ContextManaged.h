@@ -11,6 +11,10 @@ namespace zeno {
 struct ContextManagedNode : INode {
     std::unique_ptr<Context> m_ctx = nullptr;
 
+    virtual bool requiresAllInputs() const override {
+        return false;
+    }
+
     void push_context() {
         assert(!m_ctx);
         m_ctx = std::move(graph->ctx);
@@ -6,20 +6,42 @@
 #include <zeno/funcs/ObjectCodec.h>
 #include <zeno/types/UserData.h>
 #include <set>
+#include <map>
+#include <mutex>
 #include <string>
 
 namespace zeno {
 
 struct DirtyChecker {
     std::set<std::string> dirts;
+    std::map<std::string, std::size_t> memoKeys;  // INode::hashInputs of the last apply
+    mutable std::mutex mtx;  // tainted from pool workers in Graph::applyNodesParallel
 
     void taintThisNode(std::string ident) {
+        std::lock_guard lck(mtx);
         dirts.insert(std::move(ident));
     }
 
     bool amIDirty(std::string const &ident) const {
+        std::lock_guard lck(mtx);
         return dirts.find(ident) != dirts.end();
     }
+
+    bool isMemoized(std::string const &ident, std::size_t key) const {
+        std::lock_guard lck(mtx);
+        auto it = memoKeys.find(ident);
+        return it != memoKeys.end() && it->second == key;
+    }
+
+    void memorize(std::string const &ident, std::size_t key) {
+        std::lock_guard lck(mtx);
+        memoKeys[ident] = key;
+    }
+
+    void forget(std::string const &ident) {
+        std::lock_guard lck(mtx);
+        memoKeys.erase(ident);
+    }
 };
 
 }
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <zeno/extra/GlobalComm.h>
+#include <condition_variable>
+#include <functional>
+#include <thread>
+#include <deque>
+#include <mutex>
+
+namespace zeno {
+
+// encodes and writes finished frames on background threads, so that the next
+// frame can start computing right away; push blocks while the frames still
+// in flight hold more than the memory budget
+struct FrameCacheWriter {
+    using WriteFunc = std::function<void(GlobalComm::ViewObjects &objs)>;
+
+    ZENO_API explicit FrameCacheWriter(std::size_t memoryBudget, std::size_t nthreads = 1);
+    ZENO_API ~FrameCacheWriter();  // waits for all pending writes
+
+    FrameCacheWriter(FrameCacheWriter const &) = delete;
+    FrameCacheWriter &operator=(FrameCacheWriter const &) = delete;
+
+    ZENO_API void push(int frameid, GlobalComm::ViewObjects objs, WriteFunc write);
+
+    // frames written since the last call, always in push order
+    ZENO_API std::vector<int> takeWrittenFrames();
+
+    ZENO_API void wait();
+
+    // rough in-memory size of the objects, only used for the budget
+    ZENO_API static std::size_t estimateBytes(GlobalComm::ViewObjects const &objs);
+    ZENO_API static std::size_t estimateBytes(IObject const *obj);
+
+private:
+    struct Frame {
+        int frameid;
+        std::size_t bytes;
+        GlobalComm::ViewObjects objs;
+        WriteFunc write;
+        bool written = false;
+    };
+
+    std::size_t m_budget;
+    std::size_t m_inflightBytes = 0;
+    std::size_t m_pending = 0;
+    std::deque<Frame> m_frames;   // in push order, until reported by takeWrittenFrames
+    std::deque<Frame *> m_queue;  // not yet picked up by a thread
+    std::vector<std::thread> m_threads;
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+    bool m_stop = false;
+
+    void threadMain();
+};
+
+}
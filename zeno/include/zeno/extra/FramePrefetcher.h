@@ -0,0 +1,128 @@
+#pragma once
+
+#include <zeno/utils/api.h>
+#include <condition_variable>
+#include <functional>
+#include <optional>
+#include <memory>
+#include <thread>
+#include <string>
+#include <deque>
+#include <mutex>
+#include <map>
+
+namespace zeno {
+
+struct IObject;
+
+// reads upcoming frames of time-sampled files on background threads while the
+// current frame computes. readers name their stream with a key (the reader and
+// the file or file sequence), take() what was read ahead for the frame they are
+// at, and prefetch() the frames after it. entries of a stream outside of the
+// read-ahead window are dropped as soon as it's taken from, so seeking cancels
+// them; frames whose objects would go over the memory budget aren't read ahead,
+// nor frames outside of the session's frame range. a frame whose file was
+// modified after it was read ahead isn't taken, the caller reads it again.
+// $ZENO_PREFETCH_FRAMES (default 2, 0 turns it off), $ZENO_PREFETCH_BUDGET (MB,
+// default 1024) and $ZENO_PREFETCH_THREADS (default 2) configure the instance
+struct FramePrefetcher {
+    // reads the stream at frameid, may raise bytes above the estimated size of
+    // the object; null when there's nothing to read at that frame
+    using LoadFunc = std::function<std::shared_ptr<IObject>(int frameid, std::size_t &bytes)>;
+    // the file the stream reads frameid from
+    using FileFunc = std::function<std::string(int frameid)>;
+
+    // modification time and size of a file, to tell whether it was rewritten
+    struct FileStamp {
+        long long mtime;
+        unsigned long long size;
+
+        bool operator==(FileStamp const &other) const {
+            return mtime == other.mtime && size == other.size;
+        }
+    };
+
+    // nullopt if path can't be stat'ed
+    ZENO_API static std::optional<FileStamp> fileStamp(std::string const &path);
+
+    ZENO_API FramePrefetcher(int depth, std::size_t memoryBudget, std::size_t nthreads);
+    ZENO_API ~FramePrefetcher();  // drops what's queued, waits for the running reads
+
+    FramePrefetcher(FramePrefetcher const &) = delete;
+    FramePrefetcher &operator=(FramePrefetcher const &) = delete;
+
+    ZENO_API static FramePrefetcher &instance();
+
+    int depth() const {
+        return m_depth;
+    }
+
+    // the object read ahead for frameid, waiting for it if it's being read; null
+    // if it wasn't or its file changed since, then the caller reads it itself
+    ZENO_API std::shared_ptr<IObject> take(std::string const &key, int frameid);
+
+    // queues frameid + 1 .. frameid + depth of the stream that aren't read yet,
+    // up to the end of the session's frame range. with file, what was read is
+    // checked against the file when it's taken
+    ZENO_API void prefetch(std::string const &key, int frameid, LoadFunc load, FileFunc file = {});
+
+    // drops every stream, e.g. when a new run starts
+    ZENO_API void cancel();
+
+    // a file sequence with the frame number in its file name: the last run of
+    // digits before the extension, reading as the frame the path is for and not
+    // part of a word (mesh_v2.obj or lod1.obj aren't sequences, mesh.0002.obj is)
+    struct FramePath {
+        std::string prefix, suffix;
+        int width;
+
+        ZENO_API std::string at(int frameid) const;
+    };
+
+    ZENO_API static std::optional<FramePath> parseFramePath(std::string const &path, int frameid);
+
+    // an explicit sequence pattern in path: $F, $F4 (padded to 4 digits) or ####
+    // (as many digits as there are #), the last one if there are several
+    ZENO_API static std::optional<FramePath> parseFramePattern(std::string const &path);
+
+    // for readers of one file per frame: the object of path, read ahead or else
+    // read now by load, and the next files of its sequence queued. a path with a
+    // frame pattern (see parseFramePattern) is expanded at frameid first, other
+    // paths are taken for a sequence when their frame number reads as the frame.
+    // reader names the calling node, what was read ahead for it is dropped as
+    // soon as it asks for another sequence (or a path that doesn't look like one)
+    ZENO_API std::shared_ptr<IObject> readSequence(std::string const &reader, std::string const &path, int frameid,
+                                                   std::function<std::shared_ptr<IObject>(std::string const &path)> load);
+
+private:
+    struct Entry {
+        std::string key;
+        int frameid;
+        LoadFunc load;
+        std::string file;
+        std::optional<FileStamp> stamp;  // of file, just before it was read
+        std::shared_ptr<IObject> obj;
+        std::size_t bytes = 0;
+        bool running = false;
+        bool done = false;
+        bool dropped = false;
+    };
+
+    int m_depth;
+    std::size_t m_budget;
+    std::size_t m_nthreads;
+    std::size_t m_bytes = 0;  // held by finished entries
+    std::map<std::pair<std::string, int>, std::shared_ptr<Entry>> m_entries;
+    std::map<std::string, std::string> m_streams;  // reader -> key of the sequence it read last
+    std::deque<std::shared_ptr<Entry>> m_queue;
+    std::vector<std::thread> m_threads;
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+    bool m_stop = false;
+
+    void drop(std::shared_ptr<Entry> const &entry);
+    void dropStream(std::string const &key);
+    void threadMain();
+};
+
+}
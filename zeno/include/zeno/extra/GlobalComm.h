@@ -21,6 +21,12 @@ struct GlobalComm {
         FRAME_BROKEN
     };
 
+    struct CacheObjectInfo {
+        std::string key;
+        std::string type;
+        size_t size = 0;
+    };
+
     struct FrameData {
         ViewObjects view_objects;
         FRAME_STATE frame_state = FRAME_UNFINISH;
@@ -41,7 +47,11 @@ struct GlobalComm {
     ZENO_API void newFrame();
     ZENO_API void finishFrame();
     ZENO_API void dumpFrameCache(int frameid, bool cacheLightCameraOnly = false, bool cacheMaterialOnly = false);
+    // move the frame's objects out for dumping elsewhere (see FrameCacheWriter)
+    ZENO_API ViewObjects takeFrameObjects(int frameid);
     ZENO_API void addViewObject(std::string const &key, std::shared_ptr<IObject> object);
+    // view object keys are `node:frame:session` (see ToView), the node part identifies a stream across frames
+    ZENO_API static std::string viewObjectChannel(std::string const &key);
     ZENO_API int maxPlayFrames();
     ZENO_API int numOfFinishedFrame();
     ZENO_API int numOfInitializedFrame();
@@ -62,6 +72,10 @@ struct GlobalComm {
     ZENO_API void removeCachePath();
     static void toDisk(std::string cachedir, int frameid, GlobalComm::ViewObjects& objs, bool cacheLightCameraOnly, bool cacheMaterialOnly, std::string fileName = "");
     static bool fromDisk(std::string cachedir, int frameid, GlobalComm::ViewObjects& objs, std::string fileName = "");
+    // read only the index of the cached frame, or only the listed objects
+    static bool listDisk(std::string cachedir, int frameid, std::vector<CacheObjectInfo>& infos, std::string fileName = "");
+    static bool fromDiskByKeys(std::string cachedir, int frameid, GlobalComm::ViewObjects& objs, std::set<std::string> const& keys, std::string fileName = "");
+    static std::shared_ptr<IObject> fromDiskByKey(std::string cachedir, int frameid, std::string const& key, std::string fileName = "");
 private:
     ViewObjects const *_getViewObjects(const int frameid);
 };
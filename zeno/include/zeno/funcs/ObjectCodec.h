@@ -4,10 +4,36 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <set>
+#include <map>
 
 namespace zeno {
 
 ZENO_API std::shared_ptr<IObject> decodeObject(const char *buf, size_t len);
 ZENO_API bool encodeObject(IObject const *object, std::vector<char> &buf);
 
+// what was last encoded (or decoded) on each channel, e.g. one channel per view object
+// across frames; primitive arrays whose content didn't change since are only referenced
+struct ObjectDeltaState {
+    std::map<std::string, std::map<std::string, uint64_t>> hashes;  // channel -> array -> content hash
+    std::map<std::string, std::shared_ptr<IObject>> bases;          // decoding side only
+    std::map<std::string, int> sinceKeyframe;                       // encoding side only
+};
+
+// storage options for primitive attribute arrays, the default is plain copies
+struct ObjectCodecOptions {
+    bool compress = false;                  // lossless: byte shuffle + lz_compress
+    std::set<std::string> quantizeAttrs;    // lossy: float attributes kept as 16 bit fixed point
+    ObjectDeltaState *delta = nullptr;      // the decoder needs a state fed with the same channel
+    std::string deltaChannel;
+    int deltaKeyframeInterval = 30;         // every Nth object of a channel is sent whole, 0 never
+};
+
+ZENO_API bool encodeObject(IObject const *object, std::vector<char> &buf, ObjectCodecOptions const &options);
+ZENO_API std::shared_ptr<IObject> decodeObject(const char *buf, size_t len, ObjectDeltaState *delta, std::string const &deltaChannel);
+
+// type tag of an encoded object without decoding it, -1 if buf is not one
+ZENO_API int encodedObjectType(const char *buf, size_t len);
+ZENO_API const char *objectTypeName(int type);
+
 }
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <zeno/utils/api.h>
+#include <filesystem>
+#include <cstddef>
+
+namespace zeno {
+
+// read-only memory mapping of a whole file, pages are loaded on demand by the OS
+// instead of being copied into a buffer up front. the file must not be rewritten
+// in place while mapped, writers should replace it by renaming a new file over it
+struct MappedFile {
+    ZENO_API MappedFile();
+    ZENO_API explicit MappedFile(std::filesystem::path const &path);
+    ZENO_API ~MappedFile();
+
+    MappedFile(MappedFile const &) = delete;
+    MappedFile &operator=(MappedFile const &) = delete;
+
+    ZENO_API bool open(std::filesystem::path const &path);
+    ZENO_API void close();
+
+    bool is_open() const {
+        return m_data != nullptr;
+    }
+
+    const char *data() const {
+        return m_data;
+    }
+
+    std::size_t size() const {
+        return m_size;
+    }
+
+private:
+    const char *m_data = nullptr;
+    std::size_t m_size = 0;
+#ifdef _WIN32
+    void *m_file = nullptr;
+    void *m_mapping = nullptr;
+#endif
+};
+
+}
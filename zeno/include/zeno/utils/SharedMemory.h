@@ -0,0 +1,18 @@
+#pragma once
+
+#include <zeno/utils/api.h>
+#include <functional>
+#include <string>
+
+namespace zeno {
+
+// hand a large buffer to another process without streaming it through a pipe:
+// the producer copies it into a fresh named shared memory block, the consumer
+// maps that block once and removes it. only POSIX shm for now, shm_publish
+// returns an empty name where unsupported so callers can fall back.
+ZENO_API std::string shm_publish(const void *data, std::size_t size);
+ZENO_API bool shm_consume(std::string const &name, std::size_t size,
+                          std::function<void(const char *data, std::size_t size)> const &func);
+ZENO_API void shm_discard(std::string const &name);
+
+}
@@ -3,6 +3,7 @@
 #include <chrono>
 #include <string>
 #include <vector>
+#include <mutex>
 #include <cassert>
 
 namespace zeno {
@@ -20,8 +21,9 @@ public:
     };
 
 private:
-    static Timer *current;
+    static thread_local Timer *current;  // nodes may be timed on pool workers
     static std::vector<Record> records;
+    static std::mutex recordsMtx;
 
     Timer *parent = nullptr;
     ClockType::time_point beg;
@@ -42,6 +44,14 @@ public:
 #define ZINC_FUNC_TIMER ::zeno::Timer _zeno_timer(__func__);
 #define ZINC_PRETTY_TIMER ::zeno::Timer _zeno_timer(__PRETTY_FUNCTION__);
 
+// times the rest of the scope as a stage of the node being applied, which is
+// reported as "Node => tag"; compiles to nothing without ZENO_BENCHMARKING
+#ifdef ZENO_BENCHMARKING
+#define ZENO_SCOPE_TIMER(tag) ::zeno::Timer _zeno_scope_timer(tag);
+#else
+#define ZENO_SCOPE_TIMER(tag)
+#endif
+
 //struct TimerAtexitHelper {
     //~TimerAtexitHelper();
 //};
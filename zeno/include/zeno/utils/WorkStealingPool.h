@@ -0,0 +1,70 @@
+#pragma once
+
+#include <zeno/utils/api.h>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <vector>
+#include <deque>
+#include <mutex>
+
+namespace zeno {
+
+// each worker owns a deque: it pops its own tasks LIFO (cache-hot, depth-first),
+// idle workers steal FIFO from the others; tasks submitted from non-worker
+// threads go to a shared injection queue
+struct WorkStealingPool {
+    using Task = std::function<void()>;
+
+    ZENO_API explicit WorkStealingPool(std::size_t nthreads = 0);
+    ZENO_API ~WorkStealingPool();
+
+    WorkStealingPool(WorkStealingPool const &) = delete;
+    WorkStealingPool &operator=(WorkStealingPool const &) = delete;
+
+    ZENO_API void submit(Task task);
+
+    // run one pending task on the calling thread, returns false if there was none
+    ZENO_API bool runOneTask();
+
+    // keep the calling thread busy with pending tasks until pred() holds,
+    // so that waiting inside a task (e.g. nested subgraphs) can't starve the pool
+    template <class Pred>
+    void helpUntil(Pred &&pred) {
+        while (!pred()) {
+            if (!runOneTask()) {
+                std::unique_lock lck(m_mtx);
+                m_cv.wait_for(lck, std::chrono::milliseconds(1), [&] {
+                    return m_pending.load() != 0;
+                });
+            }
+        }
+    }
+
+    std::size_t size() const {
+        return m_workers.size();
+    }
+
+    // shared by the whole process, thread count from $ZENO_APPLY_THREADS
+    ZENO_API static WorkStealingPool &instance();
+
+private:
+    struct Queue {
+        std::mutex mtx;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> m_queues;  // [0] is the injection queue
+    std::vector<std::thread> m_workers;
+    std::atomic<std::size_t> m_pending{0};
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+    bool m_stop = false;
+
+    bool popTask(std::size_t self, Task &task);
+    void workerMain(std::size_t self);
+};
+
+}
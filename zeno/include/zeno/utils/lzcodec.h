@@ -0,0 +1,22 @@
+#pragma once
+
+#include <zeno/utils/api.h>
+#include <cstddef>
+#include <vector>
+
+namespace zeno {
+
+// small LZ77 block codec in the spirit of LZ4: greedy hash matching, no
+// entropy stage, so both directions run at memory-bandwidth-ish speed.
+// appends the compressed form of src to out, returns the number of bytes appended
+ZENO_API std::size_t lz_compress(const void *src, std::size_t size, std::vector<char> &out);
+
+// dst must have room for exactly dstsize bytes, returns false on malformed input
+ZENO_API bool lz_decompress(const void *src, std::size_t size, void *dst, std::size_t dstsize);
+
+// byte planes of stride-sized scalars grouped together (all first bytes, then all
+// second bytes...), which makes float arrays far more compressible
+ZENO_API void byte_shuffle(const void *src, void *dst, std::size_t size, std::size_t stride);
+ZENO_API void byte_unshuffle(const void *src, void *dst, std::size_t size, std::size_t stride);
+
+}
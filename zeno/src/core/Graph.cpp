@@ -12,9 +12,15 @@
 #include <zeno/extra/GlobalStatus.h>
 #include <zeno/extra/SubnetNode.h>
 #include <zeno/extra/DirtyChecker.h>
+#include <zeno/utils/WorkStealingPool.h>
+#include <zeno/utils/envconfig.h>
 #include <zeno/utils/Error.h>
 #include <zeno/utils/log.h>
+#include <functional>
 #include <iostream>
+#include <numeric>
+#include <atomic>
+#include <vector>
 
 namespace zeno {
 
@@ -25,7 +31,10 @@ ZENO_API Context::Context(Context const &other)
     : visited(other.visited)
 {}
 
-ZENO_API Graph::Graph() = default;
+ZENO_API Graph::Graph()
+    : parallelApply(envconfig::getBool("PARALLEL_APPLY"))
+{}
+
 ZENO_API Graph::~Graph() = default;
 
 ZENO_API zany const &Graph::getNodeOutput(
@@ -80,10 +89,24 @@ ZENO_API void Graph::completeNode(std::string const &id) {
 }
 
 ZENO_API bool Graph::applyNode(std::string const &id) {
-    if (ctx->visited.find(id) != ctx->visited.end()) {
-        return false;
+    {
+        std::unique_lock lck(applyMtx);
+        if (ctx->visited.find(id) != ctx->visited.end()) {
+            // may still be running on another pool worker in parallel mode
+            applyCv.wait(lck, [&] {
+                auto it = applyingNodes.find(id);
+                return it == applyingNodes.end() || it->second == std::this_thread::get_id();
+            });
+            return false;
+        }
+        ctx->visited.insert(id);
+        applyingNodes.emplace(id, std::this_thread::get_id());
     }
-    ctx->visited.insert(id);
+    scope_exit _{[&] {
+        std::lock_guard lck(applyMtx);
+        applyingNodes.erase(id);
+        applyCv.notify_all();
+    }};
     auto node = safe_at(nodes, id, "node name").get();
     GraphException::translated([&] {
         node->doApply();
@@ -101,11 +124,179 @@ ZENO_API void Graph::applyNodes(std::set<std::string> const &ids) {
         ctx = nullptr;
     }};
 
+    if (parallelApply) {
+        applyNodesParallel(ids);
+    }
     for (auto const &id: ids) {
         applyNode(id);
     }
 }
 
+ZENO_API void Graph::applyNodesParallel(std::set<std::string> const &ids) {
+    // a node may be scheduled if it and all of its upstream can apply in parallel;
+    // only walk through nodes which are going to require all their inputs anyway
+    std::map<std::string, bool> safe;
+    std::function<bool(std::string const &)> isSafe = [&] (std::string const &id) {
+        if (auto it = safe.find(id); it != safe.end())
+            return it->second;
+        safe[id] = false;
+        auto node = safe_at(nodes, id, "node name").get();
+        bool ok = node->canApplyInParallel() && node->requiresAllInputs();
+        for (auto const &[ds, bound]: node->inputBounds) {
+            ok = isSafe(bound.first) && ok;
+        }
+        return safe[id] = ok;
+    };
+
+    std::vector<std::string> names;
+    std::map<std::string, std::size_t> index;
+    {
+        std::set<std::string> walked;
+        std::vector<std::string> stack(ids.begin(), ids.end());
+        while (!stack.empty()) {
+            auto id = std::move(stack.back());
+            stack.pop_back();
+            if (!walked.insert(id).second)
+                continue;
+            auto node = safe_at(nodes, id, "node name").get();
+            if (isSafe(id)) {
+                index.emplace(id, names.size());
+                names.push_back(id);
+            } else if (!node->requiresAllInputs()) {
+                continue;
+            }
+            for (auto const &[ds, bound]: node->inputBounds) {
+                stack.push_back(bound.first);
+            }
+        }
+    }
+    std::size_t n = names.size();
+    if (n < 2)
+        return;
+
+    std::vector<std::vector<std::size_t>> deps(n), succs(n);
+    for (std::size_t i = 0; i < n; i++) {
+        std::set<std::size_t> ups;
+        for (auto const &[ds, bound]: nodes.at(names[i])->inputBounds) {
+            ups.insert(index.at(bound.first));
+        }
+        deps[i].assign(ups.begin(), ups.end());
+        for (auto u: deps[i]) {
+            succs[u].push_back(i);
+        }
+    }
+
+    std::vector<std::size_t> order;
+    {
+        std::vector<std::size_t> indeg(n);
+        for (std::size_t i = 0; i < n; i++) {
+            indeg[i] = deps[i].size();
+            if (!indeg[i])
+                order.push_back(i);
+        }
+        for (std::size_t k = 0; k < order.size(); k++) {
+            for (auto s: succs[order[k]]) {
+                if (!--indeg[s])
+                    order.push_back(s);
+            }
+        }
+        if (order.size() != n) {
+            log_warn("cycle in graph, parallel apply disabled");
+            return;
+        }
+    }
+
+    // nodes often modify their input objects in-place, so everything downstream
+    // of a fan-out shares objects and has to be serialized into one lane
+    std::vector<std::size_t> lane(n);
+    std::iota(lane.begin(), lane.end(), 0);
+    std::function<std::size_t(std::size_t)> findLane = [&] (std::size_t i) {
+        return lane[i] == i ? i : lane[i] = findLane(lane[i]);
+    };
+    std::vector<bool> inLane(n);
+    for (auto i: order) {
+        if (succs[i].size() > 1)
+            inLane[i] = true;
+        for (auto u: deps[i]) {
+            if (inLane[u]) {
+                lane[findLane(i)] = findLane(u);
+                inLane[i] = true;
+            }
+        }
+    }
+    {
+        std::map<std::size_t, std::size_t> laneTail;
+        for (auto i: order) {
+            if (!inLane[i])
+                continue;
+            auto [it, fresh] = laneTail.try_emplace(findLane(i), i);
+            if (!fresh) {
+                if (std::find(deps[i].begin(), deps[i].end(), it->second) == deps[i].end()) {
+                    deps[i].push_back(it->second);
+                    succs[it->second].push_back(i);
+                }
+                it->second = i;
+            }
+        }
+    }
+
+    std::map<std::string, std::vector<std::string>> consumers;
+    for (auto const &[id, node]: nodes) {
+        for (auto const &[ds, bound]: node->inputBounds) {
+            consumers[bound.first].push_back(id);
+        }
+    }
+
+    log_debug("{} nodes to apply in parallel", n);
+    auto &dc = getDirtyChecker();
+    auto &pool = WorkStealingPool::instance();
+    std::vector<std::atomic<std::size_t>> pending(n);
+    for (std::size_t i = 0; i < n; i++) {
+        pending[i] = deps[i].size();
+    }
+    std::atomic<std::size_t> inflight{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr except;
+    std::mutex exceptMtx;
+
+    std::function<void(std::size_t)> launch = [&] (std::size_t i) {
+        inflight++;
+        pool.submit([&, i] {
+            try {
+                // consumers won't see us dirty through requireInput, as we're visited then
+                if (applyNode(names[i])) {
+                    if (auto it = consumers.find(names[i]); it != consumers.end()) {
+                        for (auto const &c: it->second) {
+                            dc.taintThisNode(c);
+                        }
+                    }
+                }
+            } catch (...) {
+                std::lock_guard lck(exceptMtx);
+                if (!except)
+                    except = std::current_exception();
+                failed = true;
+            }
+            if (!failed) {
+                for (auto s: succs[i]) {
+                    if (!--pending[s])
+                        launch(s);
+                }
+            }
+            inflight--;
+        });
+    };
+    for (std::size_t i = 0; i < n; i++) {
+        if (!deps[i].size())
+            launch(i);
+    }
+    pool.helpUntil([&] {
+        return inflight.load() == 0;
+    });
+    if (except)
+        std::rethrow_exception(except);
+}
+
 ZENO_API void Graph::applyNodesToExec() {
     log_debug("{} nodes to exec", nodesToExec.size());
     applyNodes(nodesToExec);
@@ -155,6 +346,11 @@ ZENO_API void Graph::setTempCache(std::string const& id)
     safe_at(nodes, id, "node name")->bTmpCache = true;
 }
 
+ZENO_API void Graph::setMemoize(std::string const& id)
+{
+    safe_at(nodes, id, "node name")->bMemoize = true;
+}
+
 ZENO_API void Graph::addNodeOutput(std::string const& id, std::string const& par) {
     // add "dynamic" output which is not descriped by core.
     safe_at(nodes, id, "node name")->outputs[par] = nullptr;
@@ -7,6 +7,7 @@
 #include <zeno/types/StringObject.h>
 #include <zeno/extra/GlobalState.h>
 #include <zeno/extra/DirtyChecker.h>
+#include <zeno/extra/FramePrefetcher.h>
 #include <zeno/extra/TempNode.h>
 #include <zeno/utils/Error.h>
 #ifdef ZENO_BENCHMARKING
@@ -17,11 +18,39 @@
 #include <zeno/extra/GlobalState.h>
 #include <filesystem>
 #include <fstream>
+#include <string_view>
 #include <zeno/extra/GlobalComm.h>
+#include <zeno/funcs/ObjectCodec.h>
 #include <zeno/types/PrimitiveObject.h>
 
 namespace zeno {
 
+namespace {
+
+template <class T>
+void hash_combine(std::size_t &seed, T const &val) {
+    seed ^= std::hash<T>{}(val) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+// a socket or parameter (`<name>:`) declared as a file the node reads
+bool isReadPath(INodeClass const *cls, std::string const &id) {
+    if (!cls || !cls->desc)
+        return false;
+    if (!id.empty() && id.back() == ':') {
+        auto name = id.substr(0, id.size() - 1);
+        for (auto const &param: cls->desc->params)
+            if (param.name == name)
+                return param.type == "readpath";
+    } else {
+        for (auto const &socket: cls->desc->inputs)
+            if (socket.name == id)
+                return socket.type == "readpath";
+    }
+    return false;
+}
+
+}
+
 ZENO_API INode::INode() = default;
 ZENO_API INode::~INode() = default;
 
@@ -132,6 +161,27 @@ ZENO_API void INode::preApply() {
         requireInput(ds);
     }
 
+    std::size_t memoKey = 0;
+    if (bMemoize) {
+        memoKey = hashInputs();
+        if (dc.isMemoized(myname, memoKey)) {
+            log_debug("==> reuse {}", myname);
+            memoHit = true;
+            return;
+        }
+        dc.forget(myname);  // don't reuse half-written outputs if apply throws
+    }
+    for (auto const &[ds, bound]: inputBounds) {
+        // nodes often modify their inputs in-place, keep memoized outputs pristine
+        auto it = inputs.find(ds);
+        if (it == inputs.end() || !it->second)
+            continue;
+        if (safe_at(graph->nodes, bound.first, "node name")->bMemoize) {
+            if (auto obj = it->second->clone())
+                it->second = std::move(obj);
+        }
+    }
+
     log_debug("==> enter {}", myname);
     {
 #ifdef ZENO_BENCHMARKING
@@ -141,9 +191,77 @@ ZENO_API void INode::preApply() {
         if (bTmpCache)
             writeTmpCaches();
     }
+    if (bMemoize)
+        dc.memorize(myname, memoKey);
     log_debug("==> leave {}", myname);
 }
 
+ZENO_API std::size_t INode::hashInputs() const {
+    // parameters are stored as `<name>:` entries of inputs, literal sockets by
+    // their plain names; both are hashed by value, bound sockets by producer
+    std::size_t seed = 0;
+    std::vector<char> buf;
+    auto hashContent = [&] (IObject *val) {
+        buf.clear();
+        if (!val || !encodeObject(val, buf))
+            return false;
+        hash_combine(seed, std::string_view(buf.data(), buf.size()));
+        return true;
+    };
+    for (auto const &[id, obj]: inputs) {
+        hash_combine(seed, id);
+        auto val = get_input(id);
+        if (auto it = inputBounds.find(id); it != inputBounds.end()) {
+            auto const &[sn, ss] = it->second;
+            hash_combine(seed, sn);
+            hash_combine(seed, ss);
+            // a memoized producer by its version rather than object identity: it
+            // changes even if the producer modified the very same object in-place,
+            // and stays the same when we were handed a clone of memoized outputs.
+            // any other producer applied again by content, so that a hit doesn't
+            // need the whole upstream chain memoized; by version if it can't be encoded
+            auto const &producer = safe_at(graph->nodes, sn, "node name");
+            if (producer->bMemoize || !hashContent(val.get()))
+                hash_combine(seed, producer->outputsVersion);
+        } else if (auto num = dynamic_cast<NumericObject *>(val.get())) {
+            // literal value, with keyframes and formulas evaluated at this frame
+            hash_combine(seed, num->value.index());
+            std::visit([&] (auto const &v) {
+                hash_combine(seed, std::string_view((char const *)&v, sizeof(v)));
+            }, num->value);
+        } else if (auto str = dynamic_cast<StringObject *>(val.get())) {
+            hash_combine(seed, str->value);
+        } else if (!hashContent(val.get())) {
+            // other parameter objects (curves, lists...) by content, a new object
+            // may well be allocated where the previous one was
+            hash_combine(seed, val.get());
+        }
+        // a file read by the node can change under the same path, or be another
+        // file each frame with a frame pattern in its path
+        if (auto str = dynamic_cast<StringObject *>(val.get()); str && isReadPath(nodeClass, id)) {
+            auto path = str->value;
+            auto fp = FramePrefetcher::parseFramePattern(path);
+            if (fp && getGlobalState()->frameid >= 0)
+                path = fp->at(getGlobalState()->frameid);
+            hash_combine(seed, path);
+            if (auto stamp = FramePrefetcher::fileStamp(path)) {
+                hash_combine(seed, stamp->mtime);
+                hash_combine(seed, stamp->size);
+            }
+        }
+    }
+    return seed;
+}
+
+ZENO_API bool INode::canApplyInParallel() const {
+    return false;
+}
+
+ZENO_API bool INode::requiresAllInputs() const {
+    // temp-cached nodes may skip their inputs entirely
+    return !bTmpCache;
+}
+
 ZENO_API bool INode::requireInput(std::string const &ds) {
     auto it = inputBounds.find(ds);
     if (it == inputBounds.end())
@@ -165,7 +283,10 @@ ZENO_API void INode::doOnlyApply() {
 ZENO_API void INode::doApply() {
     //if (checkApplyCondition()) {
     log_trace("--> enter {}", myname);
+    memoHit = false;
     preApply();
+    if (!memoHit)
+        outputsVersion++;
     log_trace("--> leave {}", myname);
     //}
 
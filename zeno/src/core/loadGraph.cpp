@@ -124,6 +124,8 @@ ZENO_API void Graph::loadGraph(const char *json) {
                 //todo: mark node data change.
             } else if (cmd == "cacheToDisk") {
                 g->setTempCache(di[1].GetString());
+            } else if (cmd == "memoizeNode") {
+                g->setMemoize(di[1].GetString());
             } else {
                 log_warn("got unexpected command: {}", cmd);
             }
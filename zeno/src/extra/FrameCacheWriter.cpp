@@ -0,0 +1,130 @@
+#include <zeno/extra/FrameCacheWriter.h>
+#include <zeno/types/PrimitiveObject.h>
+#include <zeno/types/ListObject.h>
+#include <zeno/utils/log.h>
+#include <exception>
+
+namespace zeno {
+
+namespace {
+
+template <class T0>
+std::size_t attrVectorBytes(AttrVector<T0> const &arr) {
+    std::size_t n = arr.size() * sizeof(T0);
+    arr.template foreach_attr<AttrAcceptAll>([&] (auto const &key, auto const &attr) {
+        n += attr.size() * sizeof(attr[0]);
+    });
+    return n;
+}
+
+std::size_t objectBytes(IObject const *obj) {
+    if (auto prim = dynamic_cast<PrimitiveObject const *>(obj)) {
+        return attrVectorBytes(prim->verts) + attrVectorBytes(prim->points)
+            + attrVectorBytes(prim->lines) + attrVectorBytes(prim->tris)
+            + attrVectorBytes(prim->quads) + attrVectorBytes(prim->loops)
+            + attrVectorBytes(prim->polys) + attrVectorBytes(prim->edges)
+            + attrVectorBytes(prim->uvs);
+    } else if (auto lst = dynamic_cast<ListObject const *>(obj)) {
+        std::size_t n = 0;
+        for (auto const &elm: lst->arr)
+            if (elm)
+                n += objectBytes(elm.get());
+        return n;
+    } else {
+        return sizeof(*obj);
+    }
+}
+
+}
+
+ZENO_API FrameCacheWriter::FrameCacheWriter(std::size_t memoryBudget, std::size_t nthreads)
+    : m_budget(memoryBudget) {
+    for (std::size_t i = 0; i < std::max<std::size_t>(nthreads, 1); i++)
+        m_threads.emplace_back([this] { threadMain(); });
+}
+
+ZENO_API FrameCacheWriter::~FrameCacheWriter() {
+    wait();
+    {
+        std::lock_guard lck(m_mtx);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    for (auto &th: m_threads)
+        th.join();
+}
+
+ZENO_API std::size_t FrameCacheWriter::estimateBytes(IObject const *obj) {
+    return objectBytes(obj);
+}
+
+ZENO_API std::size_t FrameCacheWriter::estimateBytes(GlobalComm::ViewObjects const &objs) {
+    std::size_t n = 0;
+    for (auto const &[key, obj]: objs)
+        if (obj)
+            n += objectBytes(obj.get());
+    return n;
+}
+
+ZENO_API void FrameCacheWriter::push(int frameid, GlobalComm::ViewObjects objs, WriteFunc write) {
+    std::size_t bytes = estimateBytes(objs);
+    std::unique_lock lck(m_mtx);
+    // a single frame larger than the whole budget still goes through, just alone
+    m_cv.wait(lck, [&] {
+        return m_inflightBytes == 0 || m_inflightBytes + bytes <= m_budget;
+    });
+    m_inflightBytes += bytes;
+    m_pending++;
+    auto &frame = m_frames.emplace_back(Frame{frameid, bytes, std::move(objs), std::move(write)});
+    m_queue.push_back(&frame);
+    log_debug("cache writer queued frame {} ({} MB in flight)", frameid, m_inflightBytes >> 20);
+    lck.unlock();
+    m_cv.notify_all();
+}
+
+ZENO_API std::vector<int> FrameCacheWriter::takeWrittenFrames() {
+    std::lock_guard lck(m_mtx);
+    std::vector<int> res;
+    while (!m_frames.empty() && m_frames.front().written) {
+        res.push_back(m_frames.front().frameid);
+        m_frames.pop_front();
+    }
+    return res;
+}
+
+ZENO_API void FrameCacheWriter::wait() {
+    std::unique_lock lck(m_mtx);
+    m_cv.wait(lck, [&] {
+        return m_pending == 0;
+    });
+}
+
+void FrameCacheWriter::threadMain() {
+    while (true) {
+        std::unique_lock lck(m_mtx);
+        m_cv.wait(lck, [&] {
+            return m_stop || !m_queue.empty();
+        });
+        if (m_queue.empty())
+            break;
+        Frame &frame = *m_queue.front();
+        m_queue.pop_front();
+        lck.unlock();
+
+        try {
+            frame.write(frame.objs);
+        } catch (std::exception const &e) {
+            log_error("failed to write cache of frame {}: {}", frame.frameid, e.what());
+        }
+        frame.objs.clear();
+
+        lck.lock();
+        frame.written = true;
+        m_inflightBytes -= frame.bytes;
+        m_pending--;
+        lck.unlock();
+        m_cv.notify_all();
+    }
+}
+
+}
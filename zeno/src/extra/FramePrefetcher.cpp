@@ -0,0 +1,315 @@
+#include <zeno/extra/FramePrefetcher.h>
+#include <zeno/extra/FrameCacheWriter.h>
+#include <zeno/extra/GlobalComm.h>
+#include <zeno/core/Session.h>
+#include <zeno/utils/envconfig.h>
+#include <zeno/utils/log.h>
+#include <algorithm>
+#include <filesystem>
+#include <exception>
+#include <climits>
+#include <cctype>
+
+namespace zeno {
+
+ZENO_API FramePrefetcher::FramePrefetcher(int depth, std::size_t memoryBudget, std::size_t nthreads)
+    : m_depth(std::max(depth, 0)), m_budget(memoryBudget), m_nthreads(std::max<std::size_t>(nthreads, 1)) {
+}
+
+ZENO_API FramePrefetcher::~FramePrefetcher() {
+    {
+        std::lock_guard lck(m_mtx);
+        m_stop = true;
+        while (!m_entries.empty())
+            drop(m_entries.begin()->second);
+        m_queue.clear();
+    }
+    m_cv.notify_all();
+    for (auto &th: m_threads)
+        th.join();
+}
+
+ZENO_API FramePrefetcher &FramePrefetcher::instance() {
+    static FramePrefetcher prefetcher(
+        envconfig::getInt("PREFETCH_FRAMES", 2),
+        (std::size_t)envconfig::getInt("PREFETCH_BUDGET", 1024) << 20,
+        envconfig::getInt("PREFETCH_THREADS", 2));
+    return prefetcher;
+}
+
+void FramePrefetcher::drop(std::shared_ptr<Entry> const &entry) {
+    m_entries.erase({entry->key, entry->frameid});
+    entry->dropped = true;
+    if (entry->done) {
+        m_bytes -= entry->bytes;
+        entry->obj = nullptr;
+    }
+}
+
+void FramePrefetcher::dropStream(std::string const &key) {
+    std::vector<std::shared_ptr<Entry>> entries;
+    for (auto it = m_entries.lower_bound({key, INT_MIN}); it != m_entries.end() && it->first.first == key; ++it)
+        entries.push_back(it->second);
+    if (!entries.empty())
+        log_debug("prefetcher dropped {} frames of [{}], its reader moved on", entries.size(), key);
+    for (auto const &entry: entries)
+        drop(entry);
+}
+
+ZENO_API std::shared_ptr<IObject> FramePrefetcher::take(std::string const &key, int frameid) {
+    std::unique_lock lck(m_mtx);
+    std::shared_ptr<Entry> found;
+    std::vector<std::shared_ptr<Entry>> stale;
+    for (auto it = m_entries.lower_bound({key, INT_MIN}); it != m_entries.end() && it->first.first == key; ++it) {
+        auto const &entry = it->second;
+        if (entry->frameid == frameid)
+            found = entry;
+        else if (entry->frameid < frameid || entry->frameid > frameid + m_depth)
+            stale.push_back(entry);
+    }
+    if (!stale.empty())
+        log_debug("prefetcher dropped {} frames of [{}] on seek to frame {}", stale.size(), key, frameid);
+    for (auto const &entry: stale)
+        drop(entry);
+    if (!found)
+        return nullptr;
+
+    // still queued, the caller is better off reading it right away
+    if (!found->running && !found->done) {
+        drop(found);
+        return nullptr;
+    }
+    m_cv.wait(lck, [&] {
+        return found->done || found->dropped;
+    });
+    auto obj = std::move(found->obj);
+    if (!found->dropped)
+        drop(found);
+    auto file = found->file;
+    auto stamp = found->stamp;
+    lck.unlock();
+
+    // rewritten since, e.g. by a simulation still writing the sequence
+    if (obj && !file.empty() && !(fileStamp(file) == stamp)) {
+        log_debug("prefetcher dropped frame {} of [{}], {} changed", frameid, key, file);
+        return nullptr;
+    }
+    return obj;
+}
+
+ZENO_API void FramePrefetcher::prefetch(std::string const &key, int frameid, LoadFunc load, FileFunc file) {
+    if (m_depth <= 0)
+        return;
+    auto [beginFrame, endFrame] = getSession().globalComm->frameRange();
+    // nothing comes after a single frame
+    if (beginFrame == endFrame)
+        return;
+    int first = std::max(frameid + 1, beginFrame);
+    int last = std::min(frameid + m_depth, endFrame);
+    {
+        std::lock_guard lck(m_mtx);
+        if (m_stop)
+            return;
+        for (int f = first; f <= last; f++) {
+            if (m_bytes >= m_budget)
+                break;
+            if (m_entries.count({key, f}))
+                continue;
+            auto entry = std::make_shared<Entry>();
+            entry->key = key;
+            entry->frameid = f;
+            entry->load = load;
+            if (file)
+                entry->file = file(f);
+            m_entries.emplace(std::make_pair(key, f), entry);
+            m_queue.push_back(std::move(entry));
+        }
+        // started on first use, most sessions never read a file sequence
+        while (m_threads.size() < m_nthreads)
+            m_threads.emplace_back([this] { threadMain(); });
+    }
+    m_cv.notify_all();
+}
+
+ZENO_API void FramePrefetcher::cancel() {
+    std::lock_guard lck(m_mtx);
+    while (!m_entries.empty())
+        drop(m_entries.begin()->second);
+    m_queue.clear();
+    m_streams.clear();
+    m_cv.notify_all();
+}
+
+void FramePrefetcher::threadMain() {
+    while (true) {
+        std::unique_lock lck(m_mtx);
+        m_cv.wait(lck, [&] {
+            return m_stop || !m_queue.empty();
+        });
+        if (m_stop)
+            break;
+        auto entry = std::move(m_queue.front());
+        m_queue.pop_front();
+        if (entry->dropped)
+            continue;
+        if (m_bytes >= m_budget) {
+            drop(entry);
+            continue;
+        }
+        entry->running = true;
+        lck.unlock();
+
+        // taken before reading, a write while it's read shows up as a change too
+        std::optional<FileStamp> stamp;
+        if (!entry->file.empty())
+            stamp = fileStamp(entry->file);
+        std::shared_ptr<IObject> obj;
+        std::size_t bytes = 0;
+        try {
+            obj = entry->load(entry->frameid, bytes);
+        } catch (std::exception const &e) {
+            // the reader will run into it again when it gets there, and report it
+            log_debug("prefetcher failed to read frame {} of [{}]: {}", entry->frameid, entry->key, e.what());
+            obj = nullptr;
+        } catch (...) {
+            obj = nullptr;
+        }
+        if (obj)
+            bytes = std::max(bytes, FrameCacheWriter::estimateBytes(obj.get()));
+
+        lck.lock();
+        entry->running = false;
+        entry->load = nullptr;
+        if (!entry->dropped) {
+            entry->obj = std::move(obj);
+            entry->stamp = stamp;
+            entry->bytes = bytes;
+            entry->done = true;
+            m_bytes += bytes;
+        }
+        lck.unlock();
+        m_cv.notify_all();
+    }
+}
+
+ZENO_API std::string FramePrefetcher::FramePath::at(int frameid) const {
+    auto num = std::to_string(frameid);
+    if (num.size() < (std::size_t)width)
+        num.insert(0, width - num.size(), '0');
+    return prefix + num + suffix;
+}
+
+ZENO_API std::optional<FramePrefetcher::FileStamp> FramePrefetcher::fileStamp(std::string const &path) {
+    std::error_code ec;
+    auto p = std::filesystem::u8path(path);
+    auto size = std::filesystem::file_size(p, ec);
+    if (ec)
+        return std::nullopt;
+    auto mtime = std::filesystem::last_write_time(p, ec);
+    if (ec)
+        return std::nullopt;
+    return FileStamp{(long long)mtime.time_since_epoch().count(), (unsigned long long)size};
+}
+
+ZENO_API std::optional<FramePrefetcher::FramePath> FramePrefetcher::parseFramePath(std::string const &path, int frameid) {
+    if (frameid < 0)
+        return std::nullopt;
+    auto frame = std::to_string(frameid);
+    std::size_t base = path.find_last_of("/\\");
+    base = base == std::string::npos ? 0 : base + 1;
+    // mesh.0002 has no extension, mesh.0002.obj has
+    std::size_t ext = path.find_last_of('.');
+    if (ext == std::string::npos || ext < base || path.find_first_not_of("0123456789", ext + 1) == std::string::npos)
+        ext = path.size();
+    // the last run of digits before the extension
+    std::size_t j = ext;
+    while (j > base && !std::isdigit((unsigned char)path[j - 1]))
+        j--;
+    if (j == base)
+        return std::nullopt;
+    std::size_t i = j;
+    while (i > base && std::isdigit((unsigned char)path[i - 1]))
+        i--;
+    // a number glued to a word names a version or a variant (mesh_v2, lod1), not a frame
+    if (i > base && std::isalpha((unsigned char)path[i - 1]))
+        return std::nullopt;
+    // the run with its leading zeros stripped has to read as the frame
+    std::size_t k = i;
+    while (k + 1 < j && path[k] == '0')
+        k++;
+    if (path.compare(k, j - k, frame) != 0)
+        return std::nullopt;
+    // only padded numbers keep their width, frame_9 goes on to frame_10
+    int width = j - i > frame.size() ? int(j - i) : 0;
+    return FramePath{path.substr(0, i), path.substr(j), width};
+}
+
+ZENO_API std::optional<FramePrefetcher::FramePath> FramePrefetcher::parseFramePattern(std::string const &path) {
+    std::optional<FramePath> ret;
+    for (std::size_t i = 0; i < path.size();) {
+        std::size_t j = i;
+        int width = 0;
+        if (path.compare(i, 2, "$F") == 0) {
+            j = i + 2;
+            while (j < path.size() && std::isdigit((unsigned char)path[j]))
+                j++;
+            // $FPS and the like are other variables
+            if (j == i + 2 && j < path.size() && (std::isalpha((unsigned char)path[j]) || path[j] == '_')) {
+                i = j;
+                continue;
+            }
+            for (std::size_t k = i + 2; k < j; k++)
+                width = std::min(width * 10 + (path[k] - '0'), 64);
+        } else if (path[i] == '#') {
+            while (j < path.size() && path[j] == '#')
+                j++;
+            width = int(j - i);
+        } else {
+            i++;
+            continue;
+        }
+        ret = FramePath{path.substr(0, i), path.substr(j), width};
+        i = j;
+    }
+    return ret;
+}
+
+ZENO_API std::shared_ptr<IObject> FramePrefetcher::readSequence(std::string const &reader, std::string const &path, int frameid,
+                                                               std::function<std::shared_ptr<IObject>(std::string const &path)> load) {
+    std::optional<FramePath> fp = parseFramePattern(path);
+    auto framePath = fp && frameid >= 0 ? fp->at(frameid) : path;
+    if (!fp && m_depth > 0)
+        fp = parseFramePath(path, frameid);
+    std::string key;
+    if (fp && m_depth > 0)
+        key = reader + '\n' + fp->prefix + '#' + std::to_string(fp->width) + fp->suffix;
+    {
+        // a number in a plain path may have matched the frame by chance (take_1.obj at
+        // frame 1), nobody would ever take what was read ahead for it
+        std::lock_guard lck(m_mtx);
+        auto &last = m_streams[reader];
+        if (last != key) {
+            dropStream(last);
+            last = key;
+        }
+    }
+    if (key.empty())
+        return load(framePath);
+    auto obj = take(key, frameid);
+    prefetch(key, frameid, [fp = *fp, load] (int frameid, std::size_t &bytes) -> std::shared_ptr<IObject> {
+        auto path = fp.at(frameid);
+        std::error_code ec;
+        auto size = std::filesystem::file_size(std::filesystem::u8path(path), ec);
+        if (ec)
+            return nullptr;
+        bytes = size;
+        return load(path);
+    }, [fp = *fp] (int frameid) {
+        return fp.at(frameid);
+    });
+    if (!obj)
+        obj = load(framePath);
+    return obj;
+}
+
+}
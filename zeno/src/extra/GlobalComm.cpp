@@ -2,10 +2,17 @@
 #include <zeno/extra/GlobalState.h>
 #include <zeno/funcs/ObjectCodec.h>
 #include <zeno/utils/log.h>
+#include <zeno/utils/MappedFile.h>
+#include <zeno/utils/envconfig.h>
+#include <zeno/utils/string.h>
 #include <filesystem>
 #include <algorithm>
 #include <fstream>
 #include <cassert>
+#include <cstring>
+#include <utility>
+#include <cctype>
+#include <string_view>
 #include <zeno/types/UserData.h>
 #include <unordered_set>
 #include <zeno/types/MaterialObject.h>
@@ -18,96 +25,278 @@
 
 namespace zeno {
 
-std::vector<std::filesystem::path> cachepath(3);
 std::unordered_set<std::string> lightCameraNodes({
     "CameraEval", "CameraNode", "CihouMayaCameraFov", "ExtractCameraData", "GetAlembicCamera","MakeCamera",
     "LightNode", "BindLight", "ProceduralSky", "HDRSky",
     });
 std::string matlNode = "ShaderFinalize";
 
-void GlobalComm::toDisk(std::string cachedir, int frameid, GlobalComm::ViewObjects &objs, bool cacheLightCameraOnly, bool cacheMaterialOnly, std::string fileName) {
-    if (cachedir.empty()) return;
-    std::filesystem::path dir = std::filesystem::u8path(cachedir + "/" + std::to_string(1000000 + frameid).substr(1));
-    if (!std::filesystem::exists(dir) && !std::filesystem::create_directories(dir))
-    {
-        log_critical("can not create path: {}", dir);
+namespace {
+
+// zencache layout, all offsets are counted from the beginning of the file:
+//   CacheFileHeader, CacheIndexEntry[count], key strings, encoded objects
+// so that a reader can pick single objects out of the index without decoding
+// the rest. legacy files have the ascii object count right after the magic,
+// then '\a'-separated keys, an offset table and the objects; still readable.
+constexpr uint32_t kCacheVersion = 3;
+
+struct CacheFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t count;
+};
+
+struct CacheIndexEntry {
+    uint64_t offset;
+    uint64_t size;
+    uint64_t keyOffset;
+    uint32_t keyLength;
+    int32_t type;   // see encodedObjectType
+};
+
+std::vector<std::filesystem::path> cacheFilePaths(std::string const &cachedir, int frameid, std::string const &fileName) {
+    auto dir = std::filesystem::u8path(cachedir) / std::to_string(1000000 + frameid).substr(1);
+    if (!fileName.empty())
+        return {dir / std::filesystem::u8path(fileName)};
+    return {dir / "lightCameraObj.zencache", dir / "materialObj.zencache", dir / "normalObj.zencache"};
+}
+
+// $ZENO_CACHE_COMPRESS=0 stores attributes uncompressed,
+// $ZENO_CACHE_QUANTIZE=clr,nrm stores the listed float attributes as lossy 16 bit
+ObjectCodecOptions cacheCodecOptions() {
+    ObjectCodecOptions options;
+    options.compress = envconfig::getBool("CACHE_COMPRESS", true);
+    for (auto const &name: split_str(envconfig::getStr("CACHE_QUANTIZE"), ','))
+        if (!name.empty())
+            options.quantizeAttrs.insert(name);
+    return options;
+}
+
+struct CacheFileWriter {
+    std::vector<CacheIndexEntry> entries;   // offsets relative to their own sections until written
+    std::string keys;
+    std::vector<char> objs;
+
+    ObjectCodecOptions const &options;
+
+    explicit CacheFileWriter(ObjectCodecOptions const &options) : options(options) {}
+
+    void add(std::string const &key, IObject const *obj) {
+        size_t offset = objs.size();
+        if (!encodeObject(obj, objs, options)) {
+            objs.resize(offset);
+            return;
+        }
+        CacheIndexEntry e{};
+        e.offset = offset;
+        e.size = objs.size() - offset;
+        e.keyOffset = keys.size();
+        e.keyLength = key.size();
+        e.type = encodedObjectType(objs.data() + offset, e.size);
+        keys.append(key);
+        entries.push_back(e);
     }
-    std::vector<std::vector<char>> bufCaches(3);
-    std::vector<std::vector<size_t>> poses(3);
-    std::vector<std::string> keys(3);
-    for (auto const &[key, obj]: objs) {
 
-        size_t bufsize =0;
-        std::string nodeName = key.substr(key.find("-") + 1, key.find(":") - key.find("-") -1);
-        if (cacheLightCameraOnly && (lightCameraNodes.count(nodeName) || obj->userData().get2<int>("isL", 0) || std::dynamic_pointer_cast<CameraObject>(obj)))
+    size_t fileSize() const {
+        return sizeof(CacheFileHeader) + entries.size() * sizeof(CacheIndexEntry) + keys.size() + objs.size();
+    }
+
+    void write(std::filesystem::path const &path) const {
+        CacheFileHeader header{};
+        std::memcpy(header.magic, "ZENCACHE", 8);
+        header.version = kCacheVersion;
+        header.count = entries.size();
+        size_t keysBase = sizeof(header) + entries.size() * sizeof(CacheIndexEntry);
+        size_t objsBase = keysBase + keys.size();
+        std::vector<CacheIndexEntry> index(entries);
+        for (auto &e: index) {
+            e.keyOffset += keysBase;
+            e.offset += objsBase;
+        }
+        // readers may have the old file mapped (CacheFileReader), rewriting it in place
+        // would hand them torn pages or SIGBUS; write aside and swap it in instead
+        auto tmppath = path;
+        tmppath += ".tmp";
         {
-            bufsize = bufCaches[0].size();
-            if (encodeObject(obj.get(), bufCaches[0]))
-            {
-                keys[0].push_back('\a');
-                keys[0].append(key);
-                poses[0].push_back(bufsize);
+            std::ofstream ofs(tmppath, std::ios::binary);
+            ofs.write((const char *)&header, sizeof(header));
+            ofs.write((const char *)index.data(), index.size() * sizeof(CacheIndexEntry));
+            ofs.write(keys.data(), keys.size());
+            ofs.write(objs.data(), objs.size());
+            if (!ofs) {
+                log_error("failed to write zeno cache file {}", tmppath);
+                ofs.close();
+                std::error_code ec;
+                std::filesystem::remove(tmppath, ec);
+                return;
             }
         }
-        if (cacheMaterialOnly && (matlNode == nodeName || std::dynamic_pointer_cast<MaterialObject>(obj)))
-        {
-            bufsize = bufCaches[1].size();
-            if (encodeObject(obj.get(), bufCaches[1]))
-            {
-                keys[1].push_back('\a');
-                keys[1].append(key);
-                poses[1].push_back(bufsize);
+        std::error_code ec;
+        std::filesystem::rename(tmppath, path, ec);
+        if (ec) {
+            log_error("failed to replace zeno cache file {}: {}", path, ec.message());
+            std::filesystem::remove(tmppath, ec);
+        }
+    }
+};
+
+// decoded objects own their arrays, each is copied out of the mapping once;
+// borrowing the mapped pages copy-on-write is not supported, AttrVector holds
+// plain std::vectors
+struct CacheFileReader {
+    struct Entry {
+        std::string_view key;
+        size_t offset;
+        size_t size;
+        int type;
+    };
+
+    MappedFile file;
+    std::vector<Entry> entries;
+
+    bool open(std::filesystem::path const &path) {
+        entries.clear();
+        if (!file.open(path)) {
+            log_error("zeno cache file does not exist");
+            return false;
+        }
+        const char *dat = file.data();
+        size_t datsize = file.size();
+        if (datsize <= 8 || std::string_view(dat, 8) != "ZENCACHE") {
+            log_error("zeno cache file broken (1)");
+            return false;
+        }
+        if (std::isdigit((unsigned char)dat[8]))
+            return openLegacy();
+
+        CacheFileHeader header;
+        if (datsize < sizeof(header)) {
+            log_error("zeno cache file broken (2)");
+            return false;
+        }
+        std::memcpy(&header, dat, sizeof(header));
+        if (header.version != kCacheVersion) {
+            log_error("unsupported zeno cache version {}", header.version);
+            return false;
+        }
+        if (header.count > (datsize - sizeof(header)) / sizeof(CacheIndexEntry)) {
+            log_error("zeno cache file broken (3)");
+            return false;
+        }
+        entries.reserve(header.count);
+        for (size_t k = 0; k < header.count; k++) {
+            CacheIndexEntry e;
+            std::memcpy(&e, dat + sizeof(header) + k * sizeof(e), sizeof(e));
+            if (e.offset > datsize || e.size > datsize - e.offset
+                || e.keyOffset > datsize || e.keyLength > datsize - e.keyOffset) {
+                log_error("zeno cache file broken (4.{})", k);
+                return false;
             }
+            entries.push_back({std::string_view(dat + e.keyOffset, e.keyLength), e.offset, e.size, e.type});
         }
-        if (!cacheLightCameraOnly && !cacheMaterialOnly)
-        {
-            if (lightCameraNodes.count(nodeName) || obj->userData().get2<int>("isL", 0) || std::dynamic_pointer_cast<CameraObject>(obj)) {
-                bufsize = bufCaches[0].size();
-                if (encodeObject(obj.get(), bufCaches[0]))
-                {
-                    keys[0].push_back('\a');
-                    keys[0].append(key);
-                    poses[0].push_back(bufsize);
-                }
-            } else if (matlNode == nodeName || std::dynamic_pointer_cast<MaterialObject>(obj)) {
-                bufsize = bufCaches[1].size();
-                if (encodeObject(obj.get(), bufCaches[1]))
-                {
-                    keys[1].push_back('\a');
-                    keys[1].append(key);
-                    poses[1].push_back(bufsize);
-                }
-            } else {
-                bufsize = bufCaches[2].size();
-                if (encodeObject(obj.get(), bufCaches[2]))
-                {
-                    keys[2].push_back('\a');
-                    keys[2].append(key);
-                    poses[2].push_back(bufsize);
-                }
+        return true;
+    }
+
+    Entry const *find(std::string_view key) const {
+        for (auto const &e: entries)
+            if (e.key == key)
+                return &e;
+        return nullptr;
+    }
+
+    std::shared_ptr<IObject> decode(Entry const &e) const {
+        auto obj = decodeObject(file.data() + e.offset, e.size);
+        if (!obj)
+            log_error("zeno cache object {} broken", e.key);
+        return obj;
+    }
+
+private:
+    bool openLegacy() {
+        const char *dat = file.data();
+        size_t datsize = file.size();
+        size_t pos = std::find(dat + 8, dat + datsize, '\a') - dat;
+        if (pos == datsize) {
+            log_error("zeno cache file broken (2)");
+            return false;
+        }
+        size_t keyscount = std::stoi(std::string(dat + 8, pos - 8));
+        pos = pos + 1;
+        std::vector<std::string_view> keys;
+        for (int k = 0; k < keyscount; k++) {
+            size_t newpos = std::find(dat + pos, dat + datsize, '\a') - dat;
+            if (newpos == datsize) {
+                log_error("zeno cache file broken (3.{})", k);
+                return false;
+            }
+            keys.emplace_back(dat + pos, newpos - pos);
+            pos = newpos + 1;
+        }
+        if ((keyscount + 1) * sizeof(size_t) > datsize - pos) {
+            log_error("zeno cache file broken (4)");
+            return false;
+        }
+        std::vector<size_t> poses(keyscount + 1);
+        std::memcpy(poses.data(), dat + pos, (keyscount + 1) * sizeof(size_t));
+        pos += (keyscount + 1) * sizeof(size_t);
+        for (int k = 0; k < keyscount; k++) {
+            if (poses[k + 1] > datsize - pos || poses[k + 1] < poses[k]) {
+                log_error("zeno cache file broken (4.{})", k);
+                return false;
             }
+            size_t size = poses[k + 1] - poses[k];
+            entries.push_back({keys[k], pos + poses[k], size, encodedObjectType(dat + pos + poses[k], size)});
         }
+        return true;
     }
+};
 
-    if (fileName == "")
+}
+
+void GlobalComm::toDisk(std::string cachedir, int frameid, GlobalComm::ViewObjects &objs, bool cacheLightCameraOnly, bool cacheMaterialOnly, std::string fileName) {
+    if (cachedir.empty()) return;
+    auto cachepath = cacheFilePaths(cachedir, frameid, fileName);
+    std::filesystem::path dir = cachepath[0].parent_path();
+    if (!std::filesystem::exists(dir) && !std::filesystem::create_directories(dir))
     {
-        cachepath[0] = dir / "lightCameraObj.zencache";
-        cachepath[1] = dir / "materialObj.zencache";
-        cachepath[2] = dir / "normalObj.zencache";
+        log_critical("can not create path: {}", dir);
     }
-    else
-    {
-        cachepath[2] = std::filesystem::u8path(dir.string() + "/" + fileName);
+    // with an explicit file name everything goes into that single file
+    ObjectCodecOptions options = cacheCodecOptions();
+    std::vector<CacheFileWriter> writers(cachepath.size(), CacheFileWriter(options));
+    for (auto const &[key, obj]: objs) {
+        if (fileName != "")
+        {
+            writers[0].add(key, obj.get());
+            continue;
+        }
+        std::string nodeName = key.substr(key.find("-") + 1, key.find(":") - key.find("-") -1);
+        bool isLightCamera = lightCameraNodes.count(nodeName) || obj->userData().get2<int>("isL", 0) || std::dynamic_pointer_cast<CameraObject>(obj);
+        bool isMaterial = matlNode == nodeName || std::dynamic_pointer_cast<MaterialObject>(obj);
+        if (cacheLightCameraOnly || cacheMaterialOnly)
+        {
+            if (cacheLightCameraOnly && isLightCamera)
+                writers[0].add(key, obj.get());
+            if (cacheMaterialOnly && isMaterial)
+                writers[1].add(key, obj.get());
+        }
+        else if (isLightCamera)
+            writers[0].add(key, obj.get());
+        else if (isMaterial)
+            writers[1].add(key, obj.get());
+        else
+            writers[2].add(key, obj.get());
     }
+
+    // files of the categories being dumped are always written, even if empty, so that stale ones get replaced
+    auto skipped = [&] (int i) {
+        return writers[i].entries.empty() && fileName == "" && (cacheLightCameraOnly && i != 0 || cacheMaterialOnly && i != 1);
+    };
     size_t currentFrameSize = 0;
-    for (int i = 0; i < 3; i++)
+    for (int i = 0; i < writers.size(); i++)
     {
-        if (poses[i].size() == 0 && (cacheLightCameraOnly && i != 0 || cacheMaterialOnly && i != 1 || fileName != "" && i != 2))
-            continue;
-        keys[i].push_back('\a');
-        keys[i] = "ZENCACHE" + std::to_string(poses[i].size()) + keys[i];
-        poses[i].push_back(bufCaches[i].size());
-        currentFrameSize += keys[i].size() + poses[i].size() * sizeof(size_t) + bufCaches[i].size();
+        if (!skipped(i))
+            currentFrameSize += writers[i].fileSize();
     }
     size_t freeSpace = 0;
     #ifdef __linux__
@@ -132,16 +321,12 @@ void GlobalComm::toDisk(std::string cachedir, int frameid, GlobalComm::ViewObjec
             freeSpace = std::filesystem::space(std::filesystem::u8path(cachedir)).free;
         #endif
     }
-    for (int i = 0; i < 3; i++)
+    for (int i = 0; i < writers.size(); i++)
     {
-        if (poses[i].size() == 0 && (cacheLightCameraOnly && i != 0 || cacheMaterialOnly && i != 1 || fileName != "" && i != 2))
+        if (skipped(i))
             continue;
         log_debug("dump cache to disk {}", cachepath[i]);
-        std::ofstream ofs(cachepath[i], std::ios::binary);
-        std::ostreambuf_iterator<char> oit(ofs);
-        std::copy(keys[i].begin(), keys[i].end(), oit);
-        std::copy_n((const char *)poses[i].data(), poses[i].size() * sizeof(size_t), oit);
-        std::copy(bufCaches[i].begin(), bufCaches[i].end(), oit);
+        writers[i].write(cachepath[i]);
     }
     objs.clear();
 }
@@ -150,73 +335,82 @@ bool GlobalComm::fromDisk(std::string cachedir, int frameid, GlobalComm::ViewObj
     if (cachedir.empty())
         return false;
     objs.clear();
-    auto dir = std::filesystem::u8path(cachedir) / std::to_string(1000000 + frameid).substr(1);
-    if (fileName == "")
-    {
-        cachepath[0] = dir / "lightCameraObj.zencache";
-        cachepath[1] = dir / "materialObj.zencache";
-        cachepath[2] = dir / "normalObj.zencache";
-    }
-    else
-    {
-        cachepath[2] = std::filesystem::u8path(dir.string() + "/" + fileName);
-    }
-
-    for (auto path : cachepath)
+    for (auto const &path : cacheFilePaths(cachedir, frameid, fileName))
     {
         if (!std::filesystem::exists(path))
         {
             continue;
         }
         log_debug("load cache from disk {}", path);
-
-        auto szBuffer = std::filesystem::file_size(path);
-        std::vector<char> dat(szBuffer);
-        FILE *fp = fopen(path.string().c_str(), "rb");
-        if (!fp) {
-            log_error("zeno cache file does not exist");
+        CacheFileReader reader;
+        if (!reader.open(path))
             return false;
+        for (auto const &e: reader.entries) {
+            auto obj = reader.decode(e);
+            if (!obj)
+                return false;
+            objs.try_emplace(std::string(e.key), std::move(obj));
         }
-        size_t ret = fread(&dat[0], 1, szBuffer, fp);
-        assert(ret == szBuffer);
-        fclose(fp);
-        fp = nullptr;
+    }
+    return true;
+}
 
-        if (dat.size() <= 8 || std::string(dat.data(), 8) != "ZENCACHE") {
-            log_error("zeno cache file broken (1)");
-            return false;
-        }
-        size_t pos = std::find(dat.begin() + 8, dat.end(), '\a') - dat.begin();
-        if (pos == dat.size()) {
-            log_error("zeno cache file broken (2)");
+bool GlobalComm::fromDiskByKeys(std::string cachedir, int frameid, GlobalComm::ViewObjects &objs, std::set<std::string> const &keys, std::string fileName) {
+    if (cachedir.empty())
+        return false;
+    objs.clear();
+    for (auto const &path : cacheFilePaths(cachedir, frameid, fileName))
+    {
+        if (!std::filesystem::exists(path))
+            continue;
+        CacheFileReader reader;
+        if (!reader.open(path))
             return false;
-        }
-        size_t keyscount = std::stoi(std::string(dat.data() + 8, pos - 8));
-        pos = pos + 1;
-        std::vector<std::string> keys;
-        for (int k = 0; k < keyscount; k++) {
-            size_t newpos = std::find(dat.begin() + pos, dat.end(), '\a') - dat.begin();
-            if (newpos == dat.size()) {
-                log_error("zeno cache file broken (3.{})", k);
+        for (auto const &e: reader.entries) {
+            if (!keys.count(std::string(e.key)))
+                continue;
+            auto obj = reader.decode(e);
+            if (!obj)
                 return false;
-            }
-            keys.emplace_back(dat.data() + pos, newpos - pos);
-            pos = newpos + 1;
-        }
-        std::vector<size_t> poses(keyscount + 1);
-        std::copy_n(dat.data() + pos, (keyscount + 1) * sizeof(size_t), (char *)poses.data());
-        pos += (keyscount + 1) * sizeof(size_t);
-        for (int k = 0; k < keyscount; k++) {
-            if (poses[k] > dat.size() - pos || poses[k + 1] < poses[k]) {
-                log_error("zeno cache file broken (4.{})", k);
-            }
-            const char *p = dat.data() + pos + poses[k];
-            objs.try_emplace(keys[k], decodeObject(p, poses[k + 1] - poses[k]));
+            objs.try_emplace(std::string(e.key), std::move(obj));
         }
     }
     return true;
 }
 
+std::shared_ptr<IObject> GlobalComm::fromDiskByKey(std::string cachedir, int frameid, std::string const &key, std::string fileName) {
+    if (cachedir.empty())
+        return nullptr;
+    for (auto const &path : cacheFilePaths(cachedir, frameid, fileName))
+    {
+        if (!std::filesystem::exists(path))
+            continue;
+        CacheFileReader reader;
+        if (!reader.open(path))
+            return nullptr;
+        if (auto e = reader.find(key))
+            return reader.decode(*e);
+    }
+    return nullptr;
+}
+
+bool GlobalComm::listDisk(std::string cachedir, int frameid, std::vector<CacheObjectInfo> &infos, std::string fileName) {
+    if (cachedir.empty())
+        return false;
+    infos.clear();
+    for (auto const &path : cacheFilePaths(cachedir, frameid, fileName))
+    {
+        if (!std::filesystem::exists(path))
+            continue;
+        CacheFileReader reader;
+        if (!reader.open(path))
+            return false;
+        for (auto const &e: reader.entries)
+            infos.push_back({std::string(e.key), objectTypeName(e.type), e.size});
+    }
+    return true;
+}
+
 ZENO_API void GlobalComm::newFrame() {
     std::lock_guard lck(m_mtx);
     log_debug("GlobalComm::newFrame {}", m_frames.size());
@@ -240,6 +434,21 @@ ZENO_API void GlobalComm::dumpFrameCache(int frameid, bool cacheLightCameraOnly,
     }
 }
 
+ZENO_API GlobalComm::ViewObjects GlobalComm::takeFrameObjects(int frameid) {
+    std::lock_guard lck(m_mtx);
+    int frameIdx = frameid - beginFrameNumber;
+    if (frameIdx < 0 || frameIdx >= m_frames.size())
+        return {};
+    return std::exchange(m_frames[frameIdx].view_objects, {});
+}
+
+ZENO_API std::string GlobalComm::viewObjectChannel(std::string const &key) {
+    auto pos = key.rfind(':');
+    if (pos != std::string::npos && pos > 0)
+        pos = key.rfind(':', pos - 1);
+    return pos == std::string::npos ? key : key.substr(0, pos);
+}
+
 ZENO_API void GlobalComm::addViewObject(std::string const &key, std::shared_ptr<IObject> object) {
     std::lock_guard lck(m_mtx);
     log_debug("GlobalComm::addViewObject {}", m_frames.size());
@@ -1,5 +1,6 @@
 #include <zeno/extra/GlobalState.h>
 #include <zeno/extra/GlobalComm.h>
+#include <zeno/extra/FramePrefetcher.h>
 #include <zeno/utils/logger.h>
 
 namespace zeno {
@@ -45,6 +46,8 @@ ZENO_API void GlobalState::clearState() {
     has_substep_executed = false;
     time_step_integrated = false;
     sessionid++;
+    // a new run may start anywhere, whatever was read ahead for the last one is stale
+    FramePrefetcher::instance().cancel();
     log_debug("entering session id={}", sessionid);
 }
 
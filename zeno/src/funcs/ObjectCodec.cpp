@@ -12,6 +12,7 @@
 #include <zeno/utils/log.h>
 #include <algorithm>
 #include <cstring>
+#include <utility>
 
 namespace zeno {
 
@@ -25,6 +26,8 @@ enum class ObjectType : int32_t {
 
 struct ObjectHeader {
     constexpr static uint32_t kMagicNumber = 0xc0febabe;
+    // primitive arrays stored packed, bump it whenever PackedArrayHeader changes
+    constexpr static uint32_t kPackedMagicNumber = 0xc0febac0;
 
     uint32_t magicNumber;
     ObjectType type;
@@ -36,6 +39,11 @@ struct ObjectHeader {
 
 namespace _implObjectCodec {
 
+thread_local ObjectCodecOptions const *encodeOptions = nullptr;
+thread_local bool decodePacked = false;
+// consumed by the first primitive coded, so that nested objects don't take part
+thread_local ObjectDeltaState *deltaState = nullptr;
+thread_local std::string const *deltaChannel = nullptr;
 
 #define _PER_OBJECT_TYPE(TypeName, ...) \
 std::shared_ptr<TypeName> decode##TypeName(const char *it); \
@@ -71,12 +79,16 @@ ZENO_XMACRO_IObject(_PER_OBJECT_TYPE)
 
 std::shared_ptr<IObject> decodeObject(const char *buf, size_t len) {
     auto &header = *(ObjectHeader *)buf;
-    if (header.magicNumber != ObjectHeader::kMagicNumber) {
+    if (header.magicNumber != ObjectHeader::kMagicNumber && header.magicNumber != ObjectHeader::kPackedMagicNumber) {
         log_error("object header magic number mismatch");
         return nullptr;
     }
 
+    bool oldPacked = std::exchange(decodePacked, header.magicNumber == ObjectHeader::kPackedMagicNumber);
     auto object = _decodeObjectImpl(buf, len);
+    decodePacked = oldPacked;
+    if (!object)
+        return nullptr;
 
     auto ptr = buf + header.beginUserData;
     for (int i = 0; i < header.numUserData; i++) {
@@ -103,7 +115,7 @@ std::shared_ptr<IObject> decodeObject(const char *buf, size_t len) {
 static bool _encodeObjectImpl(IObject const *object, std::vector<char> &buf) {
     auto it = std::back_inserter(buf);
     ObjectHeader header;
-    header.magicNumber = ObjectHeader::kMagicNumber;
+    header.magicNumber = encodeOptions ? ObjectHeader::kPackedMagicNumber : ObjectHeader::kMagicNumber;
 
     if (0) {
 
@@ -146,4 +158,51 @@ bool encodeObject(IObject const *object, std::vector<char> &buf) {
     return true;
 }
 
+bool encodeObject(IObject const *object, std::vector<char> &buf, ObjectCodecOptions const &options) {
+    bool packed = options.compress || !options.quantizeAttrs.empty() || options.delta;
+    auto oldOptions = std::exchange(encodeOptions, packed ? &options : nullptr);
+    bool isPrim = options.delta && dynamic_cast<PrimitiveObject const *>(object);
+    auto oldState = std::exchange(deltaState, isPrim ? options.delta : nullptr);
+    auto oldChannel = std::exchange(deltaChannel, isPrim ? &options.deltaChannel : nullptr);
+    bool ret = encodeObject(object, buf);
+    encodeOptions = oldOptions;
+    deltaState = oldState;
+    deltaChannel = oldChannel;
+    return ret;
+}
+
+std::shared_ptr<IObject> decodeObject(const char *buf, size_t len, ObjectDeltaState *delta, std::string const &channel) {
+    bool isPrim = delta && encodedObjectType(buf, len) == (int)ObjectType::PrimitiveObject;
+    auto oldState = std::exchange(deltaState, isPrim ? delta : nullptr);
+    auto oldChannel = std::exchange(deltaChannel, isPrim ? &channel : nullptr);
+    auto object = decodeObject(buf, len);
+    deltaState = oldState;
+    deltaChannel = oldChannel;
+    return object;
+}
+
+int encodedObjectType(const char *buf, size_t len) {
+    ObjectHeader header;
+    if (len < sizeof(header))
+        return -1;
+    std::memcpy(&header, buf, sizeof(header));
+    if (header.magicNumber != ObjectHeader::kMagicNumber && header.magicNumber != ObjectHeader::kPackedMagicNumber)
+        return -1;
+    return (int)header.type;
+}
+
+const char *objectTypeName(int type) {
+    if (0) {
+
+#define _PER_OBJECT_TYPE(TypeName, ...) \
+    } else if (type == (int)ObjectType::TypeName) { \
+        return #TypeName;
+ZENO_XMACRO_IObject(_PER_OBJECT_TYPE)
+#undef _PER_OBJECT_TYPE
+
+    } else {
+        return "";
+    }
+}
+
 }
@@ -49,7 +49,7 @@ bool encodeListObject(ListObject const *obj, std::back_insert_iterator<std::vect
         tab[i * 2 + 1] = len;
         base += len;
     }
-    std::copy_n(tab.data(), tab.size() * sizeof(size_t), it);
+    std::copy_n((char const *)tab.data(), tab.size() * sizeof(size_t), it);
     std::copy(fin.begin(), fin.end(), it);
 
     return true;
@@ -3,13 +3,25 @@
 #include <zeno/types/MaterialObject.h>
 #include <zeno/utils/variantswitch.h>
 #include <zeno/utils/log.h>
+#include <zeno/utils/lzcodec.h>
+#include <zeno/para/parallel_for.h>
 //#include <zeno/utils/zeno_p.h>
 #include <algorithm>
 #include <cstring>
+#include <atomic>
+#include <limits>
+#include <cmath>
+#include <map>
+#include <utility>
 namespace zeno {
 
 namespace _implObjectCodec {
 
+extern thread_local ObjectCodecOptions const *encodeOptions;
+extern thread_local bool decodePacked;
+extern thread_local ObjectDeltaState *deltaState;
+extern thread_local std::string const *deltaChannel;
+
 namespace {
 
 struct AttributeHeader {
@@ -24,14 +36,240 @@ struct AttrVectorHeader {
     size_t nattrs;
 };
 
+// in packed objects every array (the values and each attribute) is stored as
+// this header followed by packedSize bytes, instead of the raw elements
+enum class ArrayCodec : uint32_t {
+    Raw,
+    Lz,         // byte_shuffle by 4 then lz_compress
+    Quant16Lz,  // per component 16 bit fixed point, byte_shuffle by 2 then lz_compress
+    Ref,        // same content as the array of that name in the delta base, no payload
+};
+
+struct PackedArrayHeader {
+    ArrayCodec codec;
+    uint32_t ncomps;
+    uint64_t packedSize;
+    uint64_t hash;  // of the unpacked content, 0 when not computed
+    float lo[4];
+    float scale[4];
+};
+
+uint64_t hashBytes(const char *data, size_t size) {
+    constexpr uint64_t kMul = 0x9e3779b97f4a7c15ull;
+    uint64_t lanes[4] = {size, kMul, ~size, ~kMul};  // independent lanes keep the multiplier busy
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        for (int l = 0; l < 4; l++) {
+            uint64_t v;
+            std::memcpy(&v, data + i + l * 8, 8);
+            lanes[l] = (lanes[l] ^ v) * kMul;
+            lanes[l] ^= lanes[l] >> 29;
+        }
+    }
+    uint64_t h = lanes[0] ^ (lanes[1] * 3) ^ (lanes[2] * 5) ^ (lanes[3] * 7);
+    for (; i < size; i++)
+        h = (h ^ (unsigned char)data[i]) * kMul;
+    return h ^ (h >> 32);
+}
+
+// delta bookkeeping of the primitive being coded, arrays are named "verts", "verts.clr"...
+struct DeltaContext {
+    ObjectDeltaState *state = nullptr;
+    std::string channel;
+    std::map<std::string, uint64_t> const *oldHashes = nullptr;
+    std::map<std::string, uint64_t> newHashes;
+    std::shared_ptr<PrimitiveObject> base;  // decoding side
+
+    DeltaContext() {
+        if (!deltaChannel)
+            return;
+        state = std::exchange(deltaState, nullptr);
+        channel = *std::exchange(deltaChannel, nullptr);
+        oldHashes = &state->hashes[channel];
+        if (auto it = state->bases.find(channel); it != state->bases.end())
+            base = std::dynamic_pointer_cast<PrimitiveObject>(it->second);
+    }
+
+    bool unchanged(std::string const &name, uint64_t hash) const {
+        if (!oldHashes)
+            return false;
+        auto it = oldHashes->find(name);
+        return it != oldHashes->end() && it->second == hash;
+    }
+};
+
+template <class T>
+constexpr uint32_t floatComponents() {
+    if constexpr (std::is_same_v<T, float>) return 1;
+    else if constexpr (std::is_same_v<T, vec2f>) return 2;
+    else if constexpr (std::is_same_v<T, vec3f>) return 3;
+    else if constexpr (std::is_same_v<T, vec4f>) return 4;
+    else return 0;
+}
+
+struct PackJob {
+    std::string name;
+    const char *data;
+    size_t bytes;
+    uint32_t ncomps;  // non-zero to quantize
+    PackedArrayHeader header{};
+    std::vector<char> payload;
+
+    void pack(ObjectCodecOptions const &options, DeltaContext const &delta) {
+        if (delta.state) {
+            header.hash = hashBytes(data, bytes);
+            if (delta.unchanged(name, header.hash)) {
+                header.codec = ArrayCodec::Ref;
+                header.packedSize = 0;
+                return;
+            }
+        }
+        if (!options.compress && !ncomps) {
+            header.codec = ArrayCodec::Raw;
+            header.packedSize = bytes;
+            return;
+        }
+        const char *src = data;
+        size_t size = bytes;
+        size_t stride = 4;
+        std::vector<uint16_t> quant;
+        header.codec = ArrayCodec::Lz;
+        if (ncomps) {
+            size_t n = bytes / (sizeof(float) * ncomps);
+            auto f = (const float *)data;
+            for (uint32_t c = 0; c < ncomps; c++) {
+                float lo = std::numeric_limits<float>::max(), hi = std::numeric_limits<float>::lowest();
+                for (size_t i = 0; i < n; i++) {
+                    float x = f[i * ncomps + c];
+                    if (std::isfinite(x)) {
+                        lo = std::min(lo, x);
+                        hi = std::max(hi, x);
+                    }
+                }
+                if (lo > hi)
+                    lo = hi = 0;
+                header.lo[c] = lo;
+                header.scale[c] = (hi - lo) / 65535.f;
+            }
+            quant.resize(n * ncomps);
+            for (size_t i = 0; i < quant.size(); i++) {
+                uint32_t c = i % ncomps;
+                float s = header.scale[c];
+                float q = s > 0 ? (f[i] - header.lo[c]) / s : 0.f;
+                quant[i] = (uint16_t)std::clamp(q + 0.5f, 0.f, 65535.f);  // NaN clamps to 0
+            }
+            header.codec = ArrayCodec::Quant16Lz;
+            header.ncomps = ncomps;
+            src = (const char *)quant.data();
+            size = quant.size() * sizeof(uint16_t);
+            stride = sizeof(uint16_t);
+        }
+        std::vector<char> shuffled(size);
+        byte_shuffle(src, shuffled.data(), size, stride);
+        lz_compress(shuffled.data(), size, payload);
+        if (header.codec == ArrayCodec::Lz && payload.size() >= bytes) {
+            header.codec = ArrayCodec::Raw;  // incompressible, store as is
+            payload.clear();
+        }
+        header.packedSize = header.codec == ArrayCodec::Raw ? bytes : payload.size();
+    }
+
+    template <class It>
+    void write(It &it) const {
+        it = std::copy_n((char const *)&header, sizeof(header), it);
+        if (header.codec == ArrayCodec::Raw)
+            it = std::copy_n(data, bytes, it);
+        else if (header.codec != ArrayCodec::Ref)
+            it = std::copy_n(payload.data(), payload.size(), it);
+    }
+};
+
+struct UnpackJob {
+    PackedArrayHeader header;
+    const char *src;
+    char *dst;
+    size_t bytes;
+
+    bool unpack() const {
+        switch (header.codec) {
+        case ArrayCodec::Raw: {
+            if (header.packedSize != bytes)
+                return false;
+            std::memcpy(dst, src, bytes);
+            return true;
+        }
+        case ArrayCodec::Ref: {  // src points into the delta base, which the viewer may have touched
+            if ((!src && bytes) || hashBytes(src, bytes) != header.hash)
+                return false;
+            std::memcpy(dst, src, bytes);
+            return true;
+        }
+        case ArrayCodec::Lz: {
+            std::vector<char> shuffled(bytes);
+            if (!lz_decompress(src, header.packedSize, shuffled.data(), bytes))
+                return false;
+            byte_unshuffle(shuffled.data(), dst, bytes, 4);
+            return true;
+        }
+        case ArrayCodec::Quant16Lz: {
+            uint32_t nc = header.ncomps;
+            if (nc < 1 || nc > 4)
+                return false;
+            size_t n = bytes / sizeof(float);
+            std::vector<char> shuffled(n * sizeof(uint16_t));
+            std::vector<uint16_t> quant(n);
+            if (!lz_decompress(src, header.packedSize, shuffled.data(), shuffled.size()))
+                return false;
+            byte_unshuffle(shuffled.data(), quant.data(), shuffled.size(), sizeof(uint16_t));
+            auto f = (float *)dst;
+            for (size_t i = 0; i < n; i++)
+                f[i] = header.lo[i % nc] + quant[i] * header.scale[i % nc];
+            return true;
+        }
+        }
+        return false;
+    }
+};
+
+template <class T, class It>
+void unpackArrayLater(std::vector<T> &vec, size_t size, It &it, std::vector<UnpackJob> &jobs,
+                      std::string const &name, std::vector<T> const *baseVec, DeltaContext &delta) {
+    UnpackJob job;
+    std::copy_n(it, sizeof(job.header), (char *)&job.header);
+    it += sizeof(job.header);
+    vec.resize(size);
+    job.src = &*it;
+    job.dst = (char *)vec.data();
+    job.bytes = sizeof(T) * size;
+    if (job.header.codec == ArrayCodec::Ref) {
+        job.src = nullptr;
+        if (baseVec && baseVec->size() == size && delta.unchanged(name, job.header.hash)) {
+            job.src = (const char *)baseVec->data();
+        } else if (size) {
+            log_error("delta base of array {} missing or out of date", name);
+        }
+    }
+    if (delta.state)
+        delta.newHashes[name] = job.header.hash;
+    jobs.push_back(job);
+    it += job.header.packedSize;  // zero for Ref
+}
+
 template <class T0, class It>
-void decodeAttrVector(AttrVector<T0> &arr, It &it) {
+bool decodeAttrVector(AttrVector<T0> &arr, It &it, std::string const &name,
+                      AttrVector<T0> const *base, DeltaContext &delta) {
     AttrVectorHeader header;
     std::copy_n(it, sizeof(header), (char *)&header);
     it += sizeof(header);
-    arr.values.reserve(header.size);
-    std::copy_n((T0 const *)it, header.size, std::back_inserter(arr.values));
-    it += sizeof(T0) * header.size;
+    std::vector<UnpackJob> jobs;
+    if (decodePacked) {
+        unpackArrayLater(arr.values, header.size, it, jobs, name, base ? &base->values : nullptr, delta);
+    } else {
+        // bulk memcpy: payloads are not guaranteed to be aligned for T0 in the cache
+        arr.values.resize(header.size);
+        std::memcpy(arr.values.data(), &*it, sizeof(T0) * header.size);
+        it += sizeof(T0) * header.size;
+    }
 
     for (int a = 0; a < header.nattrs; a++) {
         AttributeHeader h;
@@ -41,23 +279,60 @@ void decodeAttrVector(AttrVector<T0> &arr, It &it) {
         index_switch<std::variant_size_v<AttrAcceptAll>>((size_t)h.type, [&] (auto type) {
             using T = std::variant_alternative_t<type.value, AttrAcceptAll>;
             auto &attr = arr.template add_attr<T>(key);
-            attr.clear();
-            attr.reserve(h.size);
-            std::copy_n((T const *)it, h.size, std::back_inserter(attr));
-            it += sizeof(T) * h.size;
+            if (decodePacked) {
+                std::vector<T> const *baseAttr = nullptr;
+                if (base)
+                    if (auto bit = base->attrs.find(key); bit != base->attrs.end())
+                        baseAttr = std::get_if<std::vector<T>>(&bit->second);
+                unpackArrayLater(attr, h.size, it, jobs, name + "." + key, baseAttr, delta);
+            } else {
+                attr.resize(h.size);
+                std::memcpy(attr.data(), &*it, sizeof(T) * h.size);
+                it += sizeof(T) * h.size;
+            }
         });
     }
+
+    // attributes are independent, decompress them all at once
+    std::atomic<bool> ok{true};
+    parallel_for(jobs.size(), [&] (size_t i) {
+        if (!jobs[i].unpack())
+            ok = false;
+    });
+    if (!ok) {
+        log_error("corrupted packed attribute data in {}", name);
+        return false;
+    }
     arr.update();
+    return true;
 }
 
 template <class T0, class It>
-void encodeAttrVector(AttrVector<T0> const &arr, It &it) {
+void encodeAttrVector(AttrVector<T0> const &arr, It &it, std::string const &name, DeltaContext &delta) {
     AttrVectorHeader header;
     header.size = arr.size();
     header.nattrs = arr.template num_attrs<AttrAcceptAll>();
     it = std::copy_n((char const *)&header, sizeof(header), it);
-    it = std::copy_n((char const *)arr.data(), sizeof(T0) * arr.size(), it);
+    if (!encodeOptions) {
+        it = std::copy_n((char const *)arr.data(), sizeof(T0) * arr.size(), it);
+
+        arr.template foreach_attr<AttrAcceptAll>([&] (auto const &key, auto const &attr) {
+            AttributeHeader h;
+            using T = std::decay_t<decltype(attr[0])>;
+            h.type = variant_index<AttrAcceptAll, T>::value;
+            h.size = attr.size();
+            h.namelen = key.size();
+            std::strncpy(h.name, key.c_str(), sizeof(h.name));
+            it = std::copy_n((char const *)&h, sizeof(h), it);
+            it = std::copy_n((char const *)attr.data(), sizeof(T) * attr.size(), it);
+        });
+        return;
+    }
 
+    // the values array (positions, topology) is never quantized
+    std::vector<AttributeHeader> headers;
+    std::vector<PackJob> jobs;
+    jobs.push_back({name, (char const *)arr.data(), sizeof(T0) * arr.size(), 0});
     arr.template foreach_attr<AttrAcceptAll>([&] (auto const &key, auto const &attr) {
         AttributeHeader h;
         using T = std::decay_t<decltype(attr[0])>;
@@ -65,9 +340,21 @@ void encodeAttrVector(AttrVector<T0> const &arr, It &it) {
         h.size = attr.size();
         h.namelen = key.size();
         std::strncpy(h.name, key.c_str(), sizeof(h.name));
-        it = std::copy_n((char const *)&h, sizeof(h), it);
-        it = std::copy_n((char const *)attr.data(), sizeof(T) * attr.size(), it);
+        headers.push_back(h);
+        uint32_t ncomps = encodeOptions->quantizeAttrs.count(key) ? floatComponents<T>() : 0;
+        jobs.push_back({name + "." + key, (char const *)attr.data(), sizeof(T) * attr.size(), ncomps});
     });
+    parallel_for(jobs.size(), [&] (size_t i) {
+        jobs[i].pack(*encodeOptions, delta);
+    });
+    if (delta.state)
+        for (auto const &job: jobs)
+            delta.newHashes[job.name] = job.header.hash;
+    jobs[0].write(it);
+    for (size_t a = 0; a < headers.size(); a++) {
+        it = std::copy_n((char const *)&headers[a], sizeof(headers[a]), it);
+        jobs[a + 1].write(it);
+    }
 }
 
 }
@@ -75,33 +362,59 @@ void encodeAttrVector(AttrVector<T0> const &arr, It &it) {
 std::shared_ptr<PrimitiveObject> decodePrimitiveObject(const char *it);
 std::shared_ptr<PrimitiveObject> decodePrimitiveObject(const char *it) {
     auto obj = std::make_shared<PrimitiveObject>();
-    decodeAttrVector(obj->verts, it);
-    decodeAttrVector(obj->points, it);
-    decodeAttrVector(obj->lines, it);
-    decodeAttrVector(obj->tris, it);
-    decodeAttrVector(obj->quads, it);
-    decodeAttrVector(obj->loops, it);
-    decodeAttrVector(obj->polys, it);
-    decodeAttrVector(obj->edges, it);
-    decodeAttrVector(obj->uvs, it);
+    DeltaContext delta;
+    auto base = delta.base.get();
+    bool ok = decodeAttrVector(obj->verts, it, "verts", base ? &base->verts : nullptr, delta)
+        && decodeAttrVector(obj->points, it, "points", base ? &base->points : nullptr, delta)
+        && decodeAttrVector(obj->lines, it, "lines", base ? &base->lines : nullptr, delta)
+        && decodeAttrVector(obj->tris, it, "tris", base ? &base->tris : nullptr, delta)
+        && decodeAttrVector(obj->quads, it, "quads", base ? &base->quads : nullptr, delta)
+        && decodeAttrVector(obj->loops, it, "loops", base ? &base->loops : nullptr, delta)
+        && decodeAttrVector(obj->polys, it, "polys", base ? &base->polys : nullptr, delta)
+        && decodeAttrVector(obj->edges, it, "edges", base ? &base->edges : nullptr, delta)
+        && decodeAttrVector(obj->uvs, it, "uvs", base ? &base->uvs : nullptr, delta);
+    if (!ok) {  // a half decoded primitive is worse than none
+        // and later frames must not build on it; the references the encoder keeps
+        // sending are refused too, until its next keyframe sends the channel whole
+        if (delta.state) {
+            delta.state->hashes.erase(delta.channel);
+            delta.state->bases.erase(delta.channel);
+        }
+        return nullptr;
+    }
     if (*it++ == '1') {
         obj->mtl = std::make_shared<MaterialObject>();
         obj->mtl->deserialize(it);
     }
+    if (delta.state) {
+        delta.state->hashes[delta.channel] = std::move(delta.newHashes);
+        delta.state->bases[delta.channel] = obj;
+    }
     return obj;
 }
 
 bool encodePrimitiveObject(PrimitiveObject const *obj, std::back_insert_iterator<std::vector<char>> it);
 bool encodePrimitiveObject(PrimitiveObject const *obj, std::back_insert_iterator<std::vector<char>> it) {
-    encodeAttrVector(obj->verts, it);
-    encodeAttrVector(obj->points, it);
-    encodeAttrVector(obj->lines, it);
-    encodeAttrVector(obj->tris, it);
-    encodeAttrVector(obj->quads, it);
-    encodeAttrVector(obj->loops, it);
-    encodeAttrVector(obj->polys, it);
-    encodeAttrVector(obj->edges, it);
-    encodeAttrVector(obj->uvs, it);
+    DeltaContext delta;
+    // there is no way back to tell that the decoder dropped its base, so every so
+    // often nothing is sent as a reference and a decoder that lost track recovers
+    if (delta.state) {
+        int &since = delta.state->sinceKeyframe[delta.channel];
+        int interval = encodeOptions->deltaKeyframeInterval;
+        if (interval > 0 && ++since >= interval) {
+            since = 0;
+            delta.oldHashes = nullptr;
+        }
+    }
+    encodeAttrVector(obj->verts, it, "verts", delta);
+    encodeAttrVector(obj->points, it, "points", delta);
+    encodeAttrVector(obj->lines, it, "lines", delta);
+    encodeAttrVector(obj->tris, it, "tris", delta);
+    encodeAttrVector(obj->quads, it, "quads", delta);
+    encodeAttrVector(obj->loops, it, "loops", delta);
+    encodeAttrVector(obj->polys, it, "polys", delta);
+    encodeAttrVector(obj->edges, it, "edges", delta);
+    encodeAttrVector(obj->uvs, it, "uvs", delta);
     if (obj->mtl) {
         *it++ = '1';
         for (char c: obj->mtl->serialize())
@@ -109,6 +422,8 @@ bool encodePrimitiveObject(PrimitiveObject const *obj, std::back_insert_iterator
     } else {
         *it++ = '0';
     }
+    if (delta.state)
+        delta.state->hashes[delta.channel] = std::move(delta.newHashes);
     return true;
 }
 
@@ -12,6 +12,10 @@ namespace zeno {
 struct CachedByKey : zeno::INode {
     std::map<std::string, std::shared_ptr<IObject>> cache;
 
+    virtual bool requiresAllInputs() const override {
+        return false;
+    }
+
     virtual void preApply() override {
         requireInput("key");
         auto key = get_input<zeno::StringObject>("key")->get();
@@ -40,6 +44,10 @@ ZENDEFNODE(CachedByKey, {
 struct CachedIf : zeno::INode {
     bool m_done = false;
 
+    virtual bool requiresAllInputs() const override {
+        return false;
+    }
+
     virtual void preApply() override {
         if (has_input("keepCache")) {
             requireInput("keepCache");
@@ -71,6 +79,10 @@ ZENDEFNODE(CachedIf, {
 struct CachedOnce : zeno::INode {
     bool m_done = false;
 
+    virtual bool requiresAllInputs() const override {
+        return false;
+    }
+
     virtual void preApply() override {
         if (!m_done) {
             INode::preApply();
@@ -32,6 +32,11 @@ public:
         update();
     }
 
+    // loop body nodes downstream must be re-evaluated in each iteration's context
+    virtual bool requiresAllInputs() const override {
+        return false;
+    }
+
     virtual void apply() override final {
         //if (!m_updated)
             //throw makeError("BeginFor and EndFor not enclosed! "
@@ -323,6 +328,10 @@ ZENDEFNODE(SubstepDt, {
 
 
 struct IfElse : zeno::INode {
+    virtual bool requiresAllInputs() const override {
+        return false;
+    }
+
     virtual void preApply() override {
         requireInput("cond");
         auto cond = get_input("cond");
@@ -8,6 +8,10 @@ namespace zeno {
 namespace {
 
 struct FuncBegin : zeno::INode {
+    virtual bool requiresAllInputs() const override {
+        return false;
+    }
+
     virtual void apply() override {
         set_output("FUNC", std::make_shared<zeno::DummyObject>());
     }
@@ -77,6 +81,10 @@ ZENDEFNODE(FuncEnd, {
 });
 
 struct FuncSimpleBegin : zeno::INode {
+    virtual bool requiresAllInputs() const override {
+        return false;
+    }
+
     virtual void apply() override {
         set_output("FUNC", std::make_shared<zeno::DummyObject>());
     }
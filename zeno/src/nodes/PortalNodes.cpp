@@ -9,6 +9,10 @@
 namespace zeno {
 
 struct PortalIn : zeno::INode {
+    virtual bool requiresAllInputs() const override {
+        return false;
+    }
+
     virtual void complete() override {
         auto name = get_param<std::string>("name");
         graph->portalIns[name] = this->myname;
@@ -17,6 +21,7 @@ struct PortalIn : zeno::INode {
     virtual void apply() override {
         auto name = get_param<std::string>("name");
         auto obj = get_input("port");
+        std::lock_guard lck(graph->applyMtx);  // wrangles may refer portals from pool workers
         graph->portals[name] = std::move(obj);
     }
 };
@@ -29,11 +34,17 @@ ZENDEFNODE(PortalIn, {
 });
 
 struct PortalOut : zeno::INode {
+    virtual bool requiresAllInputs() const override {
+        return false;
+    }
+
     virtual void apply() override {
         auto name = get_param<std::string>("name");
         auto depnode = zeno::safe_at(graph->portalIns, name, "PortalIn");
         graph->applyNode(depnode);
+        std::unique_lock lck(graph->applyMtx);
         auto obj = zeno::safe_at(graph->portals, name, "portal object");
+        lck.unlock();
         set_output("port", std::move(obj));
     }
 };
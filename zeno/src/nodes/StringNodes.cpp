@@ -15,6 +15,10 @@ namespace zeno {
 namespace {
 
 struct MakeWritePath : zeno::INode {
+    virtual bool canApplyInParallel() const override {
+        return true;
+    }
+
     virtual void apply() override {
         auto obj = std::make_unique<zeno::StringObject>();
         obj->set(get_param<std::string>("path"));
@@ -30,6 +34,10 @@ ZENDEFNODE(MakeWritePath, {
 });
 
 struct MakeReadPath : zeno::INode {
+    virtual bool canApplyInParallel() const override {
+        return true;
+    }
+
     virtual void apply() override {
         auto obj = std::make_unique<zeno::StringObject>();
         obj->set(get_param<std::string>("path"));
@@ -45,6 +53,10 @@ ZENDEFNODE(MakeReadPath, {
 });
 
 struct MakeString : zeno::INode {
+    virtual bool canApplyInParallel() const override {
+        return true;
+    }
+
     virtual void apply() override {
         auto obj = std::make_unique<zeno::StringObject>();
         obj->set(get_param<std::string>("value"));
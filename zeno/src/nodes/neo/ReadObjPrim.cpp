@@ -1,9 +1,12 @@
 #include <zeno/zeno.h>
+#include <zeno/extra/GlobalState.h>
+#include <zeno/extra/FramePrefetcher.h>
 #include <zeno/types/PrimitiveObject.h>
 #include <zeno/funcs/PrimitiveUtils.h>
 #include <zeno/types/StringObject.h>
 #include <zeno/utils/string.h>
 #include <zeno/utils/fileio.h>
+#include <zeno/utils/MappedFile.h>
 #include <zeno/utils/logger.h>
 #include <zeno/utils/vec.h>
 #include <string_view>
@@ -12,7 +15,10 @@
 #include <cstdlib>
 #include <cassert>
 #include <cstdio>
-#include <fstream>
+#include <charconv>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
 
 namespace zeno {
 namespace {
@@ -28,92 +34,185 @@ static bool match_helper(char const *&it, char const *arr, std::index_sequence<I
 }
 
 template <std::size_t N>
-static bool match(char const *&it, char const (&arr)[N]) {
-    return match_helper(it, arr, std::make_index_sequence<N - 1>{});
+static bool match(char const *&it, char const *eit, char const (&arr)[N]) {
+    return eit - it >= std::ptrdiff_t(N - 1) && match_helper(it, arr, std::make_index_sequence<N - 1>{});
 }
 
-static float takef(char const *&it) {
-    char *eptr;
-    float val = std::strtof(it, &eptr);
-    it = eptr;
-    return val;
+static void skip_blanks(char const *&it, char const *eit) {
+    while (it != eit && (*it == ' ' || *it == '\t'))
+        ++it;
 }
 
-static int takeu(char const *&it) {
+// like strtof, but stops at the end of the line and doesn't depend on the locale
+static float takef(char const *&it, char const *eit) {
+    char const *p = it;
+    skip_blanks(p, eit);
+    if (p != eit && *p == '+')
+        ++p;
+#if defined(__cpp_lib_to_chars)
+    float val = 0;
+    auto [ptr, ec] = std::from_chars(p, eit, val);
+    if (ec == std::errc::invalid_argument)
+        return 0;
+    it = ptr;
+    return val;
+#else
+    char buf[64];
+    std::size_t n = std::min<std::size_t>(eit - p, sizeof(buf) - 1);
+    std::memcpy(buf, p, n);
+    buf[n] = '\0';
     char *eptr;
-    int val(std::strtoul(it, &eptr, 10));
-    it = eptr;
+    float val = std::strtof(buf, &eptr);
+    if (eptr != buf)
+        it = p + (eptr - buf);
     return val;
+#endif
 }
 
-// std::shared_ptr<PrimitiveObject> parse_obj(std::vector<char> &&bin) 
-PrimitiveObject* parse_obj(const char *binData, std::size_t binSize) {
-    /*bin.resize(bin.size() + 8, '\0');*/
-
-    char const *it = binData;
-    char const *eit = binData + binSize;// - 8;
+// like strtoul, but stops at the end of the line
+static int takeu(char const *&it, char const *eit) {
+    char const *p = it;
+    skip_blanks(p, eit);
+    bool neg = false;
+    if (p != eit && (*p == '-' || *p == '+'))
+        neg = *p++ == '-';
+    if (p == eit || *p < '0' || *p > '9')
+        return 0;
+    unsigned long val = 0;
+    while (p != eit && *p >= '0' && *p <= '9')
+        val = val * 10 + (*p++ - '0');
+    it = p;
+    return int(neg ? -val : val);
+}
 
-    // auto prim = std::make_shared<PrimitiveObject>();
-    auto prim = new PrimitiveObject;
+// the elements of a run of whole lines, polys start from the run's first loop
+struct ObjChunk {
+    std::vector<vec3f> verts;
+    std::vector<vec2f> uvs;
+    std::vector<int> loops;
     std::vector<int> loop_uvs;
+    std::vector<vec2i> polys;
+    std::vector<vec2i> lines;
+};
 
+static void parse_obj_lines(char const *it, char const *eit, ObjChunk &chunk) {
     while (it < eit) {
         auto nit = std::find(it, eit, '\n');
         auto nnit = nit + 1;
-        if (nit[-1] == '\r')
+        if (nit != it && nit[-1] == '\r')
             --nit;
 
-        if (match(it, "v ")) {
-            float x = takef(it);
-            float y = takef(it);
-            float z = takef(it);
-            prim->verts.emplace_back(x, y, z);
+        if (match(it, nit, "v ")) {
+            float x = takef(it, nit);
+            float y = takef(it, nit);
+            float z = takef(it, nit);
+            chunk.verts.emplace_back(x, y, z);
 
-        } else if (match(it, "vt ")) {
-            float x = takef(it);
-            float y = takef(it);
-            prim->uvs.emplace_back(x, y);
+        } else if (match(it, nit, "vt ")) {
+            float x = takef(it, nit);
+            float y = takef(it, nit);
+            chunk.uvs.emplace_back(x, y);
 
-        } else if (match(it, "f ")) {
-            int beg = prim->loops.size();
+        } else if (match(it, nit, "f ")) {
+            int beg = chunk.loops.size();
             int cnt{};
             while (it != nit) {
-                int x = takeu(it) - 1;
-                if (*it == '/' && it[1] != '/') {
+                int x = takeu(it, nit) - 1;
+                if (it != nit && *it == '/' && it + 1 != nit && it[1] != '/') {
                     ++it;
-                    int xt = takeu(it) - 1;
-                    loop_uvs.push_back(xt);
+                    int xt = takeu(it, nit) - 1;
+                    chunk.loop_uvs.push_back(xt);
                 }
                 it = std::find(it, nit, ' ');
-                prim->loops.push_back(x);
+                chunk.loops.push_back(x);
                 ++cnt;
                 it = std::find_if(it, nit, [] (char c) { return c != ' '; });
             }
-            prim->polys.emplace_back(beg, cnt);
+            chunk.polys.emplace_back(beg, cnt);
 
-        } else if (match(it, "l ")) {
-            int x = takeu(it) - 1;
-            int y = takeu(it) - 1;
-            prim->lines.emplace_back(x, y);
+        } else if (match(it, nit, "l ")) {
+            int x = takeu(it, nit) - 1;
+            int y = takeu(it, nit) - 1;
+            chunk.lines.emplace_back(x, y);
 
-        //} else if (match(it, "o ")) {
+        //} else if (match(it, nit, "o ")) {
             // todo: support tag verts to be multi components of primitive
             //std::string_view o_name(it, nit - it);
 
         }
         it = nnit;
     }
+}
+
+// concatenates the arrays of every chunk into dst, in chunk order
+template <class T, class Member>
+static void gather_chunks(std::vector<ObjChunk> const &chunks, Member member, std::vector<T> &dst, std::vector<std::size_t> &offsets) {
+    offsets.assign(chunks.size() + 1, 0);
+    for (std::size_t c = 0; c < chunks.size(); c++)
+        offsets[c + 1] = offsets[c] + (chunks[c].*member).size();
+    dst.resize(offsets.back());
+#pragma omp parallel for
+    for (int c = 0; c < (int)chunks.size(); c++)
+        std::copy((chunks[c].*member).begin(), (chunks[c].*member).end(), dst.begin() + offsets[c]);
+}
+
+// std::shared_ptr<PrimitiveObject> parse_obj(std::vector<char> &&bin) 
+// the file is cut into chunks of whole lines that are parsed in parallel, then
+// merged in file order, so the result is the same as parsing it line by line
+PrimitiveObject* parse_obj(const char *binData, std::size_t binSize) {
+    char const *it = binData;
+    char const *eit = binData + binSize;
+
+#if defined(_OPENMP)
+    std::size_t nthreads = omp_get_max_threads();
+#else
+    std::size_t nthreads = 1;
+#endif
+    // a few chunks per thread even out the sections with long face lines
+    std::size_t nchunks = std::max<std::size_t>(1, std::min(nthreads * 4, binSize >> 20));
+    std::vector<char const *> bounds(nchunks + 1, eit);
+    bounds[0] = it;
+    for (std::size_t c = 1; c < nchunks; c++) {
+        char const *p = std::max(bounds[c - 1], binData + binSize / nchunks * c);
+        p = std::find(p, eit, '\n');
+        bounds[c] = p == eit ? eit : p + 1;
+    }
+
+    std::vector<ObjChunk> chunks(nchunks);
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int c = 0; c < (int)nchunks; c++)
+        parse_obj_lines(bounds[c], bounds[c + 1], chunks[c]);
+
+    // auto prim = std::make_shared<PrimitiveObject>();
+    auto prim = new PrimitiveObject;
+    std::vector<int> loop_uvs;
+    std::vector<std::size_t> offsets, loopOffsets;
+    gather_chunks(chunks, &ObjChunk::verts, prim->verts.values, offsets);
+    gather_chunks(chunks, &ObjChunk::uvs, prim->uvs.values, offsets);
+    gather_chunks(chunks, &ObjChunk::lines, prim->lines.values, offsets);
+    gather_chunks(chunks, &ObjChunk::loop_uvs, loop_uvs, offsets);
+    gather_chunks(chunks, &ObjChunk::loops, prim->loops.values, loopOffsets);
+    gather_chunks(chunks, &ObjChunk::polys, prim->polys.values, offsets);
+#pragma omp parallel for
+    for (int c = 0; c < (int)nchunks; c++) {
+        for (std::size_t i = offsets[c]; i < offsets[c + 1]; i++)
+            prim->polys.values[i][0] += loopOffsets[c];
+    }
+    chunks.clear();
 
     {
         int vert_count = prim->verts.size();
-        for (auto &i : prim->loops) {
-            if (i < 0) {
-                i += vert_count + 1;
+        auto &loops = prim->loops.values;
+#pragma omp parallel for
+        for (std::intptr_t i = 0; i < (std::intptr_t)loops.size(); i++) {
+            if (loops[i] < 0) {
+                loops[i] += vert_count + 1;
             }
         }
-        for (auto &i : loop_uvs) {
-            if (i < 0) {
-                i += vert_count + 1;
+#pragma omp parallel for
+        for (std::intptr_t i = 0; i < (std::intptr_t)loop_uvs.size(); i++) {
+            if (loop_uvs[i] < 0) {
+                loop_uvs[i] += vert_count + 1;
             }
         }
     }
@@ -126,17 +225,25 @@ PrimitiveObject* parse_obj(const char *binData, std::size_t binSize) {
 }
 
 struct ReadObjPrim : INode {
+    virtual bool canApplyInParallel() const override {
+        return true;
+    }
+
     virtual void apply() override {
         auto path = get_input2<std::string>("path");
-        std::string native_path = std::filesystem::u8path(path).string();
-        std::ifstream file(native_path, std::ios::binary);
-        auto binary = std::vector<char>((std::istreambuf_iterator<char>(file)),
-                              std::istreambuf_iterator<char>());
-        // auto prim = parse_obj(std::move(binary));
-        auto prim = std::shared_ptr<PrimitiveObject>(parse_obj(binary.data(), binary.size()));
-        if (get_param<bool>("triangulate")) {
-            primTriangulate(prim.get());
-        }
+        bool triangulate = get_param<bool>("triangulate");
+        // the files of the next frames are parsed in the background when path is a sequence
+        auto prim = std::static_pointer_cast<PrimitiveObject>(FramePrefetcher::instance().readSequence(
+            zeno::format("ReadObjPrim:{}:{}", myname, triangulate), path, getGlobalState()->frameid,
+            [triangulate] (std::string const &path) -> std::shared_ptr<IObject> {
+            // mapped rather than read into a buffer, the parser threads fault the pages in
+            MappedFile file(std::filesystem::u8path(path));
+            auto prim = std::shared_ptr<PrimitiveObject>(parse_obj(file.data(), file.size()));
+            if (triangulate) {
+                primTriangulate(prim.get());
+            }
+            return prim;
+        }));
         set_output("prim", std::move(prim));
     }
 };
@@ -153,17 +260,27 @@ ZENDEFNODE(ReadObjPrim,
         }});
 
 struct MustReadObjPrim : INode {
+    virtual bool canApplyInParallel() const override {
+        return true;
+    }
+
     virtual void apply() override {
         auto path = get_input2<std::string>("path");
-        auto binary = file_get_binary<std::vector<char>>(path);
-        if (binary.empty()) {
-            auto s = zeno::format("can not find {}", path);
-            throw zeno::makeError(s);
-        }
-        auto prim = std::shared_ptr<PrimitiveObject>(parse_obj(binary.data(), binary.size()));
-        if (get_param<bool>("triangulate")) {
-            primTriangulate(prim.get());
-        }
+        bool triangulate = get_param<bool>("triangulate");
+        auto prim = std::static_pointer_cast<PrimitiveObject>(FramePrefetcher::instance().readSequence(
+            zeno::format("ReadObjPrim:{}:{}", myname, triangulate), path, getGlobalState()->frameid,
+            [triangulate] (std::string const &path) -> std::shared_ptr<IObject> {
+            MappedFile file(std::filesystem::u8path(path));
+            if (!file.is_open()) {
+                auto s = zeno::format("can not find {}", path);
+                throw zeno::makeError(s);
+            }
+            auto prim = std::shared_ptr<PrimitiveObject>(parse_obj(file.data(), file.size()));
+            if (triangulate) {
+                primTriangulate(prim.get());
+            }
+            return prim;
+        }));
         set_output("prim", std::move(prim));
     }
 };
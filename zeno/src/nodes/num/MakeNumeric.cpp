@@ -4,6 +4,10 @@
 namespace {
 
 struct NumericInt : zeno::INode {
+    virtual bool canApplyInParallel() const override {
+        return true;
+    }
+
     virtual void apply() override {
         auto obj = std::make_unique<zeno::NumericObject>();
         obj->set(get_param<int>("value"));
@@ -20,6 +24,10 @@ ZENDEFNODE(NumericInt, {
 
 
 struct NumericIntVec2 : zeno::INode {
+    virtual bool canApplyInParallel() const override {
+        return true;
+    }
+
     virtual void apply() override {
         auto obj = std::make_unique<zeno::NumericObject>();
         auto x = get_param<int>("x");
@@ -56,6 +64,10 @@ ZENDEFNODE(PackNumericIntVec2, {
 
 
 struct NumericIntVec3 : zeno::INode {
+    virtual bool canApplyInParallel() const override {
+        return true;
+    }
+
     virtual void apply() override {
         auto obj = std::make_unique<zeno::NumericObject>();
         auto x = get_param<int>("x");
@@ -75,6 +87,10 @@ ZENDEFNODE(NumericIntVec3, {
 
 
 struct NumericIntVec4 : zeno::INode {
+    virtual bool canApplyInParallel() const override {
+        return true;
+    }
+
     virtual void apply() override {
         auto obj = std::make_unique<zeno::NumericObject>();
         auto x = get_param<int>("x");
@@ -96,6 +112,10 @@ ZENDEFNODE(NumericIntVec4, {
 
 
 struct NumericFloat : zeno::INode {
+    virtual bool canApplyInParallel() const override {
+        return true;
+    }
+
     virtual void apply() override {
         auto obj = std::make_unique<zeno::NumericObject>();
         obj->set(get_param<float>("value"));
@@ -112,6 +132,10 @@ ZENDEFNODE(NumericFloat, {
 
 
 struct NumericVec2 : zeno::INode {
+    virtual bool canApplyInParallel() const override {
+        return true;
+    }
+
     virtual void apply() override {
         auto obj = std::make_unique<zeno::NumericObject>();
         auto x = get_param<float>("x");
@@ -130,6 +154,10 @@ ZENDEFNODE(NumericVec2, {
 
 
 struct NumericVec3 : zeno::INode {
+    virtual bool canApplyInParallel() const override {
+        return true;
+    }
+
     virtual void apply() override {
         auto obj = std::make_unique<zeno::NumericObject>();
         auto x = get_param<float>("x");
@@ -150,6 +178,10 @@ ZENDEFNODE(NumericVec3, {
 
 
 struct NumericVec4 : zeno::INode {
+    virtual bool canApplyInParallel() const override {
+        return true;
+    }
+
     virtual void apply() override {
         auto obj = std::make_unique<zeno::NumericObject>();
         auto x = get_param<float>("x");
@@ -1,4 +1,6 @@
 #include <zeno/zeno.h>
+#include <zeno/extra/GlobalState.h>
+#include <zeno/extra/FramePrefetcher.h>
 #include <zeno/types/PrimitiveObject.h>
 #include <zeno/types/PrimitiveIO.h>
 #include <zeno/types/StringObject.h>
@@ -31,10 +33,18 @@ ZENDEFNODE(ExportZpmPrimitive,
 
 
 struct ImportZpmPrimitive : zeno::INode {
+  virtual bool canApplyInParallel() const override {
+    return true;
+  }
+
   virtual void apply() override {
     auto path = get_input<StringObject>("path");
-    auto prim = std::make_shared<PrimitiveObject>();
-    readzpm(prim.get(), path->get().c_str());
+    auto prim = FramePrefetcher::instance().readSequence("ImportZpmPrimitive:" + myname, path->get(), getGlobalState()->frameid,
+        [] (std::string const &path) -> std::shared_ptr<IObject> {
+      auto prim = std::make_shared<PrimitiveObject>();
+      readzpm(prim.get(), path.c_str());
+      return prim;
+    });
     set_output("prim", std::move(prim));
   }
 };
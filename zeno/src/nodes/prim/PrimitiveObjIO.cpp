@@ -92,6 +92,10 @@ void read_obj_file(
 
 
 struct ReadObjPrimitive : zeno::INode {
+    virtual bool canApplyInParallel() const override {
+        return true;
+    }
+
     virtual void apply() override {
         auto path = get_input<zeno::StringObject>("path")->get();
         auto prim = std::make_shared<zeno::PrimitiveObject>();
@@ -312,6 +316,10 @@ read_obj_file_dict(
     return prims;
 }
 struct ReadObjPrimitiveDict : zeno::INode {
+    virtual bool canApplyInParallel() const override {
+        return true;
+    }
+
     virtual void apply() override {
         auto path = get_input<zeno::StringObject>("path")->get();
         auto prim = std::make_shared<zeno::PrimitiveObject>();
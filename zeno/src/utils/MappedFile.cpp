@@ -0,0 +1,85 @@
+#include <zeno/utils/MappedFile.h>
+#ifdef _WIN32
+#include <zeno/utils/fuck_win.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace zeno {
+
+ZENO_API MappedFile::MappedFile() = default;
+
+ZENO_API MappedFile::MappedFile(std::filesystem::path const &path) {
+    open(path);
+}
+
+ZENO_API MappedFile::~MappedFile() {
+    close();
+}
+
+ZENO_API bool MappedFile::open(std::filesystem::path const &path) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    void *ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!ptr) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    m_file = file;
+    m_mapping = mapping;
+    m_data = (const char *)ptr;
+    m_size = (std::size_t)size.QuadPart;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    void *ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // the mapping keeps its own reference to the file
+    if (ptr == MAP_FAILED)
+        return false;
+    madvise(ptr, st.st_size, MADV_SEQUENTIAL);
+    m_data = (const char *)ptr;
+    m_size = (std::size_t)st.st_size;
+#endif
+    return true;
+}
+
+ZENO_API void MappedFile::close() {
+    if (!m_data)
+        return;
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mapping);
+    CloseHandle(m_file);
+    m_mapping = m_file = nullptr;
+#else
+    munmap((void *)m_data, m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+}
+
+}
@@ -0,0 +1,88 @@
+#include <zeno/utils/SharedMemory.h>
+#include <zeno/utils/log.h>
+#include <atomic>
+#include <cstring>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define ZENO_HAS_POSIX_SHM 1
+#endif
+#ifndef MAP_POPULATE
+#define MAP_POPULATE 0
+#endif
+
+namespace zeno {
+
+#ifdef ZENO_HAS_POSIX_SHM
+
+ZENO_API std::string shm_publish(const void *data, std::size_t size) {
+    static std::atomic<unsigned> counter{0};
+    std::string name = "/zeno-" + std::to_string(getpid()) + "-" + std::to_string(counter++);
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd == -1) {
+        log_warn("shm_open({}) failed: {}", name, std::strerror(errno));
+        return {};
+    }
+    if (ftruncate(fd, size) != 0) {
+        log_warn("ftruncate shm {} to {} bytes failed: {}", name, size, std::strerror(errno));
+        close(fd);
+        shm_unlink(name.c_str());
+        return {};
+    }
+    void *ptr = size ? mmap(nullptr, size, PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0) : nullptr;
+    close(fd);
+    if (ptr == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        return {};
+    }
+    std::memcpy(ptr, data, size);
+    munmap(ptr, size);
+    return name;
+}
+
+ZENO_API bool shm_consume(std::string const &name, std::size_t size,
+                          std::function<void(const char *data, std::size_t size)> const &func) {
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd == -1) {
+        log_warn("shm_open({}) failed: {}", name, std::strerror(errno));
+        return false;
+    }
+    shm_unlink(name.c_str());  // the mapping keeps it alive until we are done
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (std::size_t)st.st_size < size) {
+        close(fd);
+        return false;
+    }
+    void *ptr = size ? mmap(nullptr, size, PROT_READ, MAP_SHARED | MAP_POPULATE, fd, 0) : nullptr;
+    close(fd);
+    if (ptr == MAP_FAILED)
+        return false;
+    func((const char *)ptr, size);
+    if (size)
+        munmap(ptr, size);
+    return true;
+}
+
+ZENO_API void shm_discard(std::string const &name) {
+    shm_unlink(name.c_str());
+}
+
+#else
+
+ZENO_API std::string shm_publish(const void *data, std::size_t size) {
+    return {};
+}
+
+ZENO_API bool shm_consume(std::string const &name, std::size_t size,
+                          std::function<void(const char *data, std::size_t size)> const &func) {
+    return false;
+}
+
+ZENO_API void shm_discard(std::string const &name) {
+}
+
+#endif
+
+}
@@ -0,0 +1,103 @@
+#include <zeno/utils/WorkStealingPool.h>
+#include <zeno/utils/envconfig.h>
+#include <algorithm>
+
+namespace zeno {
+
+namespace {
+
+thread_local WorkStealingPool *tls_pool = nullptr;
+thread_local std::size_t tls_index = 0;
+
+}
+
+ZENO_API WorkStealingPool::WorkStealingPool(std::size_t nthreads) {
+    if (!nthreads)
+        nthreads = std::max(1u, std::thread::hardware_concurrency());
+    m_queues.reserve(nthreads + 1);
+    for (std::size_t i = 0; i <= nthreads; i++)
+        m_queues.push_back(std::make_unique<Queue>());
+    m_workers.reserve(nthreads);
+    for (std::size_t i = 1; i <= nthreads; i++)
+        m_workers.emplace_back([this, i] { workerMain(i); });
+}
+
+ZENO_API WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard lck(m_mtx);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    for (auto &th: m_workers)
+        th.join();
+}
+
+ZENO_API void WorkStealingPool::submit(Task task) {
+    std::size_t self = tls_pool == this ? tls_index : 0;
+    {
+        // count first, so that a concurrent steal never drives m_pending below zero
+        std::lock_guard lck(m_mtx);
+        m_pending++;
+    }
+    {
+        auto &q = *m_queues[self];
+        std::lock_guard lck(q.mtx);
+        q.tasks.push_back(std::move(task));
+    }
+    m_cv.notify_one();
+}
+
+bool WorkStealingPool::popTask(std::size_t self, Task &task) {
+    {
+        auto &q = *m_queues[self];
+        std::lock_guard lck(q.mtx);
+        if (!q.tasks.empty()) {
+            task = std::move(q.tasks.back());
+            q.tasks.pop_back();
+            m_pending--;
+            return true;
+        }
+    }
+    for (std::size_t k = 1; k < m_queues.size(); k++) {
+        auto &q = *m_queues[(self + k) % m_queues.size()];
+        std::lock_guard lck(q.mtx);
+        if (!q.tasks.empty()) {
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            m_pending--;
+            return true;
+        }
+    }
+    return false;
+}
+
+ZENO_API bool WorkStealingPool::runOneTask() {
+    Task task;
+    if (!popTask(tls_pool == this ? tls_index : 0, task))
+        return false;
+    task();
+    return true;
+}
+
+void WorkStealingPool::workerMain(std::size_t self) {
+    tls_pool = this;
+    tls_index = self;
+    while (true) {
+        Task task;
+        if (popTask(self, task)) {
+            task();
+            continue;
+        }
+        std::unique_lock lck(m_mtx);
+        m_cv.wait(lck, [&] { return m_stop || m_pending.load() != 0; });
+        if (m_stop)
+            break;
+    }
+}
+
+ZENO_API WorkStealingPool &WorkStealingPool::instance() {
+    static WorkStealingPool pool(envconfig::getInt("APPLY_THREADS"));
+    return pool;
+}
+
+}
@@ -0,0 +1,156 @@
+#include <zeno/utils/lzcodec.h>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+
+namespace zeno {
+
+namespace {
+
+constexpr std::size_t kMinMatch = 4;
+constexpr std::size_t kMaxOffset = 65535;
+constexpr std::size_t kLastLiterals = 5;    // tail that is always emitted as literals
+constexpr std::size_t kMatchSafeDist = 12;  // no match may start closer to the end
+constexpr int kHashLog = 16;
+
+inline uint32_t load32(const uint8_t *p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t hash32(uint32_t v) {
+    return (v * 2654435761u) >> (32 - kHashLog);
+}
+
+inline void putLength(std::vector<char> &out, std::size_t len) {
+    while (len >= 255) {
+        out.push_back((char)255);
+        len -= 255;
+    }
+    out.push_back((char)len);
+}
+
+// token: high nibble literal count, low nibble match length - kMinMatch,
+// a nibble of 15 continues as 255-saturated extra bytes
+void emitSequence(std::vector<char> &out, const uint8_t *lit, std::size_t litlen,
+                  std::size_t offset, std::size_t matchlen) {
+    bool hasMatch = matchlen != 0;
+    std::size_t mlcode = hasMatch ? matchlen - kMinMatch : 0;
+    out.push_back((char)((std::min<std::size_t>(litlen, 15) << 4) | std::min<std::size_t>(mlcode, 15)));
+    if (litlen >= 15)
+        putLength(out, litlen - 15);
+    out.insert(out.end(), (const char *)lit, (const char *)lit + litlen);
+    if (!hasMatch)
+        return;
+    out.push_back((char)(offset & 0xff));
+    out.push_back((char)(offset >> 8));
+    if (mlcode >= 15)
+        putLength(out, mlcode - 15);
+}
+
+inline bool getLength(const uint8_t *&ip, const uint8_t *end, std::size_t &len) {
+    uint8_t b;
+    do {
+        if (ip == end)
+            return false;
+        b = *ip++;
+        len += b;
+    } while (b == 255);
+    return true;
+}
+
+}
+
+ZENO_API std::size_t lz_compress(const void *src, std::size_t size, std::vector<char> &out) {
+    std::size_t oldsize = out.size();
+    out.reserve(oldsize + size + size / 255 + 16);
+    auto base = (const uint8_t *)src;
+    auto ip = base, anchor = base, end = base + size;
+
+    if (size > kMatchSafeDist) {
+        std::vector<uint32_t> table(std::size_t(1) << kHashLog);
+        auto mflimit = end - kMatchSafeDist;
+        auto matchlimit = end - kLastLiterals;
+        std::size_t misses = 0;
+        while (ip <= mflimit) {
+            uint32_t v = load32(ip);
+            auto &slot = table[hash32(v)];
+            auto ref = base + slot;
+            slot = (uint32_t)(ip - base);
+            if (ref < ip && (std::size_t)(ip - ref) <= kMaxOffset && load32(ref) == v) {
+                auto mp = ip + kMinMatch, mr = ref + kMinMatch;
+                while (mp < matchlimit && *mp == *mr)
+                    mp++, mr++;
+                emitSequence(out, anchor, ip - anchor, ip - ref, mp - ip);
+                ip = anchor = mp;
+                misses = 0;
+            } else {
+                // skip faster through data that doesn't compress
+                ip += 1 + (misses++ >> 6);
+            }
+        }
+    }
+    emitSequence(out, anchor, end - anchor, 0, 0);
+    return out.size() - oldsize;
+}
+
+ZENO_API bool lz_decompress(const void *src, std::size_t size, void *dst, std::size_t dstsize) {
+    auto ip = (const uint8_t *)src, iend = ip + size;
+    auto op = (uint8_t *)dst, ostart = op, oend = op + dstsize;
+    while (ip < iend) {
+        uint8_t token = *ip++;
+        std::size_t litlen = token >> 4;
+        if (litlen == 15 && !getLength(ip, iend, litlen))
+            return false;
+        if (litlen > (std::size_t)(iend - ip) || litlen > (std::size_t)(oend - op))
+            return false;
+        std::memcpy(op, ip, litlen);
+        ip += litlen;
+        op += litlen;
+        if (ip == iend)
+            break;  // the last sequence has no match part
+
+        if (iend - ip < 2)
+            return false;
+        std::size_t offset = ip[0] | (std::size_t(ip[1]) << 8);
+        ip += 2;
+        std::size_t matchlen = token & 15;
+        if (matchlen == 15 && !getLength(ip, iend, matchlen))
+            return false;
+        matchlen += kMinMatch;
+        if (offset == 0 || offset > (std::size_t)(op - ostart) || matchlen > (std::size_t)(oend - op))
+            return false;
+        auto mp = op - offset;
+        if (offset >= matchlen) {
+            std::memcpy(op, mp, matchlen);
+            op += matchlen;
+        } else {
+            while (matchlen--)  // overlapping copy repeats the pattern
+                *op++ = *mp++;
+        }
+    }
+    return op == oend;
+}
+
+ZENO_API void byte_shuffle(const void *src, void *dst, std::size_t size, std::size_t stride) {
+    auto s = (const uint8_t *)src;
+    auto d = (uint8_t *)dst;
+    std::size_t n = size / stride;
+    for (std::size_t b = 0; b < stride; b++)
+        for (std::size_t i = 0; i < n; i++)
+            d[b * n + i] = s[i * stride + b];
+    std::memcpy(d + n * stride, s + n * stride, size - n * stride);
+}
+
+ZENO_API void byte_unshuffle(const void *src, void *dst, std::size_t size, std::size_t stride) {
+    auto s = (const uint8_t *)src;
+    auto d = (uint8_t *)dst;
+    std::size_t n = size / stride;
+    for (std::size_t b = 0; b < stride; b++)
+        for (std::size_t i = 0; i < n; i++)
+            d[i * stride + b] = s[b * n + i];
+    std::memcpy(d + n * stride, s + n * stride, size - n * stride);
+}
+
+}